@@ -0,0 +1,497 @@
+/*
+OpenGL GPUstress.
+Baked texture atlas class.
+Bake: atlas decoded and glyph cells unpacked by regular startup path,
+mip chain built by 2x2 box filter, levels written raw, aligned for
+mapping, or LZ4 block compressed. Blob is located at executable directory.
+Open: blob mapped read only, raw levels used directly from mapped view,
+LZ4 levels decompressed to one buffer. Blob baked from other JPEG resource
+is rejected by source size and hash.
+*/
+
+#include "AtlasBlob.h"
+
+AtlasBlob::AtlasBlob() : hFile(INVALID_HANDLE_VALUE), hMapping(NULL), view(nullptr), unpacked(nullptr),
+	                     header{ 0 }, levels{ { 0 } }, levelPointers{ nullptr }, levelsCount(0),
+	                     startupMilliseconds{ 0 }
+{
+
+}
+AtlasBlob::~AtlasBlob()
+{
+	close();
+}
+BOOL AtlasBlob::open(HINSTANCE hModule, double tscPeriod)
+{
+	close();
+	char path[MAX_PATH];
+	if (!getBlobPath(path, MAX_PATH)) return FALSE;
+	DWORD64 t1 = __rdtsc();
+	hFile = CreateFile(path, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) return FALSE;
+	LARGE_INTEGER fileSize;
+	if ((!GetFileSizeEx(hFile, &fileSize)) || (fileSize.QuadPart < static_cast<LONGLONG>(sizeof(atlasBlobHeader))))
+	{
+		close();
+		return FALSE;
+	}
+	hMapping = CreateFileMapping(hFile, nullptr, PAGE_READONLY, 0, 0, nullptr);
+	if (hMapping)
+	{
+		view = reinterpret_cast<const BYTE*>(MapViewOfFile(hMapping, FILE_MAP_READ, 0, 0, 0));
+	}
+	if (!view)
+	{
+		close();
+		return FALSE;
+	}
+
+	DWORD64 blobBytes = fileSize.QuadPart;
+	int chainLevels = getChainLevels(APPCONST::TEXTURE_WIDTH, APPCONST::TEXTURE_HEIGHT);
+	DWORD64 tableEnd = sizeof(atlasBlobHeader) + chainLevels * sizeof(atlasBlobLevel);
+	memcpy(&header, view, sizeof(atlasBlobHeader));
+	if ((header.signature != APPCONST::ATLAS_SIGNATURE) || (header.version != APPCONST::ATLAS_VERSION) ||
+		(header.width != APPCONST::TEXTURE_WIDTH) || (header.height != APPCONST::TEXTURE_HEIGHT) ||
+		(header.levelsCount != static_cast<DWORD32>(chainLevels)) || (header.compression >= ATLAS_COMPRESSIONS_COUNT) ||
+		(tableEnd > blobBytes))
+	{
+		close();
+		return FALSE;
+	}
+	memcpy(levels, view + sizeof(atlasBlobHeader), chainLevels * sizeof(atlasBlobLevel));
+	DWORD32 width = header.width;
+	DWORD32 height = header.height;
+	DWORD64 unpackedBytes = 0;
+	for (int i = 0; i < chainLevels; i++)
+	{
+		const atlasBlobLevel& level = levels[i];
+		if ((level.width != width) || (level.height != height) || (level.bytes != static_cast<DWORD64>(width) * height * 4) ||
+			(level.offset < tableEnd) || (level.storedBytes > blobBytes) || (level.offset > (blobBytes - level.storedBytes)) ||
+			((header.compression == ATLAS_RAW) && (level.storedBytes != level.bytes)))
+		{
+			close();
+			return FALSE;
+		}
+		unpackedBytes += level.bytes;
+		width = (width > 1) ? (width / 2) : 1;
+		height = (height > 1) ? (height / 2) : 1;
+	}
+
+	DWORD64 t2 = __rdtsc();
+	DWORD32 sourceBytes = 0;
+	DWORD64 sourceHash = hashSource(hModule, &sourceBytes);
+	if ((!sourceBytes) || (sourceBytes != header.sourceBytes) || (sourceHash != header.sourceHash))
+	{
+		close();
+		return FALSE;
+	}
+
+	DWORD64 t3 = __rdtsc();
+	if (header.compression == ATLAS_LZ4)
+	{
+		unpacked = reinterpret_cast<BYTE*>(VirtualAlloc(nullptr, static_cast<SIZE_T>(unpackedBytes), MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+		if (!unpacked)
+		{
+			close();
+			return FALSE;
+		}
+		BYTE* p = unpacked;
+		for (int i = 0; i < chainLevels; i++)
+		{
+			if (!decompressLz4(view + levels[i].offset, static_cast<size_t>(levels[i].storedBytes), p, static_cast<size_t>(levels[i].bytes)))
+			{
+				close();
+				return FALSE;
+			}
+			levelPointers[i] = p;
+			p += levels[i].bytes;
+		}
+		// Mapped view not used after decompression.
+		UnmapViewOfFile(view);
+		view = nullptr;
+		CloseHandle(hMapping);
+		hMapping = NULL;
+		CloseHandle(hFile);
+		hFile = INVALID_HANDLE_VALUE;
+	}
+	else
+	{
+		for (int i = 0; i < chainLevels; i++)
+		{
+			levelPointers[i] = view + levels[i].offset;
+		}
+	}
+	DWORD64 t4 = __rdtsc();
+
+	double k = tscPeriod * 1.0E3;
+	startupMilliseconds[STARTUP_MAP] = (t2 - t1) * k;
+	startupMilliseconds[STARTUP_CHECK] = (t3 - t2) * k;
+	startupMilliseconds[STARTUP_UNPACK] = (t4 - t3) * k;
+	levelsCount = chainLevels;
+	return TRUE;
+}
+void AtlasBlob::close()
+{
+	if (view)
+	{
+		UnmapViewOfFile(view);
+		view = nullptr;
+	}
+	if (hMapping)
+	{
+		CloseHandle(hMapping);
+		hMapping = NULL;
+	}
+	if (hFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(hFile);
+		hFile = INVALID_HANDLE_VALUE;
+	}
+	if (unpacked)
+	{
+		VirtualFree(unpacked, 0, MEM_RELEASE);
+		unpacked = nullptr;
+	}
+	memset(levelPointers, 0, sizeof(levelPointers));
+	levelsCount = 0;
+}
+// Source is decoded atlas with glyph cells, BGRA pixels, bottom-up rows.
+BOOL AtlasBlob::bake(HINSTANCE hModule, const void* rawData, BOOL compress)
+{
+	char path[MAX_PATH];
+	if ((!rawData) || (!getBlobPath(path, MAX_PATH))) return FALSE;
+	atlasBlobHeader blobHeader;
+	memset(&blobHeader, 0, sizeof(blobHeader));
+	blobHeader.signature = APPCONST::ATLAS_SIGNATURE;
+	blobHeader.version = APPCONST::ATLAS_VERSION;
+	blobHeader.width = APPCONST::TEXTURE_WIDTH;
+	blobHeader.height = APPCONST::TEXTURE_HEIGHT;
+	blobHeader.levelsCount = getChainLevels(APPCONST::TEXTURE_WIDTH, APPCONST::TEXTURE_HEIGHT);
+	blobHeader.compression = compress ? ATLAS_LZ4 : ATLAS_RAW;
+	blobHeader.sourceHash = hashSource(hModule, &blobHeader.sourceBytes);
+	if (!blobHeader.sourceBytes) return FALSE;
+
+	// Mip chain sizes as generated by OpenGL, each level filtered from previous.
+	int chainLevels = blobHeader.levelsCount;
+	atlasBlobLevel table[APPCONST::ATLAS_MAX_LEVELS];
+	const DWORD32* pixels[APPCONST::ATLAS_MAX_LEVELS];
+	memset(table, 0, sizeof(table));
+	memset(pixels, 0, sizeof(pixels));
+	pixels[0] = reinterpret_cast<const DWORD32*>(rawData);
+	int width = APPCONST::TEXTURE_WIDTH;
+	int height = APPCONST::TEXTURE_HEIGHT;
+	for (int i = 0; i < chainLevels; i++)
+	{
+		table[i].width = width;
+		table[i].height = height;
+		table[i].bytes = static_cast<DWORD64>(width) * height * 4;
+		if (i)
+		{
+			DWORD32* level = new DWORD32[static_cast<size_t>(width) * height];
+			downsample(pixels[i - 1], table[i - 1].width, table[i - 1].height, level, width, height);
+			pixels[i] = level;
+		}
+		width = (width > 1) ? (width / 2) : 1;
+		height = (height > 1) ? (height / 2) : 1;
+	}
+
+	BOOL status = FALSE;
+	BYTE* packed = nullptr;
+	DWORD32* hashTable = nullptr;
+	if (compress)
+	{
+		size_t bound = static_cast<size_t>(table[0].bytes + table[0].bytes / 255 + 16);
+		packed = new BYTE[bound];
+		hashTable = new DWORD32[static_cast<size_t>(1) << APPCONST::ATLAS_HASH_BITS];
+	}
+	HANDLE hOut = CreateFile(path, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hOut != INVALID_HANDLE_VALUE)
+	{
+		// Header and levels table rewritten when stored sizes are known.
+		static const BYTE padding[APPCONST::ATLAS_ALIGNMENT] = { 0 };
+		DWORD written = 0;
+		DWORD64 position = sizeof(atlasBlobHeader) + chainLevels * sizeof(atlasBlobLevel);
+		status = WriteFile(hOut, &blobHeader, sizeof(atlasBlobHeader), &written, nullptr) &&
+			WriteFile(hOut, table, static_cast<DWORD>(chainLevels * sizeof(atlasBlobLevel)), &written, nullptr);
+		for (int i = 0; (i < chainLevels) && status; i++)
+		{
+			const BYTE* data = reinterpret_cast<const BYTE*>(pixels[i]);
+			size_t size = static_cast<size_t>(table[i].bytes);
+			if (compress)
+			{
+				size = compressLz4(data, size, packed, static_cast<size_t>(table[0].bytes + table[0].bytes / 255 + 16), hashTable);
+				data = packed;
+				status = (size != 0);
+			}
+			else
+			{
+				// Raw levels page aligned, upload reads mapped pages directly.
+				DWORD pad = static_cast<DWORD>((APPCONST::ATLAS_ALIGNMENT - (position % APPCONST::ATLAS_ALIGNMENT)) % APPCONST::ATLAS_ALIGNMENT);
+				if (pad) status = WriteFile(hOut, padding, pad, &written, nullptr);
+				position += pad;
+			}
+			table[i].offset = position;
+			table[i].storedBytes = size;
+			status = status && WriteFile(hOut, data, static_cast<DWORD>(size), &written, nullptr) && (written == size);
+			position += size;
+		}
+		if (status)
+		{
+			SetFilePointer(hOut, sizeof(atlasBlobHeader), nullptr, FILE_BEGIN);
+			status = WriteFile(hOut, table, static_cast<DWORD>(chainLevels * sizeof(atlasBlobLevel)), &written, nullptr);
+		}
+		CloseHandle(hOut);
+		if (!status) DeleteFile(path);
+	}
+	for (int i = 1; i < chainLevels; i++)
+	{
+		if (pixels[i]) delete[] pixels[i];
+	}
+	if (packed) delete[] packed;
+	if (hashTable) delete[] hashTable;
+	return status;
+}
+int AtlasBlob::getLevelsCount()
+{
+	return levelsCount;
+}
+const void* AtlasBlob::getLevel(int level, int* width, int* height)
+{
+	if ((level < 0) || (level >= levelsCount)) return nullptr;
+	*width = levels[level].width;
+	*height = levels[level].height;
+	return levelPointers[level];
+}
+// Level 0 pixels, atlas with glyph cells, valid while blob opened.
+const void* AtlasBlob::getRawPointer()
+{
+	return levelsCount ? levelPointers[0] : nullptr;
+}
+void AtlasBlob::setStartupMilliseconds(startupStage stage, double milliseconds)
+{
+	startupMilliseconds[stage] = milliseconds;
+}
+// One row per run appended, runs with and without blob compared in one file.
+BOOL AtlasBlob::saveStartupReport(const char* fileName)
+{
+	HANDLE hReport = CreateFile(fileName, GENERIC_WRITE, FILE_SHARE_READ, nullptr, OPEN_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hReport == INVALID_HANDLE_VALUE) return FALSE;
+	char text[APPCONST::MAX_TEXT_STRING * 2];
+	int used = 0;
+	LARGE_INTEGER fileSize;
+	if (GetFileSizeEx(hReport, &fileSize) && (!fileSize.QuadPart))
+	{
+		used += snprintf(text, sizeof(text),
+			"atlas,map ms,check ms,unpack ms,decode ms,font ms,upload ms,mipmap ms,total ms\r\n");
+	}
+	double total = 0.0;
+	for (int i = 0; i < STARTUP_STAGES_COUNT; i++)
+	{
+		total += startupMilliseconds[i];
+	}
+	const char* source = levelsCount ? szSourceNames[header.compression] : szSourceNames[ATLAS_COMPRESSIONS_COUNT];
+	used += snprintf(text + used, sizeof(text) - used, "%s,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f,%.3f\r\n", source,
+		startupMilliseconds[STARTUP_MAP], startupMilliseconds[STARTUP_CHECK], startupMilliseconds[STARTUP_UNPACK],
+		startupMilliseconds[STARTUP_DECODE], startupMilliseconds[STARTUP_FONT], startupMilliseconds[STARTUP_UPLOAD],
+		startupMilliseconds[STARTUP_MIPMAP], total);
+	SetFilePointer(hReport, 0, nullptr, FILE_END);
+	DWORD written = 0;
+	BOOL status = WriteFile(hReport, text, used, &written, nullptr);
+	CloseHandle(hReport);
+	return status;
+}
+BOOL AtlasBlob::getBlobPath(char* path, int size)
+{
+	DWORD length = GetModuleFileName(NULL, path, size);
+	if ((!length) || (length >= static_cast<DWORD>(size))) return FALSE;
+	char* name = strrchr(path, '\\');
+	name = name ? (name + 1) : path;
+	int k = snprintf(name, size - (name - path), "%s", APPCONST::ATLAS_BLOB_NAME);
+	return ((k > 0) && (k < (size - (name - path))));
+}
+// FNV-1a of JPEG resource. Glyphs are part of code, blob rebaked by post-build step.
+DWORD64 AtlasBlob::hashSource(HINSTANCE hModule, DWORD32* bytes)
+{
+	*bytes = 0;
+	HRSRC hResInfo = FindResource(hModule, MAKEINTRESOURCE(IDR_JPEG_TEXTURE), RT_RCDATA);
+	if (!hResInfo) return 0;
+	DWORD byteCount = SizeofResource(hModule, hResInfo);
+	HGLOBAL hResData = LoadResource(hModule, hResInfo);
+	const BYTE* p = hResData ? reinterpret_cast<const BYTE*>(LockResource(hResData)) : nullptr;
+	if ((!p) || (!byteCount)) return 0;
+	DWORD64 hash = 0xCBF29CE484222325ULL;
+	for (DWORD i = 0; i < byteCount; i++)
+	{
+		hash ^= p[i];
+		hash *= 0x100000001B3ULL;
+	}
+	*bytes = byteCount;
+	return hash;
+}
+int AtlasBlob::getChainLevels(int width, int height)
+{
+	int count = 1;
+	while ((width > 1) || (height > 1))
+	{
+		width = (width > 1) ? (width / 2) : 1;
+		height = (height > 1) ? (height / 2) : 1;
+		count++;
+	}
+	return count;
+}
+// 2x2 box filter with rounding, last column and row of odd size source not sampled,
+// single pixel source dimension repeated.
+void AtlasBlob::downsample(const DWORD32* src, int srcWidth, int srcHeight, DWORD32* dst, int dstWidth, int dstHeight)
+{
+	for (int y = 0; y < dstHeight; y++)
+	{
+		const BYTE* row0 = reinterpret_cast<const BYTE*>(src + static_cast<size_t>(y * 2) * srcWidth);
+		const BYTE* row1 = (srcHeight > 1) ? (row0 + static_cast<size_t>(srcWidth) * 4) : row0;
+		BYTE* out = reinterpret_cast<BYTE*>(dst + static_cast<size_t>(y) * dstWidth);
+		int step = (srcWidth > 1) ? 4 : 0;
+		for (int x = 0; x < dstWidth; x++)
+		{
+			const BYTE* a = row0 + x * 8;
+			const BYTE* b = row1 + x * 8;
+			for (int c = 0; c < 4; c++)
+			{
+				*(out++) = static_cast<BYTE>((a[c] + a[c + step] + b[c] + b[c + step] + 2) >> 2);
+			}
+		}
+	}
+}
+// LZ4 block format, greedy single hash match finder. Sequence is token
+// (literals length, match length minus 4), literals, 16-bit offset, match length.
+// Last match starts 12 bytes or more before end, last 5 bytes are literals.
+// Returns compressed size, 0 if output capacity exceeded.
+size_t AtlasBlob::compressLz4(const BYTE* src, size_t srcSize, BYTE* dst, size_t dstCapacity, DWORD32* hashTable)
+{
+	constexpr size_t MIN_MATCH = 4;
+	constexpr size_t LAST_LITERALS = 5;
+	constexpr size_t MATCH_LIMIT = 12;
+	constexpr int HASH_SHIFT = 32 - APPCONST::ATLAS_HASH_BITS;
+	memset(hashTable, 0, sizeof(DWORD32) << APPCONST::ATLAS_HASH_BITS);
+	const BYTE* ip = src;
+	const BYTE* anchor = src;
+	const BYTE* end = src + srcSize;
+	BYTE* op = dst;
+	BYTE* opEnd = dst + dstCapacity;
+	if (srcSize > MATCH_LIMIT)
+	{
+		const BYTE* ipLimit = end - MATCH_LIMIT;
+		while (ip < ipLimit)
+		{
+			DWORD32 sequence = *reinterpret_cast<const DWORD32*>(ip);
+			DWORD32 h = (sequence * 2654435761U) >> HASH_SHIFT;
+			const BYTE* ref = src + hashTable[h];
+			hashTable[h] = static_cast<DWORD32>(ip - src);
+			if ((ref >= ip) || ((ip - ref) > 0xFFFF) || (*reinterpret_cast<const DWORD32*>(ref) != sequence))
+			{
+				ip++;
+				continue;
+			}
+			const BYTE* matchEnd = ip + MIN_MATCH;
+			const BYTE* refEnd = ref + MIN_MATCH;
+			while ((matchEnd < (end - LAST_LITERALS)) && (*matchEnd == *refEnd))
+			{
+				matchEnd++;
+				refEnd++;
+			}
+			size_t literals = ip - anchor;
+			size_t matchLength = (matchEnd - ip) - MIN_MATCH;
+			if (static_cast<size_t>(opEnd - op) < (literals + literals / 255 + matchLength / 255 + 8)) return 0;
+			BYTE* token = op++;
+			*token = static_cast<BYTE>(((literals >= 15) ? 15 : literals) << 4);
+			if (literals >= 15)
+			{
+				size_t n = literals - 15;
+				for (; n >= 255; n -= 255) *(op++) = 255;
+				*(op++) = static_cast<BYTE>(n);
+			}
+			memcpy(op, anchor, literals);
+			op += literals;
+			size_t offset = ip - ref;
+			*(op++) = static_cast<BYTE>(offset);
+			*(op++) = static_cast<BYTE>(offset >> 8);
+			*token |= static_cast<BYTE>((matchLength >= 15) ? 15 : matchLength);
+			if (matchLength >= 15)
+			{
+				size_t n = matchLength - 15;
+				for (; n >= 255; n -= 255) *(op++) = 255;
+				*(op++) = static_cast<BYTE>(n);
+			}
+			ip = matchEnd;
+			anchor = ip;
+		}
+	}
+	size_t literals = end - anchor;
+	if (static_cast<size_t>(opEnd - op) < (literals + literals / 255 + 2)) return 0;
+	*(op++) = static_cast<BYTE>(((literals >= 15) ? 15 : literals) << 4);
+	if (literals >= 15)
+	{
+		size_t n = literals - 15;
+		for (; n >= 255; n -= 255) *(op++) = 255;
+		*(op++) = static_cast<BYTE>(n);
+	}
+	memcpy(op, anchor, literals);
+	op += literals;
+	return op - dst;
+}
+// Bounds checked LZ4 block decoder, output must be filled exactly.
+BOOL AtlasBlob::decompressLz4(const BYTE* src, size_t srcSize, BYTE* dst, size_t dstSize)
+{
+	const BYTE* ip = src;
+	const BYTE* ipEnd = src + srcSize;
+	BYTE* op = dst;
+	BYTE* opEnd = dst + dstSize;
+	while (ip < ipEnd)
+	{
+		unsigned int token = *(ip++);
+		size_t length = token >> 4;
+		if (length == 15)
+		{
+			BYTE b = 0;
+			do
+			{
+				if (ip >= ipEnd) return FALSE;
+				b = *(ip++);
+				length += b;
+			} while (b == 255);
+		}
+		if ((static_cast<size_t>(ipEnd - ip) < length) || (static_cast<size_t>(opEnd - op) < length)) return FALSE;
+		memcpy(op, ip, length);
+		op += length;
+		ip += length;
+		if (ip == ipEnd) break;         // Last sequence has literals only.
+		if ((ipEnd - ip) < 2) return FALSE;
+		size_t offset = ip[0] | (static_cast<size_t>(ip[1]) << 8);
+		ip += 2;
+		if ((!offset) || (offset > static_cast<size_t>(op - dst))) return FALSE;
+		length = token & 15;
+		if (length == 15)
+		{
+			BYTE b = 0;
+			do
+			{
+				if (ip >= ipEnd) return FALSE;
+				b = *(ip++);
+				length += b;
+			} while (b == 255);
+		}
+		length += 4;
+		if (static_cast<size_t>(opEnd - op) < length) return FALSE;
+		const BYTE* match = op - offset;
+		if (offset >= length)
+		{
+			memcpy(op, match, length);
+		}
+		else
+		{
+			for (size_t i = 0; i < length; i++) op[i] = match[i];     // Overlapped copy repeats pattern.
+		}
+		op += length;
+	}
+	return (op == opEnd);
+}
+
+const char* AtlasBlob::szSourceNames[] = { "blob", "blob lz4", "jpeg" };
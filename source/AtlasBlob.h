@@ -0,0 +1,95 @@
+/*
+OpenGL GPUstress.
+Baked texture atlas class header.
+Texture atlas with glyph cells and full mip chain baked to binary blob,
+blob memory mapped at startup and levels uploaded directly, without
+JPEG decode, font unpack and mipmap generation.
+*/
+
+#pragma once
+#ifndef ATLASBLOB_H
+#define ATLASBLOB_H
+
+#include <windows.h>
+#include <iostream>
+#include <intrin.h>
+#include "resource.h"
+#include "Global.h"
+
+enum atlasCompression
+{
+    ATLAS_RAW = 0,
+    ATLAS_LZ4,
+    ATLAS_COMPRESSIONS_COUNT
+};
+
+// Startup stages timed for report, atlas blob path or JPEG path stages are zero.
+enum startupStage
+{
+    STARTUP_MAP = 0,        // Blob file open, map and header validation.
+    STARTUP_CHECK,          // Source JPEG hash compared with hash at bake time.
+    STARTUP_UNPACK,         // LZ4 decompression.
+    STARTUP_DECODE,         // JPEG decode by GDI+.
+    STARTUP_FONT,           // Glyph cells unpack to texture.
+    STARTUP_UPLOAD,         // Texture levels upload, until finished by GPU.
+    STARTUP_MIPMAP,         // Mip chain generation, until finished by GPU.
+    STARTUP_STAGES_COUNT
+};
+
+// Blob header, followed by levels table, levels data aligned.
+struct atlasBlobHeader
+{
+    DWORD32 signature;
+    DWORD32 version;
+    DWORD32 width;
+    DWORD32 height;
+    DWORD32 levelsCount;
+    DWORD32 compression;
+    DWORD32 sourceBytes;        // JPEG resource size, stale blob detection.
+    DWORD32 reserved;
+    DWORD64 sourceHash;         // FNV-1a hash of JPEG resource.
+};
+
+// Mip level of BGRA pixels, bottom-up rows.
+struct atlasBlobLevel
+{
+    DWORD32 width;
+    DWORD32 height;
+    DWORD64 offset;
+    DWORD64 bytes;
+    DWORD64 storedBytes;        // Compressed size, equal to bytes if raw.
+};
+
+class AtlasBlob
+{
+public:
+    AtlasBlob();
+    ~AtlasBlob();
+    BOOL open(HINSTANCE hModule, double tscPeriod);
+    void close();
+    BOOL bake(HINSTANCE hModule, const void* rawData, BOOL compress);
+    int getLevelsCount();
+    const void* getLevel(int level, int* width, int* height);
+    const void* getRawPointer();
+    void setStartupMilliseconds(startupStage stage, double milliseconds);
+    BOOL saveStartupReport(const char* fileName);
+private:
+    static BOOL getBlobPath(char* path, int size);
+    static DWORD64 hashSource(HINSTANCE hModule, DWORD32* bytes);
+    static int getChainLevels(int width, int height);
+    static void downsample(const DWORD32* src, int srcWidth, int srcHeight, DWORD32* dst, int dstWidth, int dstHeight);
+    static size_t compressLz4(const BYTE* src, size_t srcSize, BYTE* dst, size_t dstCapacity, DWORD32* hashTable);
+    static BOOL decompressLz4(const BYTE* src, size_t srcSize, BYTE* dst, size_t dstSize);
+    HANDLE hFile;
+    HANDLE hMapping;
+    const BYTE* view;
+    BYTE* unpacked;
+    atlasBlobHeader header;
+    atlasBlobLevel levels[APPCONST::ATLAS_MAX_LEVELS];
+    const BYTE* levelPointers[APPCONST::ATLAS_MAX_LEVELS];
+    int levelsCount;
+    double startupMilliseconds[STARTUP_STAGES_COUNT];
+    static const char* szSourceNames[];
+};
+
+#endif // ATLASBLOB_H
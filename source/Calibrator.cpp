@@ -0,0 +1,169 @@
+/*
+OpenGL GPUstress.
+Load calibration class.
+Each step: settle time after load change (driver buffers reallocation,
+clocks ramp), then frame times measurement. Step passes if mean frame
+time is not above target. If target is inside noise band of mean
+(2 standard errors), measurement extended before decision.
+Search doubles load until first fail, then bisects pass and fail loads.
+*/
+
+#include "Calibrator.h"
+
+Calibrator::Calibrator() : state(CALIBRATION_IDLE), tscPeriod(0.0), targetSeconds(0.0), load(0), passLoad(0), failLoad(0),
+	                       step(0), extensions(0), settling(TRUE), lastTsc(0), phaseSeconds(0.0), frames(0),
+	                       sum(0.0), sumSquares(0.0), lastFps(0.0)
+{
+
+}
+Calibrator::~Calibrator()
+{
+
+}
+void Calibrator::start(double targetFps, unsigned int startLoad, const char* description, double period)
+{
+	tscPeriod = period;
+	targetSeconds = 1.0 / targetFps;
+	load = roundLoad(startLoad);
+	passLoad = 0;
+	failLoad = 0;
+	step = 0;
+	extensions = 0;
+	settling = TRUE;
+	lastTsc = 0;
+	phaseSeconds = 0.0;
+	frames = 0;
+	sum = 0.0;
+	sumSquares = 0.0;
+	lastFps = 0.0;
+	state = CALIBRATION_RUNNING;
+	report.clear();
+	report.add("Calibration: %s, target %.2f FPS (%.3f ms)\r\n", description, targetFps, targetSeconds * 1000.0);
+	report.add("step,instances,frames,FPS,frame ms,deviation ms,extensions,result\r\n");
+}
+void Calibrator::stop()
+{
+	state = CALIBRATION_IDLE;
+}
+// Called once per frame with frame start timestamp.
+void Calibrator::frame(DWORD64 frameTsc)
+{
+	if (state != CALIBRATION_RUNNING) return;
+	if (lastTsc)
+	{
+		double dt = (frameTsc - lastTsc) * tscPeriod;
+		phaseSeconds += dt;
+		if (settling)
+		{
+			if (phaseSeconds >= APPCONST::CALIBRATION_SETTLE_SECONDS)
+			{
+				settling = FALSE;
+				phaseSeconds = 0.0;
+			}
+		}
+		else
+		{
+			frames++;
+			sum += dt;
+			sumSquares += dt * dt;
+			if ((phaseSeconds >= APPCONST::CALIBRATION_MEASURE_SECONDS) && (frames >= APPCONST::CALIBRATION_MIN_FRAMES))
+			{
+				double mean = sum / frames;
+				double variance = sumSquares / frames - mean * mean;
+				double deviation = (variance > 0.0) ? sqrt(variance) : 0.0;
+				double margin = 2.0 * deviation / sqrt(static_cast<double>(frames));
+				if ((fabs(mean - targetSeconds) < margin) && (extensions < APPCONST::CALIBRATION_MAX_EXTENSIONS))
+				{
+					extensions++;
+					phaseSeconds = 0.0;
+				}
+				else
+				{
+					decide(mean, deviation);
+				}
+			}
+		}
+	}
+	lastTsc = frameTsc;
+}
+void Calibrator::decide(double mean, double deviation)
+{
+	BOOL pass = (mean <= targetSeconds);
+	lastFps = 1.0 / mean;
+	report.add("%d,%u,%I64u,%.2f,%.3f,%.3f,%d,%s\r\n", step, load, frames, lastFps,
+		mean * 1000.0, deviation * 1000.0, extensions, pass ? "pass" : "fail");
+	if (pass)
+	{
+		passLoad = load;
+	}
+	else
+	{
+		failLoad = load;
+	}
+	step++;
+
+	unsigned int next = 0;
+	if (!failLoad)
+	{
+		if (load >= APPCONST::CALIBRATION_MAX_INSTANCES) next = 0;     // Cap reached, score is cap.
+		else next = roundLoad(load * 2.0);
+	}
+	else if (passLoad && ((failLoad - passLoad) > passLoad * APPCONST::CALIBRATION_PRECISION) &&
+		((failLoad - passLoad) > APPCONST::CALIBRATION_MIN_INSTANCES))
+	{
+		next = roundLoad((static_cast<double>(passLoad) + failLoad) / 2.0);
+	}
+	else if ((!passLoad) && (load > APPCONST::CALIBRATION_MIN_INSTANCES))
+	{
+		next = roundLoad(load / 2.0);
+	}
+	if ((!next) || (next == load) || (step >= APPCONST::CALIBRATION_MAX_STEPS))
+	{
+		state = CALIBRATION_DONE;
+		if (passLoad) load = passLoad;
+		report.add("Score: %u instances at %.2f FPS\r\n", passLoad, 1.0 / targetSeconds);
+		return;
+	}
+	load = next;
+	extensions = 0;
+	settling = TRUE;
+	phaseSeconds = 0.0;
+	frames = 0;
+	sum = 0.0;
+	sumSquares = 0.0;
+}
+// Instances count multiple of 4 for SIMD fill, in calibration limits.
+unsigned int Calibrator::roundLoad(double value)
+{
+	if (value < APPCONST::CALIBRATION_MIN_INSTANCES) value = APPCONST::CALIBRATION_MIN_INSTANCES;
+	if (value > APPCONST::CALIBRATION_MAX_INSTANCES) value = APPCONST::CALIBRATION_MAX_INSTANCES;
+	return static_cast<unsigned int>(value) & (~3U);
+}
+calibrationState Calibrator::getState()
+{
+	return state;
+}
+unsigned int Calibrator::getLoad()
+{
+	return load;
+}
+void Calibrator::writeRow(char* row, int size)
+{
+	char szResults[APPCONST::MAX_TEXT_STRING];
+	if (state == CALIBRATION_DONE)
+	{
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "Score %u instances at %.1f FPS, %d steps (C=close)",
+			passLoad, 1.0 / targetSeconds, step);
+	}
+	else
+	{
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "Calibrating %.1f FPS step %d %s last %.1f pass %u fail %u",
+			1.0 / targetSeconds, step, settling ? "settle " : "measure", lastFps, passLoad, failLoad);
+	}
+	snprintf(row, size, "%-*s", size - 1, szResults);
+}
+BOOL Calibrator::saveReport(const char* fileName)
+{
+	if (state != CALIBRATION_DONE) return FALSE;
+	return report.save(fileName);
+}
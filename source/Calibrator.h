@@ -0,0 +1,58 @@
+/*
+OpenGL GPUstress.
+Load calibration class header.
+Binary search of instances count which holds target frame rate,
+found count is single comparable score of device at current options.
+*/
+
+#pragma once
+#ifndef CALIBRATOR_H
+#define CALIBRATOR_H
+
+#include <windows.h>
+#include <iostream>
+#include <math.h>
+#include "Global.h"
+#include "Report.h"
+
+enum calibrationState
+{
+    CALIBRATION_IDLE = 0,
+    CALIBRATION_RUNNING,
+    CALIBRATION_DONE
+};
+
+class Calibrator
+{
+public:
+    Calibrator();
+    ~Calibrator();
+    void start(double targetFps, unsigned int startLoad, const char* description, double period);
+    void stop();
+    void frame(DWORD64 frameTsc);
+    calibrationState getState();
+    unsigned int getLoad();
+    void writeRow(char* row, int size);
+    BOOL saveReport(const char* fileName);
+private:
+    void decide(double mean, double deviation);
+    unsigned int roundLoad(double load);
+    calibrationState state;
+    double tscPeriod;
+    double targetSeconds;
+    unsigned int load;
+    unsigned int passLoad;      // Highest load which holds target, 0 if none.
+    unsigned int failLoad;      // Lowest load which fails target, 0 if not found yet.
+    int step;
+    int extensions;
+    BOOL settling;
+    DWORD64 lastTsc;
+    double phaseSeconds;
+    DWORD64 frames;
+    double sum;
+    double sumSquares;
+    double lastFps;
+    Report report;
+};
+
+#endif // CALIBRATOR_H
@@ -0,0 +1,379 @@
+/*
+OpenGL GPUstress.
+CPU burner threads class.
+Threads created once, parked on run events while not used. One burn pass
+is about millisecond of work, stop or kind change applied between passes.
+Frame time is time between frame calls, it includes swap and waits.
+*/
+
+#include "CpuBurner.h"
+
+CpuBurner::CpuBurner() : workers(nullptr), threads{ 0 }, workersCount(0), tscPeriod(0.0), fmaSupported(FALSE), exiting(FALSE),
+	                     kindNow(BURN_OFF), threadsNow(0), kindSelected(BURN_OFF), threadsSelected(0), lastFrameTsc(0),
+	                     windowTsc(0), windowFrames(0), windowFlops(0), windowBytes(0), sweepState(BURN_SWEEP_OFF),
+	                     sweepKind(BURN_FMA), sweepFrame(0), sweepStep(0), sweepStepsCount(0), stepTicks(0), stepUploadBytes(0),
+	                     stepUploadTicks(0), stepFlops(0), stepBytes(0), frameTimes(nullptr), sweepResults{ 0 }
+{
+	// FMA requires CPU support and YMM registers state save by OS.
+	int regs[4] = { 0 };
+	__cpuid(regs, 0);
+	if (regs[0] >= 1)
+	{
+		__cpuid(regs, 1);
+		BOOL osYmm = (regs[2] & (1 << 27)) && (regs[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6);
+		fmaSupported = osYmm && (regs[2] & (1 << 12));
+	}
+}
+CpuBurner::~CpuBurner()
+{
+	release();
+}
+// Threads count limited by BURN_MAX_THREADS, less threads used if thread creation failed.
+BOOL CpuBurner::init(int threadsCount, double period)
+{
+	release();
+	tscPeriod = period;
+	if (threadsCount < 1) threadsCount = 1;
+	if (threadsCount > APPCONST::BURN_MAX_THREADS) threadsCount = APPCONST::BURN_MAX_THREADS;
+	frameTimes = new double[APPCONST::BURN_MEASURE_FRAMES];
+	workers = new burnWorker[threadsCount];
+	memset(workers, 0, threadsCount * sizeof(burnWorker));
+	exiting = FALSE;
+	workersCount = 0;
+	for (int i = 0; i < threadsCount; i++)
+	{
+		burnWorker& w = workers[i];
+		w.owner = this;
+		w.index = i;
+		w.hRun = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+		HANDLE hThread = w.hRun ? CreateThread(nullptr, 0, workerThread, &w, 0, nullptr) : NULL;
+		if (!hThread)
+		{
+			if (w.hRun) CloseHandle(w.hRun);
+			break;
+		}
+		threads[workersCount++] = hThread;
+	}
+	threadsSelected = workersCount;
+	return (workersCount == threadsCount);
+}
+void CpuBurner::release()
+{
+	if (!workers) return;
+	exiting = TRUE;
+	for (int i = 0; i < workersCount; i++)
+	{
+		SetEvent(workers[i].hRun);
+	}
+	for (int i = 0; i < workersCount; i++)
+	{
+		WaitForSingleObject(threads[i], INFINITE);
+		CloseHandle(threads[i]);
+		CloseHandle(workers[i].hRun);
+		threads[i] = NULL;
+	}
+	delete[] workers;
+	workers = nullptr;
+	workersCount = 0;
+	delete[] frameTimes;
+	frameTimes = nullptr;
+	kindNow = BURN_OFF;
+	threadsNow = 0;
+	sweepState = BURN_SWEEP_OFF;
+}
+// User selected kind and threads count, applied if sweep not running.
+void CpuBurner::select(burnKind kind, int threads)
+{
+	if (threads < 1) threads = 1;
+	if (threads > workersCount) threads = workersCount;
+	kindSelected = kind;
+	threadsSelected = threads;
+	if (sweepState == BURN_SWEEP_RUNNING) return;
+	apply(kind, threads);
+}
+burnKind CpuBurner::getKind()
+{
+	return kindNow;
+}
+int CpuBurner::getWorkersCount()
+{
+	return workersCount;
+}
+// Called once per frame, upload of frame is bytes and CPU ticks of upload stage.
+void CpuBurner::frame(DWORD64 uploadBytes, DWORD64 uploadTicks)
+{
+	DWORD64 now = __rdtsc();
+	DWORD64 ticks = lastFrameTsc ? (now - lastFrameTsc) : 0;
+	lastFrameTsc = now;
+	if (!ticks) return;
+	windowTsc += ticks;
+	windowFrames++;
+	if (sweepState != BURN_SWEEP_RUNNING) return;
+	sweepFrame++;
+	if (sweepFrame == APPCONST::BURN_WARMUP_FRAMES)
+	{
+		stepTicks = 0;
+		stepUploadBytes = 0;
+		stepUploadTicks = 0;
+		getCounters(&stepFlops, &stepBytes);
+	}
+	else if (sweepFrame > APPCONST::BURN_WARMUP_FRAMES)
+	{
+		int measured = sweepFrame - APPCONST::BURN_WARMUP_FRAMES;
+		frameTimes[measured - 1] = ticks * tscPeriod * 1000.0;
+		stepTicks += ticks;
+		stepUploadBytes += uploadBytes;
+		stepUploadTicks += uploadTicks;
+		if (measured < APPCONST::BURN_MEASURE_FRAMES) return;
+		DWORD64 flops = 0;
+		DWORD64 bytes = 0;
+		getCounters(&flops, &bytes);
+		double seconds = stepTicks * tscPeriod;
+		burnStepResult& r = sweepResults[sweepStep];
+		r.threads = threadsNow;
+		r.fps = APPCONST::BURN_MEASURE_FRAMES / seconds;
+		r.uploadMegabytesPerSecond = stepUploadTicks ? (stepUploadBytes / 1048576.0 / (stepUploadTicks * tscPeriod)) : 0.0;
+		std::sort(frameTimes, frameTimes + APPCONST::BURN_MEASURE_FRAMES);
+		r.frameMilliseconds[0] = percentile(0.50);
+		r.frameMilliseconds[1] = percentile(0.95);
+		r.frameMilliseconds[2] = percentile(0.99);
+		r.gigaflopsPerSecond = (flops - stepFlops) / seconds / 1.0E9;
+		r.gigabytesPerSecond = (bytes - stepBytes) / seconds / 1.0E9;
+		sweepStep++;
+		nextStep();
+	}
+}
+// Sweep of threads count 0 (GPU only), 1, 2, 4 ... up to selected count, FMA kind if burners off.
+void CpuBurner::startSweep()
+{
+	if (!workersCount) return;
+	memset(sweepResults, 0, sizeof(sweepResults));
+	sweepKind = (kindSelected == BURN_OFF) ? BURN_FMA : kindSelected;
+	sweepStepsCount = 1;
+	for (int t = 1; sweepStepsCount < APPCONST::BURN_SWEEP_STEPS; t *= 2)
+	{
+		sweepStepsCount++;
+		if (t >= threadsSelected) break;
+	}
+	sweepState = BURN_SWEEP_RUNNING;
+	sweepStep = 0;
+	nextStep();
+}
+void CpuBurner::stopSweep()
+{
+	sweepState = BURN_SWEEP_OFF;
+	apply(kindSelected, threadsSelected);
+}
+burnSweepState CpuBurner::getSweepState()
+{
+	return sweepState;
+}
+// Row shows averages for display update interval, window restarts after read.
+void CpuBurner::writeRow(char* row, int size)
+{
+	char szResults[APPCONST::MAX_TEXT_STRING];
+	if (sweepState == BURN_SWEEP_RUNNING)
+	{
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "CPU burn sweep(Z) %d/%d %s threads %d",
+			sweepStep + 1, sweepStepsCount, szKindNames[sweepKind], threadsNow);
+	}
+	else if (sweepState == BURN_SWEEP_DONE)
+	{
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "CPU burn sweep(Z) done, %s saved (Z=close)", szKindNames[sweepKind]);
+	}
+	else
+	{
+		DWORD64 flops = 0;
+		DWORD64 bytes = 0;
+		getCounters(&flops, &bytes);
+		double seconds = windowTsc * tscPeriod;
+		if (seconds > 0.0)
+		{
+			snprintf(szResults, APPCONST::MAX_TEXT_STRING, "CPU burn(Y) %-6s threads %-2d GFLOP/s %-7.1f GB/s %-6.1f FPS %-6.1f",
+				szKindNames[kindNow], threadsNow, (flops - windowFlops) / seconds / 1.0E9, (bytes - windowBytes) / seconds / 1.0E9,
+				windowFrames / seconds);
+		}
+		else
+		{
+			snprintf(szResults, APPCONST::MAX_TEXT_STRING, "CPU burn(Y) %-6s threads %-2d", szKindNames[kindNow], threadsNow);
+		}
+		windowTsc = 0;
+		windowFrames = 0;
+		windowFlops = flops;
+		windowBytes = bytes;
+	}
+	snprintf(row, size, "%-*s", size - 1, szResults);
+}
+// Each step compared with first step, GPU only.
+BOOL CpuBurner::saveSweepReport(const char* fileName)
+{
+	if (sweepState != BURN_SWEEP_DONE) return FALSE;
+	const burnStepResult& b = sweepResults[0];
+	report.clear();
+	report.add("CPU burners sweep, kind %s, %d burner threads available, FMA %s, %d measured frames per step\r\n",
+		szKindNames[sweepKind], workersCount, fmaSupported ? "256-bit" : "not supported, SSE", APPCONST::BURN_MEASURE_FRAMES);
+	report.add("burner threads,FPS,FPS %% of GPU only,upload MB/s,upload %% of GPU only,p50 ms,p95 ms,p99 ms,"
+		"p99 vs GPU only,burner GFLOP/s,burner GB/s\r\n");
+	for (int i = 0; i < sweepStepsCount; i++)
+	{
+		const burnStepResult& r = sweepResults[i];
+		report.add("%d,%.1f,%.1f,%.1f,%.1f,%.3f,%.3f,%.3f,%.3f,%.1f,%.2f\r\n", r.threads, r.fps,
+			(b.fps > 0.0) ? (r.fps * 100.0 / b.fps) : 0.0, r.uploadMegabytesPerSecond,
+			(b.uploadMegabytesPerSecond > 0.0) ? (r.uploadMegabytesPerSecond * 100.0 / b.uploadMegabytesPerSecond) : 0.0,
+			r.frameMilliseconds[0], r.frameMilliseconds[1], r.frameMilliseconds[2],
+			(b.frameMilliseconds[2] > 0.0) ? (r.frameMilliseconds[2] / b.frameMilliseconds[2]) : 0.0,
+			r.gigaflopsPerSecond, r.gigabytesPerSecond);
+	}
+	return report.save(fileName);
+}
+// Mixed kind: odd threads load memory, even threads load FMA units.
+DWORD WINAPI CpuBurner::workerThread(LPVOID parm)
+{
+	burnWorker& w = *static_cast<burnWorker*>(parm);
+	CpuBurner* p = w.owner;
+	while (TRUE)
+	{
+		WaitForSingleObject(w.hRun, INFINITE);
+		if (p->exiting) break;
+		burnKind kind = p->kindNow;
+		if ((kind == BURN_MEMORY) || ((kind == BURN_MIXED) && (w.index & 1)))
+		{
+			burnMemory(w);
+		}
+		else
+		{
+			burnFma(w, p->fmaSupported);
+		}
+	}
+	if (w.block)
+	{
+		VirtualFree(w.block, 0, MEM_RELEASE);
+		w.block = nullptr;
+	}
+	return 0;
+}
+// Eight independent chains hide FMA latency, values converge to c / (1 - m), no denormals.
+void CpuBurner::burnFma(burnWorker& w, BOOL fma)
+{
+	if (fma)
+	{
+		const __m256 m = _mm256_set1_ps(0.999f);
+		const __m256 c = _mm256_set1_ps(0.001f);
+		__m256 a[8];
+		for (int j = 0; j < 8; j++)
+		{
+			a[j] = _mm256_set1_ps(static_cast<float>(w.index + j));
+		}
+		for (int i = 0; i < APPCONST::BURN_FMA_ITERATIONS; i++)
+		{
+			a[0] = _mm256_fmadd_ps(a[0], m, c);
+			a[1] = _mm256_fmadd_ps(a[1], m, c);
+			a[2] = _mm256_fmadd_ps(a[2], m, c);
+			a[3] = _mm256_fmadd_ps(a[3], m, c);
+			a[4] = _mm256_fmadd_ps(a[4], m, c);
+			a[5] = _mm256_fmadd_ps(a[5], m, c);
+			a[6] = _mm256_fmadd_ps(a[6], m, c);
+			a[7] = _mm256_fmadd_ps(a[7], m, c);
+		}
+		__m256 s = _mm256_add_ps(_mm256_add_ps(_mm256_add_ps(a[0], a[1]), _mm256_add_ps(a[2], a[3])),
+			_mm256_add_ps(_mm256_add_ps(a[4], a[5]), _mm256_add_ps(a[6], a[7])));
+		w.sink += _mm256_cvtss_f32(s);
+		w.flops += static_cast<DWORD64>(APPCONST::BURN_FMA_ITERATIONS) * 8 * 16;
+		_mm256_zeroupper();
+	}
+	else
+	{
+		const __m128 m = _mm_set1_ps(0.999f);
+		const __m128 c = _mm_set1_ps(0.001f);
+		__m128 a[8];
+		for (int j = 0; j < 8; j++)
+		{
+			a[j] = _mm_set1_ps(static_cast<float>(w.index + j));
+		}
+		for (int i = 0; i < APPCONST::BURN_FMA_ITERATIONS; i++)
+		{
+			for (int j = 0; j < 8; j++)
+			{
+				a[j] = _mm_add_ps(_mm_mul_ps(a[j], m), c);
+			}
+		}
+		__m128 s = _mm_add_ps(_mm_add_ps(_mm_add_ps(a[0], a[1]), _mm_add_ps(a[2], a[3])),
+			_mm_add_ps(_mm_add_ps(a[4], a[5]), _mm_add_ps(a[6], a[7])));
+		w.sink += _mm_cvtss_f32(s);
+		w.flops += static_cast<DWORD64>(APPCONST::BURN_FMA_ITERATIONS) * 8 * 8;
+	}
+}
+// Block read and written back, bytes counted for both directions. Compute kernel used if block allocation failed.
+void CpuBurner::burnMemory(burnWorker& w)
+{
+	if (!w.block)
+	{
+		w.block = reinterpret_cast<BYTE*>(VirtualAlloc(nullptr, APPCONST::BURN_MEMORY_BYTES, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+		if (!w.block)
+		{
+			burnFma(w, FALSE);
+			return;
+		}
+	}
+	__m128i* p = reinterpret_cast<__m128i*>(w.block);
+	const __m128i one = _mm_set1_epi32(1);
+	for (size_t i = 0; i < APPCONST::BURN_MEMORY_BYTES; i += 64)
+	{
+		_mm_store_si128(p, _mm_add_epi32(_mm_load_si128(p), one));
+		_mm_store_si128(p + 1, _mm_add_epi32(_mm_load_si128(p + 1), one));
+		_mm_store_si128(p + 2, _mm_add_epi32(_mm_load_si128(p + 2), one));
+		_mm_store_si128(p + 3, _mm_add_epi32(_mm_load_si128(p + 3), one));
+		p += 4;
+	}
+	w.bytes += APPCONST::BURN_MEMORY_BYTES * 2;
+}
+// Worker events: first threads run, others parked.
+void CpuBurner::apply(burnKind kind, int threads)
+{
+	if ((kind == kindNow) && (threads == threadsNow)) return;
+	kindNow = kind;
+	threadsNow = threads;
+	for (int i = 0; i < workersCount; i++)
+	{
+		if ((kind != BURN_OFF) && (i < threads))
+		{
+			SetEvent(workers[i].hRun);
+		}
+		else
+		{
+			ResetEvent(workers[i].hRun);
+		}
+	}
+}
+// Step threads count: 0, then powers of 2, last step is selected count. Selected burners restored after last step.
+void CpuBurner::nextStep()
+{
+	if (sweepStep >= sweepStepsCount)
+	{
+		sweepState = BURN_SWEEP_DONE;
+		apply(kindSelected, threadsSelected);
+		return;
+	}
+	int threads = sweepStep ? (1 << (sweepStep - 1)) : 0;
+	if ((threads > threadsSelected) || (sweepStep == (sweepStepsCount - 1))) threads = threadsSelected;
+	apply(sweepKind, threads);
+	sweepFrame = 0;
+}
+void CpuBurner::getCounters(DWORD64* flops, DWORD64* bytes)
+{
+	*flops = 0;
+	*bytes = 0;
+	for (int i = 0; i < workersCount; i++)
+	{
+		*flops += workers[i].flops;
+		*bytes += workers[i].bytes;
+	}
+}
+// Frame times sorted, nearest rank.
+double CpuBurner::percentile(double fraction)
+{
+	int index = static_cast<int>(fraction * (APPCONST::BURN_MEASURE_FRAMES - 1) + 0.5);
+	return frameTimes[index];
+}
+
+const char* CpuBurner::szKindNames[] = { "off", "FMA", "memory", "mixed" };
@@ -0,0 +1,119 @@
+/*
+OpenGL GPUstress.
+CPU burner threads class header.
+Burner threads load CPU cores while GPU renders: FMA compute, memory
+read-modify-write, or both at alternate threads. Sweep ramps threads
+count from GPU only to selected count and measures frame rate, upload
+rate and frame time percentiles at each step.
+*/
+
+#pragma once
+#ifndef CPUBURNER_H
+#define CPUBURNER_H
+
+#include <windows.h>
+#include <iostream>
+#include <intrin.h>
+#include <immintrin.h>
+#include <algorithm>
+#include "Global.h"
+#include "Report.h"
+
+enum burnKind
+{
+    BURN_OFF = 0,
+    BURN_FMA,           // 256-bit FMA chains if supported, SSE multiply and add otherwise.
+    BURN_MEMORY,        // Read-modify-write of own block larger than caches.
+    BURN_MIXED,         // Even threads FMA, odd threads memory.
+    BURN_KINDS_COUNT
+};
+
+enum burnSweepState
+{
+    BURN_SWEEP_OFF = 0,
+    BURN_SWEEP_RUNNING,
+    BURN_SWEEP_DONE
+};
+
+class CpuBurner;
+
+// Burner thread state, counters written by own thread only.
+struct burnWorker
+{
+    CpuBurner* owner;
+    int index;
+    HANDLE hRun;                // Manual reset, set while thread must burn.
+    BYTE* block;                // Memory kernel block, allocated at first use by own thread.
+    volatile DWORD64 flops;
+    volatile DWORD64 bytes;
+    float sink;
+    BYTE pad[APPCONST::CACHE_LINE_SIZE];
+};
+
+// Sweep step result, frame times percentiles are 50, 95 and 99.
+struct burnStepResult
+{
+    int threads;
+    double fps;
+    double uploadMegabytesPerSecond;
+    double frameMilliseconds[3];
+    double gigaflopsPerSecond;
+    double gigabytesPerSecond;
+};
+
+class CpuBurner
+{
+public:
+    CpuBurner();
+    ~CpuBurner();
+    BOOL init(int threadsCount, double period);
+    void release();
+    void select(burnKind kind, int threads);
+    burnKind getKind();
+    int getWorkersCount();
+    void frame(DWORD64 uploadBytes, DWORD64 uploadTicks);
+    void startSweep();
+    void stopSweep();
+    burnSweepState getSweepState();
+    void writeRow(char* row, int size);
+    BOOL saveSweepReport(const char* fileName);
+private:
+    static DWORD WINAPI workerThread(LPVOID parm);
+    static void burnFma(burnWorker& w, BOOL fma);
+    static void burnMemory(burnWorker& w);
+    void apply(burnKind kind, int threads);
+    void nextStep();
+    void getCounters(DWORD64* flops, DWORD64* bytes);
+    double percentile(double fraction);
+    burnWorker* workers;
+    HANDLE threads[APPCONST::BURN_MAX_THREADS];
+    int workersCount;
+    double tscPeriod;
+    BOOL fmaSupported;
+    volatile BOOL exiting;
+    volatile burnKind kindNow;
+    int threadsNow;
+    burnKind kindSelected;
+    int threadsSelected;
+    DWORD64 lastFrameTsc;
+    DWORD64 windowTsc;
+    DWORD64 windowFrames;
+    DWORD64 windowFlops;
+    DWORD64 windowBytes;
+    burnSweepState sweepState;
+    burnKind sweepKind;
+    int sweepFrame;
+    int sweepStep;
+    int sweepStepsCount;
+    DWORD64 stepTicks;
+    DWORD64 stepUploadBytes;
+    DWORD64 stepUploadTicks;
+    DWORD64 stepFlops;
+    DWORD64 stepBytes;
+    double* frameTimes;
+    burnStepResult sweepResults[APPCONST::BURN_SWEEP_STEPS];
+    Report report;
+    static const char* szKindNames[];
+};
+
+#endif // CPUBURNER_H
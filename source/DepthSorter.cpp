@@ -0,0 +1,211 @@
+/*
+OpenGL GPUstress.
+Instance depth ordering class.
+Radix sort: four 8-bit digit passes over key of scale absolute value,
+each pass is histogram phase and scatter phase at all threads, offsets
+computed between phases by caller thread. Caller thread is worker 0,
+other workers wait for start events, no thread creation per frame.
+*/
+
+#include "DepthSorter.h"
+
+DepthSorter::DepthSorter() : workers(nullptr), doneEvents{ 0 }, threads{ 0 }, workersCount(0), activeCount(0),
+	                         phase(SORT_HISTOGRAM), source(nullptr), destination(nullptr), keyFlip(0), keyShift(0)
+{
+
+}
+DepthSorter::~DepthSorter()
+{
+	release();
+}
+// Workers count limited by DEPTH_SORT_MAX_THREADS, less workers used if thread creation failed.
+BOOL DepthSorter::init(int threadsCount)
+{
+	release();
+	if (threadsCount < 1) threadsCount = 1;
+	if (threadsCount > APPCONST::DEPTH_SORT_MAX_THREADS) threadsCount = APPCONST::DEPTH_SORT_MAX_THREADS;
+	workers = new sortWorker[threadsCount];
+	memset(workers, 0, threadsCount * sizeof(sortWorker));
+	workersCount = 1;
+	workers[0].owner = this;
+	for (int i = 1; i < threadsCount; i++)
+	{
+		sortWorker& w = workers[i];
+		w.owner = this;
+		w.hStart = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+		w.hDone = CreateEvent(nullptr, FALSE, FALSE, nullptr);
+		HANDLE hThread = (w.hStart && w.hDone) ? CreateThread(nullptr, 0, workerThread, &w, 0, nullptr) : NULL;
+		if (!hThread)
+		{
+			if (w.hStart) CloseHandle(w.hStart);
+			if (w.hDone) CloseHandle(w.hDone);
+			break;
+		}
+		threads[workersCount - 1] = hThread;
+		doneEvents[workersCount - 1] = w.hDone;
+		workersCount++;
+	}
+	return (workersCount == threadsCount);
+}
+void DepthSorter::release()
+{
+	if (!workers) return;
+	phase = SORT_EXIT;
+	for (int i = 1; i < workersCount; i++)
+	{
+		SetEvent(workers[i].hStart);
+	}
+	for (int i = 1; i < workersCount; i++)
+	{
+		WaitForSingleObject(threads[i - 1], INFINITE);
+		CloseHandle(threads[i - 1]);
+		CloseHandle(workers[i].hStart);
+		CloseHandle(workers[i].hDone);
+		threads[i - 1] = NULL;
+		doneEvents[i - 1] = NULL;
+	}
+	delete[] workers;
+	workers = nullptr;
+	workersCount = 0;
+}
+// Jittered scales: common animated scale multiplied by fixed factor of instance index.
+void DepthSorter::fill(float* scales, size_t count, float scale, BOOL streaming)
+{
+	if (jitter.size() < count)
+	{
+		size_t i = jitter.size();
+		jitter.resize(count);
+		for (; i < count; i++)
+		{
+			// Integer hash of index, factor at 0.4 ... 1.0 range.
+			DWORD32 x = static_cast<DWORD32>(i) * 0x9E3779B1;
+			x ^= x >> 16;
+			x *= 0x85EBCA6B;
+			x ^= x >> 13;
+			jitter[i] = 0.4f + 0.6f * (x >> 8) / 16777216.0f;
+		}
+	}
+	const float* pJitter = jitter.data();
+	size_t i = 0;
+	if (streaming)
+	{
+		// Non-temporal stores from 16-byte aligned element, used if scales not sorted at CPU.
+		for (; (i < count) && (reinterpret_cast<size_t>(scales + i) & 15); i++)
+		{
+			scales[i] = scale * pJitter[i];
+		}
+		__m128 vScale = _mm_set1_ps(scale);
+		for (; (i + 4) <= count; i += 4)
+		{
+			_mm_stream_ps(scales + i, _mm_mul_ps(vScale, _mm_loadu_ps(pJitter + i)));
+		}
+		_mm_sfence();
+	}
+	for (; i < count; i++)
+	{
+		scales[i] = scale * pJitter[i];
+	}
+}
+// Stable sort of scales by absolute value: descending is front to back, ascending is back to front.
+void DepthSorter::sort(float* scales, size_t count, BOOL frontToBack)
+{
+	if ((count < 2) || (!workers)) return;
+	if (temp.size() < count) temp.resize(count);
+	activeCount = (count >= APPCONST::DEPTH_SORT_PARALLEL_MIN) ? workersCount : 1;
+	for (int i = 0; i < activeCount; i++)
+	{
+		workers[i].first = count * i / activeCount;
+		workers[i].count = count * (i + 1) / activeCount - workers[i].first;
+	}
+	keyFlip = frontToBack ? 0x7FFFFFFF : 0;
+	DWORD32* data = reinterpret_cast<DWORD32*>(scales);
+	source = data;
+	destination = temp.data();
+	for (keyShift = 0; keyShift < 32; keyShift += 8)
+	{
+		runPhase(SORT_HISTOGRAM);
+		size_t running = 0;
+		BOOL sameDigit = FALSE;
+		for (int d = 0; d < 256; d++)
+		{
+			size_t digitCount = 0;
+			for (int i = 0; i < activeCount; i++)
+			{
+				workers[i].offsets[d] = running;
+				running += workers[i].histogram[d];
+				digitCount += workers[i].histogram[d];
+			}
+			if (digitCount == count) sameDigit = TRUE;
+		}
+		// Pass skipped if all keys have same digit, typical for exponent bits.
+		if (sameDigit) continue;
+		runPhase(SORT_SCATTER);
+		DWORD32* p = source;
+		source = destination;
+		destination = p;
+	}
+	if (source != data)
+	{
+		memcpy(data, source, count * sizeof(DWORD32));
+	}
+}
+DWORD WINAPI DepthSorter::workerThread(LPVOID parm)
+{
+	sortWorker* w = reinterpret_cast<sortWorker*>(parm);
+	while (WaitForSingleObject(w->hStart, INFINITE) == WAIT_OBJECT_0)
+	{
+		DepthSorter* p = w->owner;
+		if (p->phase == SORT_EXIT) break;
+		if (p->phase == SORT_HISTOGRAM)
+		{
+			p->histogram(*w);
+		}
+		else
+		{
+			p->scatter(*w);
+		}
+		SetEvent(w->hDone);
+	}
+	return 0;
+}
+// Events signal and wait are full memory barriers between phases.
+void DepthSorter::runPhase(sortPhase sortStep)
+{
+	phase = sortStep;
+	for (int i = 1; i < activeCount; i++)
+	{
+		SetEvent(workers[i].hStart);
+	}
+	if (sortStep == SORT_HISTOGRAM)
+	{
+		histogram(workers[0]);
+	}
+	else
+	{
+		scatter(workers[0]);
+	}
+	if (activeCount > 1)
+	{
+		WaitForMultipleObjects(activeCount - 1, doneEvents, TRUE, INFINITE);
+	}
+}
+void DepthSorter::histogram(sortWorker& w)
+{
+	memset(w.histogram, 0, sizeof(w.histogram));
+	const DWORD32* p = source + w.first;
+	for (size_t i = 0; i < w.count; i++)
+	{
+		DWORD32 key = (p[i] & 0x7FFFFFFF) ^ keyFlip;
+		w.histogram[(key >> keyShift) & 0xFF]++;
+	}
+}
+void DepthSorter::scatter(sortWorker& w)
+{
+	const DWORD32* p = source + w.first;
+	for (size_t i = 0; i < w.count; i++)
+	{
+		DWORD32 value = p[i];
+		DWORD32 key = (value & 0x7FFFFFFF) ^ keyFlip;
+		destination[w.offsets[(key >> keyShift) & 0xFF]++] = value;
+	}
+}
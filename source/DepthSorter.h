@@ -0,0 +1,78 @@
+/*
+OpenGL GPUstress.
+Instance depth ordering class header.
+Per-instance scale jitter gives instances at same grid position different depths,
+bigger scale is nearer cube front face. Parallel LSD radix sort orders
+instance stream by depth at CPU.
+*/
+
+#pragma once
+#ifndef DEPTHSORTER_H
+#define DEPTHSORTER_H
+
+#include <windows.h>
+#include <intrin.h>
+#include <vector>
+#include "Global.h"
+
+enum depthOrder
+{
+    DEPTH_ORDER_OFF = 0,        // Same scale for all instances, default workload.
+    DEPTH_ORDER_RANDOM,         // Jittered scales, instance ID order.
+    DEPTH_ORDER_FRONT_TO_BACK,  // Jittered scales sorted, nearest first.
+    DEPTH_ORDER_BACK_TO_FRONT,  // Jittered scales sorted, farthest first.
+    DEPTH_ORDER_PREPASS,        // Jittered scales, depth-only pass then color pass with EQUAL depth test.
+    DEPTH_ORDERS_COUNT
+};
+
+enum sortPhase
+{
+    SORT_HISTOGRAM = 0,
+    SORT_SCATTER,
+    SORT_EXIT
+};
+
+class DepthSorter;
+
+// Sort thread state: own range of source, digit counts and scatter offsets of current pass.
+struct sortWorker
+{
+    DepthSorter* owner;
+    HANDLE hStart;
+    HANDLE hDone;
+    size_t first;
+    size_t count;
+    DWORD32 histogram[256];
+    size_t offsets[256];
+    BYTE pad[APPCONST::CACHE_LINE_SIZE];
+};
+
+class DepthSorter
+{
+public:
+    DepthSorter();
+    ~DepthSorter();
+    BOOL init(int threadsCount);
+    void release();
+    void fill(float* scales, size_t count, float scale, BOOL streaming);
+    void sort(float* scales, size_t count, BOOL frontToBack);
+private:
+    static DWORD WINAPI workerThread(LPVOID parm);
+    void runPhase(sortPhase sortStep);
+    void histogram(sortWorker& w);
+    void scatter(sortWorker& w);
+    std::vector<float> jitter;
+    std::vector<DWORD32> temp;
+    sortWorker* workers;
+    HANDLE doneEvents[APPCONST::DEPTH_SORT_MAX_THREADS];
+    HANDLE threads[APPCONST::DEPTH_SORT_MAX_THREADS];
+    int workersCount;
+    int activeCount;
+    sortPhase phase;
+    DWORD32* source;
+    DWORD32* destination;
+    DWORD32 keyFlip;
+    int keyShift;
+};
+
+#endif // DEPTHSORTER_H
@@ -0,0 +1,363 @@
+/*
+OpenGL GPUstress.
+Frame capture class.
+Render thread never waits for capture: read back fence polled with zero timeout,
+pixels copied when ready. When all pack buffers are in flight or all frame slots
+are busy with encoders, frame dropped and counted, memory is bounded by slots count.
+Encoder threads run below normal priority, PNG files saved by GDI+ encoder,
+Y4M frames converted to 4:2:0 and written at offset of frame sequence number.
+*/
+
+#include "FrameCapture.h"
+
+FrameCapture::FrameCapture() : f(nullptr), width(0), height(0), videoWidth(0), videoHeight(0),
+	                           frameBytes(0), videoFrameBytes(0), videoHeaderBytes(0),
+	                           pbos{ 0 }, fences{ nullptr }, pboNext(0), pboCollect(0),
+	                           slots{ { nullptr, 0, 0 } }, queue{ 0 }, queueHead(0), queueTail(0),
+	                           hJobs(NULL), hStopEvent(NULL), hThreads{ NULL }, threadsCount(0),
+	                           hVideo(INVALID_HANDLE_VALUE), format(CAPTURE_OFF), intervalIndex(0),
+	                           frameCounter(0), sequence(0), savedCount(0), failedCount(0), encodeTicks(0),
+	                           droppedCount(0), windowTicks(0), windowFrames(0)
+{
+	InitializeCriticalSection(&queueLock);
+}
+FrameCapture::~FrameCapture()
+{
+	DeleteCriticalSection(&queueLock);
+}
+void FrameCapture::init(const oglFunctionsList* pFunctions, GLsizei viewWidth, GLsizei viewHeight)
+{
+	f = pFunctions;
+	width = viewWidth;
+	height = viewHeight;
+}
+// Called with rendering context current, before GDI+ shutdown.
+void FrameCapture::release()
+{
+	stop();
+}
+// Window resized, active capture stopped before size change because encoders read size,
+// then restarted: read back buffers, slots and Y4M header use new size, video restarts from first frame.
+void FrameCapture::resize(GLsizei viewWidth, GLsizei viewHeight)
+{
+	if ((viewWidth == width) && (viewHeight == height)) return;
+	captureFormat mode = format;
+	stop();
+	width = viewWidth;
+	height = viewHeight;
+	if (mode != CAPTURE_OFF) start(mode, intervalIndex);
+}
+// Capture size is current window client size, updated by resize.
+BOOL FrameCapture::start(captureFormat mode, int interval)
+{
+	stop();
+	if ((!f) || (mode == CAPTURE_OFF) || (width <= 1) || (height <= 1)) return FALSE;
+	intervalIndex = interval;
+	frameBytes = static_cast<size_t>(width) * height * 4;
+	// Y4M 4:2:0 requires even sizes, last column and row cropped if odd.
+	videoWidth = width & ~1;
+	videoHeight = height & ~1;
+	videoFrameBytes = strlen(szVideoFrame) + static_cast<size_t>(videoWidth) * videoHeight * 3 / 2;
+	if (mode == CAPTURE_Y4M)
+	{
+		hVideo = CreateFile(APPCONST::CAPTURE_Y4M_NAME, GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+		if (hVideo == INVALID_HANDLE_VALUE) return FALSE;
+		char szHeader[APPCONST::MAX_TEXT_STRING];
+		int k = snprintf(szHeader, APPCONST::MAX_TEXT_STRING, "YUV4MPEG2 W%d H%d F%d:1 Ip A1:1 C420jpeg\n",
+			videoWidth, videoHeight, APPCONST::CAPTURE_Y4M_FPS);
+		DWORD written = 0;
+		if ((k <= 0) || (!WriteFile(hVideo, szHeader, k, &written, nullptr)))
+		{
+			CloseHandle(hVideo);
+			hVideo = INVALID_HANDLE_VALUE;
+			return FALSE;
+		}
+		videoHeaderBytes = k;
+	}
+	for (int i = 0; i < APPCONST::CAPTURE_SLOTS; i++)
+	{
+		slots[i].pixels = new BYTE[frameBytes];
+		slots[i].busy = 0;
+	}
+	f->glGenBuffers(APPCONST::CAPTURE_PBO_COUNT, pbos);
+	for (int i = 0; i < APPCONST::CAPTURE_PBO_COUNT; i++)
+	{
+		f->glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[i]);
+		f->glBufferData(GL_PIXEL_PACK_BUFFER, frameBytes, nullptr, GL_STREAM_READ);
+		fences[i] = nullptr;
+	}
+	f->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+	pboNext = 0;
+	pboCollect = 0;
+	queueHead = 0;
+	queueTail = 0;
+	frameCounter = 0;
+	sequence = 0;
+	savedCount = 0;
+	failedCount = 0;
+	encodeTicks = 0;
+	droppedCount = 0;
+	windowTicks = 0;
+	windowFrames = 0;
+	format = mode;
+
+	// One logical processor left for render thread.
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	int count = static_cast<int>(info.dwNumberOfProcessors) - 1;
+	if (count > APPCONST::CAPTURE_MAX_THREADS) count = APPCONST::CAPTURE_MAX_THREADS;
+	if (count < 1) count = 1;
+	hJobs = CreateSemaphore(nullptr, 0, APPCONST::CAPTURE_SLOTS, nullptr);
+	hStopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+	if (hJobs && hStopEvent)
+	{
+		for (threadsCount = 0; threadsCount < count; threadsCount++)
+		{
+			hThreads[threadsCount] = CreateThread(nullptr, 0, encoderThread, this, 0, nullptr);
+			if (!hThreads[threadsCount]) break;
+		}
+	}
+	if (!threadsCount)
+	{
+		stop();
+		return FALSE;
+	}
+	return TRUE;
+}
+// Pending read backs collected with wait, queued frames encoded before threads exit.
+void FrameCapture::stop()
+{
+	if (format == CAPTURE_OFF) return;
+	if (threadsCount) collect(TRUE);
+	for (int i = 0; i < APPCONST::CAPTURE_PBO_COUNT; i++)
+	{
+		if (fences[i]) f->glDeleteSync(fences[i]);
+		fences[i] = nullptr;
+	}
+	if (threadsCount)
+	{
+		SetEvent(hStopEvent);
+		WaitForMultipleObjects(threadsCount, hThreads, TRUE, INFINITE);
+		for (int i = 0; i < threadsCount; i++)
+		{
+			CloseHandle(hThreads[i]);
+			hThreads[i] = NULL;
+		}
+		threadsCount = 0;
+	}
+	if (hJobs)
+	{
+		CloseHandle(hJobs);
+		hJobs = NULL;
+	}
+	if (hStopEvent)
+	{
+		CloseHandle(hStopEvent);
+		hStopEvent = NULL;
+	}
+	if (hVideo != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(hVideo);
+		hVideo = INVALID_HANDLE_VALUE;
+	}
+	if (pbos[0]) f->glDeleteBuffers(APPCONST::CAPTURE_PBO_COUNT, pbos);
+	memset(pbos, 0, sizeof(pbos));
+	for (int i = 0; i < APPCONST::CAPTURE_SLOTS; i++)
+	{
+		if (slots[i].pixels) delete[] slots[i].pixels;
+		slots[i].pixels = nullptr;
+	}
+	format = CAPTURE_OFF;
+}
+captureFormat FrameCapture::getFormat()
+{
+	return format;
+}
+int FrameCapture::getIntervalIndex()
+{
+	return intervalIndex;
+}
+// Called after last draw of frame, before SwapBuffers, back buffer read.
+// Returns CPU TSC ticks spent by render thread.
+DWORD64 FrameCapture::frame()
+{
+	if (format == CAPTURE_OFF) return 0;
+	DWORD64 t1 = __rdtsc();
+	collect(FALSE);
+	if ((frameCounter++ % APPCONST::CAPTURE_INTERVALS[intervalIndex]) == 0)
+	{
+		if (fences[pboNext])
+		{
+			droppedCount++;     // All pack buffers in flight, GPU is behind.
+		}
+		else
+		{
+			f->glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[pboNext]);
+			glReadPixels(0, 0, width, height, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+			f->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+			fences[pboNext] = f->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+			pboNext = (pboNext + 1) % APPCONST::CAPTURE_PBO_COUNT;
+		}
+	}
+	DWORD64 ticks = __rdtsc() - t1;
+	windowTicks += ticks;
+	windowFrames++;
+	return ticks;
+}
+void FrameCapture::writeRow(char* row, int size, double tscPeriod, double fps)
+{
+	char szResults[APPCONST::MAX_TEXT_STRING];
+	double us = windowFrames ? (windowTicks * tscPeriod * 1.0E6 / windowFrames) : 0.0;
+	LONG saved = savedCount;
+	double encodeMs = saved ? (encodeTicks * tscPeriod * 1.0E3 / saved) : 0.0;
+	snprintf(szResults, APPCONST::MAX_TEXT_STRING, "Capture(K,Q) %s 1/%-3d saved %-6d drop %-5d CPU us %-6.1f %5.2f%% enc ms %-5.1f",
+		szFormatNames[format], APPCONST::CAPTURE_INTERVALS[intervalIndex], saved, static_cast<int>(droppedCount + failedCount),
+		us, us * fps / 1.0E4, encodeMs);
+	windowTicks = 0;
+	windowFrames = 0;
+	snprintf(row, size, "%-*s", size - 1, szResults);
+}
+// Read backs collected in issue order, without wait polling stops at first not ready.
+void FrameCapture::collect(BOOL wait)
+{
+	while (fences[pboCollect])
+	{
+		GLenum status = f->glClientWaitSync(fences[pboCollect], wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0,
+			wait ? APPCONST::CAPTURE_FLUSH_TIMEOUT_NS : 0);
+		BOOL ready = ((status == GL_ALREADY_SIGNALED) || (status == GL_CONDITION_SATISFIED));
+		if ((!ready) && (!wait)) break;
+		int index = -1;
+		for (int i = 0; i < APPCONST::CAPTURE_SLOTS; i++)
+		{
+			if (!slots[i].busy)
+			{
+				index = i;
+				break;
+			}
+		}
+		void* pixels = nullptr;
+		f->glBindBuffer(GL_PIXEL_PACK_BUFFER, pbos[pboCollect]);
+		if (ready && (index >= 0))
+		{
+			pixels = f->glMapBufferRange(GL_PIXEL_PACK_BUFFER, 0, frameBytes, GL_MAP_READ_BIT);
+		}
+		if (pixels)
+		{
+			memcpy(slots[index].pixels, pixels, frameBytes);
+			f->glUnmapBuffer(GL_PIXEL_PACK_BUFFER);
+			slots[index].sequence = sequence++;
+			InterlockedExchange(&slots[index].busy, 1);
+			EnterCriticalSection(&queueLock);
+			queue[queueTail] = index;
+			queueTail = (queueTail + 1) % APPCONST::CAPTURE_SLOTS;
+			LeaveCriticalSection(&queueLock);
+			ReleaseSemaphore(hJobs, 1, nullptr);
+		}
+		else
+		{
+			droppedCount++;     // Encoders are behind or read back failed.
+		}
+		f->glBindBuffer(GL_PIXEL_PACK_BUFFER, 0);
+		f->glDeleteSync(fences[pboCollect]);
+		fences[pboCollect] = nullptr;
+		pboCollect = (pboCollect + 1) % APPCONST::CAPTURE_PBO_COUNT;
+	}
+}
+// Jobs semaphore is first wait object, queue drained before stop event accepted.
+DWORD WINAPI FrameCapture::encoderThread(LPVOID parm)
+{
+	FrameCapture* p = reinterpret_cast<FrameCapture*>(parm);
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+	BYTE* frameBuffer = nullptr;
+	if (p->format == CAPTURE_Y4M)
+	{
+		frameBuffer = new BYTE[p->videoFrameBytes];
+	}
+	HANDLE events[2] = { p->hJobs, p->hStopEvent };
+	while (WaitForMultipleObjects(2, events, FALSE, INFINITE) == WAIT_OBJECT_0)
+	{
+		EnterCriticalSection(&p->queueLock);
+		int index = p->queue[p->queueHead];
+		p->queueHead = (p->queueHead + 1) % APPCONST::CAPTURE_SLOTS;
+		LeaveCriticalSection(&p->queueLock);
+		p->encode(p->slots[index], frameBuffer);
+	}
+	if (frameBuffer) delete[] frameBuffer;
+	return 0;
+}
+void FrameCapture::encode(captureSlot& slot, BYTE* frameBuffer)
+{
+	DWORD64 t1 = __rdtsc();
+	BOOL status = (format == CAPTURE_PNG) ? savePng(slot) : writeY4m(slot, frameBuffer);
+	InterlockedExchangeAdd64(&encodeTicks, static_cast<LONG64>(__rdtsc() - t1));
+	InterlockedIncrement(status ? &savedCount : &failedCount);
+	InterlockedExchange(&slot.busy, 0);
+}
+BOOL FrameCapture::savePng(const captureSlot& slot)
+{
+	char szName[MAX_PATH];
+	WCHAR fileName[MAX_PATH];
+	snprintf(szName, MAX_PATH, APPCONST::CAPTURE_PNG_NAME, slot.sequence);
+	if (!MultiByteToWideChar(CP_ACP, 0, szName, -1, fileName, MAX_PATH)) return FALSE;
+	// Read back rows are bottom-up, negative stride from last row gives top-down image.
+	INT stride = width * 4;
+	BYTE* scan0 = slot.pixels + static_cast<size_t>(height - 1) * stride;
+	GpBitmap* pBitmap = nullptr;
+	GpStatus status = GdipCreateBitmapFromScan0(width, height, -stride, PixelFormat32bppRGB, scan0, &pBitmap);
+	if (status != Gdiplus::GpStatus::Ok) return FALSE;
+	status = GdipSaveImageToFile(pBitmap, fileName, &pngEncoder, nullptr);
+	GdipDisposeImage(pBitmap);
+	return (status == Gdiplus::GpStatus::Ok);
+}
+// BGRA to full range BT.601 4:2:0, chroma is average of 2x2 block.
+BOOL FrameCapture::writeY4m(const captureSlot& slot, BYTE* frameBuffer)
+{
+	if (!frameBuffer) return FALSE;
+	size_t headerLength = strlen(szVideoFrame);
+	memcpy(frameBuffer, szVideoFrame, headerLength);
+	BYTE* pY = frameBuffer + headerLength;
+	BYTE* pU = pY + static_cast<size_t>(videoWidth) * videoHeight;
+	BYTE* pV = pU + static_cast<size_t>(videoWidth) * videoHeight / 4;
+	size_t stride = static_cast<size_t>(width) * 4;
+	for (int y = 0; y < videoHeight; y += 2)
+	{
+		const BYTE* row0 = slot.pixels + (height - 1 - y) * stride;
+		const BYTE* row1 = row0 - stride;
+		BYTE* y0 = pY + static_cast<size_t>(y) * videoWidth;
+		BYTE* y1 = y0 + videoWidth;
+		for (int x = 0; x < videoWidth; x += 2)
+		{
+			const BYTE* src[4] = { row0 + x * 4, row0 + x * 4 + 4, row1 + x * 4, row1 + x * 4 + 4 };
+			BYTE* dst[4] = { y0 + x, y0 + x + 1, y1 + x, y1 + x + 1 };
+			int r = 0;
+			int g = 0;
+			int b = 0;
+			for (int i = 0; i < 4; i++)
+			{
+				int pb = src[i][0];
+				int pg = src[i][1];
+				int pr = src[i][2];
+				*dst[i] = static_cast<BYTE>((77 * pr + 150 * pg + 29 * pb) >> 8);
+				r += pr;
+				g += pg;
+				b += pb;
+			}
+			*pU++ = static_cast<BYTE>(128 + ((-43 * r - 85 * g + 128 * b) >> 10));
+			*pV++ = static_cast<BYTE>(128 + ((128 * r - 107 * g - 21 * b) >> 10));
+		}
+	}
+	// Frames written by several threads, each at own offset, order of writes not matters.
+	DWORD64 offset = videoHeaderBytes + static_cast<DWORD64>(slot.sequence) * videoFrameBytes;
+	OVERLAPPED overlapped;
+	memset(&overlapped, 0, sizeof(overlapped));
+	overlapped.Offset = static_cast<DWORD>(offset);
+	overlapped.OffsetHigh = static_cast<DWORD>(offset >> 32);
+	DWORD written = 0;
+	BOOL status = WriteFile(hVideo, frameBuffer, static_cast<DWORD>(videoFrameBytes), &written, &overlapped);
+	return (status && (written == videoFrameBytes));
+}
+
+// {557CF406-1A04-11D3-9A73-0000F81EF32E} GDI+ built-in PNG encoder.
+const CLSID FrameCapture::pngEncoder = { 0x557CF406, 0x1A04, 0x11D3, { 0x9A, 0x73, 0x00, 0x00, 0xF8, 0x1E, 0xF3, 0x2E } };
+const char* FrameCapture::szVideoFrame = "FRAME\n";
+const char* FrameCapture::szFormatNames[] = { "Off", "PNG", "Y4M" };
@@ -0,0 +1,95 @@
+/*
+OpenGL GPUstress.
+Frame capture class header.
+Every Nth frame read back to ring of pixel pack buffers without wait,
+pixels copied to one of fixed count of frame slots, slots encoded to
+PNG files or Y4M video by background threads pool.
+*/
+
+#pragma once
+#ifndef FRAMECAPTURE_H
+#define FRAMECAPTURE_H
+
+#include <windows.h>
+#include <iostream>
+#include <intrin.h>
+#include <gdiplus.h>
+#include "Global.h"
+#include "OpenGLImport.h"
+using namespace Gdiplus;
+using namespace DllExports;
+
+enum captureFormat
+{
+    CAPTURE_OFF = 0,
+    CAPTURE_PNG,
+    CAPTURE_Y4M,
+    CAPTURE_FORMATS_COUNT
+};
+
+// Captured frame pixels, busy from copy until encoder thread done.
+struct captureSlot
+{
+    BYTE* pixels;
+    DWORD32 sequence;
+    volatile LONG busy;
+};
+
+class FrameCapture
+{
+public:
+    FrameCapture();
+    ~FrameCapture();
+    void init(const oglFunctionsList* pFunctions, GLsizei viewWidth, GLsizei viewHeight);
+    void release();
+    void resize(GLsizei viewWidth, GLsizei viewHeight);
+    BOOL start(captureFormat mode, int interval);
+    void stop();
+    captureFormat getFormat();
+    int getIntervalIndex();
+    DWORD64 frame();
+    void writeRow(char* row, int size, double tscPeriod, double fps);
+private:
+    static DWORD WINAPI encoderThread(LPVOID parm);
+    void collect(BOOL wait);
+    void encode(captureSlot& slot, BYTE* frameBuffer);
+    BOOL savePng(const captureSlot& slot);
+    BOOL writeY4m(const captureSlot& slot, BYTE* frameBuffer);
+    const oglFunctionsList* f;
+    GLsizei width;
+    GLsizei height;
+    GLsizei videoWidth;
+    GLsizei videoHeight;
+    size_t frameBytes;
+    size_t videoFrameBytes;
+    DWORD64 videoHeaderBytes;
+    GLuint pbos[APPCONST::CAPTURE_PBO_COUNT];
+    GLsync fences[APPCONST::CAPTURE_PBO_COUNT];
+    int pboNext;
+    int pboCollect;
+    captureSlot slots[APPCONST::CAPTURE_SLOTS];
+    int queue[APPCONST::CAPTURE_SLOTS];
+    int queueHead;
+    int queueTail;
+    CRITICAL_SECTION queueLock;
+    HANDLE hJobs;
+    HANDLE hStopEvent;
+    HANDLE hThreads[APPCONST::CAPTURE_MAX_THREADS];
+    int threadsCount;
+    HANDLE hVideo;
+    captureFormat format;
+    int intervalIndex;
+    DWORD64 frameCounter;
+    DWORD32 sequence;
+    volatile LONG savedCount;
+    volatile LONG failedCount;
+    volatile LONG64 encodeTicks;
+    DWORD32 droppedCount;
+    DWORD64 windowTicks;
+    DWORD64 windowFrames;
+    static const CLSID pngEncoder;
+    static const char* szVideoFrame;
+    static const char* szFormatNames[];
+};
+
+#endif // FRAMECAPTURE_H
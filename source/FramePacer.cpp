@@ -0,0 +1,249 @@
+/*
+OpenGL GPUstress.
+Frames in flight limiter class.
+Completed frames collected without wait at each frame start, waits only
+if limit reached. Latencies of latest frames kept for percentiles,
+limits sweep measures frame rate and latency from driver default to
+maximum limit at same workload.
+*/
+
+#include "FramePacer.h"
+
+FramePacer::FramePacer() : f(nullptr), slots{ 0 }, slotNext(0), slotOldest(0), pendingCount(0), limitNow(0), limitSelected(0),
+	                       tscFrequency(0.0), calibrationTsc(0), calibrationGpu(0), calibrationFrames(0), latencies{ 0 },
+	                       latenciesCount(0), latencyNext(0), lastThrottleTsc(0), windowTicks(0), windowWaitTicks(0), windowFrames(0),
+	                       sweepState(PACER_SWEEP_OFF), sweepFrame(0), sweepResults{ 0 }
+{
+
+}
+FramePacer::~FramePacer()
+{
+
+}
+int FramePacer::init(const oglFunctionsList* pFunctions, double tscHz)
+{
+	f = pFunctions;
+	tscFrequency = tscHz;
+	for (int i = 0; i < APPCONST::PACER_RING_SLOTS; i++)
+	{
+		f->glGenQueries(1, &slots[i].query);
+		if (glGetError() || (!slots[i].query)) return 0x180;
+	}
+	calibrate();
+	if (glGetError()) return 0x181;
+	return 0;
+}
+void FramePacer::release()
+{
+	if (!f) return;
+	for (int i = 0; i < APPCONST::PACER_RING_SLOTS; i++)
+	{
+		if (slots[i].fence) f->glDeleteSync(slots[i].fence);
+		if (slots[i].query) f->glDeleteQueries(1, &slots[i].query);
+		slots[i].fence = nullptr;
+		slots[i].query = 0;
+	}
+	pendingCount = 0;
+}
+// User selected limit, applied if limits sweep not running.
+void FramePacer::select(int limit)
+{
+	if (limit < 0) limit = 0;
+	if (limit > APPCONST::PACER_MAX_FRAMES) limit = APPCONST::PACER_MAX_FRAMES;
+	limitSelected = limit;
+	if ((sweepState == PACER_SWEEP_RUNNING) || (limit == limitNow)) return;
+	limitNow = limit;
+	latenciesCount = 0;
+	latencyNext = 0;
+}
+int FramePacer::getLimit()
+{
+	return limitNow;
+}
+// Called before frame start: completed frames collected, then oldest frames waited
+// until queued frames count is less than limit. Wait time is not part of frame latency.
+void FramePacer::throttle()
+{
+	if (!f) return;
+	while (pendingCount && collect(FALSE)) { }
+	int limit = limitNow ? limitNow : APPCONST::PACER_RING_SLOTS;
+	DWORD64 t1 = __rdtsc();
+	while (pendingCount >= limit)
+	{
+		collect(TRUE);
+	}
+	DWORD64 t2 = __rdtsc();
+	if (lastThrottleTsc)
+	{
+		windowTicks += t2 - lastThrottleTsc;
+		windowWaitTicks += t2 - t1;
+		windowFrames++;
+	}
+	lastThrottleTsc = t2;
+	if (++calibrationFrames >= APPCONST::PACER_CALIBRATE_FRAMES)
+	{
+		calibrate();
+	}
+	if (sweepState != PACER_SWEEP_RUNNING) return;
+	sweepFrame++;
+	if (sweepFrame == APPCONST::PACER_WARMUP_FRAMES)
+	{
+		windowTicks = 0;
+		windowWaitTicks = 0;
+		windowFrames = 0;
+		latenciesCount = 0;
+		latencyNext = 0;
+	}
+	else if (sweepFrame >= (APPCONST::PACER_WARMUP_FRAMES + APPCONST::PACER_MEASURE_FRAMES))
+	{
+		pacerResult& r = sweepResults[limitNow];
+		r.limit = limitNow;
+		r.fps = windowTicks ? (windowFrames * tscFrequency / windowTicks) : 0.0;
+		r.waitMicroseconds = windowFrames ? (windowWaitTicks * 1.0E6 / tscFrequency / windowFrames) : 0.0;
+		r.samples = getPercentiles(r.latencyMilliseconds);
+		limitNow++;
+		nextStep();
+	}
+}
+// Called after swap, marks frame end in command stream.
+void FramePacer::endFrame(DWORD64 beginTsc)
+{
+	if (!f) return;
+	pacerSlot& s = slots[slotNext];
+	s.beginTsc = beginTsc;
+	f->glQueryCounter(s.query, GL_TIMESTAMP);
+	s.fence = f->glFenceSync(GL_SYNC_GPU_COMMANDS_COMPLETE, 0);
+	if (!s.fence) return;
+	slotNext = (slotNext + 1) % APPCONST::PACER_RING_SLOTS;
+	pendingCount++;
+}
+// Sweep of limits from driver default to maximum, at current workload.
+void FramePacer::startSweep()
+{
+	memset(sweepResults, 0, sizeof(sweepResults));
+	sweepState = PACER_SWEEP_RUNNING;
+	limitNow = 0;
+	nextStep();
+}
+void FramePacer::stopSweep()
+{
+	sweepState = PACER_SWEEP_OFF;
+	limitNow = limitSelected;
+	latenciesCount = 0;
+	latencyNext = 0;
+}
+pacerSweepState FramePacer::getSweepState()
+{
+	return sweepState;
+}
+// Row shows averages for display update interval, latencies of latest frames.
+void FramePacer::writeRow(char* row, int size)
+{
+	char szResults[APPCONST::MAX_TEXT_STRING];
+	char szLimit[16];
+	snprintf(szLimit, sizeof(szLimit), limitNow ? "%d" : "drv", limitNow);
+	if (sweepState == PACER_SWEEP_RUNNING)
+	{
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "Queue sweep(3) limit %s, %d/%d", szLimit,
+			limitNow + 1, APPCONST::PACER_MAX_FRAMES + 1);
+	}
+	else if (sweepState == PACER_SWEEP_DONE)
+	{
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "Queue sweep(3) done, saved (3=close)");
+	}
+	else
+	{
+		double ms[3] = { 0.0, 0.0, 0.0 };
+		getPercentiles(ms);
+		double fps = windowTicks ? (windowFrames * tscFrequency / windowTicks) : 0.0;
+		double waitUs = windowFrames ? (windowWaitTicks * 1.0E6 / tscFrequency / windowFrames) : 0.0;
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "Queue(2) %-3s FPS %-6.1f lat ms p50 %-6.2f p99 %-6.2f wait us %-6.0f",
+			szLimit, fps, ms[0], ms[2], waitUs);
+		windowTicks = 0;
+		windowWaitTicks = 0;
+		windowFrames = 0;
+	}
+	snprintf(row, size, "%-*s", size - 1, szResults);
+}
+// Limit 0 is driver default, throughput and latency compared with it.
+BOOL FramePacer::saveSweepReport(const char* fileName, const char* renderer, int swapInterval)
+{
+	if (sweepState != PACER_SWEEP_DONE) return FALSE;
+	const pacerResult& b = sweepResults[0];
+	report.clear();
+	report.add("Frames in flight sweep, %s, swap interval %d, %d measured frames per limit\r\n",
+		renderer ? renderer : "unknown renderer", swapInterval, APPCONST::PACER_MEASURE_FRAMES);
+	report.add("frames in flight,FPS,FPS %% of driver,latency p50 ms,latency p95 ms,latency p99 ms,p50 %% of driver,wait us/frame,samples\r\n");
+	for (int i = 0; i <= APPCONST::PACER_MAX_FRAMES; i++)
+	{
+		const pacerResult& r = sweepResults[i];
+		char szLimit[16];
+		snprintf(szLimit, sizeof(szLimit), r.limit ? "%d" : "driver", r.limit);
+		report.add("%s,%.1f,%.1f,%.3f,%.3f,%.3f,%.1f,%.1f,%d\r\n", szLimit, r.fps, (b.fps > 0.0) ? (r.fps * 100.0 / b.fps) : 0.0,
+			r.latencyMilliseconds[0], r.latencyMilliseconds[1], r.latencyMilliseconds[2],
+			(b.latencyMilliseconds[0] > 0.0) ? (r.latencyMilliseconds[0] * 100.0 / b.latencyMilliseconds[0]) : 0.0,
+			r.waitMicroseconds, r.samples);
+	}
+	return report.save(fileName);
+}
+// Oldest frame: timestamp result available after fence signaled. Frame dropped
+// from measure if wait timed out, slot released to avoid endless wait.
+BOOL FramePacer::collect(BOOL wait)
+{
+	pacerSlot& s = slots[slotOldest];
+	GLenum status = f->glClientWaitSync(s.fence, wait ? GL_SYNC_FLUSH_COMMANDS_BIT : 0, wait ? APPCONST::PACER_WAIT_TIMEOUT_NS : 0);
+	BOOL ready = ((status == GL_ALREADY_SIGNALED) || (status == GL_CONDITION_SATISFIED));
+	if ((!ready) && (!wait)) return FALSE;
+	if (ready)
+	{
+		DWORD64 gpuTime = 0;
+		f->glGetQueryObjectui64v(s.query, GL_QUERY_RESULT, &gpuTime);
+		double endTsc = calibrationTsc + (static_cast<double>(gpuTime) - calibrationGpu) * tscFrequency / 1.0E9;
+		double milliseconds = (endTsc - s.beginTsc) * 1000.0 / tscFrequency;
+		if (milliseconds > 0.0)
+		{
+			latencies[latencyNext] = milliseconds;
+			latencyNext = (latencyNext + 1) % APPCONST::PACER_MEASURE_FRAMES;
+			if (latenciesCount < APPCONST::PACER_MEASURE_FRAMES) latenciesCount++;
+		}
+	}
+	f->glDeleteSync(s.fence);
+	s.fence = nullptr;
+	slotOldest = (slotOldest + 1) % APPCONST::PACER_RING_SLOTS;
+	pendingCount--;
+	return TRUE;
+}
+// GPU timestamp now paired with TSC at middle of query, repeated for clocks drift.
+void FramePacer::calibrate()
+{
+	DWORD64 t1 = __rdtsc();
+	GLint64 gpuTime = 0;
+	f->glGetInteger64v(GL_TIMESTAMP, &gpuTime);
+	DWORD64 t2 = __rdtsc();
+	calibrationTsc = t1 + (t2 - t1) / 2;
+	calibrationGpu = gpuTime;
+	calibrationFrames = 0;
+}
+// Step is limit, user selected limit restored after maximum limit.
+void FramePacer::nextStep()
+{
+	if (limitNow > APPCONST::PACER_MAX_FRAMES)
+	{
+		sweepState = PACER_SWEEP_DONE;
+		limitNow = limitSelected;
+		return;
+	}
+	sweepFrame = 0;
+}
+// Nearest rank percentiles of latest frames latencies, returns samples count.
+int FramePacer::getPercentiles(double* milliseconds)
+{
+	if (!latenciesCount) return 0;
+	double sorted[APPCONST::PACER_MEASURE_FRAMES];
+	memcpy(sorted, latencies, latenciesCount * sizeof(double));
+	std::sort(sorted, sorted + latenciesCount);
+	milliseconds[0] = sorted[static_cast<int>(0.50 * (latenciesCount - 1) + 0.5)];
+	milliseconds[1] = sorted[static_cast<int>(0.95 * (latenciesCount - 1) + 0.5)];
+	milliseconds[2] = sorted[static_cast<int>(0.99 * (latenciesCount - 1) + 0.5)];
+	return latenciesCount;
+}
@@ -0,0 +1,92 @@
+/*
+OpenGL GPUstress.
+Frames in flight limiter class header.
+Fence and GPU timestamp issued after each frame swap, next frame starts
+after completion of older frames if queued frames count reaches limit.
+Frame latency is time from frame start at CPU to GPU timestamp of frame
+end, GPU time converted to TSC by periodic clocks calibration.
+*/
+
+#pragma once
+#ifndef FRAMEPACER_H
+#define FRAMEPACER_H
+
+#include <windows.h>
+#include <iostream>
+#include <intrin.h>
+#include <algorithm>
+#include "Global.h"
+#include "OpenGLImport.h"
+#include "Report.h"
+
+enum pacerSweepState
+{
+    PACER_SWEEP_OFF = 0,
+    PACER_SWEEP_RUNNING,
+    PACER_SWEEP_DONE
+};
+
+// Issued frame: fence and timestamp query after swap, TSC of frame start.
+struct pacerSlot
+{
+    GLsync fence;
+    GLuint query;
+    DWORD64 beginTsc;
+};
+
+// Sweep step result, latency percentiles are 50, 95 and 99.
+struct pacerResult
+{
+    int limit;
+    double fps;
+    double latencyMilliseconds[3];
+    double waitMicroseconds;
+    int samples;
+};
+
+class FramePacer
+{
+public:
+    FramePacer();
+    ~FramePacer();
+    int init(const oglFunctionsList* pFunctions, double tscHz);
+    void release();
+    void select(int limit);
+    int getLimit();
+    void throttle();
+    void endFrame(DWORD64 beginTsc);
+    void startSweep();
+    void stopSweep();
+    pacerSweepState getSweepState();
+    void writeRow(char* row, int size);
+    BOOL saveSweepReport(const char* fileName, const char* renderer, int swapInterval);
+private:
+    BOOL collect(BOOL wait);
+    void calibrate();
+    void nextStep();
+    int getPercentiles(double* milliseconds);
+    const oglFunctionsList* f;
+    pacerSlot slots[APPCONST::PACER_RING_SLOTS];
+    int slotNext;
+    int slotOldest;
+    int pendingCount;
+    int limitNow;               // 0 is driver default, frames queued up to fences ring size.
+    int limitSelected;
+    double tscFrequency;
+    DWORD64 calibrationTsc;
+    GLint64 calibrationGpu;
+    int calibrationFrames;
+    double latencies[APPCONST::PACER_MEASURE_FRAMES];
+    int latenciesCount;
+    int latencyNext;
+    DWORD64 lastThrottleTsc;
+    DWORD64 windowTicks;
+    DWORD64 windowWaitTicks;
+    DWORD64 windowFrames;
+    pacerSweepState sweepState;
+    int sweepFrame;
+    pacerResult sweepResults[APPCONST::PACER_MAX_FRAMES + 1];
+    Report report;
+};
+
+#endif // FRAMEPACER_H
@@ -25,7 +25,7 @@ namespace APPCONST
 	constexpr int Y_SIZE = 750;
 // Texture image sizes.
 	constexpr int TEXTURE_WIDTH  = 2952;   // Texture JPG file X, Y sizes,
-	constexpr int TEXTURE_HEIGHT = 1967;   // shaders update required if this changed
+	constexpr int TEXTURE_HEIGHT = 1967;   // shaders read sizes by textureSize()
 // Render window background R, G, B as float
 	constexpr float BACKGROUND_R = 0.95f;
 	constexpr float BACKGROUND_G = 0.95f;
@@ -35,10 +35,10 @@ namespace APPCONST
 	constexpr DWORD32 TEXT_FRONT_COLOR_2 = 0xFFE05757;
 	constexpr DWORD32 TEXT_BACK_COLOR    = 0xFFF2F2F2;
 // This constants is IMPORTANT for GPU load.
-// 128 x 5 = 640 chars positions matrix for text output:
-// 1 up string + 4 down strings.
+// 128 x 7 = 896 chars positions matrix for text output:
+// 3 up strings + 4 down strings.
 // 9 x 3 = 27 portraits.
-// Render objects count = 128 * 5 + 27 + duplications for GPU load.
+// Render objects count = 128 * 7 + 27 + duplications for GPU load.
 	constexpr int INSTANCING_COUNT_LOAD_0  = 1000;
 	constexpr int INSTANCING_COUNT_LOAD_1  = 30000;
 	constexpr int INSTANCING_COUNT_LOAD_2  = 100000;
@@ -54,8 +54,199 @@ namespace APPCONST
 	constexpr int MAXIMUM_INSTANCING_COUNT = MAXIMUM_GPU_LOAD;
 	// Text output parameters: sizes.
 	constexpr int MAX_TEXT_STRING = 160;
+	// Text output matrix: 128 chars x 7 strings, 4 down strings + 3 up strings,
+	// packed 4 chars per shader uniform integer.
+	constexpr int TEXT_CHARS  = 128 * 7;
+	constexpr int TEXT_DWORDS = TEXT_CHARS / 4;
+	// Text char is one quad, drawn by separate instanced draw after cubes.
+	constexpr int TEXT_QUAD_VERTICES = 6;
 	// Text buffer for shaders compiler error log.
 	constexpr int TEMP_BUFFER_SIZE = 4096;
+	// CPU cache line size, used for separate data written by different threads.
+	constexpr int CACHE_LINE_SIZE = 64;
+	// Saved instanced mode results, for compare with other benchmark modes.
+	constexpr int REFERENCE_SLOTS = 16;
+	// Text reports buffer size, bytes.
+	constexpr int REPORT_BUFFER_SIZE = 65536;
+// Cube model: vertices count, vertex stride and texture coordinates offset, bytes.
+	constexpr int CUBE_VERTICES = 6 * 6;
+	constexpr int CUBE_STRIDE = 5 * 4;
+	constexpr int CUBE_TEXTURE_OFFSET = 3 * 4;
+	constexpr double TWO_PI = 6.283185307179586;
+// State change cost benchmark parameters.
+	constexpr int STATE_DRAWS_PER_FRAME = 4096;
+	constexpr int STATE_FREQUENCIES_COUNT = 4;
+	constexpr int STATE_FREQUENCIES[STATE_FREQUENCIES_COUNT] = { 1, 4, 16, 64 };   // Switch state once per N draws.
+	const char* const STATE_REPORT_NAME = "GPUstress_state.csv";
+// Instance attribute formats: saved results of formats and fetch paths.
+	constexpr int INSTANCE_RESULT_SLOTS = 64;
+	const char* const INSTANCE_REPORT_NAME = "GPUstress_instances.csv";
+// Load calibration: instances count search for target FPS, times in seconds.
+	constexpr double CALIBRATION_TARGET_FPS      = 60.0;
+	constexpr double CALIBRATION_SETTLE_SECONDS  = 1.0;      // Skipped after load change.
+	constexpr double CALIBRATION_MEASURE_SECONDS = 2.0;
+	constexpr int CALIBRATION_MIN_FRAMES         = 30;
+	constexpr int CALIBRATION_MAX_EXTENSIONS     = 3;        // Measure repeats if target inside noise band.
+	constexpr int CALIBRATION_MAX_STEPS          = 32;
+	constexpr double CALIBRATION_PRECISION       = 0.005;    // Search stops at relative pass-fail interval.
+	constexpr int CALIBRATION_MIN_INSTANCES      = 1024;     // Must be above TEXT_CHARS.
+	constexpr int CALIBRATION_MAX_INSTANCES      = 32 * 1024 * 1024;
+	const char* const CALIBRATION_REPORT_NAME = "GPUstress_calibration.csv";
+// Statistical benchmark harness: scenarios repeated, steady state detected by frame time windows.
+	constexpr int HARNESS_REPETITIONS           = 5;        // Default, command line option -repeat.
+	constexpr int HARNESS_MAX_REPETITIONS       = 16;
+	constexpr int HARNESS_WINDOW_FRAMES         = 30;       // Frames per warmup window.
+	constexpr int HARNESS_STEADY_WINDOWS        = 4;        // Consecutive windows compared for steady state.
+	constexpr double HARNESS_STEADY_TOLERANCE   = 0.02;     // Relative spread of windows means.
+	constexpr double HARNESS_WARMUP_MIN_SECONDS = 1.0;
+	constexpr double HARNESS_WARMUP_MAX_SECONDS = 15.0;     // Measure starts without steady state after it.
+	constexpr double HARNESS_MEASURE_SECONDS    = 3.0;
+	constexpr double HARNESS_OUTLIER_SCORE      = 3.5;      // Modified z-score limit, median and MAD based.
+	constexpr double HARNESS_MIN_CHANGE         = 0.01;     // Relative change below it is not regression.
+	constexpr int HARNESS_EXIT_REGRESSION       = 8;        // Process exit codes.
+	constexpr int HARNESS_EXIT_BASELINE         = 9;        // Baseline file not loaded.
+	constexpr int HARNESS_EXIT_INCOMPLETE       = 10;       // Run stopped by user.
+	const char* const HARNESS_REPORT_NAME = "GPUstress_harness.csv";
+// Record and replay: log write buffer, paced replay timestep, GPU frame timestamps
+// read with frames latency, per-frame report line size, exit code, file names.
+	constexpr int REPLAY_BUFFER_RECORDS  = 1024;
+	constexpr DWORD32 REPLAY_MAX_FRAMES  = 16 * 1024 * 1024;
+	constexpr double REPLAY_TIMESTEP     = 1.0 / 60.0;      // Seconds per frame, command line option -paced.
+	constexpr int FRAME_QUERY_FRAMES     = 4;
+	constexpr int REPLAY_TEXT_RECORD     = 256;
+	constexpr DWORD32 REPLAY_SIGNATURE   = 0x4C525047;      // "GPRL" signature for replay log.
+	constexpr int REPLAY_EXIT_LOG        = 11;              // Replay log not loaded.
+	const char* const REPLAY_LOG_NAME    = "GPUstress_replay.bin";
+	const char* const REPLAY_REPORT_NAME = "GPUstress_replay.csv";
+// Baked texture atlas: blob file at executable directory, format version, mip levels limit,
+// levels alignment in uncompressed blob, LZ4 match finder hash bits, startup times report.
+	const char* const ATLAS_BLOB_NAME    = "GPUstress_atlas.bin";
+	constexpr DWORD32 ATLAS_SIGNATURE    = 0x54415047;      // "GPAT" signature for atlas blob.
+	constexpr DWORD32 ATLAS_VERSION      = 1;
+	constexpr int ATLAS_MAX_LEVELS       = 16;
+	constexpr DWORD64 ATLAS_ALIGNMENT    = 4096;
+	constexpr int ATLAS_HASH_BITS        = 16;
+	constexpr int ATLAS_EXIT_BAKE        = 12;              // Atlas blob not baked.
+	const char* const STARTUP_REPORT_NAME = "GPUstress_startup.csv";
+// Vulkan backend: frames in flight, frames per measured load, fence wait limit, offscreen target size.
+	constexpr int VULKAN_FRAMES_IN_FLIGHT = 3;
+	constexpr int VULKAN_WARMUP_FRAMES = 60;
+	constexpr int VULKAN_MEASURE_FRAMES = 300;
+	constexpr int VULKAN_TOTAL_FRAMES = VULKAN_WARMUP_FRAMES + VULKAN_MEASURE_FRAMES;
+	constexpr DWORD64 VULKAN_FENCE_TIMEOUT_NS = 5000000000ULL;
+	constexpr int VULKAN_TARGET_WIDTH = 1280;       // Offscreen render target, headless run without window.
+	constexpr int VULKAN_TARGET_HEIGHT = 720;
+	const char* const VULKAN_LIBRARY_NAME = "vulkan-1.dll";
+	const char* const VULKAN_REPORT_NAME = "GPUstress_vulkan.csv";
+// Software rasterizer: frame buffer and tile sizes, pixels, instances per setup batch.
+	constexpr int SOFT_WIDTH = 960;                 // Must be multiple of SOFT_TILE_SIZE.
+	constexpr int SOFT_HEIGHT = 720;
+	constexpr int SOFT_TILE_SIZE = 64;              // Must be multiple of 8, AVX2 raster step.
+	constexpr int SOFT_BATCH_INSTANCES = 8192;
+	constexpr int SOFT_FRAMES = 4;                  // Frames per threads count.
+	constexpr int SOFT_MAX_THREADS = 64;
+	const char* const SOFT_REPORT_NAME = "GPUstress_software.csv";
+	const char* const SOFT_IMAGE_NAME = "GPUstress_reference.bmp";
+// Depth ordering: sort threads, one thread below parallel threshold, samples passed
+// queries read with frames latency, results slots and report.
+	constexpr int DEPTH_SORT_MAX_THREADS = 8;
+	constexpr size_t DEPTH_SORT_PARALLEL_MIN = 65536;
+	constexpr int DEPTH_QUERY_FRAMES = 4;
+	constexpr int DEPTH_RESULT_SLOTS = 64;
+	const char* const DEPTH_REPORT_NAME = "GPUstress_depth.csv";
+// Render targets: queries read with frames latency, format sweep warmup
+// and measured frames per format, report.
+	constexpr int TARGET_QUERY_FRAMES = 4;
+	constexpr int TARGET_WARMUP_FRAMES = 20;
+	constexpr int TARGET_MEASURE_FRAMES = 60;
+	const char* const TARGET_REPORT_NAME = "GPUstress_targets.csv";
+// Texture sampling stress: full screen layers per frame, samples per fragment, texels step
+// of strided pattern, anisotropic footprint ratio, queries read with frames latency, report.
+	constexpr int SAMPLING_LAYERS = 4;
+	constexpr int SAMPLING_TAPS = 8;
+	constexpr int SAMPLING_STRIDE = 33;
+	constexpr float SAMPLING_FOOTPRINT = 16.0f;
+	constexpr int SAMPLING_QUERY_FRAMES = 4;
+	const char* const SAMPLING_REPORT_NAME = "GPUstress_sampling.csv";
+// Texture working sets: base level megabytes of generated RGBA8 texture arrays, 0 is main
+// texture atlas, maximum layer size, working sets sweep warmup and measured frames, report.
+	constexpr int SAMPLING_SETS_COUNT = 7;
+	constexpr int SAMPLING_SET_MEGABYTES[SAMPLING_SETS_COUNT] = { 0, 4, 16, 64, 256, 1024, 4096 };
+	constexpr int SAMPLING_LAYER_SIZE = 2048;
+	constexpr int SAMPLING_WARMUP_FRAMES = 10;
+	constexpr int SAMPLING_MEASURE_FRAMES = 60;
+	const char* const SAMPLING_SWEEP_REPORT_NAME = "GPUstress_workingset.csv";
+// Frame capture: readback buffers ring, captured frames buffered for encoder threads
+// (bounds memory), encoder threads limit, frames intervals selected by user, Y4M frame rate.
+	constexpr int CAPTURE_PBO_COUNT = 3;
+	constexpr int CAPTURE_SLOTS = 8;
+	constexpr int CAPTURE_MAX_THREADS = 4;
+	constexpr int CAPTURE_INTERVALS_COUNT = 4;
+	constexpr int CAPTURE_INTERVALS[CAPTURE_INTERVALS_COUNT] = { 1, 10, 60, 600 };
+	constexpr int CAPTURE_Y4M_FPS = 60;
+	constexpr DWORD64 CAPTURE_FLUSH_TIMEOUT_NS = 1000000000ULL;
+	const char* const CAPTURE_PNG_NAME = "GPUstress_capture_%06u.png";
+	const char* const CAPTURE_Y4M_NAME = "GPUstress_capture.y4m";
+// CPU burners: threads limit, FMA kernel iterations and memory kernel block bytes per pass
+// (pass bounds stop latency), sweep steps limit, warmup and measured frames per step, report.
+	constexpr int BURN_MAX_THREADS = 64;
+	constexpr int BURN_FMA_ITERATIONS = 65536;
+	constexpr size_t BURN_MEMORY_BYTES = 32 * 1024 * 1024;
+	constexpr int BURN_SWEEP_STEPS = 10;
+	constexpr int BURN_WARMUP_FRAMES = 30;
+	constexpr int BURN_MEASURE_FRAMES = 240;
+	const char* const BURN_REPORT_NAME = "GPUstress_interference.csv";
+// Sensor sampler: sysfs root (Linux root is drive Z: under Wine), sample period default and limits,
+// channels and cpufreq nodes limits, node name and trace line sizes, trace.
+	const char* const SENSOR_SYSFS_ROOT = "Z:\\sys";
+	constexpr DWORD SENSOR_DEFAULT_PERIOD_MS = 100;
+	constexpr DWORD SENSOR_MIN_PERIOD_MS = 10;
+	constexpr DWORD SENSOR_MAX_PERIOD_MS = 10000;
+	constexpr int SENSOR_MAX_CHANNELS = 64;
+	constexpr int SENSOR_MAX_CPUS = 256;
+	constexpr int SENSOR_NAME_SIZE = 64;
+	constexpr int SENSOR_TEXT_RECORD = 4096;
+	const char* const SENSOR_TRACE_NAME = "GPUstress_sensors.csv";
+// Frames in flight: fences ring (bounds frames queued if limit is driver default), maximum
+// selected limit, fence wait timeout, GPU clock calibration period, sweep warmup and
+// measured frames per limit, report.
+	constexpr int PACER_RING_SLOTS = 16;
+	constexpr int PACER_MAX_FRAMES = 6;
+	constexpr DWORD64 PACER_WAIT_TIMEOUT_NS = 1000000000ULL;
+	constexpr int PACER_CALIBRATE_FRAMES = 60;
+	constexpr int PACER_WARMUP_FRAMES = 30;
+	constexpr int PACER_MEASURE_FRAMES = 240;
+	const char* const PACER_REPORT_NAME = "GPUstress_latency.csv";
+// Staging arena results slots and report.
+	constexpr int ARENA_RESULT_SLOTS = 32;
+	const char* const ARENA_REPORT_NAME = "GPUstress_arena.csv";
+// CPU memory bandwidth: block sizes range (L1 cache to DRAM), bytes moved per measurement,
+// best of repetitions, all cores row threads limit, report.
+	constexpr size_t BANDWIDTH_MIN_BYTES = 16 * 1024;
+	constexpr size_t BANDWIDTH_MAX_BYTES = 256 * 1024 * 1024;
+	constexpr size_t BANDWIDTH_TRAFFIC_BYTES = 256 * 1024 * 1024;
+	constexpr int BANDWIDTH_REPEATS = 3;
+	constexpr int BANDWIDTH_MAX_THREADS = 64;
+	const char* const BANDWIDTH_REPORT_NAME = "GPUstress_bandwidth.csv";
+// Instance data fetch paths: uniform range limit, bytes, and binding points.
+	constexpr int FETCH_UNIFORM_MAX_BYTES = 65536;
+	constexpr int FETCH_UNIFORM_BINDING = 1;        // Binding 0 used by state change benchmark.
+	constexpr int FETCH_STORAGE_BINDING = 0;        // Must match layout binding of shader storage block.
+// Shader program binary cache and shader build time benchmark parameters.
+	constexpr int SHADER_VARIANTS_MAX = 32;                 // Registered variants for benchmark.
+	constexpr int SHADER_BINARY_MAX = 4 * 1024 * 1024;      // Maximum program binary size, bytes.
+	constexpr int SHADER_BENCH_REPEATS = 8;
+	constexpr DWORD32 SHADER_CACHE_SIGNATURE = 0x43505547;  // "GUPC" signature for cache files.
+	const char* const SHADER_CACHE_DIR = "GPUstress_cache";
+	const char* const SHADER_REPORT_NAME = "GPUstress_shaders.csv";
+// Per-frame telemetry trace parameters.
+	constexpr int TELEMETRY_RING_RECORDS = 65536;           // Must be power of 2.
+	constexpr int TELEMETRY_WRITE_BUFFER = 1024 * 1024;     // Writer thread file buffer, bytes.
+	constexpr int TELEMETRY_TEXT_RECORD  = 512;             // Maximum one CSV line size, bytes.
+	constexpr DWORD TELEMETRY_POLL_MS    = 20;              // Writer thread ring poll period.
+	constexpr DWORD32 TRACE_SIGNATURE    = 0x54555047;      // "GPUT" signature for binary trace.
+	const char* const TRACE_CSV_NAME     = "GPUstress_trace.csv";
+	const char* const TRACE_BINARY_NAME  = "GPUstress_trace.bin";
 }
 
 #endif // GLOBAL_H
@@ -0,0 +1,351 @@
+/*
+OpenGL GPUstress.
+Statistical benchmark harness class.
+Each repetition of scenario starts with warmup: frame times averaged by windows,
+steady state when spread of last windows means is in tolerance (clocks boost
+and driver buffers reallocation finished). Then FPS measured for fixed time.
+Repetitions outliers rejected by modified z-score of median and MAD,
+confidence interval of mean by Student t. Regression if Welch t-test shows
+significant FPS decrease versus baseline and decrease is above minimal change.
+*/
+
+#include "Harness.h"
+
+Harness::Harness() : state(HARNESS_OFF), tscPeriod(0.0), repetitions(APPCONST::HARNESS_REPETITIONS), scenarioIndex(0),
+	                     repetitionIndex(0), lastTsc(0), phaseFrames(0), phaseSeconds(0.0), windowSeconds(0.0), windowFrames(0),
+	                     windowMeans{ 0 }, windowsCount(0), baselineRequired(FALSE), baselineLoaded(FALSE), statusChanged(FALSE),
+	                     swapInterval(-1), baselineSwapInterval(-1), saveFileName{ 0 }
+{
+	results = new harnessResult[scenariosCount];
+	memset(results, 0, scenariosCount * sizeof(harnessResult));
+}
+Harness::~Harness()
+{
+	if (results) delete[] results;
+}
+// Baseline and save file names are optional, nullptr if not used.
+BOOL Harness::start(int repeats, const char* baselineName, const char* saveName, double period)
+{
+	if (!results) return FALSE;
+	memset(results, 0, scenariosCount * sizeof(harnessResult));
+	tscPeriod = period;
+	repetitions = repeats;
+	if (repetitions < 3) repetitions = 3;
+	if (repetitions > APPCONST::HARNESS_MAX_REPETITIONS) repetitions = APPCONST::HARNESS_MAX_REPETITIONS;
+	saveFileName[0] = 0;
+	if (saveName) snprintf(saveFileName, MAX_PATH, "%s", saveName);
+	baselineRequired = (baselineName != nullptr);
+	baselineLoaded = FALSE;
+	baselineSwapInterval = -1;
+	if (baselineRequired)
+	{
+		baselineLoaded = loadBaseline(baselineName);
+		if (!baselineLoaded) return FALSE;
+	}
+	scenarioIndex = 0;
+	repetitionIndex = 0;
+	lastTsc = 0;
+	phaseFrames = 0;
+	phaseSeconds = 0.0;
+	windowSeconds = 0.0;
+	windowFrames = 0;
+	windowsCount = 0;
+	state = HARNESS_WARMUP;
+	statusChanged = TRUE;
+	return TRUE;
+}
+// Swap interval set by caller before first frame, vertical sync caps FPS by display refresh.
+void Harness::setSwapInterval(int interval)
+{
+	swapInterval = interval;
+}
+// Called before each frame draw, sets options of current scenario.
+// Returns FALSE when all scenarios done.
+BOOL Harness::frame(drawOptions& options)
+{
+	if ((state == HARNESS_OFF) || (state == HARNESS_DONE)) return FALSE;
+	DWORD64 tsc = __rdtsc();
+	double dt = lastTsc ? ((tsc - lastTsc) * tscPeriod) : 0.0;
+	lastTsc = tsc;
+	if (dt > 0.0)
+	{
+		phaseSeconds += dt;
+		if (state == HARNESS_WARMUP)
+		{
+			windowSeconds += dt;
+			windowFrames++;
+			if (windowFrames >= APPCONST::HARNESS_WINDOW_FRAMES)
+			{
+				windowMeans[windowsCount % APPCONST::HARNESS_STEADY_WINDOWS] = windowSeconds / windowFrames;
+				windowsCount++;
+				windowSeconds = 0.0;
+				windowFrames = 0;
+			}
+			BOOL steady = FALSE;
+			if ((phaseSeconds >= APPCONST::HARNESS_WARMUP_MIN_SECONDS) && (windowsCount >= APPCONST::HARNESS_STEADY_WINDOWS))
+			{
+				double minimum = windowMeans[0];
+				double maximum = windowMeans[0];
+				double sum = 0.0;
+				for (int i = 0; i < APPCONST::HARNESS_STEADY_WINDOWS; i++)
+				{
+					if (windowMeans[i] < minimum) minimum = windowMeans[i];
+					if (windowMeans[i] > maximum) maximum = windowMeans[i];
+					sum += windowMeans[i];
+				}
+				steady = ((maximum - minimum) <= (sum / APPCONST::HARNESS_STEADY_WINDOWS * APPCONST::HARNESS_STEADY_TOLERANCE));
+			}
+			if (steady || (phaseSeconds >= APPCONST::HARNESS_WARMUP_MAX_SECONDS))
+			{
+				if (!steady) results[scenarioIndex].unsteadyCount++;
+				state = HARNESS_MEASURE;
+				phaseSeconds = 0.0;
+				phaseFrames = 0;
+				statusChanged = TRUE;
+			}
+		}
+		else
+		{
+			phaseFrames++;
+			if (phaseSeconds >= APPCONST::HARNESS_MEASURE_SECONDS)
+			{
+				harnessResult& r = results[scenarioIndex];
+				r.fps[repetitionIndex] = phaseFrames / phaseSeconds;
+				repetitionIndex++;
+				if (repetitionIndex >= repetitions)
+				{
+					computeStatistics(r);
+					compare(r);
+					repetitionIndex = 0;
+					scenarioIndex++;
+					if (scenarioIndex >= scenariosCount)
+					{
+						state = HARNESS_DONE;
+						statusChanged = TRUE;
+						return FALSE;
+					}
+				}
+				state = HARNESS_WARMUP;
+				lastTsc = 0;
+				phaseSeconds = 0.0;
+				windowSeconds = 0.0;
+				windowFrames = 0;
+				windowsCount = 0;
+				statusChanged = TRUE;
+			}
+		}
+	}
+	const harnessScenario& s = scenarios[scenarioIndex];
+	options.load = s.load;
+	options.depthTest = s.depthTest;
+	options.mode = s.mode;
+	options.perDrawUniform = FALSE;
+	options.format = FORMAT_FLOAT32;
+	options.fetch = FETCH_ATTRIBUTE;
+	options.arena = ARENA_PAGES;
+	options.depthOrdering = DEPTH_ORDER_OFF;
+	options.color = TARGET_COLOR_DEFAULT;
+	options.depth = TARGET_D24S8;
+	options.samplesIndex = 0;
+	options.filter = SAMPLING_OFF;
+	options.pattern = PATTERN_COHERENT;
+	options.workingSet = 0;
+	options.streamingStores = FALSE;
+	options.burn = BURN_OFF;
+	options.burnThreads = 1;
+	options.framesInFlight = 0;
+	return TRUE;
+}
+harnessState Harness::getState()
+{
+	return state;
+}
+// Writes report and optional baseline file, returns process exit code.
+int Harness::finish()
+{
+	if (state == HARNESS_OFF) return 0;
+	writeReport();
+	report.save(APPCONST::HARNESS_REPORT_NAME);
+	if (state != HARNESS_DONE) return APPCONST::HARNESS_EXIT_INCOMPLETE;
+	if (saveFileName[0] && (!report.save(saveFileName))) return APPCONST::HARNESS_EXIT_BASELINE;
+	for (int i = 0; i < scenariosCount; i++)
+	{
+		if (results[i].verdict < 0) return APPCONST::HARNESS_EXIT_REGRESSION;
+	}
+	return 0;
+}
+// Progress text for window title, returns TRUE if text changed since previous call.
+BOOL Harness::getStatusText(char* text, int size)
+{
+	if (!statusChanged) return FALSE;
+	statusChanged = FALSE;
+	if (state == HARNESS_DONE)
+	{
+		snprintf(text, size, "Harness done");
+	}
+	else
+	{
+		snprintf(text, size, "Harness scenario %d/%d %s, repetition %d/%d, %s", scenarioIndex + 1, scenariosCount,
+			scenarios[scenarioIndex].name, repetitionIndex + 1, repetitions, (state == HARNESS_WARMUP) ? "warmup" : "measure");
+	}
+	return TRUE;
+}
+void Harness::computeStatistics(harnessResult& r)
+{
+	double sorted[APPCONST::HARNESS_MAX_REPETITIONS];
+	double deviations[APPCONST::HARNESS_MAX_REPETITIONS];
+	int n = repetitions;
+	memcpy(sorted, r.fps, n * sizeof(double));
+	std::sort(sorted, sorted + n);
+	double median = (n & 1) ? sorted[n / 2] : (sorted[n / 2 - 1] + sorted[n / 2]) / 2.0;
+	for (int i = 0; i < n; i++)
+	{
+		deviations[i] = fabs(r.fps[i] - median);
+	}
+	std::sort(deviations, deviations + n);
+	double mad = (n & 1) ? deviations[n / 2] : (deviations[n / 2 - 1] + deviations[n / 2]) / 2.0;
+	double sum = 0.0;
+	r.count = 0;
+	for (int i = 0; i < n; i++)
+	{
+		// 0.6745 scales MAD to standard deviation units for normal distribution.
+		r.outlier[i] = (mad > 0.0) && ((0.6745 * fabs(r.fps[i] - median) / mad) > APPCONST::HARNESS_OUTLIER_SCORE);
+		if (!r.outlier[i])
+		{
+			sum += r.fps[i];
+			r.count++;
+		}
+	}
+	r.mean = sum / r.count;
+	double squares = 0.0;
+	for (int i = 0; i < n; i++)
+	{
+		if (!r.outlier[i]) squares += (r.fps[i] - r.mean) * (r.fps[i] - r.mean);
+	}
+	r.deviation = (r.count > 1) ? sqrt(squares / (r.count - 1)) : 0.0;
+	r.ciHalf = (r.count > 1) ? (studentT(r.count - 1) * r.deviation / sqrt(static_cast<double>(r.count))) : 0.0;
+}
+// Welch t-test, variances of current and baseline runs not assumed equal.
+void Harness::compare(harnessResult& r)
+{
+	r.verdict = 0;
+	if ((!r.baselineFound) || (r.baselineMean <= 0.0)) return;
+	double change = (r.mean - r.baselineMean) / r.baselineMean;
+	if (fabs(change) < APPCONST::HARNESS_MIN_CHANGE) return;
+	double v1 = r.deviation * r.deviation / r.count;
+	double v0 = r.baselineDeviation * r.baselineDeviation / r.baselineCount;
+	double se2 = v1 + v0;
+	BOOL significant = TRUE;
+	if (se2 > 0.0)
+	{
+		double t = (r.mean - r.baselineMean) / sqrt(se2);
+		double d = 0.0;
+		if (r.count > 1) d += v1 * v1 / (r.count - 1);
+		if (r.baselineCount > 1) d += v0 * v0 / (r.baselineCount - 1);
+		double df = (d > 0.0) ? (se2 * se2 / d) : 1.0;
+		significant = (fabs(t) > studentT(df));
+	}
+	if (significant) r.verdict = (change < 0.0) ? -1 : 1;
+}
+// Baseline is report of previous run, lines matched by scenario name.
+BOOL Harness::loadBaseline(const char* fileName)
+{
+	HANDLE hFile = CreateFile(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) return FALSE;
+	char* text = new char[APPCONST::REPORT_BUFFER_SIZE];
+	DWORD read = 0;
+	BOOL status = ReadFile(hFile, text, APPCONST::REPORT_BUFFER_SIZE - 1, &read, nullptr);
+	CloseHandle(hFile);
+	int found = 0;
+	if (status)
+	{
+		text[read] = 0;
+		char* line = text;
+		while (line && *line)
+		{
+			char name[APPCONST::MAX_TEXT_STRING];
+			int count = 0;
+			double mean = 0.0;
+			double deviation = 0.0;
+			int interval = 0;
+			if (sscanf(line, "swap interval,%d", &interval) == 1)
+			{
+				baselineSwapInterval = interval;
+			}
+			else if (sscanf(line, "%159[^,],%d,%lf,%lf", name, &count, &mean, &deviation) == 4)
+			{
+				for (int i = 0; i < scenariosCount; i++)
+				{
+					if ((!strcmp(name, scenarios[i].name)) && (count > 0))
+					{
+						results[i].baselineFound = TRUE;
+						results[i].baselineCount = count;
+						results[i].baselineMean = mean;
+						results[i].baselineDeviation = deviation;
+						found++;
+					}
+				}
+			}
+			line = strchr(line, '\n');
+			if (line) line++;
+		}
+	}
+	delete[] text;
+	return found > 0;
+}
+void Harness::writeReport()
+{
+	static const char* szVerdicts[] { "REGRESSION", "same", "improvement" };
+	report.clear();
+	report.add("swap interval,%d,baseline swap interval,%d\r\n", swapInterval, baselineSwapInterval);
+	report.add("scenario,repetitions,FPS mean,FPS deviation,CI95 low,CI95 high,outliers,unsteady,"
+		"baseline FPS,baseline deviation,baseline repetitions,change %,verdict\r\n");
+	for (int i = 0; i < scenariosCount; i++)
+	{
+		const harnessResult& r = results[i];
+		if (!r.count) continue;
+		int outliers = 0;
+		for (int j = 0; j < repetitions; j++)
+		{
+			if (r.outlier[j]) outliers++;
+		}
+		report.add("%s,%d,%.3f,%.3f,%.3f,%.3f,%d,%d,", scenarios[i].name, r.count, r.mean, r.deviation,
+			r.mean - r.ciHalf, r.mean + r.ciHalf, outliers, r.unsteadyCount);
+		if (r.baselineFound)
+		{
+			report.add("%.3f,%.3f,%d,%.2f,%s\r\n", r.baselineMean, r.baselineDeviation, r.baselineCount,
+				(r.mean - r.baselineMean) / r.baselineMean * 100.0, szVerdicts[r.verdict + 1]);
+		}
+		else
+		{
+			report.add(",,,,no baseline\r\n");
+		}
+	}
+}
+// Two-sided 95% critical values of Student t, degrees of freedom 1...30, normal above.
+double Harness::studentT(double df)
+{
+	int k = static_cast<int>(df);
+	if (k < 1) k = 1;
+	return (k <= 30) ? tTable[k - 1] : 1.96;
+}
+
+const harnessScenario Harness::scenarios[]
+{
+	{ "instanced_1000_depth",     MODE_INSTANCED,     APPCONST::INSTANCING_COUNT_LOAD_0, TRUE  },
+	{ "instanced_100000_depth",   MODE_INSTANCED,     APPCONST::INSTANCING_COUNT_LOAD_2, TRUE  },
+	{ "instanced_500000_depth",   MODE_INSTANCED,     APPCONST::INSTANCING_COUNT_LOAD_4, TRUE  },
+	{ "instanced_1500000_depth",  MODE_INSTANCED,     APPCONST::INSTANCING_COUNT_LOAD_7, TRUE  },
+	{ "instanced_500000_nodepth", MODE_INSTANCED,     APPCONST::INSTANCING_COUNT_LOAD_4, FALSE },
+	{ "animated_500000_depth",    MODE_GPU_ANIMATION, APPCONST::INSTANCING_COUNT_LOAD_4, TRUE  },
+	{ "animated_1500000_depth",   MODE_GPU_ANIMATION, APPCONST::INSTANCING_COUNT_LOAD_7, TRUE  },
+	{ "drawcalls_1000_depth",     MODE_DRAW_CALLS,    APPCONST::INSTANCING_COUNT_LOAD_0, TRUE  },
+	{ "drawcalls_30000_depth",    MODE_DRAW_CALLS,    APPCONST::INSTANCING_COUNT_LOAD_1, TRUE  }
+};
+const int Harness::scenariosCount = sizeof(scenarios) / sizeof(harnessScenario);
+const double Harness::tTable[]
+{
+	12.706, 4.303, 3.182, 2.776, 2.571, 2.447, 2.365, 2.306, 2.262, 2.228,
+	2.201,  2.179, 2.160, 2.145, 2.131, 2.120, 2.110, 2.101, 2.093, 2.086,
+	2.080,  2.074, 2.069, 2.064, 2.060, 2.056, 2.052, 2.048, 2.045, 2.042
+};
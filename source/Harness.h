@@ -0,0 +1,96 @@
+/*
+OpenGL GPUstress.
+Statistical benchmark harness class header.
+Unattended run of scenarios list with repetitions, results compared with
+baseline file saved by previous run, for regression checks of driver updates.
+*/
+
+#pragma once
+#ifndef HARNESS_H
+#define HARNESS_H
+
+#include <windows.h>
+#include <iostream>
+#include <math.h>
+#include <algorithm>
+#include "Global.h"
+#include "Report.h"
+#include "OpenGL.h"
+
+enum harnessState
+{
+    HARNESS_OFF = 0,
+    HARNESS_WARMUP,
+    HARNESS_MEASURE,
+    HARNESS_DONE
+};
+
+// Benchmark scenario: options of one measured configuration.
+struct harnessScenario
+{
+    const char* name;
+    benchmarkMode mode;
+    unsigned int load;
+    BOOL depthTest;
+};
+
+// Scenario results, FPS per repetition and statistics after outliers rejection.
+struct harnessResult
+{
+    double fps[APPCONST::HARNESS_MAX_REPETITIONS];
+    BOOL outlier[APPCONST::HARNESS_MAX_REPETITIONS];
+    int unsteadyCount;
+    int count;
+    double mean;
+    double deviation;
+    double ciHalf;
+    BOOL baselineFound;
+    double baselineMean;
+    double baselineDeviation;
+    int baselineCount;
+    int verdict;            // -1 regression, 0 no significant change, 1 improvement.
+};
+
+class Harness
+{
+public:
+    Harness();
+    ~Harness();
+    BOOL start(int repeats, const char* baselineName, const char* saveName, double period);
+    void setSwapInterval(int interval);
+    BOOL frame(drawOptions& options);
+    harnessState getState();
+    int finish();
+    BOOL getStatusText(char* text, int size);
+private:
+    void computeStatistics(harnessResult& r);
+    void compare(harnessResult& r);
+    BOOL loadBaseline(const char* fileName);
+    void writeReport();
+    static double studentT(double df);
+    harnessState state;
+    double tscPeriod;
+    int repetitions;
+    int scenarioIndex;
+    int repetitionIndex;
+    DWORD64 lastTsc;
+    DWORD64 phaseFrames;
+    double phaseSeconds;
+    double windowSeconds;
+    int windowFrames;
+    double windowMeans[APPCONST::HARNESS_STEADY_WINDOWS];
+    int windowsCount;
+    BOOL baselineRequired;
+    BOOL baselineLoaded;
+    BOOL statusChanged;
+    int swapInterval;           // Swap interval of run and of baseline run, -1 if unknown.
+    int baselineSwapInterval;
+    char saveFileName[MAX_PATH];
+    harnessResult* results;
+    Report report;
+    static const harnessScenario scenarios[];
+    static const int scenariosCount;
+    static const double tTable[];
+};
+
+#endif // HARNESS_H
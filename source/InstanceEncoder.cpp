@@ -0,0 +1,208 @@
+/*
+OpenGL GPUstress.
+Per-instance attributes encoder class.
+Kernels process full SSE blocks, tail copied to zero padded block,
+only used part of encoded block stored to output.
+Streaming variant stores full blocks by non-temporal stores, output buffer
+is cache line aligned, encoded data bypasses cache before driver copy.
+*/
+
+#include "InstanceEncoder.h"
+
+InstanceEncoder::InstanceEncoder() : buffer(nullptr), bufferBytes(0)
+{
+
+}
+InstanceEncoder::~InstanceEncoder()
+{
+
+}
+void InstanceEncoder::setBuffer(BYTE* pBuffer, size_t bytes)
+{
+	buffer = pBuffer;
+	bufferBytes = pBuffer ? bytes : 0;
+}
+// Returns pointer to upload data and data size, float format uploaded from source without copy.
+const void* InstanceEncoder::encode(instanceFormat format, const GLfloat* src, size_t count, GLsizeiptr& bytes, BOOL streaming)
+{
+	const instanceLayout& layout = layouts[format];
+	size_t elements = (count + layout.divisor - 1) / layout.divisor;
+	bytes = static_cast<GLsizeiptr>(elements * layout.bytesPerElement);
+	if ((format == FORMAT_FLOAT32) || (!buffer) || (static_cast<size_t>(bytes) > bufferBytes))
+	{
+		bytes = static_cast<GLsizeiptr>(count * sizeof(GLfloat));
+		return src;
+	}
+	switch (format)
+	{
+	case FORMAT_HALF16:
+		encodeHalf(src, buffer, count, streaming);
+		break;
+	case FORMAT_SNORM16:
+		encodeSnorm16(src, buffer, count, streaming);
+		break;
+	default:
+		encodeSnorm10Packed(src, buffer, count, streaming);
+		break;
+	}
+	if (streaming)
+	{
+		_mm_sfence();       // Non-temporal stores visible before upload reads buffer.
+	}
+	return buffer;
+}
+// Float to half conversion for 4 values, round to nearest even,
+// subnormals, overflow to infinity and NaN supported. SSE2 only, no F16C required.
+// Result is half at low 16 bits of each 32-bit lane, sign extended.
+__m128i InstanceEncoder::halfVector(__m128 f)
+{
+	const __m128i maxNormal = _mm_set1_epi32((127 + 16) << 23);             // Values above rounds to infinity.
+	const __m128i minNormal = _mm_set1_epi32((127 - 14) << 23);             // Values below gives half subnormal.
+	const __m128i subnormalMagic = _mm_set1_epi32(((127 - 15) + (23 - 10) + 1) << 23);
+	const __m128i normalBias = _mm_set1_epi32(0xFFF - ((127 - 15) << 23));  // Exponent rebias and rounding.
+	const __m128i infinity = _mm_set1_epi32(0x7C00);
+	const __m128i nanBit = _mm_set1_epi32(0x200);
+
+	__m128 sign = _mm_and_ps(f, _mm_castsi128_ps(_mm_set1_epi32(0x80000000)));
+	__m128 absf = _mm_xor_ps(f, sign);
+	__m128i absi = _mm_castps_si128(absf);
+	__m128i isNan = _mm_castps_si128(_mm_cmpunord_ps(absf, absf));
+	__m128i isRegular = _mm_cmpgt_epi32(maxNormal, absi);
+	__m128i isSubnormal = _mm_cmpgt_epi32(minNormal, absi);
+	__m128i special = _mm_or_si128(_mm_and_si128(isNan, nanBit), infinity);
+	// Subnormal result: float add aligns mantissa and rounds.
+	__m128i subnormal = _mm_sub_epi32(_mm_castps_si128(_mm_add_ps(absf, _mm_castsi128_ps(subnormalMagic))), subnormalMagic);
+	// Normal result: rebias exponent, odd mantissa rounds half up for round to even.
+	__m128i odd = _mm_srai_epi32(_mm_slli_epi32(absi, 31 - 13), 31);
+	__m128i normal = _mm_srli_epi32(_mm_sub_epi32(_mm_add_epi32(absi, normalBias), odd), 13);
+	__m128i finite = _mm_or_si128(_mm_and_si128(isSubnormal, subnormal), _mm_andnot_si128(isSubnormal, normal));
+	__m128i result = _mm_or_si128(_mm_and_si128(isRegular, finite), _mm_andnot_si128(isRegular, special));
+	return _mm_or_si128(result, _mm_srai_epi32(_mm_castps_si128(sign), 16));
+}
+// 8 floats per iteration, results packed to 8 halfs by signed saturation,
+// sign extended lanes fits to 16-bit range without change.
+void InstanceEncoder::encodeHalf(const GLfloat* src, BYTE* dst, size_t count, BOOL streaming)
+{
+	__m128i* vDst = reinterpret_cast<__m128i*>(dst);
+	size_t vCount = count / 8;
+	for (size_t i = 0; i < vCount; i++)
+	{
+		__m128i a = halfVector(_mm_loadu_ps(src));
+		__m128i b = halfVector(_mm_loadu_ps(src + 4));
+		if (streaming)
+		{
+			_mm_stream_si128(vDst++, _mm_packs_epi32(a, b));
+		}
+		else
+		{
+			_mm_storeu_si128(vDst++, _mm_packs_epi32(a, b));
+		}
+		src += 8;
+	}
+	size_t tail = count % 8;
+	if (tail)
+	{
+		alignas(16) GLfloat block[8] = { 0 };
+		alignas(16) BYTE encoded[16];
+		memcpy(block, src, tail * sizeof(GLfloat));
+		__m128i a = halfVector(_mm_load_ps(block));
+		__m128i b = halfVector(_mm_load_ps(block + 4));
+		_mm_store_si128(reinterpret_cast<__m128i*>(encoded), _mm_packs_epi32(a, b));
+		memcpy(vDst, encoded, tail * 2);
+	}
+}
+void InstanceEncoder::encodeSnorm16(const GLfloat* src, BYTE* dst, size_t count, BOOL streaming)
+{
+	const __m128 vMin = _mm_set1_ps(-1.0f);
+	const __m128 vMax = _mm_set1_ps(1.0f);
+	const __m128 vScale = _mm_set1_ps(32767.0f);
+	__m128i* vDst = reinterpret_cast<__m128i*>(dst);
+	alignas(16) GLfloat block[8] = { 0 };
+	size_t vCount = (count + 7) / 8;
+	for (size_t i = 0; i < vCount; i++)
+	{
+		const GLfloat* p = src;
+		size_t n = count - i * 8;
+		if (n < 8)
+		{
+			memcpy(block, src, n * sizeof(GLfloat));
+			p = block;
+		}
+		__m128 a = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(p), vMin), vMax), vScale);
+		__m128 b = _mm_mul_ps(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(p + 4), vMin), vMax), vScale);
+		__m128i packed = _mm_packs_epi32(_mm_cvtps_epi32(a), _mm_cvtps_epi32(b));
+		if (n < 8)
+		{
+			alignas(16) BYTE encoded[16];
+			_mm_store_si128(reinterpret_cast<__m128i*>(encoded), packed);
+			memcpy(vDst, encoded, n * 2);
+			break;
+		}
+		if (streaming)
+		{
+			_mm_stream_si128(vDst++, packed);
+		}
+		else
+		{
+			_mm_storeu_si128(vDst++, packed);
+		}
+		src += 8;
+	}
+}
+// 12 floats per iteration: instances 3k, 3k+1, 3k+2 deinterleaved to x, y, z vectors,
+// quantized to 10-bit signed normalized and packed to 4 elements.
+void InstanceEncoder::encodeSnorm10Packed(const GLfloat* src, BYTE* dst, size_t count, BOOL streaming)
+{
+	const __m128 vMin = _mm_set1_ps(-1.0f);
+	const __m128 vMax = _mm_set1_ps(1.0f);
+	const __m128 vScale = _mm_set1_ps(511.0f);
+	const __m128i vMask = _mm_set1_epi32(0x3FF);
+	__m128i* vDst = reinterpret_cast<__m128i*>(dst);
+	alignas(16) GLfloat block[12] = { 0 };
+	size_t vCount = (count + 11) / 12;
+	for (size_t i = 0; i < vCount; i++)
+	{
+		const GLfloat* p = src;
+		size_t n = count - i * 12;
+		if (n < 12)
+		{
+			memcpy(block, src, n * sizeof(GLfloat));
+			p = block;
+		}
+		__m128 q0 = _mm_loadu_ps(p);        // x0 y0 z0 x1
+		__m128 q1 = _mm_loadu_ps(p + 4);    // y1 z1 x2 y2
+		__m128 q2 = _mm_loadu_ps(p + 8);    // z2 x3 y3 z3
+		__m128 t0 = _mm_shuffle_ps(q1, q2, _MM_SHUFFLE(2, 1, 3, 2));   // x2 y2 x3 y3
+		__m128 t1 = _mm_shuffle_ps(q0, q1, _MM_SHUFFLE(1, 0, 2, 1));   // y0 z0 y1 z1
+		__m128 x = _mm_shuffle_ps(q0, t0, _MM_SHUFFLE(2, 0, 3, 0));
+		__m128 y = _mm_shuffle_ps(t1, t0, _MM_SHUFFLE(3, 1, 2, 0));
+		__m128 z = _mm_shuffle_ps(t1, q2, _MM_SHUFFLE(3, 0, 3, 1));
+		__m128i xi = _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(x, vMin), vMax), vScale)), vMask);
+		__m128i yi = _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(y, vMin), vMax), vScale)), vMask);
+		__m128i zi = _mm_and_si128(_mm_cvtps_epi32(_mm_mul_ps(_mm_min_ps(_mm_max_ps(z, vMin), vMax), vScale)), vMask);
+		__m128i packed = _mm_or_si128(xi, _mm_or_si128(_mm_slli_epi32(yi, 10), _mm_slli_epi32(zi, 20)));
+		if (n < 12)
+		{
+			alignas(16) BYTE encoded[16];
+			_mm_store_si128(reinterpret_cast<__m128i*>(encoded), packed);
+			memcpy(vDst, encoded, ((n + 2) / 3) * 4);
+			break;
+		}
+		if (streaming)
+		{
+			_mm_stream_si128(vDst++, packed);
+		}
+		else
+		{
+			_mm_storeu_si128(vDst++, packed);
+		}
+		src += 12;
+	}
+}
+const instanceLayout InstanceEncoder::layouts[FORMATS_COUNT]
+{
+	{ 1, GL_FLOAT,               GL_FALSE, 1, 4 },
+	{ 1, GL_HALF_FLOAT,          GL_FALSE, 1, 2 },
+	{ 1, GL_SHORT,               GL_TRUE,  1, 2 },
+	{ 4, GL_INT_2_10_10_10_REV,  GL_TRUE,  3, 4 }
+};
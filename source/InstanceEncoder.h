@@ -0,0 +1,53 @@
+/*
+OpenGL GPUstress.
+Per-instance attributes encoder class header.
+Float instance stream quantized by SIMD kernels to packed formats,
+decoded by vertex fetch normalization and packed variant of vertex shader.
+*/
+
+#pragma once
+#ifndef INSTANCEENCODER_H
+#define INSTANCEENCODER_H
+
+#include <windows.h>
+#include <intrin.h>
+#include "Global.h"
+#include "OpenGLImport.h"
+
+enum instanceFormat
+{
+    FORMAT_FLOAT32 = 0,     // Source floats uploaded as is, 4 bytes per instance.
+    FORMAT_HALF16,          // IEEE half float, 2 bytes per instance.
+    FORMAT_SNORM16,         // Normalized signed 16-bit, 2 bytes per instance.
+    FORMAT_SNORM10_PACKED,  // Three instances per GL_INT_2_10_10_10_REV element, 4/3 bytes per instance.
+    FORMATS_COUNT
+};
+
+// Vertex attribute parameters for instance format.
+struct instanceLayout
+{
+    GLint size;
+    GLenum type;
+    GLboolean normalized;
+    GLuint divisor;             // Instances per attribute element.
+    GLsizei bytesPerElement;
+};
+
+class InstanceEncoder
+{
+public:
+    InstanceEncoder();
+    ~InstanceEncoder();
+    void setBuffer(BYTE* pBuffer, size_t bytes);
+    const void* encode(instanceFormat format, const GLfloat* src, size_t count, GLsizeiptr& bytes, BOOL streaming);
+    static const instanceLayout layouts[FORMATS_COUNT];
+private:
+    static void encodeHalf(const GLfloat* src, BYTE* dst, size_t count, BOOL streaming);
+    static void encodeSnorm16(const GLfloat* src, BYTE* dst, size_t count, BOOL streaming);
+    static void encodeSnorm10Packed(const GLfloat* src, BYTE* dst, size_t count, BOOL streaming);
+    static __m128i halfVector(__m128 f);
+    BYTE* buffer;       // Owned by caller.
+    size_t bufferBytes;
+};
+
+#endif // INSTANCEENCODER_H
@@ -0,0 +1,173 @@
+/*
+OpenGL GPUstress.
+Instance data fetch paths class.
+All paths read one float per instance, uploaded by one glBufferData per frame.
+Uniform block size is limited (16KB minimum, 64KB typical), uniform path
+binds consecutive buffer ranges and draws one instanced batch per range.
+*/
+
+#include "InstanceFetch.h"
+
+InstanceFetch::InstanceFetch() : f(nullptr), programs{ 0 }, buffers{ 0 }, bufferTexture(0),
+	                             uploadedBytes(0), uniformBatch(0), textureInstances(0), uniformDefines{ 0 }
+{
+
+}
+InstanceFetch::~InstanceFetch()
+{
+
+}
+int InstanceFetch::init(const oglFunctionsList* pFunctions, ShaderBuilder* pBuilder,
+	const char* version, const char* vertexSource, const char* fragmentSource)
+{
+	f = pFunctions;
+
+	// Uniform range: maximum block size, not above 64KB, multiple of offset alignment.
+	GLint blockSize = 0;
+	GLint alignment = 0;
+	glGetIntegerv(GL_MAX_UNIFORM_BLOCK_SIZE, &blockSize);
+	glGetIntegerv(GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT, &alignment);
+	if (glGetError() || (blockSize < APPCONST::TEXT_CHARS * 4)) return 0x150;
+	if (blockSize > APPCONST::FETCH_UNIFORM_MAX_BYTES) blockSize = APPCONST::FETCH_UNIFORM_MAX_BYTES;
+	if (alignment < 16) alignment = 16;
+	blockSize -= blockSize % alignment;
+	uniformBatch = blockSize / 4;
+	snprintf(uniformDefines, APPCONST::MAX_TEXT_STRING,
+		"#define FETCH_UNIFORM_BUFFER\r\n#define FETCH_UNIFORM_VECTORS %d\r\n", uniformBatch / 4);
+
+	int status = pBuilder->build(version, textureDefines, vertexSource, fragmentSource, programs[FETCH_TEXTURE_BUFFER]);
+	if (status) return status;
+	status = pBuilder->build(version, uniformDefines, vertexSource, fragmentSource, programs[FETCH_UNIFORM_BUFFER]);
+	if (status) return status;
+	GLint major = 0;
+	GLint minor = 0;
+	glGetIntegerv(GL_MAJOR_VERSION, &major);
+	glGetIntegerv(GL_MINOR_VERSION, &minor);
+	if ((major > 4) || ((major == 4) && (minor >= 3)))
+	{
+		status = pBuilder->build(storageVersion, storageDefines, vertexSource, fragmentSource, programs[FETCH_STORAGE_BUFFER]);
+		if (status) return status;
+	}
+
+	for (int i = FETCH_TEXTURE_BUFFER; i < FETCH_PATHS_COUNT; i++)
+	{
+		if (!programs[i]) continue;
+		f->glUseProgram(programs[i]);
+		f->glUniform1i(f->glGetUniformLocation(programs[i], "texture1"), 0);
+		if (glGetError()) return 0x151;
+		f->glGenBuffers(1, &buffers[i]);
+		if (glGetError() || (!buffers[i])) return 0x152;
+		f->glBindBuffer(targets[i], buffers[i]);
+		f->glBufferData(targets[i], APPCONST::TEXT_CHARS * 4, nullptr, GL_DYNAMIC_DRAW);
+		f->glBindBuffer(targets[i], 0);
+		if (glGetError()) return 0x153;
+	}
+
+	f->glUseProgram(programs[FETCH_TEXTURE_BUFFER]);
+	f->glUniform1i(f->glGetUniformLocation(programs[FETCH_TEXTURE_BUFFER], "scBuffer"), 1);
+	glGenTextures(1, &bufferTexture);
+	if (glGetError() || (!bufferTexture)) return 0x154;
+	f->glActiveTexture(GL_TEXTURE1);
+	glBindTexture(GL_TEXTURE_BUFFER, bufferTexture);
+	f->glTexBuffer(GL_TEXTURE_BUFFER, GL_R32F, buffers[FETCH_TEXTURE_BUFFER]);
+	f->glActiveTexture(GL_TEXTURE0);
+	if (glGetError()) return 0x155;
+	// Buffer texture size limit in texels, 64K minimum, one texel per instance.
+	GLint textureTexels = 0;
+	glGetIntegerv(GL_MAX_TEXTURE_BUFFER_SIZE, &textureTexels);
+	if (glGetError() || (textureTexels <= APPCONST::TEXT_CHARS)) return 0x158;
+	textureInstances = textureTexels - APPCONST::TEXT_CHARS;
+
+	GLuint blockIndex = f->glGetUniformBlockIndex(programs[FETCH_UNIFORM_BUFFER], "instanceBlock");
+	if (blockIndex == GL_INVALID_INDEX) return 0x156;
+	f->glUniformBlockBinding(programs[FETCH_UNIFORM_BUFFER], blockIndex, APPCONST::FETCH_UNIFORM_BINDING);
+	if (glGetError()) return 0x157;
+	return 0;
+}
+void InstanceFetch::release()
+{
+	if (!f) return;
+	for (int i = 0; i < FETCH_PATHS_COUNT; i++)
+	{
+		if (programs[i]) f->glDeleteProgram(programs[i]);
+		if (buffers[i])  f->glDeleteBuffers(1, &buffers[i]);
+		programs[i] = 0;
+		buffers[i] = 0;
+	}
+	if (bufferTexture) glDeleteTextures(1, &bufferTexture);
+	bufferTexture = 0;
+}
+BOOL InstanceFetch::getSupported(fetchPath path)
+{
+	return (path == FETCH_ATTRIBUTE) || (programs[path] != 0);
+}
+// Cubes count limit of buffer texture path, other paths limited by instance buffers size only.
+BOOL InstanceFetch::getSupported(fetchPath path, GLsizei instancesCount)
+{
+	if (!getSupported(path)) return FALSE;
+	return (path != FETCH_TEXTURE_BUFFER) || (instancesCount <= textureInstances);
+}
+GLuint InstanceFetch::getProgram(fetchPath path)
+{
+	return programs[path];
+}
+// Uniform buffer padded to whole ranges, last batch binds range of full declared block size.
+void InstanceFetch::upload(fetchPath path, const void* data, GLsizeiptr bytes)
+{
+	f->glBindBuffer(targets[path], buffers[path]);
+	if (path == FETCH_UNIFORM_BUFFER)
+	{
+		GLsizeiptr rangeBytes = static_cast<GLsizeiptr>(uniformBatch) * 4;
+		GLsizeiptr paddedBytes = (bytes + rangeBytes - 1) / rangeBytes * rangeBytes;
+		f->glBufferData(targets[path], paddedBytes, nullptr, GL_DYNAMIC_DRAW);
+		f->glBufferSubData(targets[path], 0, bytes, data);
+		uploadedBytes = paddedBytes;
+		return;
+	}
+	f->glBufferData(targets[path], bytes, data, GL_DYNAMIC_DRAW);
+	uploadedBytes = bytes;
+}
+// Cube position ID is (gl_InstanceID + instanceBase), cubes start from TEXT_CHARS,
+// uniform path indexes block array by gl_InstanceID inside current range.
+void InstanceFetch::draw(fetchPath path, GLsizei instancesCount, GLint instanceBaseLocation)
+{
+	constexpr GLint ARRAY_COUNT = APPCONST::CUBE_VERTICES;
+	if (path == FETCH_UNIFORM_BUFFER)
+	{
+		for (GLsizei base = 0; base < instancesCount; base += uniformBatch)
+		{
+			GLsizei count = instancesCount - base;
+			if (count > uniformBatch) count = uniformBatch;
+			GLintptr offset = static_cast<GLintptr>(base) * 4;
+			GLsizeiptr size = static_cast<GLsizeiptr>(uniformBatch) * 4;
+			if (offset + size > uploadedBytes) break;
+			f->glBindBufferRange(GL_UNIFORM_BUFFER, APPCONST::FETCH_UNIFORM_BINDING, buffers[path], offset, size);
+			f->glUniform1i(instanceBaseLocation, APPCONST::TEXT_CHARS + base);
+			f->glDrawArraysInstanced(GL_TRIANGLES, 0, ARRAY_COUNT, count);
+		}
+		f->glUniform1i(instanceBaseLocation, APPCONST::TEXT_CHARS);
+		return;
+	}
+	if (path == FETCH_TEXTURE_BUFFER)
+	{
+		f->glActiveTexture(GL_TEXTURE1);
+		glBindTexture(GL_TEXTURE_BUFFER, bufferTexture);
+		f->glActiveTexture(GL_TEXTURE0);
+	}
+	else if (path == FETCH_STORAGE_BUFFER)
+	{
+		f->glBindBufferBase(GL_SHADER_STORAGE_BUFFER, APPCONST::FETCH_STORAGE_BINDING, buffers[path]);
+	}
+	f->glDrawArraysInstanced(GL_TRIANGLES, 0, ARRAY_COUNT, instancesCount);
+}
+
+const GLenum InstanceFetch::targets[FETCH_PATHS_COUNT]
+{ GL_ARRAY_BUFFER, GL_TEXTURE_BUFFER, GL_UNIFORM_BUFFER, GL_SHADER_STORAGE_BUFFER };
+
+// Storage buffer variant requires GLSL 4.30, other sources are same.
+const char* InstanceFetch::storageVersion =
+"#version 430 core\r\n";
+const char* InstanceFetch::textureDefines =
+"#define FETCH_TEXTURE_BUFFER\r\n";
+const char* InstanceFetch::storageDefines =
+"#define FETCH_STORAGE_BUFFER\r\n";
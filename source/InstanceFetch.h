@@ -0,0 +1,56 @@
+/*
+OpenGL GPUstress.
+Instance data fetch paths class header.
+Same per-instance float stream delivered to vertex shader by buffer texture,
+uniform block array or shader storage buffer, shader variant per path.
+Vertex attribute path is main program of OpenGL class.
+*/
+
+#pragma once
+#ifndef INSTANCEFETCH_H
+#define INSTANCEFETCH_H
+
+#include <windows.h>
+#include <iostream>
+#include "Global.h"
+#include "OpenGLImport.h"
+#include "ShaderBuilder.h"
+
+enum fetchPath
+{
+    FETCH_ATTRIBUTE = 0,    // Instanced vertex attribute, divisor 1.
+    FETCH_TEXTURE_BUFFER,   // Buffer texture, texelFetch by instance index.
+    FETCH_UNIFORM_BUFFER,   // Uniform block array, instances drawn by block size batches.
+    FETCH_STORAGE_BUFFER,   // Shader storage buffer, requires OpenGL 4.3.
+    FETCH_PATHS_COUNT
+};
+
+class InstanceFetch
+{
+public:
+    InstanceFetch();
+    ~InstanceFetch();
+    int init(const oglFunctionsList* pFunctions, ShaderBuilder* pBuilder,
+        const char* version, const char* vertexSource, const char* fragmentSource);
+    void release();
+    BOOL getSupported(fetchPath path);
+    BOOL getSupported(fetchPath path, GLsizei instancesCount);
+    GLuint getProgram(fetchPath path);
+    void upload(fetchPath path, const void* data, GLsizeiptr bytes);
+    void draw(fetchPath path, GLsizei instancesCount, GLint instanceBaseLocation);
+private:
+    const oglFunctionsList* f;
+    GLuint programs[FETCH_PATHS_COUNT];
+    GLuint buffers[FETCH_PATHS_COUNT];
+    GLuint bufferTexture;
+    GLsizeiptr uploadedBytes;
+    GLsizei uniformBatch;       // Instances per uniform block range.
+    GLsizei textureInstances;   // Cubes count limit of buffer texture.
+    char uniformDefines[APPCONST::MAX_TEXT_STRING];
+    static const GLenum targets[FETCH_PATHS_COUNT];
+    static const char* storageVersion;
+    static const char* textureDefines;
+    static const char* storageDefines;
+};
+
+#endif // INSTANCEFETCH_H
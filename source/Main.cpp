@@ -17,18 +17,28 @@ https://ravesli.com/uroki-cpp/#toc-0
 #include "Timer.h"
 #include "TextureLoader.h"
 #include "FontLoader.h"
+#include "AtlasBlob.h"
 #include "OpenGL.h"
+#include "Telemetry.h"
+#include "Harness.h"
+#include "Replay.h"
+#include "VulkanBackend.h"
 
 LRESULT CALLBACK WndProc(HWND, UINT, WPARAM, LPARAM);
 void WndDestroyHelper(HWND, HDC);
+void ParseCommandLine();
 
 Timer* pTimer = nullptr;
+Telemetry* pTelemetry = nullptr;
 TextureLoader* pTextureLoader = nullptr;
 FontLoader* pFontLoader = nullptr;
+AtlasBlob* pAtlas = nullptr;
 OpenGL* pOpenGL = nullptr;
+Harness* pHarness = nullptr;
+Replay* pReplay = nullptr;
 HINSTANCE hInst = NULL;
 HDC hDC = NULL;
-void* rawPtr = nullptr;
+const void* rawPtr = nullptr;
 double tscFrequency = 0.0;
 double tscPeriod = 0.0;
 int windowExitCode = 0;
@@ -46,6 +56,40 @@ constexpr unsigned int GPU_LOADS[]
 };
 int optionLoadIndex = APPCONST::DEFAULT_GPU_LOAD_SELECT;
 BOOL optionDepthTest = TRUE;
+benchmarkMode optionMode = MODE_INSTANCED;
+BOOL optionPerDrawUniform = FALSE;
+instanceFormat optionFormat = FORMAT_FLOAT32;
+fetchPath optionFetch = FETCH_ATTRIBUTE;
+arenaKind optionArena = ARENA_PAGES;
+depthOrder optionDepthOrder = DEPTH_ORDER_OFF;
+targetColor optionTargetColor = TARGET_COLOR_DEFAULT;
+targetDepth optionTargetDepth = TARGET_D24S8;
+int optionTargetSamples = 0;
+samplingFilter optionFilter = SAMPLING_OFF;
+samplingPattern optionPattern = PATTERN_COHERENT;
+int optionWorkingSet = 0;
+captureFormat optionCapture = CAPTURE_OFF;
+int optionCaptureInterval = 1;
+BOOL optionStreaming = FALSE;
+burnKind optionBurn = BURN_OFF;
+BOOL optionSensors = FALSE;
+int optionFramesInFlight = 0;
+// Command line options: -harness [-repeat N] [-baseline file] [-save file], -vulkan, -replay file [-paced],
+// -bake [-lz4] writes atlas blob and exits, -jpeg ignores atlas blob, -burners N is CPU burner threads count,
+// -sysfs path is sensors sysfs root, -sensorms N is sensors sample period.
+BOOL optionHarness = FALSE;
+BOOL optionVulkan = FALSE;
+int optionRepeat = APPCONST::HARNESS_REPETITIONS;
+char optionBaseline[MAX_PATH] = { 0 };
+char optionSave[MAX_PATH] = { 0 };
+char optionReplay[MAX_PATH] = { 0 };
+BOOL optionPaced = FALSE;
+BOOL optionBake = FALSE;
+BOOL optionLz4 = FALSE;
+BOOL optionJpeg = FALSE;
+int optionBurnThreads = 0;
+char optionSysfs[MAX_PATH] = { 0 };
+int optionSensorPeriod = APPCONST::SENSOR_DEFAULT_PERIOD_MS;
 
 int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
     _In_opt_ HINSTANCE hPrevInstance,
@@ -56,21 +100,85 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
     windowExitCode = 0;
     char szAppMsg[APPCONST::MAX_TEXT_STRING];
     hInst = hInstance;
+    ParseCommandLine();
     snprintf(szAppMsg, APPCONST::MAX_TEXT_STRING, "%s %s", APPCONST::APP_NAME, APPCONST::BUILD_NAME);
-    int userInput = MessageBox(NULL,
-        "This application can overheat your GPU,\r\nespecially if Depth test OFF.\r\n\r\nRun application ?",
-        szAppMsg, MB_YESNO + MB_ICONWARNING);
+    // Harness, replay, Vulkan and atlas bake modes are unattended runs, started by command line option, without confirmation.
+    BOOL unattended = optionHarness || optionVulkan || optionReplay[0] || optionBake;
+    int userInput = IDYES;
+    if (!unattended)
+    {
+        userInput = MessageBox(NULL,
+            "This application can overheat your GPU,\r\nespecially if Depth test OFF.\r\n\r\nRun application ?",
+            szAppMsg, MB_YESNO + MB_ICONWARNING);
+    }
     if (userInput == IDYES)
     {
         pTimer = new Timer();
+        pTelemetry = new Telemetry();
         pTextureLoader = new TextureLoader(hInst);
         pFontLoader = new FontLoader();
+        pAtlas = new AtlasBlob();
         pOpenGL = new OpenGL();
-        if (pTimer && pTextureLoader && pFontLoader && pOpenGL)
+        pHarness = new Harness();
+        pReplay = new Replay();
+        if (pTimer && pTelemetry && pTextureLoader && pFontLoader && pAtlas && pOpenGL && pHarness && pReplay)
         {
-            if (pTimer->getStatus())
+            if (optionHarness && (!pHarness->start(optionRepeat, optionBaseline[0] ? optionBaseline : nullptr,
+                optionSave[0] ? optionSave : nullptr, pTimer->getTscPeriod())))
+            {
+                exitCode = APPCONST::HARNESS_EXIT_BASELINE;
+            }
+            else if (optionReplay[0] && (!pReplay->startReplay(optionReplay, optionPaced, pTimer->getTscPeriod())))
+            {
+                exitCode = APPCONST::REPLAY_EXIT_LOG;
+            }
+            else if (optionVulkan && pTimer->getStatus())
+            {
+                // Same atlas source as regular startup path, glyph cells required for text overlay.
+                if ((!optionJpeg) && pAtlas->open(hInst, pTimer->getTscPeriod()))
+                {
+                    rawPtr = pAtlas->getRawPointer();
+                }
+                else
+                {
+                    rawPtr = pTextureLoader->decode();
+                    if ((!rawPtr) || pFontLoader->init(rawPtr))
+                    {
+                        rawPtr = nullptr;
+                    }
+                }
+                VulkanBackend vulkan;
+                exitCode = rawPtr ? vulkan.init(pTimer->getTscPeriod(), rawPtr, OpenGL::getCubeVertices()) : 4;
+                if (!exitCode)
+                {
+                    exitCode = vulkan.run(APPCONST::VULKAN_REPORT_NAME);
+                }
+            }
+            else if (optionBake)
+            {
+                // Atlas baked from regular startup path result: decoded JPEG with glyph cells.
+                rawPtr = pTextureLoader->decode();
+                if (!rawPtr)
+                {
+                    exitCode = 4;
+                }
+                else if (pFontLoader->init(rawPtr) || (!pAtlas->bake(hInst, rawPtr, optionLz4)))
+                {
+                    exitCode = APPCONST::ATLAS_EXIT_BAKE;
+                }
+            }
+            else if (pTimer->getStatus())
             {
-                rawPtr = pTextureLoader->getRawPointer();
+                if ((!optionJpeg) && pAtlas->open(hInst, pTimer->getTscPeriod()))
+                {
+                    rawPtr = pAtlas->getRawPointer();
+                }
+                else
+                {
+                    DWORD64 t1 = __rdtsc();
+                    rawPtr = pTextureLoader->decode();
+                    pAtlas->setStartupMilliseconds(STARTUP_DECODE, (__rdtsc() - t1) * pTimer->getTscPeriod() * 1.0E3);
+                }
                 if (rawPtr)
                 {
                     const char* szClassName = "OPENGLSAMPLE";
@@ -107,6 +215,10 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
                             {
                                 exitCode = 7;
                             }
+                            else if (optionHarness)
+                            {
+                                exitCode = pHarness->finish();
+                            }
                         }
                         else
                         {
@@ -132,7 +244,7 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
         {
             exitCode = 2;
         }
-        if ((exitCode) && (!windowExitCode))
+        if ((exitCode) && (!windowExitCode) && (!unattended))
         {
             char szError[APPCONST::MAX_TEXT_STRING];
             snprintf(szError, APPCONST::MAX_TEXT_STRING, "Initialization failed (%d).", exitCode);
@@ -145,12 +257,91 @@ int APIENTRY wWinMain(_In_ HINSTANCE hInstance,
     }
     
     if (pTimer) delete pTimer;
+    if (pTelemetry) delete pTelemetry;
     if (pTextureLoader) delete pTextureLoader;
     if (pFontLoader) delete pFontLoader;
     if (pOpenGL) delete pOpenGL;
+    if (pAtlas) delete pAtlas;
+    if (pHarness) delete pHarness;
+    if (pReplay) delete pReplay;
     return exitCode;
 }
 
+void ParseCommandLine()
+{
+    int argc = 0;
+    LPWSTR* argv = CommandLineToArgvW(GetCommandLineW(), &argc);
+    if (!argv) return;
+    for (int i = 1; i < argc; i++)
+    {
+        char szValue[MAX_PATH] = { 0 };
+        if ((i + 1) < argc)
+        {
+            WideCharToMultiByte(CP_ACP, 0, argv[i + 1], -1, szValue, MAX_PATH, nullptr, nullptr);
+        }
+        if (!_wcsicmp(argv[i], L"-harness"))
+        {
+            optionHarness = TRUE;
+        }
+        else if (!_wcsicmp(argv[i], L"-vulkan"))
+        {
+            optionVulkan = TRUE;
+        }
+        else if ((!_wcsicmp(argv[i], L"-repeat")) && szValue[0])
+        {
+            optionRepeat = atoi(szValue);
+            i++;
+        }
+        else if ((!_wcsicmp(argv[i], L"-baseline")) && szValue[0])
+        {
+            snprintf(optionBaseline, MAX_PATH, "%s", szValue);
+            i++;
+        }
+        else if ((!_wcsicmp(argv[i], L"-save")) && szValue[0])
+        {
+            snprintf(optionSave, MAX_PATH, "%s", szValue);
+            i++;
+        }
+        else if ((!_wcsicmp(argv[i], L"-replay")) && szValue[0])
+        {
+            snprintf(optionReplay, MAX_PATH, "%s", szValue);
+            i++;
+        }
+        else if (!_wcsicmp(argv[i], L"-paced"))
+        {
+            optionPaced = TRUE;
+        }
+        else if (!_wcsicmp(argv[i], L"-bake"))
+        {
+            optionBake = TRUE;
+        }
+        else if (!_wcsicmp(argv[i], L"-lz4"))
+        {
+            optionLz4 = TRUE;
+        }
+        else if (!_wcsicmp(argv[i], L"-jpeg"))
+        {
+            optionJpeg = TRUE;
+        }
+        else if ((!_wcsicmp(argv[i], L"-burners")) && szValue[0])
+        {
+            optionBurnThreads = atoi(szValue);
+            i++;
+        }
+        else if ((!_wcsicmp(argv[i], L"-sysfs")) && szValue[0])
+        {
+            snprintf(optionSysfs, MAX_PATH, "%s", szValue);
+            i++;
+        }
+        else if ((!_wcsicmp(argv[i], L"-sensorms")) && szValue[0])
+        {
+            optionSensorPeriod = atoi(szValue);
+            i++;
+        }
+    }
+    LocalFree(argv);
+}
+
 LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 {
     switch (message)
@@ -158,10 +349,29 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         case WM_CREATE:
         {
             hDC = GetDC(hWnd);
-            windowExitCode = pFontLoader->init(rawPtr);
+            // Baked atlas blob contains glyph cells.
+            if (!pAtlas->getLevelsCount())
+            {
+                DWORD64 t1 = __rdtsc();
+                windowExitCode = pFontLoader->init(rawPtr);
+                pAtlas->setStartupMilliseconds(STARTUP_FONT, (__rdtsc() - t1) * pTimer->getTscPeriod() * 1.0E3);
+            }
             if (!windowExitCode)
             {
-                windowExitCode = pOpenGL->init(hWnd, hDC, rawPtr, pTimer); 
+                windowExitCode = pOpenGL->init(hWnd, hDC, rawPtr, pAtlas, pTimer, pTelemetry);
+            }
+            if (!windowExitCode)
+            {
+                pAtlas->saveStartupReport(APPCONST::STARTUP_REPORT_NAME);
+            }
+            // Harness scenarios not capped by display refresh.
+            if ((!windowExitCode) && (pHarness->getState() != HARNESS_OFF))
+            {
+                pHarness->setSwapInterval(pOpenGL->setUnthrottled(TRUE));
+            }
+            if ((!windowExitCode) && (pReplay->getState() == REPLAY_PLAYING))
+            {
+                pOpenGL->setFrameTiming(pReplay->getGpuMilliseconds(), pReplay->getFramesCount());
             }
             if (windowExitCode)
             {
@@ -177,13 +387,65 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
         {
             RECT r;
             GetClientRect(hWnd, &r);
-            glViewport(0, 0, r.right, r.bottom);
+            pOpenGL->resize(r.right, r.bottom);
         }
         break;
 
         case WM_PAINT:
         {
-            pOpenGL->draw(hWnd, hDC, GPU_LOADS[optionLoadIndex], optionDepthTest);
+            drawOptions options;
+            options.seconds = pTimer->getApplicationSeconds();
+            options.load = GPU_LOADS[optionLoadIndex];
+            options.depthTest = optionDepthTest;
+            options.mode = optionMode;
+            options.perDrawUniform = optionPerDrawUniform;
+            options.format = optionFormat;
+            options.fetch = optionFetch;
+            options.arena = optionArena;
+            options.depthOrdering = optionDepthOrder;
+            options.color = optionTargetColor;
+            options.depth = optionTargetDepth;
+            options.samplesIndex = optionTargetSamples;
+            options.filter = optionFilter;
+            options.pattern = optionPattern;
+            options.workingSet = optionWorkingSet;
+            options.streamingStores = optionStreaming;
+            options.burn = optionBurn;
+            options.burnThreads = optionBurnThreads ? optionBurnThreads : APPCONST::BURN_MAX_THREADS;
+            options.framesInFlight = optionFramesInFlight;
+            if (pHarness->getState() != HARNESS_OFF)
+            {
+                BOOL running = pHarness->frame(options);
+                char szStatus[APPCONST::MAX_TEXT_STRING];
+                if (pHarness->getStatusText(szStatus, APPCONST::MAX_TEXT_STRING))
+                {
+                    SetWindowText(hWnd, szStatus);
+                }
+                if (!running)
+                {
+                    pOpenGL->setUnthrottled(FALSE);
+                    WndDestroyHelper(hWnd, hDC);
+                    break;
+                }
+            }
+            // Replay overrides all options by logged frame, recording logs final options.
+            if (pReplay->getState() == REPLAY_PLAYING)
+            {
+                if (!pReplay->frame(options))
+                {
+                    pOpenGL->setFrameTiming(nullptr, 0);
+                    pReplay->saveReport(APPCONST::REPLAY_REPORT_NAME);
+                    WndDestroyHelper(hWnd, hDC);
+                    break;
+                }
+                char szStatus[APPCONST::MAX_TEXT_STRING];
+                if (pReplay->getStatusText(szStatus, APPCONST::MAX_TEXT_STRING))
+                {
+                    SetWindowText(hWnd, szStatus);
+                }
+            }
+            pReplay->record(options);
+            pOpenGL->draw(hWnd, hDC, options);
         }
         break;
 
@@ -218,6 +480,176 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
                 pTimer->resetStatistics();
                 break;
 
+            case 'M':
+                optionMode = static_cast<benchmarkMode>((optionMode + 1) % MODES_COUNT);
+                pTimer->resetStatistics();
+                break;
+
+            case 'U':
+                optionPerDrawUniform = !optionPerDrawUniform;
+                pTimer->resetStatistics();
+                break;
+
+            case 'F':
+                optionFormat = static_cast<instanceFormat>((optionFormat + 1) % FORMATS_COUNT);
+                pTimer->resetStatistics();
+                break;
+
+            case 'I':
+                optionFetch = static_cast<fetchPath>((optionFetch + 1) % FETCH_PATHS_COUNT);
+                pTimer->resetStatistics();
+                break;
+
+            case 'A':
+                optionArena = static_cast<arenaKind>((optionArena + 1) % ARENA_KINDS_COUNT);
+                pTimer->resetStatistics();
+                break;
+
+            case 'D':
+                optionDepthOrder = static_cast<depthOrder>((optionDepthOrder + 1) % DEPTH_ORDERS_COUNT);
+                pTimer->resetStatistics();
+                break;
+
+            case 'V':
+                optionTargetColor = static_cast<targetColor>((optionTargetColor + 1) % TARGET_COLORS_COUNT);
+                pTimer->resetStatistics();
+                break;
+
+            case 'B':
+                optionTargetDepth = static_cast<targetDepth>((optionTargetDepth + 1) % TARGET_DEPTHS_COUNT);
+                pTimer->resetStatistics();
+                break;
+
+            case 'N':
+                optionTargetSamples = (optionTargetSamples + 1) % TARGET_SAMPLES_COUNT;
+                pTimer->resetStatistics();
+                break;
+
+            case 'L':
+                optionFilter = static_cast<samplingFilter>((optionFilter + 1) % SAMPLING_FILTERS_COUNT);
+                pTimer->resetStatistics();
+                break;
+
+            case 'P':
+                optionPattern = static_cast<samplingPattern>((optionPattern + 1) % PATTERNS_COUNT);
+                pTimer->resetStatistics();
+                break;
+
+            case 'G':
+                optionWorkingSet = (optionWorkingSet + 1) % APPCONST::SAMPLING_SETS_COUNT;
+                pTimer->resetStatistics();
+                break;
+
+            case 'J':
+                pOpenGL->switchSamplingSweep();
+                pTimer->resetStatistics();
+                break;
+
+            case 'K':
+                optionCapture = static_cast<captureFormat>((optionCapture + 1) % CAPTURE_FORMATS_COUNT);
+                if (!pOpenGL->setCapture(optionCapture, optionCaptureInterval))
+                {
+                    optionCapture = CAPTURE_OFF;
+                }
+                break;
+
+            case 'Q':
+                optionCaptureInterval = (optionCaptureInterval + 1) % APPCONST::CAPTURE_INTERVALS_COUNT;
+                if ((optionCapture != CAPTURE_OFF) && (!pOpenGL->setCapture(optionCapture, optionCaptureInterval)))
+                {
+                    optionCapture = CAPTURE_OFF;
+                }
+                break;
+
+            case 'H':
+                optionStreaming = !optionStreaming;
+                pTimer->resetStatistics();
+                break;
+
+            case 'X':
+                pOpenGL->benchmarkBandwidth();
+                pTimer->resetStatistics();
+                break;
+
+            case 'Y':
+                optionBurn = static_cast<burnKind>((optionBurn + 1) % BURN_KINDS_COUNT);
+                pTimer->resetStatistics();
+                break;
+
+            case 'Z':
+                pOpenGL->switchBurnSweep();
+                pTimer->resetStatistics();
+                break;
+
+            case '1':
+                optionSensors = !optionSensors;
+                if (!pOpenGL->setSensors(optionSensors ? (optionSysfs[0] ? optionSysfs : APPCONST::SENSOR_SYSFS_ROOT) : nullptr,
+                    static_cast<DWORD>(optionSensorPeriod)))
+                {
+                    optionSensors = FALSE;
+                }
+                break;
+
+            case '2':
+                optionFramesInFlight = (optionFramesInFlight + 1) % (APPCONST::PACER_MAX_FRAMES + 1);
+                pTimer->resetStatistics();
+                break;
+
+            case '3':
+                pOpenGL->switchPacerSweep();
+                pTimer->resetStatistics();
+                break;
+
+            case 'E':
+                if (pReplay->getState() == REPLAY_RECORDING)
+                {
+                    pReplay->stopRecord();
+                }
+                else
+                {
+                    pReplay->startRecord(APPCONST::REPLAY_LOG_NAME);
+                }
+                break;
+
+            case 'W':
+                pOpenGL->switchTargetSweep();
+                pTimer->resetStatistics();
+                break;
+
+            case 'C':
+                pOpenGL->switchCalibration(APPCONST::CALIBRATION_TARGET_FPS, GPU_LOADS[optionLoadIndex]);
+                pTimer->resetStatistics();
+                break;
+
+            case 'R':
+                pOpenGL->saveReports();
+                break;
+
+            case 'S':
+                pOpenGL->benchmarkShaders();
+                pTimer->resetStatistics();
+                break;
+
+            case 'O':
+                pOpenGL->benchmarkSoftware();
+                pTimer->resetStatistics();
+                break;
+
+            case 'T':
+                {
+                    int traceMode = (pTelemetry->getFormat() + 1) % TRACE_FORMATS_COUNT;
+                    pTelemetry->stop();
+                    if (traceMode == TRACE_CSV)
+                    {
+                        pTelemetry->start(APPCONST::TRACE_CSV_NAME, TRACE_CSV, pTimer->getTscFrequency());
+                    }
+                    else if (traceMode == TRACE_BINARY)
+                    {
+                        pTelemetry->start(APPCONST::TRACE_BINARY_NAME, TRACE_BINARY, pTimer->getTscFrequency());
+                    }
+                }
+                break;
+
             case VK_ESCAPE:
                 WndDestroyHelper(hWnd, hDC);
                 break;
@@ -242,6 +674,11 @@ LRESULT CALLBACK WndProc(HWND hWnd, UINT message, WPARAM wParam, LPARAM lParam)
 
 void WndDestroyHelper(HWND hWnd, HDC hDC)
 {
+    // Capture encoders use GDI+, stopped while context current and before GDI+ shutdown.
+    if (pOpenGL)
+    {
+        pOpenGL->setCapture(CAPTURE_OFF, 0);
+    }
     if (hDC)
     {
         ReleaseDC(hWnd, hDC);
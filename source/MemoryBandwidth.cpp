@@ -0,0 +1,233 @@
+/*
+OpenGL GPUstress.
+CPU memory bandwidth class.
+Kernels move 64 bytes (one cache line) per iteration by SSE2 loads and stores,
+block passes repeated until fixed traffic, best of repetitions reported.
+*/
+
+#include "MemoryBandwidth.h"
+
+MemoryBandwidth::MemoryBandwidth() : buffer(nullptr), sink(0)
+{
+}
+MemoryBandwidth::~MemoryBandwidth()
+{
+	if (buffer)
+	{
+		VirtualFree(buffer, 0, MEM_RELEASE);
+	}
+}
+// Long operation, blocks rendering. Buffer allocated for run only, pages touched before measure.
+BOOL MemoryBandwidth::benchmark(const char* fileName, double tscPeriod, double busMegabytesPerSecond)
+{
+	buffer = reinterpret_cast<BYTE*>(VirtualAlloc(nullptr, APPCONST::BANDWIDTH_MAX_BYTES, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE));
+	if (!buffer) return FALSE;
+	writePass(buffer, APPCONST::BANDWIDTH_MAX_BYTES);
+	report.clear();
+	report.add("CPU memory bandwidth, single thread except all cores row, SSE2, best of %d, GB/s\r\n", APPCONST::BANDWIDTH_REPEATS);
+	report.add("block KB");
+	for (int k = 0; k < BANDWIDTH_KERNELS_COUNT; k++)
+	{
+		report.add(",%s", szKernelNames[k]);
+	}
+	report.add("\r\n");
+	double copyGigabytesPerSecond = 0.0;
+	for (size_t bytes = APPCONST::BANDWIDTH_MIN_BYTES; bytes <= APPCONST::BANDWIDTH_MAX_BYTES; bytes *= 2)
+	{
+		report.add("%u", static_cast<unsigned int>(bytes / 1024));
+		for (int k = 0; k < BANDWIDTH_KERNELS_COUNT; k++)
+		{
+			double gigabytesPerSecond = measure(static_cast<bandwidthKernel>(k), bytes, tscPeriod);
+			if (k == BANDWIDTH_COPY) copyGigabytesPerSecond = gigabytesPerSecond;
+			report.add(",%.2f", gigabytesPerSecond);
+		}
+		report.add("\r\n");
+	}
+	// Largest block split between all logical processors, one slice per thread.
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	int threads = static_cast<int>(info.dwNumberOfProcessors);
+	if (threads > APPCONST::BANDWIDTH_MAX_THREADS) threads = APPCONST::BANDWIDTH_MAX_THREADS;
+	if (threads < 1) threads = 1;
+	double copyAllGigabytesPerSecond = 0.0;
+	report.add("%u all cores (%d threads)", static_cast<unsigned int>(APPCONST::BANDWIDTH_MAX_BYTES / 1024), threads);
+	for (int k = 0; k < BANDWIDTH_KERNELS_COUNT; k++)
+	{
+		double gigabytesPerSecond = measureAllCores(static_cast<bandwidthKernel>(k), threads, tscPeriod);
+		if (k == BANDWIDTH_COPY) copyAllGigabytesPerSecond = gigabytesPerSecond;
+		report.add(",%.2f", gigabytesPerSecond);
+	}
+	report.add("\r\n");
+	// Largest block is DRAM bound, bus upload is copy from system memory by driver.
+	double busGigabytesPerSecond = busMegabytesPerSecond * 1048576.0 / 1.0E9;
+	report.add("bus upload average GB/s,%.2f,DRAM copy single thread GB/s,%.2f,upload to single thread copy ratio,%.3f,"
+		"DRAM copy all cores GB/s,%.2f,upload to all cores copy ratio,%.3f\r\n",
+		busGigabytesPerSecond, copyGigabytesPerSecond,
+		(copyGigabytesPerSecond > 0.0) ? (busGigabytesPerSecond / copyGigabytesPerSecond) : 0.0,
+		copyAllGigabytesPerSecond,
+		(copyAllGigabytesPerSecond > 0.0) ? (busGigabytesPerSecond / copyAllGigabytesPerSecond) : 0.0);
+	VirtualFree(buffer, 0, MEM_RELEASE);
+	buffer = nullptr;
+	return report.save(fileName);
+}
+// Bytes moved per second, passes count gives same traffic for all block sizes.
+double MemoryBandwidth::measure(bandwidthKernel kernel, size_t bytes, double tscPeriod)
+{
+	size_t passes = APPCONST::BANDWIDTH_TRAFFIC_BYTES / bytes;
+	if (!passes) passes = 1;
+	DWORD64 best = 0;
+	for (int r = 0; r < APPCONST::BANDWIDTH_REPEATS; r++)
+	{
+		DWORD64 t1 = __rdtsc();
+		runPasses(kernel, buffer, bytes, passes, sink);
+		DWORD64 ticks = __rdtsc() - t1;
+		if ((!best) || (ticks < best)) best = ticks;
+	}
+	if (!best) return 0.0;
+	return static_cast<double>(bytes) * passes / (best * tscPeriod) / 1.0E9;
+}
+// Sum of all threads bytes per second of wall time, threads created before start event,
+// time from start event to last thread exit. Less threads used if thread creation failed.
+double MemoryBandwidth::measureAllCores(bandwidthKernel kernel, int threads, double tscPeriod)
+{
+	size_t slice = (APPCONST::BANDWIDTH_MAX_BYTES / threads) & (~static_cast<size_t>(4095));
+	if (!slice) return 0.0;
+	size_t passes = APPCONST::BANDWIDTH_TRAFFIC_BYTES / APPCONST::BANDWIDTH_MAX_BYTES;
+	if (!passes) passes = 1;
+	bandwidthWorker workers[APPCONST::BANDWIDTH_MAX_THREADS];
+	HANDLE handles[APPCONST::BANDWIDTH_MAX_THREADS];
+	DWORD64 best = 0;
+	int bestCount = 0;
+	for (int r = 0; r < APPCONST::BANDWIDTH_REPEATS; r++)
+	{
+		HANDLE hStart = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+		if (!hStart) return 0.0;
+		int created = 0;
+		for (int i = 0; i < threads; i++)
+		{
+			bandwidthWorker& w = workers[i];
+			w.kernel = kernel;
+			w.block = buffer + slice * i;
+			w.bytes = slice;
+			w.passes = passes;
+			w.hStart = hStart;
+			w.sink = 0;
+			handles[created] = CreateThread(nullptr, 0, workerThread, &w, 0, nullptr);
+			if (!handles[created]) break;
+			created++;
+		}
+		DWORD64 t1 = __rdtsc();
+		SetEvent(hStart);
+		if (created) WaitForMultipleObjects(created, handles, TRUE, INFINITE);
+		DWORD64 ticks = __rdtsc() - t1;
+		for (int i = 0; i < created; i++)
+		{
+			CloseHandle(handles[i]);
+			sink = sink + workers[i].sink;
+		}
+		CloseHandle(hStart);
+		if (created && ((!best) || (ticks < best)))
+		{
+			best = ticks;
+			bestCount = created;
+		}
+	}
+	if (!best) return 0.0;
+	return static_cast<double>(slice) * passes * bestCount / (best * tscPeriod) / 1.0E9;
+}
+DWORD WINAPI MemoryBandwidth::workerThread(LPVOID parm)
+{
+	bandwidthWorker* p = reinterpret_cast<bandwidthWorker*>(parm);
+	WaitForSingleObject(p->hStart, INFINITE);
+	runPasses(p->kernel, p->block, p->bytes, p->passes, p->sink);
+	return 0;
+}
+void MemoryBandwidth::runPasses(bandwidthKernel kernel, BYTE* block, size_t bytes, size_t passes, volatile DWORD64& result)
+{
+	for (size_t i = 0; i < passes; i++)
+	{
+		switch (kernel)
+		{
+		case BANDWIDTH_READ:
+			readPass(block, bytes, result);
+			break;
+		case BANDWIDTH_WRITE:
+			writePass(block, bytes);
+			break;
+		case BANDWIDTH_COPY:
+			copyPass(block, block + bytes / 2, bytes / 2);
+			break;
+		default:
+			streamPass(block, bytes);
+			break;
+		}
+	}
+}
+// Four independent accumulators, loads not limited by add latency.
+// Result is sink of calling thread, threads not share written cache line.
+void MemoryBandwidth::readPass(const BYTE* src, size_t bytes, volatile DWORD64& result)
+{
+	const __m128i* p = reinterpret_cast<const __m128i*>(src);
+	__m128i a = _mm_setzero_si128();
+	__m128i b = _mm_setzero_si128();
+	__m128i c = _mm_setzero_si128();
+	__m128i d = _mm_setzero_si128();
+	for (size_t i = 0; i < bytes; i += 64)
+	{
+		a = _mm_add_epi64(a, _mm_load_si128(p));
+		b = _mm_add_epi64(b, _mm_load_si128(p + 1));
+		c = _mm_add_epi64(c, _mm_load_si128(p + 2));
+		d = _mm_add_epi64(d, _mm_load_si128(p + 3));
+		p += 4;
+	}
+	a = _mm_xor_si128(_mm_xor_si128(a, b), _mm_xor_si128(c, d));
+	result = result + static_cast<DWORD64>(_mm_cvtsi128_si32(a));
+}
+void MemoryBandwidth::writePass(BYTE* dst, size_t bytes)
+{
+	__m128i* p = reinterpret_cast<__m128i*>(dst);
+	const __m128i v = _mm_set1_epi32(0x3F800000);
+	for (size_t i = 0; i < bytes; i += 64)
+	{
+		_mm_store_si128(p, v);
+		_mm_store_si128(p + 1, v);
+		_mm_store_si128(p + 2, v);
+		_mm_store_si128(p + 3, v);
+		p += 4;
+	}
+}
+void MemoryBandwidth::copyPass(const BYTE* src, BYTE* dst, size_t bytes)
+{
+	const __m128i* s = reinterpret_cast<const __m128i*>(src);
+	__m128i* d = reinterpret_cast<__m128i*>(dst);
+	for (size_t i = 0; i < bytes; i += 64)
+	{
+		__m128i v0 = _mm_load_si128(s);
+		__m128i v1 = _mm_load_si128(s + 1);
+		__m128i v2 = _mm_load_si128(s + 2);
+		__m128i v3 = _mm_load_si128(s + 3);
+		_mm_store_si128(d, v0);
+		_mm_store_si128(d + 1, v1);
+		_mm_store_si128(d + 2, v2);
+		_mm_store_si128(d + 3, v3);
+		s += 4;
+		d += 4;
+	}
+}
+// Non-temporal stores, full cache lines written without read for ownership.
+void MemoryBandwidth::streamPass(BYTE* dst, size_t bytes)
+{
+	__m128i* p = reinterpret_cast<__m128i*>(dst);
+	const __m128i v = _mm_set1_epi32(0x3F800000);
+	for (size_t i = 0; i < bytes; i += 64)
+	{
+		_mm_stream_si128(p, v);
+		_mm_stream_si128(p + 1, v);
+		_mm_stream_si128(p + 2, v);
+		_mm_stream_si128(p + 3, v);
+		p += 4;
+	}
+	_mm_sfence();
+}
+
+const char* MemoryBandwidth::szKernelNames[] = { "read", "write", "copy", "NT write" };
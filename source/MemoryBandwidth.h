@@ -0,0 +1,61 @@
+/*
+OpenGL GPUstress.
+CPU memory bandwidth class header.
+Single thread read, write, copy and non-temporal write bandwidth
+at block sizes from L1 cache up to DRAM, and DRAM bandwidth by all cores,
+context for bus upload rate.
+*/
+
+#pragma once
+#ifndef MEMORYBANDWIDTH_H
+#define MEMORYBANDWIDTH_H
+
+#include <windows.h>
+#include <iostream>
+#include <intrin.h>
+#include "Global.h"
+#include "Report.h"
+
+enum bandwidthKernel
+{
+    BANDWIDTH_READ = 0,
+    BANDWIDTH_WRITE,
+    BANDWIDTH_COPY,         // Half of block copied to other half, read and write bytes counted.
+    BANDWIDTH_STREAM,       // Non-temporal write.
+    BANDWIDTH_KERNELS_COUNT
+};
+
+// All cores row thread: own slice of buffer, passes started by shared event.
+struct bandwidthWorker
+{
+    bandwidthKernel kernel;
+    BYTE* block;
+    size_t bytes;
+    size_t passes;
+    HANDLE hStart;
+    volatile DWORD64 sink;      // Own read kernel result, folded to owner sink after join.
+    BYTE pad[APPCONST::CACHE_LINE_SIZE];
+};
+
+class MemoryBandwidth
+{
+public:
+    MemoryBandwidth();
+    ~MemoryBandwidth();
+    BOOL benchmark(const char* fileName, double tscPeriod, double busMegabytesPerSecond);
+private:
+    double measure(bandwidthKernel kernel, size_t bytes, double tscPeriod);
+    double measureAllCores(bandwidthKernel kernel, int threads, double tscPeriod);
+    static DWORD WINAPI workerThread(LPVOID parm);
+    static void runPasses(bandwidthKernel kernel, BYTE* block, size_t bytes, size_t passes, volatile DWORD64& result);
+    static void readPass(const BYTE* src, size_t bytes, volatile DWORD64& result);
+    static void writePass(BYTE* dst, size_t bytes);
+    static void copyPass(const BYTE* src, BYTE* dst, size_t bytes);
+    static void streamPass(BYTE* dst, size_t bytes);
+    BYTE* buffer;
+    volatile DWORD64 sink;      // Read kernel result, keeps loads from elimination.
+    Report report;
+    static const char* szKernelNames[];
+};
+
+#endif // MEMORYBANDWIDTH_H
@@ -9,42 +9,78 @@ https://learn.microsoft.com/en-us/windows/win32/api/wingdi/nf-wingdi-wglgetproca
 
 #include "OpenGL.h"
 
-OpenGL::OpenGL() : pfd{ 0 }, viewRect{ 0 }, f{ 0 }, hglrc(nullptr), vao(0), vbo(0), texture1(0), shaderProgramId(0),
-                   gpuLoadNow(APPCONST::DEFAULT_GPU_LOAD), gpuDepthTest(TRUE), ptrTimer(nullptr)
+OpenGL::OpenGL() : pfd{ 0 }, viewRect{ 0 }, f{ 0 }, fo{ 0 }, hglrc(nullptr), vao(0), textVao(0), vbo(0), ivbo(0), texture1(0), shaderProgramId(0),
+                   packedProgramId(0), animationProgramId(0), activeProgramId(0), textProgramId(0), showTextLocation(-1),
+                   gpuLoadNow(APPCONST::DEFAULT_GPU_LOAD), gpuDepthTest(TRUE), gpuMode(MODE_INSTANCED), gpuPerDrawUniform(FALSE),
+                   gpuFormat(FORMAT_FLOAT32), gpuFetch(FETCH_ATTRIBUTE), gpuStreaming(FALSE),
+                   gpuFetchSelected(FETCH_ATTRIBUTE), gpuArenaSelected(ARENA_PAGES), instanceBaseLocation(-1), windowSubmitTicks(0), windowCubes(0), windowFrames(0),
+                   windowUploadBytes(0), windowUploadTicks(0), references{ 0 }, referenceNext(0), instanceResults{ 0 }, instanceResultNext(0),
+                   arenaFillTicks(0), arenaFillBytes(0), arenaUploadTicks(0), arenaUploadBytes(0), arenaFrames(0), arenaFaults(0),
+                   arenaResults{ 0 }, arenaResultNext(0), gpuDepthOrder(DEPTH_ORDER_OFF), depthQueries{ { 0 } },
+                   depthQueriesIssued{ 0 }, depthQueryNext(0), depthFragments(0), depthPrepassFragments(0), depthQueryFrames(0),
+                   depthSortTicks(0), depthFrames(0), depthResults{ 0 }, depthResultNext(0), frameQueries{ { 0 } },
+                   frameQueriesIssued{ 0 }, frameQuerySequence{ 0 }, frameQueryNext(0), frameSequence(0), frameTimes(nullptr),
+                   frameTimesCount(0), instanceCapacity(0), swapIntervalSaved(-1), unthrottleOwners(0),
+                   ptrTimer(nullptr), ptrTelemetry(nullptr)
 {
 	constexpr int TRANS_MATRIXES_XYZ = 4 * 4 * 4;
 	ptrTransfMatrixes = new GLfloat[TRANS_MATRIXES_XYZ];
 	memset(ptrTransfMatrixes, 0, TRANS_MATRIXES_XYZ * sizeof(GLfloat));
-	ptrScales = new GLfloat[APPCONST::MAXIMUM_INSTANCING_COUNT];
-	memset(ptrScales, 0, APPCONST::TEMP_BUFFER_SIZE * sizeof(GLfloat));
+	ptrScales = nullptr;
+	if (!createArena(ARENA_PAGES, APPCONST::MAXIMUM_INSTANCING_COUNT))
+	{
+		createArena(ARENA_HEAP, APPCONST::MAXIMUM_INSTANCING_COUNT);
+	}
 	textOutput = new GLchar[APPCONST::TEMP_BUFFER_SIZE];
 	memset(textOutput, 0, APPCONST::TEMP_BUFFER_SIZE);
-	errorLog = new GLchar[APPCONST::TEMP_BUFFER_SIZE];
-	memset(errorLog, 0, APPCONST::TEMP_BUFFER_SIZE);
 }
 OpenGL::~OpenGL()
 {
+	stateBenchmark.release();
+	instanceFetch.release();
+	depthSorter.release();
+	cpuBurner.release();
+	renderTarget.release();
+	textureSampler.release();
+	frameCapture.release();
+	sensorSampler.stop();
+	framePacer.release();
+	if (depthQueries[0][0])
+	{
+		f.glDeleteQueries(APPCONST::DEPTH_QUERY_FRAMES * 2, &depthQueries[0][0]);
+	}
+	if (frameQueries[0][0])
+	{
+		f.glDeleteQueries(APPCONST::FRAME_QUERY_FRAMES * 2, &frameQueries[0][0]);
+	}
 	if (vao)
 	{
 		f.glDeleteVertexArrays(1, &vao);
 	}
+	if (textVao)
+	{
+		f.glDeleteVertexArrays(1, &textVao);
+	}
 	if (vbo)
 	{
 		f.glDeleteBuffers(1, &vbo);
 	}
+	if (ivbo)
+	{
+		f.glDeleteBuffers(1, &ivbo);
+	}
 	wglMakeCurrent(NULL, NULL);
 	if (hglrc)
 	{
 		wglDeleteContext(hglrc);
 	}
 	if (ptrTransfMatrixes) delete[] ptrTransfMatrixes;
-	if (ptrScales)         delete[] ptrScales;
 	if (textOutput)        delete[] textOutput;
-	if (errorLog)          delete[] errorLog;
 }
-int OpenGL::init(HWND hWnd, HDC hDC, const void* rawData, Timer* pTimer)
+int OpenGL::init(HWND hWnd, HDC hDC, const void* rawData, AtlasBlob* pAtlas, Timer* pTimer, Telemetry* pTelemetry)
 {
 	ptrTimer = pTimer;
+	ptrTelemetry = pTelemetry;
 	gpuLoadNow = APPCONST::DEFAULT_GPU_LOAD;
 	
 	PIXELFORMATDESCRIPTOR* pPfd = &pfd;
@@ -98,6 +134,9 @@ int OpenGL::init(HWND hWnd, HDC hDC, const void* rawData, Timer* pTimer)
 	snprintf(textOutput + 128 * 0 + 90, 128, szBusMBPScur);
 	snprintf(textOutput + 128 * 4 + 1,  128, szGpuLoad);
 	snprintf(textOutput + 128 * 4 + 52, 128, szDepthTest);
+	snprintf(textOutput + 128 * 4 + 92, 128, szTrace);
+	snprintf(textOutput + 128 * 6 + 1,  128, szMode);
+	snprintf(textOutput + 128 * 6 + 28, 128, szPerDrawUniform);
 
 	const char** pName = oglNamesList;
 	size_t* pFunc = reinterpret_cast<size_t*>(&f);
@@ -116,65 +155,23 @@ int OpenGL::init(HWND hWnd, HDC hDC, const void* rawData, Timer* pTimer)
 		pFunc++;
 	}
 	if(failure) return 0x105;
+	// Optional functions, unsupported entries stays nullptr.
+	pName = oglOptionalNamesList;
+	pFunc = reinterpret_cast<size_t*>(&fo);
+	while (*pName)
+	{
+		*(pFunc++) = reinterpret_cast<size_t>(wglGetProcAddress(*(pName++)));
+	}
 
-	GLuint vertexShaderId = f.glCreateShader(GL_VERTEX_SHADER);
-	if(!vertexShaderId) return 0x106;
-	f.glShaderSource(vertexShaderId, 1, &vertexShaderSource, nullptr);
-	f.glCompileShader(vertexShaderId);
-	GLint params = 0;
-	f.glGetShaderiv(vertexShaderId, GL_COMPILE_STATUS, &params);
-	if (params == GL_FALSE)
-	{
-		if (!errorLog) return 0x107;
-		char* p = errorLog;
-		GLsizei n = APPCONST::TEMP_BUFFER_SIZE;
-		GLsizei k = snprintf(p, n, "Vertex shader compiling error:\r\n");
-		p += k;
-		n -= k;
-		f.glGetShaderInfoLog(vertexShaderId, n, nullptr, p);
-		MessageBox(NULL, errorLog, nullptr, MB_ICONERROR);
-		return 0x108;
-	}
-
-	GLuint fragmentShaderId = f.glCreateShader(GL_FRAGMENT_SHADER);
-	if (!fragmentShaderId) return 0x109;
-	f.glShaderSource(fragmentShaderId, 1, &fragmentShaderSource, nullptr);
-	f.glCompileShader(fragmentShaderId);
-	params = 0;
-	f.glGetShaderiv(fragmentShaderId, GL_COMPILE_STATUS, &params);
-	if (params == GL_FALSE)
-	{
-		if (!errorLog) return 0x10A;
-		char* p = errorLog;
-		GLsizei n = APPCONST::TEMP_BUFFER_SIZE;
-		GLsizei k = snprintf(p, n, "Fragment shader compiling error:\r\n");
-		p += k;
-		n -= k;
-		f.glGetShaderInfoLog(fragmentShaderId, n, nullptr, p);
-		MessageBox(NULL, errorLog, nullptr, MB_ICONERROR);
-		return 0x10B;
-	}
-
-	shaderProgramId = f.glCreateProgram();
-	if (!shaderProgramId) return 0x10C;
-	f.glAttachShader(shaderProgramId, vertexShaderId);
-	f.glAttachShader(shaderProgramId, fragmentShaderId);
-	f.glLinkProgram(shaderProgramId);
-	f.glGetProgramiv(shaderProgramId, GL_LINK_STATUS, &params);
-	if (params == GL_FALSE)
-	{
-		if (!errorLog) return 0x10D;
-		char* p = errorLog;
-		GLsizei n = APPCONST::TEMP_BUFFER_SIZE;
-		GLsizei k = snprintf(p, n, "Shader program linking error:\r\n");
-		p += k;
-		n -= k;
-		f.glGetProgramInfoLog(shaderProgramId, n, nullptr, p);
-		MessageBox(NULL, errorLog, nullptr, MB_ICONERROR);
-		return 0x10E;
-	}
-	f.glDeleteShader(vertexShaderId);
-	f.glDeleteShader(fragmentShaderId);
+	shaderBuilder.init(&f, &fo, ptrTimer->getTscPeriod());
+	int status = shaderBuilder.build(shaderVersion, "", vertexShaderSource, fragmentShaderSource, shaderProgramId);
+	if (status) return status;
+	status = shaderBuilder.build(shaderVersion, packedDefines, vertexShaderSource, fragmentShaderSource, packedProgramId);
+	if (status) return status;
+	status = shaderBuilder.build(shaderVersion, animationDefines, vertexShaderSource, fragmentShaderSource, animationProgramId);
+	if (status) return status;
+	status = shaderBuilder.build(shaderVersion, "", textVertexShaderSource, fragmentShaderSource, textProgramId);
+	if (status) return status;
 
 	vao = 0;
 	f.glGenVertexArrays(1, &vao);
@@ -187,20 +184,28 @@ int OpenGL::init(HWND hWnd, HDC hDC, const void* rawData, Timer* pTimer)
 	f.glBindBuffer(GL_ARRAY_BUFFER, vbo);
 	if (glGetError()) return 0x112;
 
-	constexpr GLsizeiptr CUBE_MODEL_SIZE = 6 * 6 * 5 * 4;
-	constexpr GLsizei CUBE_STRIDE = 5 * 4;
-	constexpr size_t CUBE_TEXTURE_OFFSET = 3 * 4;
+	constexpr GLsizeiptr CUBE_MODEL_SIZE = APPCONST::CUBE_VERTICES * APPCONST::CUBE_STRIDE;
 	f.glBufferData(GL_ARRAY_BUFFER, CUBE_MODEL_SIZE, &verticesCube, GL_STATIC_DRAW);
 	if (glGetError()) return 0x113;
-	f.glVertexAttribPointer(0, 3, GL_FLOAT, 0, CUBE_STRIDE, 0);
+	f.glVertexAttribPointer(0, 3, GL_FLOAT, 0, APPCONST::CUBE_STRIDE, 0);
 	if (glGetError()) return 0x114;
 	f.glEnableVertexAttribArray(0);
 	if (glGetError()) return 0x115;
-	f.glVertexAttribPointer(1, 2, GL_FLOAT, 0, CUBE_STRIDE, (void*)CUBE_TEXTURE_OFFSET);
+	f.glVertexAttribPointer(1, 2, GL_FLOAT, 0, APPCONST::CUBE_STRIDE, (void*)APPCONST::CUBE_TEXTURE_OFFSET);
 	if (glGetError()) return 0x116;
 	f.glEnableVertexAttribArray(1);
 	if (glGetError()) return 0x117;
 
+	// Text quads: first cube face positions, no texture coordinates and instance stream.
+	textVao = 0;
+	f.glGenVertexArrays(1, &textVao);
+	if (!textVao) return 0x130;
+	f.glBindVertexArray(textVao);
+	f.glVertexAttribPointer(0, 3, GL_FLOAT, 0, APPCONST::CUBE_STRIDE, 0);
+	f.glEnableVertexAttribArray(0);
+	f.glBindVertexArray(vao);
+	if (glGetError()) return 0x131;
+
 	texture1 = 0;
 	glGenTextures(1, &texture1);
 	if (glGetError() || (!texture1)) return 0x118;
@@ -215,22 +220,68 @@ int OpenGL::init(HWND hWnd, HDC hDC, const void* rawData, Timer* pTimer)
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
 	if (glGetError()) return 0x11D;
 
-	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB, 
-		APPCONST::TEXTURE_WIDTH, APPCONST::TEXTURE_HEIGHT,
-		0, GL_BGRA, GL_UNSIGNED_BYTE, rawData);
+	// Baked atlas blob levels uploaded as is, otherwise mip chain generated.
+	// Stages timed until finished by GPU for startup report.
+	double msPerTick = pTimer->getTscPeriod() * 1.0E3;
+	int levelsCount = pAtlas->getLevelsCount();
+	DWORD64 t1 = __rdtsc();
+	if (levelsCount)
+	{
+		for (int i = 0; i < levelsCount; i++)
+		{
+			int levelWidth = 0;
+			int levelHeight = 0;
+			const void* levelData = pAtlas->getLevel(i, &levelWidth, &levelHeight);
+			glTexImage2D(GL_TEXTURE_2D, i, GL_RGB, levelWidth, levelHeight, 0, GL_BGRA, GL_UNSIGNED_BYTE, levelData);
+		}
+	}
+	else
+	{
+		glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB,
+			APPCONST::TEXTURE_WIDTH, APPCONST::TEXTURE_HEIGHT,
+			0, GL_BGRA, GL_UNSIGNED_BYTE, rawData);
+	}
+	glFinish();
 	if (glGetError()) return 0x11E;
-	f.glGenerateMipmap(GL_TEXTURE_2D);
-	if (glGetError()) return 0x11F;
+	DWORD64 t2 = __rdtsc();
+	if (!levelsCount)
+	{
+		f.glGenerateMipmap(GL_TEXTURE_2D);
+		glFinish();
+		if (glGetError()) return 0x11F;
+	}
+	DWORD64 t3 = __rdtsc();
+	pAtlas->setStartupMilliseconds(STARTUP_UPLOAD, (t2 - t1) * msPerTick);
+	pAtlas->setStartupMilliseconds(STARTUP_MIPMAP, (t3 - t2) * msPerTick);
 
 	f.glUseProgram(shaderProgramId);
 	if (glGetError()) return 0x120;
 	GLint location = f.glGetUniformLocation(shaderProgramId, textureName);
 	f.glUniform1i(location, 0);
 	if (glGetError()) return 0x121;
+	f.glUseProgram(packedProgramId);
+	if (glGetError()) return 0x12C;
+	location = f.glGetUniformLocation(packedProgramId, textureName);
+	f.glUniform1i(location, 0);
+	if (glGetError()) return 0x12D;
+	f.glUseProgram(animationProgramId);
+	if (glGetError()) return 0x12E;
+	location = f.glGetUniformLocation(animationProgramId, textureName);
+	f.glUniform1i(location, 0);
+	if (glGetError()) return 0x12F;
+	f.glUseProgram(textProgramId);
+	if (glGetError()) return 0x132;
+	location = f.glGetUniformLocation(textProgramId, textureName);
+	f.glUniform1i(location, 0);
+	showTextLocation = f.glGetUniformLocation(textProgramId, showTextName);
+	if (glGetError() || (showTextLocation < 0)) return 0x133;
+	f.glUseProgram(shaderProgramId);
+	activeProgramId = shaderProgramId;
+	instanceBaseLocation = f.glGetUniformLocation(shaderProgramId, instanceBaseName);
 
 	GLfloat* p = ptrScales;
 	if(!p) return 0x122;
-	for (int i = 0; i < APPCONST::MAXIMUM_INSTANCING_COUNT; i++)
+	for (size_t i = 0; i < instanceCapacity; i++)
 	{
 		*(p++) = 0.55f;
 	}
@@ -249,7 +300,7 @@ int OpenGL::init(HWND hWnd, HDC hDC, const void* rawData, Timer* pTimer)
 		}
 	}
 
-	GLuint ivbo = 0;
+	ivbo = 0;
 	f.glGenBuffers(1, &ivbo);
 	if (glGetError() || (!ivbo)) return 0x124;
 	f.glBindBuffer(GL_ARRAY_BUFFER, ivbo);
@@ -268,124 +319,1074 @@ int OpenGL::init(HWND hWnd, HDC hDC, const void* rawData, Timer* pTimer)
 	f.glVertexAttribDivisor(2, 1);
 	if (glGetError()) return 0x12B;
 
+	status = stateBenchmark.init(&f, &shaderBuilder, shaderVersion, vertexShaderSource, fragmentShaderSource,
+		texture1, vao, vbo, ivbo, rawData, ptrTimer->getTscPeriod());
+	if (status) return status;
+	status = instanceFetch.init(&f, &shaderBuilder, shaderVersion, vertexShaderSource, fragmentShaderSource);
+	if (status) return status;
+	f.glGenQueries(APPCONST::DEPTH_QUERY_FRAMES * 2, &depthQueries[0][0]);
+	if (glGetError() || (!depthQueries[0][0])) return 0x134;
+	f.glGenQueries(APPCONST::FRAME_QUERY_FRAMES * 2, &frameQueries[0][0]);
+	if (glGetError() || (!frameQueries[0][0])) return 0x135;
+	status = renderTarget.init(&f, viewRect.right, viewRect.bottom);
+	if (status) return status;
+	status = textureSampler.init(&f, &shaderBuilder, shaderVersion, texture1, viewRect.right, viewRect.bottom);
+	if (status) return status;
+	frameCapture.init(&f, viewRect.right, viewRect.bottom);
+	status = framePacer.init(&f, ptrTimer->getTscFrequency());
+	if (status) return status;
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	depthSorter.init(static_cast<int>(info.dwNumberOfProcessors));
+	cpuBurner.init(static_cast<int>(info.dwNumberOfProcessors), ptrTimer->getTscPeriod());
+	softRasterizer.init(rawData, verticesCube);
+	f.glUseProgram(shaderProgramId);
+	f.glBindBuffer(GL_ARRAY_BUFFER, ivbo);
+
+	profiler.setTscPeriod(ptrTimer->getTscPeriod());
 	ptrTimer->resetStatistics();
 	ptrTimer->startApplicationSeconds();
 	ptrTimer->startPerformanceSeconds();
 	return 0;
 }
-void OpenGL::draw(HWND hWnd, HDC hDC, unsigned int optionLoad, BOOL optionDepth)
+// Window client size changed, minimized window (zero size) keeps previous targets.
+void OpenGL::resize(GLsizei width, GLsizei height)
 {
-	double seconds = ptrTimer->getApplicationSeconds();
-	gpuLoadNow = optionLoad;
-	gpuDepthTest = optionDepth;
-	
-	glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
-	glClear(GL_COLOR_BUFFER_BIT + GL_DEPTH_BUFFER_BIT);
+	glViewport(0, 0, width, height);
+	if ((width <= 0) || (height <= 0)) return;
+	viewRect.right = width;
+	viewRect.bottom = height;
+	renderTarget.resize(width, height);
+	textureSampler.resize(width, height);
+	frameCapture.resize(width, height);
+}
+void OpenGL::draw(HWND hWnd, HDC hDC, const drawOptions& options)
+{
+	frameRecord record;
+	pacerSweepState pacerSweep = framePacer.getSweepState();
+	framePacer.select(options.framesInFlight);
+	framePacer.throttle();
+	profiler.beginFrame(record);
+	double seconds = options.seconds;
+	int frameSlot = frameQueryNext;
+	if (frameTimes)
+	{
+		readFrameQueries(frameSlot);
+		f.glQueryCounter(frameQueries[frameSlot][0], GL_TIMESTAMP);
+	}
+	// Calibration selects load, instance buffers grows above default maximum if required.
+	unsigned int load = options.load;
+	calibrationState calibration = calibrator.getState();
+	calibrator.frame(record.tsc[STAGE_BEGIN]);
+	if ((calibration == CALIBRATION_RUNNING) && (calibrator.getState() == CALIBRATION_DONE))
+	{
+		releaseUnthrottled(UNTHROTTLE_CALIBRATION);
+		calibrator.saveReport(APPCONST::CALIBRATION_REPORT_NAME);
+	}
+	targetSweepState sweep = renderTarget.getSweepState();
+	renderTarget.select(options.color, options.depth, options.samplesIndex);
+	samplingSweepState samplingSweep = textureSampler.getSweepState();
+	textureSampler.select(options.filter, options.pattern, options.workingSet);
+	burnSweepState burnSweep = cpuBurner.getSweepState();
+	cpuBurner.select(options.burn, options.burnThreads);
+	if (calibrator.getState() != CALIBRATION_IDLE)
+	{
+		load = calibrator.getLoad();
+	}
+	// Fetch paths compared in instanced mode only, they reads float instance stream.
+	// State change benchmark own vertex arrays expects float instance stream.
+	// Buffer texture path falls back to attributes above driver texels limit.
+	gpuFetchSelected = options.fetch;
+	fetchPath fetch = FETCH_ATTRIBUTE;
+	if ((options.mode == MODE_INSTANCED) && instanceFetch.getSupported(options.fetch, static_cast<GLsizei>(load)))
+	{
+		fetch = options.fetch;
+	}
+	instanceFormat format = options.format;
+	if ((options.mode == MODE_STATE_CHANGES) || (options.mode == MODE_GPU_ANIMATION) || (fetch != FETCH_ATTRIBUTE))
+	{
+		format = FORMAT_FLOAT32;
+	}
+	BOOL animation = (options.mode == MODE_GPU_ANIMATION);
+	// Depth order and render target both use samples passed queries, queries of same target can't nest.
+	depthOrder order = (options.mode == MODE_INSTANCED) ? options.depthOrdering : DEPTH_ORDER_OFF;
+	if (renderTarget.getActive() || (renderTarget.getSweepState() == TARGET_SWEEP_RUNNING))
+	{
+		order = DEPTH_ORDER_OFF;
+	}
+	BOOL animationChanged = (animation != (gpuMode == MODE_GPU_ANIMATION));
+	BOOL arenaChanged = (options.arena != gpuArenaSelected);
+	if (arenaChanged)
+	{
+		gpuArenaSelected = options.arena;
+	}
+	if (arenaChanged || (load > instanceCapacity))
+	{
+		size_t capacity = (load > instanceCapacity) ? load : instanceCapacity;
+		if (!createArena(gpuArenaSelected, capacity))
+		{
+			createArena(ARENA_PAGES, capacity);
+		}
+		if (!ptrScales)
+		{
+			// No staging memory even at default maximum: text only frames, fill and upload skipped.
+			load = createArena(ARENA_PAGES, APPCONST::MAXIMUM_INSTANCING_COUNT) ?
+				APPCONST::MAXIMUM_INSTANCING_COUNT : APPCONST::TEXT_CHARS;
+			calibrator.stop();
+		}
+		arenaChanged = TRUE;
+	}
+	if ((options.mode != gpuMode) || (load != static_cast<unsigned int>(gpuLoadNow)) ||
+		(format != gpuFormat) || (fetch != gpuFetch) || (order != gpuDepthOrder) || arenaChanged ||
+		(options.streamingStores != gpuStreaming))
+	{
+		resetArenaWindow();
+		memset(depthQueriesIssued, 0, sizeof(depthQueriesIssued));
+		depthFragments = 0;
+		depthPrepassFragments = 0;
+		depthQueryFrames = 0;
+		depthSortTicks = 0;
+		depthFrames = 0;
+		windowSubmitTicks = 0;
+		windowCubes = 0;
+		windowFrames = 0;
+		windowUploadBytes = 0;
+		windowUploadTicks = 0;
+		if (options.mode == MODE_STATE_CHANGES)
+		{
+			stateBenchmark.resetStatistics();
+		}
+	}
+	gpuLoadNow = load;
+	gpuDepthTest = options.depthTest;
+	gpuMode = options.mode;
+	gpuPerDrawUniform = options.perDrawUniform;
+	gpuDepthOrder = order;
+	gpuStreaming = options.streamingStores;
+	if ((format != gpuFormat) || (fetch != gpuFetch) || animationChanged)
+	{
+		applyInstancePath(format, fetch, animation);
+	}
+	GLsizeiptr bytesPerFrame = 0;
+	const void* uploadData = nullptr;
+	double mbpsCurrent = 0.0;
 
-	if (gpuDepthTest)
 	{
-		glEnable(GL_DEPTH_TEST);
+		ProfileZone zone(profiler, record, STAGE_SETUP);
+		renderTarget.beginFrame();
+		glClearColor(clearColor[0], clearColor[1], clearColor[2], clearColor[3]);
+		glClear(GL_COLOR_BUFFER_BIT + GL_DEPTH_BUFFER_BIT);
+
+		if (gpuDepthTest)
+		{
+			glEnable(GL_DEPTH_TEST);
+		}
+		else
+		{
+			glDisable(GL_DEPTH_TEST);
+		}
+
+		f.glActiveTexture(GL_TEXTURE0);
+		glBindTexture(GL_TEXTURE_2D, texture1);
+		f.glUseProgram(activeProgramId);
 	}
-	else
+
 	{
-		glDisable(GL_DEPTH_TEST);
+		ProfileZone zone(profiler, record, STAGE_MATRIX);
+		float xSin = static_cast<float>(sin(-seconds * 0.25));
+		float xCos = static_cast<float>(cos(-seconds * 0.25));
+		float ySin = static_cast<float>(sin(seconds * 0.5));
+		float yCos = static_cast<float>(cos(seconds * 0.5));
+		float zSin = static_cast<float>(sin(seconds * 1.5));
+		float zCos = static_cast<float>(cos(seconds * 1.5));
+		ptrTransfMatrixes[16 + 5]  =  xCos;
+		ptrTransfMatrixes[16 + 6]  = -xSin;
+		ptrTransfMatrixes[16 + 9]  =  xSin;
+		ptrTransfMatrixes[16 + 10] =  xCos;
+		ptrTransfMatrixes[32 + 0]  =  yCos;
+		ptrTransfMatrixes[32 + 2]  =  ySin;
+		ptrTransfMatrixes[32 + 8]  = -ySin;
+		ptrTransfMatrixes[32 + 10] =  yCos;
+		ptrTransfMatrixes[48 + 0]  =  zCos;
+		ptrTransfMatrixes[48 + 1]  = -zSin;
+		ptrTransfMatrixes[48 + 4]  =  zSin;
+		ptrTransfMatrixes[48 + 5]  =  zCos;
+		matrixMultiply(ptrTransfMatrixes + 16, ptrTransfMatrixes + 32, ptrTransfMatrixes);
+		matrixMultiply(ptrTransfMatrixes, ptrTransfMatrixes + 48, ptrTransfMatrixes);
 	}
 
-	f.glActiveTexture(GL_TEXTURE0);
-	glBindTexture(GL_TEXTURE_2D, texture1);
-	f.glUseProgram(shaderProgramId);
+	{
+		ProfileZone zone(profiler, record, STAGE_FILL);
+		if ((!animation) && ptrScales && (!arena.refault()))
+		{
+			// Arena pages lost at recommit, new committed pages arena, arena shown as n/a.
+			createArena(ARENA_PAGES, instanceCapacity);
+		}
+		if ((!animation) && ptrScales)
+		{
+			float scale = static_cast<float>(sin(seconds * 0.45) * 0.6);
+			// Packed formats encoder reads scales back, streamed scales would be reloaded from memory.
+			BOOL streamScales = gpuStreaming && (gpuFormat == FORMAT_FLOAT32);
+			if (gpuDepthOrder != DEPTH_ORDER_OFF)
+			{
+				// Depth order modes: jittered cube scales, sorted by depth if required.
+				size_t cubesCount = gpuLoadNow - APPCONST::TEXT_CHARS;
+				BOOL sorted = (gpuDepthOrder == DEPTH_ORDER_FRONT_TO_BACK) || (gpuDepthOrder == DEPTH_ORDER_BACK_TO_FRONT);
+				depthSorter.fill(ptrScales + APPCONST::TEXT_CHARS, cubesCount, scale, streamScales && (!sorted));
+				if (sorted)
+				{
+					DWORD64 t1 = __rdtsc();
+					depthSorter.sort(ptrScales + APPCONST::TEXT_CHARS, cubesCount, (gpuDepthOrder == DEPTH_ORDER_FRONT_TO_BACK));
+					depthSortTicks += __rdtsc() - t1;
+				}
+				depthFrames++;
+			}
+			else
+			{
+				const size_t vCount = gpuLoadNow / 4;
+				__m128* vPtr = reinterpret_cast<__m128*>(ptrScales);
+				__m128 vData = _mm_load_ps1(&scale);
+				if (streamScales)
+				{
+					// Non-temporal stores, scales not read by CPU before driver copy.
+					for (size_t i = 0; i < vCount; i++)
+					{
+						_mm_stream_ps(reinterpret_cast<float*>(vPtr++), vData);
+					}
+					_mm_sfence();
+				}
+				else
+				{
+					for (size_t i = 0; i < vCount; i++)
+					{
+						*(vPtr++) = vData;
+					}
+				}
+			}
+			// Instance stream holds cubes only, text slots of scales array are not uploaded.
+			uploadData = instanceEncoder.encode(gpuFormat, ptrScales + APPCONST::TEXT_CHARS,
+				gpuLoadNow - APPCONST::TEXT_CHARS, bytesPerFrame, gpuStreaming);
+		}
+	}
+
+	{
+		ProfileZone zone(profiler, record, STAGE_UPLOAD);
+		GLint location = f.glGetUniformLocation(activeProgramId, modelName);
+		f.glUniformMatrix4fv(location, 1, 0, ptrTransfMatrixes);
+		if (animation)
+		{
+			// Phase wrapped at CPU for float precision, shader computes same scale as CPU fill.
+			location = f.glGetUniformLocation(activeProgramId, animationPhaseName);
+			f.glUniform1f(location, static_cast<GLfloat>(fmod(seconds * 0.45, APPCONST::TWO_PI)));
+		}
+		else if (uploadData)
+		{
+			DWORD64 t1 = __rdtsc();
+			ptrTimer->startTransferSeconds();
+			if (gpuFetch == FETCH_ATTRIBUTE)
+			{
+				f.glBindBuffer(GL_ARRAY_BUFFER, ivbo);
+				f.glBufferData(GL_ARRAY_BUFFER, bytesPerFrame, uploadData, GL_DYNAMIC_DRAW);
+			}
+			else
+			{
+				instanceFetch.upload(gpuFetch, uploadData, bytesPerFrame);
+			}
+			mbpsCurrent = ptrTimer->stopTransferSeconds(bytesPerFrame);
+			windowUploadTicks += __rdtsc() - t1;
+			windowUploadBytes += bytesPerFrame;
+		}
+	}
 
-	float xSin = static_cast<float>(sin(-seconds * 0.25));
-	float xCos = static_cast<float>(cos(-seconds * 0.25));
-	float ySin = static_cast<float>(sin(seconds * 0.5));
-	float yCos = static_cast<float>(cos(seconds * 0.5));
-	float zSin = static_cast<float>(sin(seconds * 1.5));
-	float zCos = static_cast<float>(cos(seconds * 1.5));
-	ptrTransfMatrixes[16 + 5]  =  xCos;
-	ptrTransfMatrixes[16 + 6]  = -xSin;
-	ptrTransfMatrixes[16 + 9]  =  xSin;
-	ptrTransfMatrixes[16 + 10] =  xCos;
-	ptrTransfMatrixes[32 + 0]  =  yCos;
-	ptrTransfMatrixes[32 + 2]  =  ySin;
-	ptrTransfMatrixes[32 + 8]  = -ySin;
-	ptrTransfMatrixes[32 + 10] =  yCos;
-	ptrTransfMatrixes[48 + 0]  =  zCos;
-	ptrTransfMatrixes[48 + 1]  = -zSin;
-	ptrTransfMatrixes[48 + 4]  =  zSin;
-	ptrTransfMatrixes[48 + 5]  =  zCos;
-	matrixMultiply(ptrTransfMatrixes + 16, ptrTransfMatrixes + 32, ptrTransfMatrixes);
-	matrixMultiply(ptrTransfMatrixes, ptrTransfMatrixes + 48, ptrTransfMatrixes);
-
-	float scale = static_cast<float>(sin(seconds * 0.45) * 0.6);
-	const size_t vCount = gpuLoadNow / 4;
-	__m128* vPtr = reinterpret_cast<__m128*>(ptrScales);
-	__m128 vData = _mm_load_ps1(&scale);
-	for (size_t i = 0; i < vCount; i++)
-	{
-		*(vPtr++) = vData;
-	}
-
-	GLsizeiptr bytesPerFrame = gpuLoadNow * 4;
-	GLint location = f.glGetUniformLocation(shaderProgramId, modelName);
-	f.glUniformMatrix4fv(location, 1, 0, ptrTransfMatrixes);
-	ptrTimer->startTransferSeconds();
-	f.glBufferData(GL_ARRAY_BUFFER, bytesPerFrame, ptrScales, GL_DYNAMIC_DRAW);
-	double mbpsCurrent = ptrTimer->stopTransferSeconds(bytesPerFrame);
+	{
+		ProfileZone zone(profiler, record, STAGE_DRAW);
+		drawCubes(static_cast<GLsizei>(gpuLoadNow) - APPCONST::TEXT_CHARS);
+		renderTarget.endFrame(static_cast<unsigned int>(gpuLoadNow) - APPCONST::TEXT_CHARS);
+		if (textureSampler.getActive())
+		{
+			textureSampler.draw();
+			f.glBindVertexArray(vao);
+			f.glUseProgram(activeProgramId);
+		}
+		drawText();
+		if (frameTimes)
+		{
+			f.glQueryCounter(frameQueries[frameSlot][1], GL_TIMESTAMP);
+			frameQueriesIssued[frameSlot] = TRUE;
+			frameQuerySequence[frameSlot] = frameSequence++;
+			frameQueryNext = (frameSlot + 1) % APPCONST::FRAME_QUERY_FRAMES;
+		}
+	}
+	if ((sweep == TARGET_SWEEP_RUNNING) && (renderTarget.getSweepState() == TARGET_SWEEP_DONE))
+	{
+		releaseUnthrottled(UNTHROTTLE_TARGET_SWEEP);
+		renderTarget.saveReport(APPCONST::TARGET_REPORT_NAME);
+	}
+	if ((samplingSweep == SAMPLING_SWEEP_RUNNING) && (textureSampler.getSweepState() == SAMPLING_SWEEP_DONE))
+	{
+		releaseUnthrottled(UNTHROTTLE_SAMPLING_SWEEP);
+		textureSampler.saveSweepReport(APPCONST::SAMPLING_SWEEP_REPORT_NAME);
+	}
+	// Capture outside of stage zones, swap stage time excludes it.
+	record.captureTicks = frameCapture.frame();
 
-	f.glBindVertexArray(vao);
-	constexpr GLint ARRAY_COUNT = 6 * 6;
-	f.glDrawArraysInstanced(GL_TRIANGLES, 0, ARRAY_COUNT, static_cast<GLsizei>(gpuLoadNow));
-	SwapBuffers(hDC);
+	{
+		ProfileZone zone(profiler, record, STAGE_SWAP);
+		SwapBuffers(hDC);
+		framePacer.endFrame(record.tsc[STAGE_BEGIN]);
+	}
 
-	snprintf(textOutput + 128 * 4 + 36, 128, "%I64d       ", (long long)gpuLoadNow);
-	const char* szOnOff;
-	if (gpuDepthTest)
 	{
-		szOnOff = szDepthOn;
+		ProfileZone zone(profiler, record, STAGE_TEXT);
+		snprintf(textOutput + 128 * 4 + 36, 128, "%I64d       ", (long long)gpuLoadNow);
+		const char* szOnOff;
+		if (gpuDepthTest)
+		{
+			szOnOff = szDepthOn;
+		}
+		else
+		{
+			szOnOff = szDepthOff;
+		}
+		snprintf(textOutput + 128 * 4 + 82, 128, "%s   ", szOnOff);
+		snprintf(textOutput + 128 * 4 + 106, 128, "%s   ", szTraceModes[ptrTelemetry->getFormat()]);
+		snprintf(textOutput + 128 * 5 + 113, 15, "%s%-4s", szFormat, szFormatNames[gpuFormat]);
+		snprintf(textOutput + 128 * 4 + 112, 16, "%s%-6s", szArena,
+			(arena.getKind() == gpuArenaSelected) ? szArenaNames[arena.getKind()] : szArenaFailed);
+
+		double busTrafficSeconds = ptrTimer->getTransferSeconds();
+		double megabytesCount = ptrTimer->getMegabytesCount();
+		double mbpsAverage = ptrTimer->getAverageMBPS();
+		double elapsedSeconds = ptrTimer->getPerformanceSeconds();
+
+		snprintf(textOutput + 128 * 3 + 112, 128, "%.2f    ", busTrafficSeconds);
+		snprintf(textOutput + 128 * 2 + 112, 128, "%.2f    ", megabytesCount);
+		snprintf(textOutput + 128 * 1 + 112, 128, "%.2f    ", mbpsAverage);
+		if (ptrTimer->antiBlinkMBPS())
+		{
+			snprintf(textOutput + 128 * 0 + 112, 128, "%.2f    ", mbpsCurrent);
+		}
+		snprintf(textOutput + 128 * 3 + 73, 128, "%.1f    ", elapsedSeconds);
+		DWORD64 framesCount = ptrTimer->getFramesCount();
+		snprintf(textOutput + 128 * 2 + 73, 128, "%I64u ", framesCount);
+
+		if (framesCount)
+		{
+			double fpsAverage = ptrTimer->getAverageFPS();
+			double fpsCurrent = ptrTimer->stopFrameSeconds();
+			snprintf(textOutput + 128 * 1 + 73, 128, "%.1f    ", fpsAverage);
+			if (ptrTimer->antiBlinkFPS())
+			{
+				snprintf(textOutput + 128 * 0 + 73, 128, "%.1f    ", fpsCurrent);
+				writeProfileRow();
+				writeModeRow(fpsCurrent);
+				updateArenaResult();
+			}
+		}
+		ptrTimer->startFrameSeconds();
+		uploadText();
+	}
+
+	profiler.endFrame(record);
+	cpuBurner.frame(animation ? 0 : bytesPerFrame, animation ? 0 : profiler.getFrameTicks(STAGE_UPLOAD));
+	sensorSampler.frame(static_cast<DWORD32>(gpuLoadNow) - APPCONST::TEXT_CHARS);
+	if ((pacerSweep == PACER_SWEEP_RUNNING) && (framePacer.getSweepState() == PACER_SWEEP_DONE))
+	{
+		framePacer.saveSweepReport(APPCONST::PACER_REPORT_NAME, reinterpret_cast<const char*>(glGetString(GL_RENDERER)),
+			fo.wglGetSwapIntervalEXT ? fo.wglGetSwapIntervalEXT() : -1);
+	}
+	if ((burnSweep == BURN_SWEEP_RUNNING) && (cpuBurner.getSweepState() == BURN_SWEEP_DONE))
+	{
+		releaseUnthrottled(UNTHROTTLE_BURN_SWEEP);
+		cpuBurner.saveSweepReport(APPCONST::BURN_REPORT_NAME);
+	}
+	if ((!animation) && uploadData)
+	{
+		arenaFillTicks += profiler.getFrameTicks(STAGE_FILL);
+		arenaFillBytes += gpuLoadNow * sizeof(GLfloat) + ((uploadData != (ptrScales + APPCONST::TEXT_CHARS)) ? bytesPerFrame : 0);
+		arenaUploadTicks += profiler.getFrameTicks(STAGE_UPLOAD);
+		arenaUploadBytes += bytesPerFrame;
+		arenaFrames++;
+	}
+	record.frameIndex = 0;
+	record.bytesUploaded = bytesPerFrame;
+	record.instanceCount = static_cast<DWORD32>(gpuLoadNow);
+	record.depthMode = static_cast<DWORD32>(gpuDepthTest | (gpuDepthOrder << 1));
+	ptrTelemetry->push(record);
+}
+// Cubes draw, submit CPU time accumulated for mode results.
+// Cube position ID is (gl_InstanceID + instanceBase), starts from TEXT_CHARS,
+// instance stream index is gl_InstanceID.
+void OpenGL::drawCubes(GLsizei cubesCount)
+{
+	constexpr GLint ARRAY_COUNT = APPCONST::CUBE_VERTICES;
+	f.glBindVertexArray(vao);
+	f.glUniform1i(instanceBaseLocation, APPCONST::TEXT_CHARS);
+	DWORD64 t1 = __rdtsc();
+	if (gpuMode == MODE_DRAW_CALLS)
+	{
+		if (gpuPerDrawUniform)
+		{
+			for (GLsizei i = 0; i < cubesCount; i++)
+			{
+				f.glUniform1i(instanceBaseLocation, APPCONST::TEXT_CHARS + i);
+				glDrawArrays(GL_TRIANGLES, 0, ARRAY_COUNT);
+			}
+		}
+		else
+		{
+			for (GLsizei i = 0; i < cubesCount; i++)
+			{
+				glDrawArrays(GL_TRIANGLES, 0, ARRAY_COUNT);
+			}
+		}
+	}
+	else if (gpuMode == MODE_STATE_CHANGES)
+	{
+		stateBenchmark.draw(ptrTransfMatrixes);
+		f.glUseProgram(activeProgramId);
+		f.glBindVertexArray(vao);
+		glBindTexture(GL_TEXTURE_2D, texture1);
+		return;
+	}
+	else if (gpuDepthOrder != DEPTH_ORDER_OFF)
+	{
+		drawDepthOrdered(cubesCount);
 	}
 	else
 	{
-		szOnOff = szDepthOff;
+		drawInstances(cubesCount);
+	}
+	windowSubmitTicks += __rdtsc() - t1;
+	windowCubes += cubesCount;
+	windowFrames++;
+}
+// Instanced cubes draw by attribute or fetch path.
+void OpenGL::drawInstances(GLsizei cubesCount)
+{
+	if (gpuFetch != FETCH_ATTRIBUTE)
+	{
+		instanceFetch.draw(gpuFetch, cubesCount, instanceBaseLocation);
+	}
+	else
+	{
+		f.glDrawArraysInstanced(GL_TRIANGLES, 0, APPCONST::CUBE_VERTICES, cubesCount);
+	}
+}
+// Depth order modes: samples passed counted for color pass and depth prepass.
+// Prepass draws depth only, color pass then shades visible fragments only,
+// by EQUAL depth test without depth write, same program gives same depth.
+void OpenGL::drawDepthOrdered(GLsizei cubesCount)
+{
+	int slot = depthQueryNext;
+	readDepthQueries(slot);
+	BOOL prepass = gpuDepthTest && (gpuDepthOrder == DEPTH_ORDER_PREPASS);
+	if (prepass)
+	{
+		glColorMask(GL_FALSE, GL_FALSE, GL_FALSE, GL_FALSE);
+		f.glBeginQuery(GL_SAMPLES_PASSED, depthQueries[slot][1]);
+		drawInstances(cubesCount);
+		f.glEndQuery(GL_SAMPLES_PASSED);
+		glColorMask(GL_TRUE, GL_TRUE, GL_TRUE, GL_TRUE);
+		glDepthMask(GL_FALSE);
+		glDepthFunc(GL_EQUAL);
+	}
+	f.glBeginQuery(GL_SAMPLES_PASSED, depthQueries[slot][0]);
+	drawInstances(cubesCount);
+	f.glEndQuery(GL_SAMPLES_PASSED);
+	if (prepass)
+	{
+		glDepthMask(GL_TRUE);
+		glDepthFunc(GL_LESS);
+	}
+	depthQueriesIssued[slot] = prepass ? 2 : 1;
+	depthQueryNext = (slot + 1) % APPCONST::DEPTH_QUERY_FRAMES;
+}
+// Queries of frame slot read before slot reuse, DEPTH_QUERY_FRAMES frames later,
+// results not ready yet are skipped, no wait for GPU.
+void OpenGL::readDepthQueries(int slot)
+{
+	if (!depthQueriesIssued[slot]) return;
+	GLuint available = 0;
+	f.glGetQueryObjectuiv(depthQueries[slot][depthQueriesIssued[slot] - 1], GL_QUERY_RESULT_AVAILABLE, &available);
+	if (available)
+	{
+		DWORD64 samples = 0;
+		f.glGetQueryObjectui64v(depthQueries[slot][0], GL_QUERY_RESULT, &samples);
+		depthFragments += samples;
+		if (depthQueriesIssued[slot] == 2)
+		{
+			samples = 0;
+			f.glGetQueryObjectui64v(depthQueries[slot][1], GL_QUERY_RESULT, &samples);
+			depthPrepassFragments += samples;
+		}
+		depthQueryFrames++;
+	}
+	depthQueriesIssued[slot] = 0;
+}
+// Depth order row: fragments shaded per frame, overdraw relative to visible fragments
+// of prepass color pass at same load, sort CPU time.
+void OpenGL::writeDepthRow(char* p, double cubesPerSecond)
+{
+	double fragments = depthQueryFrames ? (static_cast<double>(depthFragments) / depthQueryFrames) : 0.0;
+	double prepassFragments = depthQueryFrames ? (static_cast<double>(depthPrepassFragments) / depthQueryFrames) : 0.0;
+	double sortMicroseconds = depthFrames ? (depthSortTicks * ptrTimer->getTscPeriod() * 1.0E6 / depthFrames) : 0.0;
+	depthFragments = 0;
+	depthPrepassFragments = 0;
+	depthQueryFrames = 0;
+	depthSortTicks = 0;
+	depthFrames = 0;
+
+	unsigned int load = static_cast<unsigned int>(gpuLoadNow);
+	depthResult* pResult = nullptr;
+	const depthResult* pVisible = nullptr;
+	for (int i = 0; i < APPCONST::DEPTH_RESULT_SLOTS; i++)
+	{
+		if (depthResults[i].load != load) continue;
+		if ((depthResults[i].order == gpuDepthOrder) && (depthResults[i].depthTest == gpuDepthTest)) pResult = &depthResults[i];
+		if ((depthResults[i].order == DEPTH_ORDER_PREPASS) && depthResults[i].depthTest) pVisible = &depthResults[i];
+	}
+	if (!pResult)
+	{
+		pResult = &depthResults[depthResultNext];
+		depthResultNext = (depthResultNext + 1) % APPCONST::DEPTH_RESULT_SLOTS;
 	}
-	snprintf(textOutput + 128 * 4 + 82, 128, "%s   ", szOnOff);
+	pResult->load = load;
+	pResult->order = gpuDepthOrder;
+	pResult->depthTest = gpuDepthTest;
+	pResult->instancesPerSecond = cubesPerSecond;
+	pResult->fragmentsPerFrame = fragments;
+	pResult->prepassFragmentsPerFrame = prepassFragments;
+	pResult->sortMicroseconds = sortMicroseconds;
 
-	double busTrafficSeconds = ptrTimer->getTransferSeconds();
-	double megabytesCount = ptrTimer->getMegabytesCount();
-	double mbpsAverage = ptrTimer->getAverageMBPS();
-	double elapsedSeconds = ptrTimer->getPerformanceSeconds();
+	char szResults[APPCONST::MAX_TEXT_STRING];
+	if (gpuDepthOrder == DEPTH_ORDER_PREPASS)
+	{
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "%s%-4s Minst/s %-7.3f Mfrag %-8.3f Pre %-8.3f",
+			szDepthOrder, szDepthOrderNames[gpuDepthOrder], cubesPerSecond / 1.0E6, fragments / 1.0E6, prepassFragments / 1.0E6);
+	}
+	else if (pVisible && (pVisible->fragmentsPerFrame > 0.0))
+	{
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "%s%-4s Minst/s %-7.3f Mfrag %-8.3f OD %-6.2f Sort us %-8.1f",
+			szDepthOrder, szDepthOrderNames[gpuDepthOrder], cubesPerSecond / 1.0E6, fragments / 1.0E6,
+			fragments / pVisible->fragmentsPerFrame, sortMicroseconds);
+	}
+	else
+	{
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "%s%-4s Minst/s %-7.3f Mfrag %-8.3f OD n/a Sort us %-8.1f",
+			szDepthOrder, szDepthOrderNames[gpuDepthOrder], cubesPerSecond / 1.0E6, fragments / 1.0E6, sortMicroseconds);
+	}
+	snprintf(p, 74, "%-73s", szResults);
+}
+// Text overlay, separate small instanced draw: own program and vertex array,
+// depth test off, cube shader has no text branch.
+void OpenGL::drawText()
+{
+	if (gpuDepthTest)
+	{
+		glDisable(GL_DEPTH_TEST);
+	}
+	f.glUseProgram(textProgramId);
+	f.glBindVertexArray(textVao);
+	f.glDrawArraysInstanced(GL_TRIANGLES, 0, APPCONST::TEXT_QUAD_VERTICES, APPCONST::TEXT_CHARS);
+	f.glBindVertexArray(vao);
+	f.glUseProgram(activeProgramId);
+}
+// Upload source buffers: float instance stream and encoded stream at one arena.
+// Encoded stream is not above 2 bytes per instance, plus tail of last SSE block.
+BOOL OpenGL::createArena(arenaKind kind, size_t capacity)
+{
+	const size_t scalesBytes = capacity * sizeof(GLfloat);
+	const size_t encoderBytes = capacity * 2 + 64;
+	BOOL status = arena.create(kind, scalesBytes + encoderBytes + APPCONST::CACHE_LINE_SIZE * 2);
+	ptrScales = static_cast<GLfloat*>(arena.allocate(scalesBytes));
+	BYTE* pEncoder = static_cast<BYTE*>(arena.allocate(encoderBytes));
+	instanceEncoder.setBuffer(pEncoder, encoderBytes);
+	instanceCapacity = ptrScales ? capacity : 0;
+	return status && ptrScales;
+}
+void OpenGL::resetArenaWindow()
+{
+	arenaFillTicks = 0;
+	arenaFillBytes = 0;
+	arenaUploadTicks = 0;
+	arenaUploadBytes = 0;
+	arenaFrames = 0;
+	arenaFaults = StagingArena::getPageFaults();
+}
+// Fill and upload stages per-frame times and page faults for display update interval,
+// process page faults include faults of driver at upload.
+void OpenGL::updateArenaResult()
+{
+	if (!arenaFrames) return;
+	double tscPeriod = ptrTimer->getTscPeriod();
+	DWORD faults = StagingArena::getPageFaults();
+	arenaResult* pResult = nullptr;
+	for (int i = 0; i < APPCONST::ARENA_RESULT_SLOTS; i++)
+	{
+		if ((arenaResults[i].load == static_cast<unsigned int>(gpuLoadNow)) && (arenaResults[i].kind == arena.getKind()) &&
+			(arenaResults[i].streaming == gpuStreaming) && (arenaResults[i].node == arena.getNode()))
+		{
+			pResult = &arenaResults[i];
+			break;
+		}
+	}
+	if (!pResult)
+	{
+		pResult = &arenaResults[arenaResultNext];
+		arenaResultNext = (arenaResultNext + 1) % APPCONST::ARENA_RESULT_SLOTS;
+	}
+	pResult->load = static_cast<unsigned int>(gpuLoadNow);
+	pResult->kind = arena.getKind();
+	pResult->node = arena.getNode();
+	pResult->streaming = gpuStreaming;
+	pResult->fillMicroseconds = arenaFillTicks * tscPeriod * 1.0E6 / arenaFrames;
+	pResult->fillGigabytesPerSecond = arenaFillTicks ? (arenaFillBytes / (arenaFillTicks * tscPeriod) / 1.0E9) : 0.0;
+	pResult->uploadMicroseconds = arenaUploadTicks * tscPeriod * 1.0E6 / arenaFrames;
+	pResult->uploadMegabytesPerSecond = arenaUploadTicks ? (arenaUploadBytes / 1048576.0 / (arenaUploadTicks * tscPeriod)) : 0.0;
+	pResult->faultsPerFrame = static_cast<double>(faults - arenaFaults) / arenaFrames;
+	arenaFillTicks = 0;
+	arenaFillBytes = 0;
+	arenaUploadTicks = 0;
+	arenaUploadBytes = 0;
+	arenaFrames = 0;
+	arenaFaults = faults;
+}
+// Text chars packed to integer uniforms array of text program.
+void OpenGL::uploadText()
+{
+	f.glUseProgram(textProgramId);
+	f.glUniform1iv(showTextLocation, APPCONST::TEXT_DWORDS, reinterpret_cast<const GLint*>(textOutput));
+	f.glUseProgram(activeProgramId);
+}
+// Instance stream attribute layout and matched program, packed format
+// needs shader variant which selects component of element by instance index,
+// other fetch paths and GPU animation have own shader variants.
+void OpenGL::applyInstancePath(instanceFormat format, fetchPath fetch, BOOL animation)
+{
+	const instanceLayout& layout = InstanceEncoder::layouts[format];
+	gpuFormat = format;
+	gpuFetch = fetch;
+	activeProgramId = (format == FORMAT_SNORM10_PACKED) ? packedProgramId : shaderProgramId;
+	if (fetch != FETCH_ATTRIBUTE)
+	{
+		activeProgramId = instanceFetch.getProgram(fetch);
+	}
+	if (animation)
+	{
+		activeProgramId = animationProgramId;
+	}
+	f.glUseProgram(activeProgramId);
+	instanceBaseLocation = f.glGetUniformLocation(activeProgramId, instanceBaseName);
+	f.glBindVertexArray(vao);
+	f.glBindBuffer(GL_ARRAY_BUFFER, ivbo);
+	f.glVertexAttribPointer(2, layout.size, layout.type, layout.normalized, layout.bytesPerElement, 0);
+	f.glVertexAttribDivisor(2, layout.divisor);
+}
+// Mode row: draw calls rate and CPU time per draw, compared with instanced mode at same load.
+void OpenGL::writeModeRow(double fps)
+{
+	char* p = textOutput + 128 * 6;
+	snprintf(p + 14, 128, "%-12s", szModeNames[gpuMode]);
+	snprintf(p + 49, 128, "%-4s", gpuPerDrawUniform ? szDepthOn : szDepthOff);
+	if (calibrator.getState() != CALIBRATION_IDLE)
+	{
+		calibrator.writeRow(p + 54, 74);
+		return;
+	}
+	if (frameCapture.getFormat() != CAPTURE_OFF)
+	{
+		frameCapture.writeRow(p + 54, 74, ptrTimer->getTscPeriod(), fps);
+		return;
+	}
+	if (sensorSampler.getActive())
+	{
+		sensorSampler.writeRow(p + 54, 74);
+		return;
+	}
+	if ((cpuBurner.getKind() != BURN_OFF) || (cpuBurner.getSweepState() != BURN_SWEEP_OFF))
+	{
+		cpuBurner.writeRow(p + 54, 74);
+		return;
+	}
+	if (framePacer.getLimit() || (framePacer.getSweepState() != PACER_SWEEP_OFF))
+	{
+		framePacer.writeRow(p + 54, 74);
+		return;
+	}
+	if (renderTarget.getActive() || (renderTarget.getSweepState() != TARGET_SWEEP_OFF))
+	{
+		renderTarget.writeRow(p + 54, 74);
+		return;
+	}
+	if (textureSampler.getActive() || (textureSampler.getSweepState() != SAMPLING_SWEEP_OFF))
+	{
+		textureSampler.writeRow(p + 54, 74);
+		return;
+	}
+	if (gpuMode == MODE_STATE_CHANGES)
+	{
+		stateBenchmark.writeRow(p + 54, 74);
+		return;
+	}
+	if ((!windowFrames) || (!windowCubes)) return;
+	double cubesPerFrame = static_cast<double>(windowCubes) / windowFrames;
+	double nsPerCube = windowSubmitTicks * ptrTimer->getTscPeriod() * 1.0E9 / windowCubes;
+	double cubesPerSecond = cubesPerFrame * fps;
+	double megabytesPerSecond = 0.0;
+	if (windowUploadTicks)
+	{
+		megabytesPerSecond = windowUploadBytes / 1048576.0 / (windowUploadTicks * ptrTimer->getTscPeriod());
+	}
+	windowSubmitTicks = 0;
+	windowCubes = 0;
+	windowFrames = 0;
+	windowUploadBytes = 0;
+	windowUploadTicks = 0;
 
-	snprintf(textOutput + 128 * 3 + 112, 128, "%.2f    ", busTrafficSeconds);
-	snprintf(textOutput + 128 * 2 + 112, 128, "%.2f    ", megabytesCount);
-	snprintf(textOutput + 128 * 1 + 112, 128, "%.2f    ", mbpsAverage);
-	if (ptrTimer->antiBlinkMBPS())
+	if (gpuDepthOrder != DEPTH_ORDER_OFF)
 	{
-		snprintf(textOutput + 128 * 0 + 112, 128, "%.2f    ", mbpsCurrent);
+		writeDepthRow(p + 54, cubesPerSecond);
+		return;
 	}
-	snprintf(textOutput + 128 * 3 + 73, 128, "%.1f    ", elapsedSeconds);
-	DWORD64 framesCount = ptrTimer->getFramesCount();
-	snprintf(textOutput + 128 * 2 + 73, 128, "%I64u ", framesCount);
 
-	if (framesCount)
+	instancedReference* pRef = nullptr;
+	for (int i = 0; i < APPCONST::REFERENCE_SLOTS; i++)
 	{
-		double fpsAverage = ptrTimer->getAverageFPS();
-		double fpsCurrent = ptrTimer->stopFrameSeconds();
-		snprintf(textOutput + 128 * 1 + 73, 128, "%.1f    ", fpsAverage);
-		if (ptrTimer->antiBlinkFPS())
+		if (references[i].load == static_cast<unsigned int>(gpuLoadNow))
 		{
-			snprintf(textOutput + 128 * 0 + 73, 128, "%.1f    ", fpsCurrent);
+			pRef = &references[i];
+			break;
 		}
 	}
-	ptrTimer->startFrameSeconds();
+	char szResults[APPCONST::MAX_TEXT_STRING];
+	if (gpuMode == MODE_INSTANCED)
+	{
+		if (!pRef)
+		{
+			pRef = &references[referenceNext];
+			referenceNext = (referenceNext + 1) % APPCONST::REFERENCE_SLOTS;
+		}
+		pRef->load = static_cast<unsigned int>(gpuLoadNow);
+		pRef->instancesPerSecond = cubesPerSecond;
+		pRef->nsPerInstance = nsPerCube;
 
-	GLchar szTextIndex[APPCONST::MAX_TEXT_STRING];
-	GLint* ptrTextDwords = reinterpret_cast<GLint*>(textOutput);
-	for (int i = 0; i < (128 + 32); i++)
+		instanceResult* pResult = nullptr;
+		for (int i = 0; i < APPCONST::INSTANCE_RESULT_SLOTS; i++)
+		{
+			if ((instanceResults[i].load == pRef->load) && (instanceResults[i].format == gpuFormat) &&
+				(instanceResults[i].fetch == gpuFetch))
+			{
+				pResult = &instanceResults[i];
+				break;
+			}
+		}
+		if (!pResult)
+		{
+			pResult = &instanceResults[instanceResultNext];
+			instanceResultNext = (instanceResultNext + 1) % APPCONST::INSTANCE_RESULT_SLOTS;
+		}
+		pResult->format = gpuFormat;
+		pResult->fetch = gpuFetch;
+		pResult->load = pRef->load;
+		pResult->instancesPerSecond = cubesPerSecond;
+		pResult->megabytesPerSecond = megabytesPerSecond;
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "%s%-4s Minst/s %-7.3f ns/inst %-6.3f Upload MB/s %-8.1f",
+			szFetch, szFetchNames[gpuFetch], cubesPerSecond / 1.0E6, nsPerCube, megabytesPerSecond);
+		if (gpuFetch != gpuFetchSelected)
+		{
+			snprintf(szResults, APPCONST::MAX_TEXT_STRING, "%s%-4s not supported", szFetch, szFetchNames[gpuFetchSelected]);
+		}
+	}
+	else if (gpuMode == MODE_GPU_ANIMATION)
+	{
+		if (pRef)
+		{
+			snprintf(szResults, APPCONST::MAX_TEXT_STRING, "Minst/s %-7.3f ns/inst %-6.3f | Stream Minst/s %-7.3f ns/inst %-6.3f",
+				cubesPerSecond / 1.0E6, nsPerCube, pRef->instancesPerSecond / 1.0E6, pRef->nsPerInstance);
+		}
+		else
+		{
+			snprintf(szResults, APPCONST::MAX_TEXT_STRING, "Minst/s %-7.3f ns/inst %-6.3f | Stream not measured",
+				cubesPerSecond / 1.0E6, nsPerCube);
+		}
+	}
+	else if (pRef)
+	{
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "Mdraws/s %-7.3f ns/draw %-7.1f | Inst Minst/s %-7.3f ns/inst %-6.3f",
+			cubesPerSecond / 1.0E6, nsPerCube, pRef->instancesPerSecond / 1.0E6, pRef->nsPerInstance);
+	}
+	else
+	{
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "Mdraws/s %-7.3f ns/draw %-7.1f | Inst not measured",
+			cubesPerSecond / 1.0E6, nsPerCube);
+	}
+	snprintf(p + 54, 74, "%-73s", szResults);
+}
+// Save results tables of benchmarks which have measured data.
+void OpenGL::saveReports()
+{
+	stateBenchmark.saveReport(APPCONST::STATE_REPORT_NAME);
+	textureSampler.saveReport(APPCONST::SAMPLING_REPORT_NAME);
+	report.clear();
+	report.add("fetch path,format,bytes per instance,instances,Minst/s,upload MB/s,Minst per upload MB\r\n");
+	for (int i = 0; i < APPCONST::INSTANCE_RESULT_SLOTS; i++)
+	{
+		const instanceResult& r = instanceResults[i];
+		if (!r.load) continue;
+		const instanceLayout& layout = InstanceEncoder::layouts[r.format];
+		double ratio = (r.megabytesPerSecond > 0.0) ? (r.instancesPerSecond / 1.0E6 / r.megabytesPerSecond) : 0.0;
+		report.add("%s,%s,%.3f,%u,%.3f,%.1f,%.4f\r\n", szFetchNames[r.fetch], szFormatNames[r.format],
+			static_cast<double>(layout.bytesPerElement) / layout.divisor, r.load,
+			r.instancesPerSecond / 1.0E6, r.megabytesPerSecond, ratio);
+	}
+	report.save(APPCONST::INSTANCE_REPORT_NAME);
+	report.clear();
+	report.add("arena,NUMA node,page bytes,stores,instances,fill us/frame,fill GB/s,upload us/frame,upload MB/s,page faults/frame\r\n");
+	for (int i = 0; i < APPCONST::ARENA_RESULT_SLOTS; i++)
+	{
+		const arenaResult& r = arenaResults[i];
+		if (!r.load) continue;
+		report.add("%s,%u,%s,%s,%u,%.1f,%.2f,%.1f,%.1f,%.1f\r\n", szArenaNames[r.kind], r.node,
+			(r.kind == ARENA_LARGE_PAGES) ? "2M" : "4K", r.streaming ? "stream" : "cached", r.load, r.fillMicroseconds, r.fillGigabytesPerSecond,
+			r.uploadMicroseconds, r.uploadMegabytesPerSecond, r.faultsPerFrame);
+	}
+	report.save(APPCONST::ARENA_REPORT_NAME);
+	report.clear();
+	report.add("depth order,depth test,instances,Minst/s,fragments/frame,prepass fragments/frame,overdraw,sort us/frame\r\n");
+	for (int i = 0; i < APPCONST::DEPTH_RESULT_SLOTS; i++)
+	{
+		const depthResult& r = depthResults[i];
+		if (!r.load) continue;
+		double visible = 0.0;
+		for (int j = 0; j < APPCONST::DEPTH_RESULT_SLOTS; j++)
+		{
+			if ((depthResults[j].load == r.load) && (depthResults[j].order == DEPTH_ORDER_PREPASS) && depthResults[j].depthTest)
+			{
+				visible = depthResults[j].fragmentsPerFrame;
+			}
+		}
+		report.add("%s,%s,%u,%.3f,%.0f,%.0f,%.3f,%.1f\r\n", szDepthOrderNames[r.order], r.depthTest ? "on" : "off",
+			r.load, r.instancesPerSecond / 1.0E6, r.fragmentsPerFrame, r.prepassFragmentsPerFrame,
+			(visible > 0.0) ? (r.fragmentsPerFrame / visible) : 0.0, r.sortMicroseconds);
+	}
+	report.save(APPCONST::DEPTH_REPORT_NAME);
+}
+// Shader compile, link and binary load times, long operation, blocks rendering.
+BOOL OpenGL::benchmarkShaders()
+{
+	BOOL status = shaderBuilder.benchmark(APPCONST::SHADER_REPORT_NAME);
+	f.glUseProgram(activeProgramId);
+	return status;
+}
+// CPU reference render of current frame scene, long operation, blocks rendering.
+BOOL OpenGL::benchmarkSoftware()
+{
+	if (!ptrScales) return FALSE;
+	return softRasterizer.benchmark(ptrTransfMatrixes, ptrScales, static_cast<unsigned int>(gpuLoadNow),
+		gpuDepthTest, ptrTimer->getTscPeriod());
+}
+// CPU memory bandwidth at block sizes up to DRAM, compared with average bus upload rate, long operation, blocks rendering.
+BOOL OpenGL::benchmarkBandwidth()
+{
+	double busMegabytesPerSecond = (ptrTimer->getTransferSeconds() > 0.0) ? ptrTimer->getAverageMBPS() : 0.0;
+	return memoryBandwidth.benchmark(APPCONST::BANDWIDTH_REPORT_NAME, ptrTimer->getTscPeriod(), busMegabytesPerSecond);
+}
+// Calibration start at current options, or stop of running or finished calibration.
+// Vertical sync limits frame rate by display refresh, disabled while calibration runs.
+void OpenGL::switchCalibration(double targetFps, unsigned int startLoad)
+{
+	if (calibrator.getState() != CALIBRATION_IDLE)
+	{
+		releaseUnthrottled(UNTHROTTLE_CALIBRATION);
+		calibrator.stop();
+		return;
+	}
+	char description[APPCONST::MAX_TEXT_STRING];
+	snprintf(description, APPCONST::MAX_TEXT_STRING, "%s %s %s depth %s arena %s", szModeNames[gpuMode],
+		szFormatNames[gpuFormat], szFetchNames[gpuFetch], gpuDepthTest ? "on" : "off", szArenaNames[arena.getKind()]);
+	acquireUnthrottled(UNTHROTTLE_CALIBRATION);
+	calibrator.start(targetFps, startLoad, description, ptrTimer->getTscPeriod());
+}
+// Render target formats sweep start at current load and options, or stop of running or finished sweep.
+// Vertical sync disabled while sweep runs.
+void OpenGL::switchTargetSweep()
+{
+	if (renderTarget.getSweepState() != TARGET_SWEEP_OFF)
+	{
+		releaseUnthrottled(UNTHROTTLE_TARGET_SWEEP);
+		renderTarget.stopSweep();
+		return;
+	}
+	acquireUnthrottled(UNTHROTTLE_TARGET_SWEEP);
+	renderTarget.startSweep();
+}
+// Texture working sets sweep start at current sampling options, or stop of running or finished sweep.
+// Vertical sync disabled while sweep runs.
+void OpenGL::switchSamplingSweep()
+{
+	if (textureSampler.getSweepState() != SAMPLING_SWEEP_OFF)
+	{
+		releaseUnthrottled(UNTHROTTLE_SAMPLING_SWEEP);
+		textureSampler.stopSweep();
+		return;
+	}
+	acquireUnthrottled(UNTHROTTLE_SAMPLING_SWEEP);
+	textureSampler.startSweep();
+}
+// CPU burners sweep start at current options, or stop of running or finished sweep.
+// Vertical sync disabled while sweep runs.
+void OpenGL::switchBurnSweep()
+{
+	if (cpuBurner.getSweepState() != BURN_SWEEP_OFF)
+	{
+		releaseUnthrottled(UNTHROTTLE_BURN_SWEEP);
+		cpuBurner.stopSweep();
+		return;
+	}
+	acquireUnthrottled(UNTHROTTLE_BURN_SWEEP);
+	cpuBurner.startSweep();
+}
+// Frames in flight limits sweep start, or stop of running or finished sweep.
+// Swap interval kept, queue depth effect on latency differs with vertical sync.
+void OpenGL::switchPacerSweep()
+{
+	if (framePacer.getSweepState() != PACER_SWEEP_OFF)
+	{
+		framePacer.stopSweep();
+		return;
+	}
+	framePacer.startSweep();
+}
+// GPU time of each frame by timestamps at frame start and after last draw, stored to
+// caller buffer indexed by frame sequence number. Null buffer stops timing, pending
+// results read. Vertical sync disabled while timing runs.
+void OpenGL::setFrameTiming(double* milliseconds, DWORD32 count)
+{
+	if (!milliseconds)
+	{
+		for (int i = 0; i < APPCONST::FRAME_QUERY_FRAMES; i++)
+		{
+			readFrameQueries(i);
+		}
+		frameTimes = nullptr;
+		frameTimesCount = 0;
+		releaseUnthrottled(UNTHROTTLE_FRAME_TIMING);
+		return;
+	}
+	memset(frameQueriesIssued, 0, sizeof(frameQueriesIssued));
+	frameSequence = 0;
+	frameTimes = milliseconds;
+	frameTimesCount = count;
+	acquireUnthrottled(UNTHROTTLE_FRAME_TIMING);
+}
+// Timestamps of frame slot read before slot reuse, with wait: frame times must be complete,
+// slot is frames count old, wait is rare.
+void OpenGL::readFrameQueries(int slot)
+{
+	if (!frameQueriesIssued[slot]) return;
+	frameQueriesIssued[slot] = FALSE;
+	DWORD64 start = 0;
+	DWORD64 stop = 0;
+	f.glGetQueryObjectui64v(frameQueries[slot][0], GL_QUERY_RESULT, &start);
+	f.glGetQueryObjectui64v(frameQueries[slot][1], GL_QUERY_RESULT, &stop);
+	if (frameQuerySequence[slot] < frameTimesCount)
+	{
+		frameTimes[frameQuerySequence[slot]] = (stop - start) / 1.0E6;
+	}
+}
+// Capture of every Nth frame start, restart with new interval, or stop by CAPTURE_OFF.
+// Must be stopped before GDI+ shutdown.
+BOOL OpenGL::setCapture(captureFormat format, int intervalIndex)
+{
+	if (format == CAPTURE_OFF)
+	{
+		frameCapture.stop();
+		return TRUE;
+	}
+	return frameCapture.start(format, intervalIndex);
+}
+// Sensor sampler start with sysfs root and sample period, null root stops sampler.
+BOOL OpenGL::setSensors(const char* root, DWORD periodMs)
+{
+	if (!root)
+	{
+		sensorSampler.stop();
+		return TRUE;
+	}
+	return sensorSampler.start(root, periodMs, ptrTimer->getTscFrequency(), APPCONST::SENSOR_TRACE_NAME);
+}
+// Vertical sync off for unattended harness run, restored by FALSE if no other owner.
+// Returns swap interval in effect, -1 if swap control not supported.
+int OpenGL::setUnthrottled(BOOL unthrottled)
+{
+	if (unthrottled)
+	{
+		acquireUnthrottled(UNTHROTTLE_HARNESS);
+	}
+	else
+	{
+		releaseUnthrottled(UNTHROTTLE_HARNESS);
+	}
+	return fo.wglGetSwapIntervalEXT ? fo.wglGetSwapIntervalEXT() : -1;
+}
+// Cube model for other backends, same layout as OpenGL vertex buffer.
+const GLfloat* OpenGL::getCubeVertices()
+{
+	return verticesCube;
+}
+// Vertical sync disabled by first owner, swap interval saved once.
+void OpenGL::acquireUnthrottled(unthrottleOwner owner)
+{
+	DWORD bit = 1UL << owner;
+	if (unthrottleOwners & bit) return;
+	if ((!unthrottleOwners) && fo.wglGetSwapIntervalEXT && fo.wglSwapIntervalEXT && (swapIntervalSaved < 0))
+	{
+		swapIntervalSaved = fo.wglGetSwapIntervalEXT();
+		fo.wglSwapIntervalEXT(0);
+	}
+	unthrottleOwners |= bit;
+}
+// Owner not holding reference ignored, swap interval restored by last owner.
+void OpenGL::releaseUnthrottled(unthrottleOwner owner)
+{
+	DWORD bit = 1UL << owner;
+	if (!(unthrottleOwners & bit)) return;
+	unthrottleOwners &= ~bit;
+	if (!unthrottleOwners) restoreSwapInterval();
+}
+void OpenGL::restoreSwapInterval()
+{
+	if ((swapIntervalSaved >= 0) && fo.wglSwapIntervalEXT)
+	{
+		fo.wglSwapIntervalEXT(swapIntervalSaved);
+	}
+	swapIntervalSaved = -1;
+}
+// Profiling row: per-frame CPU time of draw stages, averaged for display update interval.
+void OpenGL::writeProfileRow()
+{
+	double us[STAGE_COUNT];
+	if (profiler.getWindowMicroseconds(us))
 	{
-		snprintf(szTextIndex, APPCONST::MAX_TEXT_STRING, "%s[%d]", showTextName, i);
-		GLint location = f.glGetUniformLocation(shaderProgramId, szTextIndex);
-		f.glUniform1i(location, *(ptrTextDwords++));
+		// Cells of 12 chars from column 14, total last, ends before format label at column 113.
+		const int cellWidth = 12;
+		char* p = textOutput + 128 * 5;
+		snprintf(p + 1, 128, "%s", szProfile);
+		for (int i = STAGE_SETUP; i < STAGE_COUNT; i++)
+		{
+			writeProfileCell(p + 14 + cellWidth * (i - STAGE_SETUP), cellWidth, szStageNames[i], us[i]);
+		}
+		writeProfileCell(p + 14 + cellWidth * (STAGE_COUNT - STAGE_SETUP), cellWidth, szStageNames[STAGE_BEGIN], us[STAGE_BEGIN]);
 	}
 }
+// Profiling cell: stage name and microseconds, precision reduced for large values to fit cell.
+void OpenGL::writeProfileCell(char* cell, int size, const char* name, double us)
+{
+	int digits = (us < 1000.0) ? 1 : 0;
+	int width = size - 2 - static_cast<int>(strlen(name));
+	snprintf(cell, size, "%s %-*.*f", name, width, digits, us);
+}
 void OpenGL::matrixMultiply(float* src1, float* src2, float* dst)
 {
 	__m128 a1 = _mm_load_ps(src1);
@@ -444,34 +1445,159 @@ const char* OpenGL::oglNamesList[]
 	"glActiveTexture",
 	"glDrawArraysInstanced",
 	"glVertexAttribDivisor",
+	"glBindBufferBase",
+	"glGetUniformBlockIndex",
+	"glUniformBlockBinding",
+	"glDeleteProgram",
+	"glBindBufferRange",
+	"glTexBuffer",
+	"glUniform1f",
+	"glUniform1iv",
+	"glGenQueries",
+	"glDeleteQueries",
+	"glBeginQuery",
+	"glEndQuery",
+	"glGetQueryObjectuiv",
+	"glGetQueryObjectui64v",
+	"glGenFramebuffers",
+	"glDeleteFramebuffers",
+	"glBindFramebuffer",
+	"glFramebufferRenderbuffer",
+	"glCheckFramebufferStatus",
+	"glGenRenderbuffers",
+	"glDeleteRenderbuffers",
+	"glBindRenderbuffer",
+	"glRenderbufferStorageMultisample",
+	"glBlitFramebuffer",
+	"glUniform2f",
+	"glGenSamplers",
+	"glDeleteSamplers",
+	"glBindSampler",
+	"glSamplerParameteri",
+	"glSamplerParameterf",
+	"glTexImage3D",
+	"glTexSubImage3D",
+	"glQueryCounter",
+	"glMapBufferRange",
+	"glUnmapBuffer",
+	"glFenceSync",
+	"glClientWaitSync",
+	"glDeleteSync",
+	"glGetInteger64v",
+	"glBufferSubData",
+	nullptr };
+// Names for optional functions import, absent functions not cause failure.
+const char* OpenGL::oglOptionalNamesList[]
+{	"glGetProgramBinary",
+	"glProgramBinary",
+	"glProgramParameteri",
+	"wglSwapIntervalEXT",
+	"wglGetSwapIntervalEXT",
 	nullptr };
 
 // Vertex shader source, compiled at runtime by GPU driver
+// Shaders version string, defines for generated variants follows it.
+const char* OpenGL::shaderVersion =
+"#version 330 core\r\n";
+// Variant for instance stream with three instances per packed element.
+const char* OpenGL::packedDefines =
+"#define INSTANCE_PACKED\r\n";
+// Variant without instance stream, scale computed from phase uniform.
+const char* OpenGL::animationDefines =
+"#define GPU_ANIMATION\r\n";
+
 const char* OpenGL::vertexShaderSource =
-"#version 330 core\r\n"
 "layout (location = 0) in vec3 aPos;\r\n"
 "layout (location = 1) in vec2 aTexCoord;\r\n"
+"#if defined(GPU_ANIMATION)\r\n"
+"uniform float animationPhase;\r\n"
+"#elif defined(FETCH_TEXTURE_BUFFER)\r\n"
+"uniform samplerBuffer scBuffer;\r\n"
+"#elif defined(FETCH_UNIFORM_BUFFER)\r\n"
+"layout(std140) uniform instanceBlock { vec4 scVectors[FETCH_UNIFORM_VECTORS]; };\r\n"
+"#elif defined(FETCH_STORAGE_BUFFER)\r\n"
+"layout(std430, binding = 0) readonly buffer instanceStorage { float scStorage[]; };\r\n"
+"#elif defined(INSTANCE_PACKED)\r\n"
+"layout (location = 2) in vec4 scPacked;\r\n"
+"#else\r\n"
 "layout (location = 2) in float sc;\r\n"
+"#endif\r\n"
 "out vec2 TexCoord;\r\n"
+"uniform sampler2D texture1;\r\n"
 "uniform mat4 model_R;\r\n"
-"uniform int showText[160];\r\n"
+"uniform int instanceBase;\r\n"
+"#ifdef STATE_BLOCK\r\n"
+"layout(std140) uniform stateBlock { vec4 stateOffset; };\r\n"
+"#endif\r\n"
+"void main()\r\n"
+"{\r\n"
+// Grid position from cube ID, instance stream indexed by gl_InstanceID.
+"   int id = gl_InstanceID + instanceBase;\r\n"
+"   int nx = id % 9;\r\n"
+"   int ny = id / 9 % 3;\r\n"
+"   float dx = -0.85f + nx / 4.75f;\r\n"
+"   float dy = -0.56f + ny / 1.80f;\r\n"
+"   vec4 t = model_R * vec4(aPos, 1.0f);\r\n"
+"#if defined(GPU_ANIMATION)\r\n"
+"   float sc = sin(animationPhase) * 0.6f;\r\n"
+"#elif defined(FETCH_TEXTURE_BUFFER)\r\n"
+"   float sc = texelFetch(scBuffer, gl_InstanceID).r;\r\n"
+"#elif defined(FETCH_UNIFORM_BUFFER)\r\n"
+"   float sc = scVectors[gl_InstanceID >> 2][gl_InstanceID & 3];\r\n"
+"#elif defined(FETCH_STORAGE_BUFFER)\r\n"
+"   float sc = scStorage[gl_InstanceID];\r\n"
+"#elif defined(INSTANCE_PACKED)\r\n"
+"   float sc = scPacked[gl_InstanceID % 3];\r\n"
+"#endif\r\n"
+"   float sx = 5.50f + 7.5 - 8.5f * abs(sc);\r\n"
+"   float sy = 3.55f + 7.5 - 8.5f * abs(sc);\r\n"
+"   float sz = 5.50f + 7.5 - 8.5f * abs(sc);\r\n"
+"   sx = 3.2f + sx / 3.0f;\r\n"
+"   sy = 3.2f + sy / 3.0f;\r\n"
+"   sy = 3.2f + sz / 3.0f;\r\n"
+"   gl_Position = vec4(t.x/sx + dx , t.y/sy + dy, t.z/sz, t.w);\r\n"
+"#ifdef STATE_BLOCK\r\n"
+"   gl_Position.xy += stateOffset.xy;\r\n"
+"#endif\r\n"
+"#ifdef STATE_VARIANT_B\r\n"
+"   gl_Position.z *= 0.999f;\r\n"
+"#endif\r\n"
+// Atlas cells in texels, converted by texture size, no texture size literals.
+"   vec2 texSize = vec2(textureSize(texture1, 0));\r\n"
+"   float ctx = 94.0f   / texSize.x;\r\n"
+"   float cty = 1527.0f / texSize.y;\r\n"
+"   float mtx = 303.0f  / texSize.x;\r\n"
+"   float mty = 482.0f  / texSize.y;\r\n"
+"   float dtx = 344.0f  / texSize.x;\r\n"
+"   float dty = 344.0f  / texSize.y;\r\n"
+"   float tx  = ctx + dtx * aTexCoord.x + nx * mtx;\r\n"
+"   float ty  = cty - dty * aTexCoord.y - mty * (2 - ny);\r\n"
+"   TexCoord = vec2(tx, ty);\r\n"
+"}\r\n\0";
+
+// Text overlay vertex shader: one quad per char, char ID is instance ID.
+const char* OpenGL::textVertexShaderSource =
+"layout (location = 0) in vec3 aPos;\r\n"
+"out vec2 TexCoord;\r\n"
+"uniform int showText[224];\r\n"
+"uniform sampler2D texture1;\r\n"
 "void main()\r\n"
 "{\r\n"
-"if(gl_InstanceID < 640)\r\n"
-"   {\r\n"
-// Screen coordinates for 128x4 chars positions, screen down
-"   int nx = gl_InstanceID & 0x7F;\r\n"
-"   int ny = gl_InstanceID >> 7;\r\n"
-"   if(ny == 4) ny = 43;\r\n"
+"   int id = gl_InstanceID;\r\n"
+// Screen coordinates for 128x4 chars positions, screen down, and 128x3 chars positions, screen up
+"   int nx = id & 0x7F;\r\n"
+"   int ny = id >> 7;\r\n"
+"   if(ny >= 4) ny = 47 - ny;\r\n"
+"   vec2 texSize = vec2(textureSize(texture1, 0));\r\n"
 "   float dx = 2.0f / 128.0f;\r\n"
-"   float dy = 2.0f * 44.0f / 1967.0f;\r\n"
+"   float dy = 2.0f * 44.0f / texSize.y;\r\n"
 "   float x1 = nx * dx - 1.0f;\r\n"
 "   float y1 = ny * dy - 1.0f;\r\n"
 "   float x2 = x1 + dx;\r\n"
 "   float y2 = y1 + dy;\r\n"
 "   float rx = (aPos.x < 0) ? x1 : x2;\r\n"
 "   float ry = (aPos.y < 0) ? y1 : y2;\r\n"
-"   float rz = aPos.z;\r\n"
+"   float rz = 0.0f;\r\n"
 "   gl_Position = vec4(rx, ry, rz, 1.0f);\r\n"
 // Texture coordinates(showed chars select) for 128x4 chars positions
 "   bool b1 = false;\r\n"
@@ -483,14 +1609,14 @@ const char* OpenGL::vertexShaderSource =
 "   if ((nx > 111)&&(nx < 121)) b3 = true;\r\n"
 "   if (ny == 43) b4 = true;\r\n"
 "   bool b = (b1 && (b2 || b3)) || b4;\r\n"
-"   float fs = b ? (16.0f / 1967.0f) : 0.0f;\r\n"
-"   int index = gl_InstanceID / 4;\r\n"                // index of dword
-"   int shift = (gl_InstanceID & 3) * 8;\r\n"          // shift of byte
+"   float fs = b ? (16.0f / texSize.y) : 0.0f;\r\n"
+"   int index = id / 4;\r\n"                // index of dword
+"   int shift = (id & 3) * 8;\r\n"          // shift of byte
 "   int a = (showText[index] >> shift) & 0x7F;\r\n"    // a = char
-"   float corx = 0.5f / 2952.0f;\r\n"
-"   float cory = 0.5f / 1967.0f;\r\n"
-"   float kx = 8.0f / 2952.0f;\r\n"
-"   float ky = 16.0f / 1967.0f;\r\n"
+"   float corx = 0.5f / texSize.x;\r\n"
+"   float cory = 0.5f / texSize.y;\r\n"
+"   float kx = 8.0f / texSize.x;\r\n"
+"   float ky = 16.0f / texSize.y;\r\n"
 "   float tx1 = kx * a - corx;\r\n"
 "   float tx2 = tx1 + kx - corx;\r\n"
 "   float ty1 = 0.0f + cory + fs;\r\n"
@@ -498,37 +1624,10 @@ const char* OpenGL::vertexShaderSource =
 "   float tx = (aPos.x < 0) ? tx1 : tx2;\r\n"
 "   float ty = (aPos.y < 0) ? ty1 : ty2;\r\n"
 "   TexCoord = vec2(tx, ty);\r\n"
-"   }\r\n"
-// Otherwise render cubes.
-"   else\r\n"
-"   {\r\n"
-"   int nx = gl_InstanceID % 9;\r\n"
-"   int ny = gl_InstanceID / 9 % 3;\r\n"
-"   float dx = -0.85f + nx / 4.75f;\r\n"
-"   float dy = -0.56f + ny / 1.80f;\r\n"
-"   vec4 t = model_R * vec4(aPos, 1.0f);\r\n"
-"   float sx = 5.50f + 7.5 - 8.5f * abs(sc);\r\n"
-"   float sy = 3.55f + 7.5 - 8.5f * abs(sc);\r\n"
-"   float sz = 5.50f + 7.5 - 8.5f * abs(sc);\r\n"
-"   sx = 3.2f + sx / 3.0f;\r\n"
-"   sy = 3.2f + sy / 3.0f;\r\n"
-"   sy = 3.2f + sz / 3.0f;\r\n"
-"   gl_Position = vec4(t.x/sx + dx , t.y/sy + dy, t.z/sz, t.w);\r\n"
-"   float ctx = 94.0f   / 2952.0f;\r\n"
-"   float cty = 1527.0f / 1967.0f;\r\n"
-"   float mtx = 303.0f  / 2952.0f;\r\n"
-"   float mty = 482.0f  / 1967.0f;\r\n"
-"   float dtx = 344.0f  / 2952.0f;\r\n"
-"   float dty = 344.0f  / 1967.0f;\r\n"
-"   float tx  = ctx + dtx * aTexCoord.x + nx * mtx;\r\n"
-"   float ty  = cty - dty * aTexCoord.y - mty * (2 - ny);\r\n"
-"   TexCoord = vec2(tx, ty);\r\n"
-"   }\r\n"
 "}\r\n\0";
 
 // Fragment shader source, compiled at runtime by GPU driver
 const char* OpenGL::fragmentShaderSource =
-"#version 330 core\r\n"
 "out vec4 FragColor;\r\n"
 "in vec2 TexCoord;\r\n"
 "uniform sampler2D texture1;\r\n"
@@ -589,6 +1688,8 @@ const GLclampf OpenGL::clearColor[]
 const GLchar* OpenGL::modelName    = "model_R";
 const GLchar* OpenGL::textureName  = "texture1";
 const GLchar* OpenGL::showTextName = "showText";
+const GLchar* OpenGL::instanceBaseName = "instanceBase";
+const GLchar* OpenGL::animationPhaseName = "animationPhase";
 
 const GLenum OpenGL::infoNames[]
 { GL_VENDOR, GL_RENDERER, GL_VERSION, GL_SHADING_LANGUAGE_VERSION, 0 };
@@ -605,3 +1706,19 @@ const char* OpenGL::szGpuLoad     =  "GPU load instances (up/down keys)";
 const char* OpenGL::szDepthTest   =  "Depth test (left/right keys)";
 const char* OpenGL::szDepthOn     =  "ON";
 const char* OpenGL::szDepthOff    =  "OFF";
+const char* OpenGL::szTrace       =  "Trace (T key)";
+const char* OpenGL::szTraceModes[] { "OFF", "CSV", "BIN" };
+const char* OpenGL::szProfile     =  "CPU us/frame";
+const char* OpenGL::szStageNames[] { "Total", "Setup", "Matrix", "Fill", "Upload", "Draw", "Swap", "Text" };
+const char* OpenGL::szMode        =  "Mode (M key)";
+const char* OpenGL::szModeNames[] { "Instanced", "Draw calls", "State change", "GPU animated" };
+const char* OpenGL::szPerDrawUniform = "Uniform/draw (U key)";
+const char* OpenGL::szFormat      =  "Format(F) ";
+const char* OpenGL::szFormatNames[] { "FP32", "FP16", "SN16", "S10P" };
+const char* OpenGL::szFetch       =  "Fetch(I) ";
+const char* OpenGL::szFetchNames[] { "Attr", "TBO", "UBO", "SSBO" };
+const char* OpenGL::szArena       =  "Arena(A) ";
+const char* OpenGL::szArenaNames[] { "Heap", "Pages", "Fault", "Large" };
+const char* OpenGL::szArenaFailed =  "n/a";
+const char* OpenGL::szDepthOrder  =  "Depth(D) ";
+const char* OpenGL::szDepthOrderNames[] { "Off", "Rand", "F2B", "B2F", "Pre" };
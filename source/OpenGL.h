@@ -9,63 +9,117 @@ OpenGL and graphics mathematics class header.
 
 #include <windows.h>
 #include <iostream>
-#include <gl\GL.h>
 #include <intrin.h>
 #include "Global.h"
+#include "OpenGLImport.h"
 #include "Timer.h"
+#include "Telemetry.h"
+#include "Profiler.h"
+#include "ShaderBuilder.h"
+#include "StateBenchmark.h"
+#include "InstanceEncoder.h"
+#include "InstanceFetch.h"
+#include "StagingArena.h"
+#include "Calibrator.h"
+#include "SoftRasterizer.h"
+#include "DepthSorter.h"
+#include "RenderTarget.h"
+#include "TextureSampler.h"
+#include "FrameCapture.h"
+#include "AtlasBlob.h"
+#include "MemoryBandwidth.h"
+#include "CpuBurner.h"
+#include "SensorSampler.h"
+#include "FramePacer.h"
 
-// Some definitions from glad.h.
-#define GL_FRAGMENT_SHADER  0x8B30
-#define GL_VERTEX_SHADER    0x8B31
-#define GL_COMPILE_STATUS   0x8B81
-#define GL_LINK_STATUS      0x8B82
-#define GL_ARRAY_BUFFER     0x8892
-#define GL_STATIC_DRAW      0x88E4
-#define GL_DYNAMIC_DRAW     0x88E8
-#define GL_BGRA             0x80E1
-#define GL_TEXTURE0         0x84C0
-#define GL_SHADING_LANGUAGE_VERSION  0x8B8C
+// Benchmark modes, how cubes workload submitted to GPU.
+enum benchmarkMode
+{
+    MODE_INSTANCED = 0,     // One instanced draw for all cubes.
+    MODE_DRAW_CALLS,        // One non-instanced draw per cube, API overhead bound.
+    MODE_STATE_CHANGES,     // Draws interleaved with state changes, cost matrix.
+    MODE_GPU_ANIMATION,     // One instanced draw, scale computed by vertex shader, no instance upload.
+    MODES_COUNT
+};
+
+// Measurements which require vertical sync off, each owner holds one reference,
+// swap interval restored when last owner released.
+enum unthrottleOwner
+{
+    UNTHROTTLE_CALIBRATION = 0,
+    UNTHROTTLE_TARGET_SWEEP,
+    UNTHROTTLE_SAMPLING_SWEEP,
+    UNTHROTTLE_FRAME_TIMING,
+    UNTHROTTLE_BURN_SWEEP,
+    UNTHROTTLE_HARNESS
+};
+
+// Per-frame options selected by user, animation time of frame.
+struct drawOptions
+{
+    double seconds;
+    unsigned int load;
+    BOOL depthTest;
+    benchmarkMode mode;
+    BOOL perDrawUniform;
+    instanceFormat format;
+    fetchPath fetch;
+    arenaKind arena;
+    depthOrder depthOrdering;
+    targetColor color;
+    targetDepth depth;
+    int samplesIndex;
+    samplingFilter filter;
+    samplingPattern pattern;
+    int workingSet;
+    BOOL streamingStores;       // Non-temporal stores at instance data fill.
+    burnKind burn;
+    int burnThreads;
+    int framesInFlight;         // 0 is driver default.
+};
 
-typedef char GLchar;
-#if defined(_WIN64)
-typedef signed   long long int khronos_ssize_t;
-typedef unsigned long long int khronos_usize_t;
-#else
-typedef signed   long  int     khronos_ssize_t;
-typedef unsigned long  int     khronos_usize_t;
-#endif
-typedef khronos_ssize_t GLsizeiptr;
+// Instanced mode results saved for compare with draw calls mode at same instance count.
+struct instancedReference
+{
+    unsigned int load;
+    double instancesPerSecond;
+    double nsPerInstance;
+};
+
+// Instanced mode results for instance data format and fetch path at instance count.
+struct instanceResult
+{
+    unsigned int load;
+    instanceFormat format;
+    fetchPath fetch;
+    double instancesPerSecond;
+    double megabytesPerSecond;
+};
+
+// Depth order results at instance count, fragments are samples passed depth test per frame.
+struct depthResult
+{
+    unsigned int load;
+    depthOrder order;
+    BOOL depthTest;
+    double instancesPerSecond;
+    double fragmentsPerFrame;
+    double prepassFragmentsPerFrame;
+    double sortMicroseconds;
+};
 
-struct oglFunctionsList
+// Fill and upload stages results for staging arena type at instance count.
+struct arenaResult
 {
-    GLuint(__stdcall *glCreateShader)(GLenum shaderType);
-    void(__stdcall *glShaderSource)(GLuint shader, GLsizei count, const GLchar** string, const GLint* length);
-    void(__stdcall *glCompileShader)(GLuint shader);
-    void(__stdcall *glGetShaderiv)(GLuint shader, GLenum pname, GLint* params);
-    void(__stdcall *glGetShaderInfoLog)(GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
-    GLuint(__stdcall *glCreateProgram)();
-    void(__stdcall *glAttachShader)(GLuint program, GLuint shader);
-    void(__stdcall *glLinkProgram)(GLuint program);
-    void(__stdcall *glGetProgramiv)(GLuint program, GLenum pname, GLint* params);
-    void(__stdcall *glGetProgramInfoLog)(GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
-    void(__stdcall *glDeleteShader)(GLuint shader);
-    void(__stdcall *glGenVertexArrays)(GLsizei n, GLuint* arrays);
-    void(__stdcall *glGenBuffers)(GLsizei n, GLuint* buffers);
-    void(__stdcall *glBindVertexArray)(GLuint vArray);
-    void(__stdcall *glBindBuffer)(GLenum target, GLuint buffer);
-    void(__stdcall *glBufferData)(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
-    void(__stdcall *glVertexAttribPointer)(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer);
-    void(__stdcall *glEnableVertexAttribArray)(GLuint index);
-    void(__stdcall *glUseProgram)(GLuint program);
-    void(__stdcall *glDeleteVertexArrays)(GLsizei n, const GLuint* arrays);
-    void(__stdcall *glDeleteBuffers)(GLsizei n, const GLuint* buffers);
-    GLint(__stdcall *glGetUniformLocation)(GLuint program, const GLchar* name);
-    void(__stdcall *glUniformMatrix4fv)(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
-    void(__stdcall *glGenerateMipmap)(GLenum target);
-    void(__stdcall *glUniform1i)(GLint location, GLint v0);
-    void(__stdcall *glActiveTexture)(GLenum texture);
-    void(__stdcall *glDrawArraysInstanced)(GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
-    void(__stdcall *glVertexAttribDivisor)(GLuint index, GLuint divisor);
+    unsigned int load;
+    arenaKind kind;
+    DWORD node;                 // NUMA node of arena at measurement.
+    BOOL streaming;
+    double fillMicroseconds;
+    double fillGigabytesPerSecond;
+    double uploadMicroseconds;
+    double uploadMegabytesPerSecond;
+    double faultsPerFrame;
 };
 
 class OpenGL
@@ -73,33 +127,144 @@ class OpenGL
 public:
     OpenGL();
     ~OpenGL();
-    int init(HWND hWnd, HDC hDC, const void* rawData, Timer* pTimer);
-    void draw(HWND hWnd, HDC hDC, unsigned int optionLoad, BOOL optionDepth);
+    int init(HWND hWnd, HDC hDC, const void* rawData, AtlasBlob* pAtlas, Timer* pTimer, Telemetry* pTelemetry);
+    void draw(HWND hWnd, HDC hDC, const drawOptions& options);
+    void resize(GLsizei width, GLsizei height);
+    void saveReports();
+    BOOL benchmarkShaders();
+    void switchCalibration(double targetFps, unsigned int startLoad);
+    BOOL benchmarkSoftware();
+    BOOL benchmarkBandwidth();
+    void switchTargetSweep();
+    void switchSamplingSweep();
+    void switchBurnSweep();
+    void switchPacerSweep();
+    void setFrameTiming(double* milliseconds, DWORD32 count);
+    BOOL setCapture(captureFormat format, int intervalIndex);
+    BOOL setSensors(const char* root, DWORD periodMs);
+    int setUnthrottled(BOOL unthrottled);
+    static const GLfloat* getCubeVertices();
 private:
     void matrixMultiply(float* src1, float* src2, float* dst);
+    void writeProfileRow();
+    void writeProfileCell(char* cell, int size, const char* name, double us);
+    void writeModeRow(double fps);
+    void drawCubes(GLsizei cubesCount);
+    void drawText();
+    void drawInstances(GLsizei cubesCount);
+    void drawDepthOrdered(GLsizei cubesCount);
+    void readDepthQueries(int slot);
+    void writeDepthRow(char* p, double cubesPerSecond);
+    void applyInstancePath(instanceFormat format, fetchPath fetch, BOOL animation);
+    void uploadText();
+    BOOL createArena(arenaKind kind, size_t capacity);
+    void acquireUnthrottled(unthrottleOwner owner);
+    void releaseUnthrottled(unthrottleOwner owner);
+    void restoreSwapInterval();
+    void readFrameQueries(int slot);
+    void resetArenaWindow();
+    void updateArenaResult();
     PIXELFORMATDESCRIPTOR pfd;
     RECT viewRect;
     oglFunctionsList f;
+    oglOptionalFunctionsList fo;
     HGLRC hglrc;
     GLuint vao;
+    GLuint textVao;
     GLuint vbo;
+    GLuint ivbo;
     GLuint texture1;
     GLuint shaderProgramId;
+    GLuint packedProgramId;
+    GLuint animationProgramId;
+    GLuint activeProgramId;
+    GLuint textProgramId;
+    GLint showTextLocation;
     GLsizeiptr gpuLoadNow;
     BOOL gpuDepthTest;
+    benchmarkMode gpuMode;
+    BOOL gpuPerDrawUniform;
+    instanceFormat gpuFormat;
+    fetchPath gpuFetch;
+    BOOL gpuStreaming;
+    fetchPath gpuFetchSelected;
+    arenaKind gpuArenaSelected;
+    GLint instanceBaseLocation;
+    DWORD64 windowSubmitTicks;
+    DWORD64 windowCubes;
+    DWORD64 windowFrames;
+    DWORD64 windowUploadBytes;
+    DWORD64 windowUploadTicks;
+    instancedReference references[APPCONST::REFERENCE_SLOTS];
+    int referenceNext;
+    instanceResult instanceResults[APPCONST::INSTANCE_RESULT_SLOTS];
+    int instanceResultNext;
+    DWORD64 arenaFillTicks;
+    DWORD64 arenaFillBytes;
+    DWORD64 arenaUploadTicks;
+    DWORD64 arenaUploadBytes;
+    DWORD64 arenaFrames;
+    DWORD arenaFaults;
+    arenaResult arenaResults[APPCONST::ARENA_RESULT_SLOTS];
+    int arenaResultNext;
+    depthOrder gpuDepthOrder;
+    GLuint depthQueries[APPCONST::DEPTH_QUERY_FRAMES][2];     // Color pass, depth prepass.
+    int depthQueriesIssued[APPCONST::DEPTH_QUERY_FRAMES];     // Queries count issued at frame slot.
+    int depthQueryNext;
+    DWORD64 depthFragments;
+    DWORD64 depthPrepassFragments;
+    DWORD64 depthQueryFrames;
+    DWORD64 depthSortTicks;
+    DWORD64 depthFrames;
+    depthResult depthResults[APPCONST::DEPTH_RESULT_SLOTS];
+    int depthResultNext;
+    GLuint frameQueries[APPCONST::FRAME_QUERY_FRAMES][2];     // Frame start and end timestamps.
+    BOOL frameQueriesIssued[APPCONST::FRAME_QUERY_FRAMES];
+    DWORD32 frameQuerySequence[APPCONST::FRAME_QUERY_FRAMES];
+    int frameQueryNext;
+    DWORD32 frameSequence;
+    double* frameTimes;
+    DWORD32 frameTimesCount;
     GLfloat* ptrTransfMatrixes;
     GLfloat* ptrScales;
+    size_t instanceCapacity;
+    int swapIntervalSaved;
+    DWORD unthrottleOwners;     // Bit per unthrottleOwner.
     GLchar* textOutput;
-    GLchar* errorLog;
     Timer* ptrTimer;
+    Telemetry* ptrTelemetry;
+    Profiler profiler;
+    ShaderBuilder shaderBuilder;
+    StateBenchmark stateBenchmark;
+    InstanceEncoder instanceEncoder;
+    InstanceFetch instanceFetch;
+    StagingArena arena;
+    Calibrator calibrator;
+    SoftRasterizer softRasterizer;
+    DepthSorter depthSorter;
+    RenderTarget renderTarget;
+    TextureSampler textureSampler;
+    FrameCapture frameCapture;
+    MemoryBandwidth memoryBandwidth;
+    CpuBurner cpuBurner;
+    SensorSampler sensorSampler;
+    FramePacer framePacer;
+    Report report;
     static const char* oglNamesList[];
+    static const char* oglOptionalNamesList[];
+    static const char* shaderVersion;
+    static const char* packedDefines;
+    static const char* animationDefines;
     static const char* vertexShaderSource;
+    static const char* textVertexShaderSource;
     static const char* fragmentShaderSource;
     static const alignas(16) GLfloat verticesCube[];
     static const GLclampf clearColor[];
     static const GLchar* modelName;
     static const GLchar* textureName;
     static const GLchar* showTextName;
+    static const GLchar* instanceBaseName;
+    static const GLchar* animationPhaseName;
     static const GLenum infoNames[];
     static const char* szSeconds;
     static const char* szFrames;
@@ -113,6 +278,22 @@ private:
     static const char* szDepthTest;
     static const char* szDepthOn;
     static const char* szDepthOff;
+    static const char* szTrace;
+    static const char* szTraceModes[];
+    static const char* szProfile;
+    static const char* szStageNames[];
+    static const char* szMode;
+    static const char* szModeNames[];
+    static const char* szPerDrawUniform;
+    static const char* szFormat;
+    static const char* szFormatNames[];
+    static const char* szFetch;
+    static const char* szFetchNames[];
+    static const char* szArena;
+    static const char* szArenaNames[];
+    static const char* szArenaFailed;
+    static const char* szDepthOrder;
+    static const char* szDepthOrderNames[];
 };
 
 #endif // OPENGL_H
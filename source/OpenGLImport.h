@@ -0,0 +1,169 @@
+/*
+OpenGL GPUstress.
+OpenGL definitions and dynamically imported functions list, shared by OpenGL classes.
+*/
+
+#pragma once
+#ifndef OPENGLIMPORT_H
+#define OPENGLIMPORT_H
+
+#include <windows.h>
+#include <gl\GL.h>
+
+// Some definitions from glad.h.
+#define GL_FRAGMENT_SHADER  0x8B30
+#define GL_VERTEX_SHADER    0x8B31
+#define GL_COMPILE_STATUS   0x8B81
+#define GL_LINK_STATUS      0x8B82
+#define GL_ARRAY_BUFFER     0x8892
+#define GL_STATIC_DRAW      0x88E4
+#define GL_DYNAMIC_DRAW     0x88E8
+#define GL_BGRA             0x80E1
+#define GL_TEXTURE0         0x84C0
+#define GL_SHADING_LANGUAGE_VERSION  0x8B8C
+#define GL_UNIFORM_BUFFER   0x8A11
+#define GL_INVALID_INDEX    0xFFFFFFFFu
+#define GL_HALF_FLOAT       0x140B
+#define GL_INT_2_10_10_10_REV  0x8D9F
+#define GL_TEXTURE1         0x84C1
+#define GL_R32F             0x822E
+#define GL_TEXTURE_BUFFER   0x8C2A
+#define GL_MAX_TEXTURE_BUFFER_SIZE  0x8C2B
+#define GL_SHADER_STORAGE_BUFFER    0x90D2
+#define GL_MAX_UNIFORM_BLOCK_SIZE   0x8A30
+#define GL_UNIFORM_BUFFER_OFFSET_ALIGNMENT  0x8A34
+#define GL_MAJOR_VERSION    0x821B
+#define GL_MINOR_VERSION    0x821C
+#define GL_PROGRAM_BINARY_RETRIEVABLE_HINT  0x8257
+#define GL_PROGRAM_BINARY_LENGTH    0x8741
+#define GL_SAMPLES_PASSED   0x8914
+#define GL_QUERY_RESULT     0x8866
+#define GL_QUERY_RESULT_AVAILABLE   0x8867
+#define GL_TIME_ELAPSED     0x88BF
+#define GL_TIMESTAMP        0x8E28
+#define GL_FRAMEBUFFER      0x8D40
+#define GL_READ_FRAMEBUFFER 0x8CA8
+#define GL_DRAW_FRAMEBUFFER 0x8CA9
+#define GL_RENDERBUFFER     0x8D41
+#define GL_COLOR_ATTACHMENT0        0x8CE0
+#define GL_DEPTH_ATTACHMENT         0x8D00
+#define GL_DEPTH_STENCIL_ATTACHMENT 0x821A
+#define GL_FRAMEBUFFER_COMPLETE     0x8CD5
+#define GL_MAX_SAMPLES      0x8D57
+#define GL_RGBA16F          0x881A
+#define GL_RGBA32F          0x8814
+#define GL_DEPTH_COMPONENT16        0x81A5
+#define GL_DEPTH24_STENCIL8 0x88F0
+#define GL_DEPTH_COMPONENT32F       0x8CAC
+#define GL_TEXTURE_MAX_ANISOTROPY   0x84FE
+#define GL_MAX_TEXTURE_MAX_ANISOTROPY       0x84FF
+#define GL_TEXTURE_2D_ARRAY 0x8C1A
+#define GL_MAX_ARRAY_TEXTURE_LAYERS 0x88FF
+#define GL_PIXEL_PACK_BUFFER        0x88EB
+#define GL_STREAM_READ      0x88E1
+#define GL_MAP_READ_BIT     0x0001
+#define GL_SYNC_GPU_COMMANDS_COMPLETE       0x9117
+#define GL_ALREADY_SIGNALED 0x911A
+#define GL_CONDITION_SATISFIED      0x911C
+#define GL_SYNC_FLUSH_COMMANDS_BIT  0x00000001
+
+typedef char GLchar;
+#if defined(_WIN64)
+typedef signed   long long int khronos_ssize_t;
+typedef unsigned long long int khronos_usize_t;
+#else
+typedef signed   long  int     khronos_ssize_t;
+typedef unsigned long  int     khronos_usize_t;
+#endif
+typedef khronos_ssize_t GLsizeiptr;
+typedef khronos_ssize_t GLintptr;
+typedef unsigned long long int GLuint64;
+typedef signed long long int GLint64;
+typedef struct __GLsync* GLsync;
+
+struct oglFunctionsList
+{
+    GLuint(__stdcall *glCreateShader)(GLenum shaderType);
+    void(__stdcall *glShaderSource)(GLuint shader, GLsizei count, const GLchar** string, const GLint* length);
+    void(__stdcall *glCompileShader)(GLuint shader);
+    void(__stdcall *glGetShaderiv)(GLuint shader, GLenum pname, GLint* params);
+    void(__stdcall *glGetShaderInfoLog)(GLuint shader, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
+    GLuint(__stdcall *glCreateProgram)();
+    void(__stdcall *glAttachShader)(GLuint program, GLuint shader);
+    void(__stdcall *glLinkProgram)(GLuint program);
+    void(__stdcall *glGetProgramiv)(GLuint program, GLenum pname, GLint* params);
+    void(__stdcall *glGetProgramInfoLog)(GLuint program, GLsizei maxLength, GLsizei* length, GLchar* infoLog);
+    void(__stdcall *glDeleteShader)(GLuint shader);
+    void(__stdcall *glGenVertexArrays)(GLsizei n, GLuint* arrays);
+    void(__stdcall *glGenBuffers)(GLsizei n, GLuint* buffers);
+    void(__stdcall *glBindVertexArray)(GLuint vArray);
+    void(__stdcall *glBindBuffer)(GLenum target, GLuint buffer);
+    void(__stdcall *glBufferData)(GLenum target, GLsizeiptr size, const void* data, GLenum usage);
+    void(__stdcall *glVertexAttribPointer)(GLuint index, GLint size, GLenum type, GLboolean normalized, GLsizei stride, const void* pointer);
+    void(__stdcall *glEnableVertexAttribArray)(GLuint index);
+    void(__stdcall *glUseProgram)(GLuint program);
+    void(__stdcall *glDeleteVertexArrays)(GLsizei n, const GLuint* arrays);
+    void(__stdcall *glDeleteBuffers)(GLsizei n, const GLuint* buffers);
+    GLint(__stdcall *glGetUniformLocation)(GLuint program, const GLchar* name);
+    void(__stdcall *glUniformMatrix4fv)(GLint location, GLsizei count, GLboolean transpose, const GLfloat* value);
+    void(__stdcall *glGenerateMipmap)(GLenum target);
+    void(__stdcall *glUniform1i)(GLint location, GLint v0);
+    void(__stdcall *glActiveTexture)(GLenum texture);
+    void(__stdcall *glDrawArraysInstanced)(GLenum mode, GLint first, GLsizei count, GLsizei instancecount);
+    void(__stdcall *glVertexAttribDivisor)(GLuint index, GLuint divisor);
+    void(__stdcall *glBindBufferBase)(GLenum target, GLuint index, GLuint buffer);
+    GLuint(__stdcall *glGetUniformBlockIndex)(GLuint program, const GLchar* uniformBlockName);
+    void(__stdcall *glUniformBlockBinding)(GLuint program, GLuint uniformBlockIndex, GLuint uniformBlockBinding);
+    void(__stdcall *glDeleteProgram)(GLuint program);
+    void(__stdcall *glBindBufferRange)(GLenum target, GLuint index, GLuint buffer, GLintptr offset, GLsizeiptr size);
+    void(__stdcall *glTexBuffer)(GLenum target, GLenum internalformat, GLuint buffer);
+    void(__stdcall *glUniform1f)(GLint location, GLfloat v0);
+    void(__stdcall *glUniform1iv)(GLint location, GLsizei count, const GLint* value);
+    void(__stdcall *glGenQueries)(GLsizei n, GLuint* ids);
+    void(__stdcall *glDeleteQueries)(GLsizei n, const GLuint* ids);
+    void(__stdcall *glBeginQuery)(GLenum target, GLuint id);
+    void(__stdcall *glEndQuery)(GLenum target);
+    void(__stdcall *glGetQueryObjectuiv)(GLuint id, GLenum pname, GLuint* params);
+    void(__stdcall *glGetQueryObjectui64v)(GLuint id, GLenum pname, DWORD64* params);
+    void(__stdcall *glGenFramebuffers)(GLsizei n, GLuint* framebuffers);
+    void(__stdcall *glDeleteFramebuffers)(GLsizei n, const GLuint* framebuffers);
+    void(__stdcall *glBindFramebuffer)(GLenum target, GLuint framebuffer);
+    void(__stdcall *glFramebufferRenderbuffer)(GLenum target, GLenum attachment, GLenum renderbuffertarget, GLuint renderbuffer);
+    GLenum(__stdcall *glCheckFramebufferStatus)(GLenum target);
+    void(__stdcall *glGenRenderbuffers)(GLsizei n, GLuint* renderbuffers);
+    void(__stdcall *glDeleteRenderbuffers)(GLsizei n, const GLuint* renderbuffers);
+    void(__stdcall *glBindRenderbuffer)(GLenum target, GLuint renderbuffer);
+    void(__stdcall *glRenderbufferStorageMultisample)(GLenum target, GLsizei samples, GLenum internalformat, GLsizei width, GLsizei height);
+    void(__stdcall *glBlitFramebuffer)(GLint srcX0, GLint srcY0, GLint srcX1, GLint srcY1, GLint dstX0, GLint dstY0,
+        GLint dstX1, GLint dstY1, GLbitfield mask, GLenum filter);
+    void(__stdcall *glUniform2f)(GLint location, GLfloat v0, GLfloat v1);
+    void(__stdcall *glGenSamplers)(GLsizei count, GLuint* samplers);
+    void(__stdcall *glDeleteSamplers)(GLsizei count, const GLuint* samplers);
+    void(__stdcall *glBindSampler)(GLuint unit, GLuint sampler);
+    void(__stdcall *glSamplerParameteri)(GLuint sampler, GLenum pname, GLint param);
+    void(__stdcall *glSamplerParameterf)(GLuint sampler, GLenum pname, GLfloat param);
+    void(__stdcall *glTexImage3D)(GLenum target, GLint level, GLint internalformat, GLsizei width, GLsizei height,
+        GLsizei depth, GLint border, GLenum format, GLenum type, const void* pixels);
+    void(__stdcall *glTexSubImage3D)(GLenum target, GLint level, GLint xoffset, GLint yoffset, GLint zoffset,
+        GLsizei width, GLsizei height, GLsizei depth, GLenum format, GLenum type, const void* pixels);
+    void(__stdcall *glQueryCounter)(GLuint id, GLenum target);
+    void*(__stdcall *glMapBufferRange)(GLenum target, GLintptr offset, GLsizeiptr length, GLbitfield access);
+    GLboolean(__stdcall *glUnmapBuffer)(GLenum target);
+    GLsync(__stdcall *glFenceSync)(GLenum condition, GLbitfield flags);
+    GLenum(__stdcall *glClientWaitSync)(GLsync sync, GLbitfield flags, GLuint64 timeout);
+    void(__stdcall *glDeleteSync)(GLsync sync);
+    void(__stdcall *glGetInteger64v)(GLenum pname, GLint64* data);
+    void(__stdcall *glBufferSubData)(GLenum target, GLintptr offset, GLsizeiptr size, const void* data);
+};
+
+// Functions not required for run, entry is nullptr if not supported.
+struct oglOptionalFunctionsList
+{
+    void(__stdcall *glGetProgramBinary)(GLuint program, GLsizei bufSize, GLsizei* length, GLenum* binaryFormat, void* binary);
+    void(__stdcall *glProgramBinary)(GLuint program, GLenum binaryFormat, const void* binary, GLsizei length);
+    void(__stdcall *glProgramParameteri)(GLuint program, GLenum pname, GLint value);
+    BOOL(__stdcall *wglSwapIntervalEXT)(int interval);
+    int(__stdcall *wglGetSwapIntervalEXT)(void);
+};
+
+#endif // OPENGLIMPORT_H
@@ -0,0 +1,69 @@
+/*
+OpenGL GPUstress.
+Per-stage CPU profiling class.
+Stage times accumulated per frame, then summed for display window,
+window average is per-frame stage time in microseconds.
+*/
+
+#include "Profiler.h"
+
+Profiler::Profiler() : tscPeriod(0.0), frameTicks{ 0 }, windowTicks{ 0 }, windowFrames(0)
+{
+
+}
+Profiler::~Profiler()
+{
+
+}
+void Profiler::setTscPeriod(double period)
+{
+	tscPeriod = period;
+}
+void Profiler::resetStatistics()
+{
+	memset(frameTicks, 0, sizeof(frameTicks));
+	memset(windowTicks, 0, sizeof(windowTicks));
+	windowFrames = 0;
+}
+void Profiler::beginFrame(frameRecord& record)
+{
+	memset(frameTicks, 0, sizeof(frameTicks));
+	record.tsc[STAGE_BEGIN] = __rdtsc();
+}
+void Profiler::addZone(frameStage stage, DWORD64 ticks)
+{
+	frameTicks[stage] += ticks;
+}
+// Zone ticks of frame stored to frame record, index 0 is sum of all zones.
+void Profiler::endFrame(frameRecord& record)
+{
+	DWORD64 total = 0;
+	for (int i = STAGE_SETUP; i < STAGE_COUNT; i++)
+	{
+		windowTicks[i] += frameTicks[i];
+		record.ticks[i] = frameTicks[i];
+		total += frameTicks[i];
+	}
+	record.ticks[STAGE_BEGIN] = total;
+	windowTicks[STAGE_BEGIN] += total;   // Index 0 accumulates sum of all zones.
+	windowFrames++;
+}
+// Stage ticks of current frame, valid after zones of stage finished.
+DWORD64 Profiler::getFrameTicks(frameStage stage)
+{
+	return frameTicks[stage];
+}
+// Per-frame average stage times for window, STAGE_BEGIN index returns total of zones.
+// Window restarts after read.
+BOOL Profiler::getWindowMicroseconds(double* microseconds)
+{
+	if (!windowFrames) return FALSE;
+	double k = tscPeriod * 1000000.0 / windowFrames;
+	for (int i = 0; i < STAGE_COUNT; i++)
+	{
+		microseconds[i] = windowTicks[i] * k;
+		windowTicks[i] = 0;
+	}
+	windowFrames = 0;
+	return TRUE;
+}
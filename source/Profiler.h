@@ -0,0 +1,54 @@
+/*
+OpenGL GPUstress.
+Per-stage CPU profiling class header.
+Scoped TSC zones mark draw stages, profiler aggregates stage times per frame.
+*/
+
+#pragma once
+#ifndef PROFILER_H
+#define PROFILER_H
+
+#include <windows.h>
+#include <intrin.h>
+#include "Global.h"
+#include "Telemetry.h"
+
+class Profiler
+{
+public:
+    Profiler();
+    ~Profiler();
+    void setTscPeriod(double period);
+    void resetStatistics();
+    void beginFrame(frameRecord& record);
+    void addZone(frameStage stage, DWORD64 ticks);
+    void endFrame(frameRecord& record);
+    DWORD64 getFrameTicks(frameStage stage);
+    BOOL getWindowMicroseconds(double* microseconds);
+private:
+    double tscPeriod;
+    DWORD64 frameTicks[STAGE_COUNT];
+    DWORD64 windowTicks[STAGE_COUNT];
+    DWORD64 windowFrames;
+};
+
+// Scoped zone: measures own lifetime, stores stage end timestamp to frame record.
+class ProfileZone
+{
+public:
+    ProfileZone(Profiler& p, frameRecord& r, frameStage s) :
+        profiler(p), record(r), stage(s), start(__rdtsc()) { }
+    ~ProfileZone()
+    {
+        DWORD64 stop = __rdtsc();
+        record.tsc[stage] = stop;
+        profiler.addZone(stage, stop - start);
+    }
+private:
+    Profiler& profiler;
+    frameRecord& record;
+    frameStage stage;
+    DWORD64 start;
+};
+
+#endif // PROFILER_H
@@ -0,0 +1,342 @@
+/*
+OpenGL GPUstress.
+Render target class.
+Scene time and samples passed depth test measured by GPU queries, read
+with frames latency without wait. Fill rate normalized by bandwidth:
+samples per second multiplied by color and depth bytes per sample.
+Multisampled color resolved to single sample target of same format
+(blit from multisampled target requires same formats), then copied to window.
+*/
+
+#include "RenderTarget.h"
+
+RenderTarget::RenderTarget() : f(nullptr), width(0), height(0), maxSamples(1), drawFbo(0), resolveFbo(0),
+	                           colorBuffer(0), depthBuffer(0), resolveBuffer(0),
+	                           colorNow(TARGET_COLOR_DEFAULT), depthNow(TARGET_D24S8), samplesNow(0),
+	                           colorSelected(TARGET_COLOR_DEFAULT), depthSelected(TARGET_D24S8), samplesSelected(0),
+	                           queries{ { 0 } }, queriesIssued{ 0 }, queryNext(0),
+	                           windowDrawNs(0), windowResolveNs(0), windowSamples(0), windowFrames(0),
+	                           sweepState(TARGET_SWEEP_OFF), sweepIndex(0), sweepFrame(0), results{ 0 }
+{
+
+}
+RenderTarget::~RenderTarget()
+{
+
+}
+int RenderTarget::init(const oglFunctionsList* pFunctions, GLsizei viewWidth, GLsizei viewHeight)
+{
+	f = pFunctions;
+	width = viewWidth;
+	height = viewHeight;
+	glGetIntegerv(GL_MAX_SAMPLES, &maxSamples);
+	if (glGetError()) return 0x160;
+	f->glGenQueries(APPCONST::TARGET_QUERY_FRAMES * 3, &queries[0][0]);
+	if (glGetError() || (!queries[0][0])) return 0x161;
+	return 0;
+}
+void RenderTarget::release()
+{
+	if (!f) return;
+	destroy();
+	if (queries[0][0]) f->glDeleteQueries(APPCONST::TARGET_QUERY_FRAMES * 3, &queries[0][0]);
+	queries[0][0] = 0;
+}
+// Window resized, attachments of active target recreated with new size.
+// Queries issued for old size discarded.
+void RenderTarget::resize(GLsizei viewWidth, GLsizei viewHeight)
+{
+	if ((viewWidth == width) && (viewHeight == height)) return;
+	width = viewWidth;
+	height = viewHeight;
+	if (!f) return;
+	resetWindow();
+	if (colorNow == TARGET_COLOR_DEFAULT) return;
+	destroy();
+	create();
+}
+// User selected target, applied if format sweep not running.
+BOOL RenderTarget::select(targetColor color, targetDepth depth, int samplesIndex)
+{
+	colorSelected = color;
+	depthSelected = depth;
+	samplesSelected = samplesIndex;
+	if (sweepState == TARGET_SWEEP_RUNNING) return TRUE;
+	return apply(color, depth, samplesIndex);
+}
+// Target selected, it is framebuffer object or not supported formats combination.
+BOOL RenderTarget::getActive()
+{
+	return (colorNow != TARGET_COLOR_DEFAULT);
+}
+// Called before frame clear, scene rendered to framebuffer object.
+void RenderTarget::beginFrame()
+{
+	if (!drawFbo) return;
+	f->glBindFramebuffer(GL_FRAMEBUFFER, drawFbo);
+	int slot = queryNext;
+	readQueries(slot);
+	f->glBeginQuery(GL_TIME_ELAPSED, queries[slot][0]);
+	f->glBeginQuery(GL_SAMPLES_PASSED, queries[slot][1]);
+}
+// Called after scene draw, before text overlay, window framebuffer bound at return.
+void RenderTarget::endFrame(unsigned int load)
+{
+	if (drawFbo)
+	{
+		int slot = queryNext;
+		f->glEndQuery(GL_SAMPLES_PASSED);
+		f->glEndQuery(GL_TIME_ELAPSED);
+		f->glBeginQuery(GL_TIME_ELAPSED, queries[slot][2]);
+		GLuint source = drawFbo;
+		if (resolveFbo)
+		{
+			f->glBindFramebuffer(GL_READ_FRAMEBUFFER, drawFbo);
+			f->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, resolveFbo);
+			f->glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+			source = resolveFbo;
+		}
+		f->glBindFramebuffer(GL_READ_FRAMEBUFFER, source);
+		f->glBindFramebuffer(GL_DRAW_FRAMEBUFFER, 0);
+		f->glBlitFramebuffer(0, 0, width, height, 0, 0, width, height, GL_COLOR_BUFFER_BIT, GL_NEAREST);
+		f->glEndQuery(GL_TIME_ELAPSED);
+		f->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+		queriesIssued[slot] = TRUE;
+		queryNext = (slot + 1) % APPCONST::TARGET_QUERY_FRAMES;
+	}
+	if (sweepState != TARGET_SWEEP_RUNNING) return;
+	sweepFrame++;
+	if (sweepFrame == APPCONST::TARGET_WARMUP_FRAMES)
+	{
+		resetWindow();
+	}
+	else if (sweepFrame >= (APPCONST::TARGET_WARMUP_FRAMES + APPCONST::TARGET_MEASURE_FRAMES))
+	{
+		targetResult& r = results[sweepIndex];
+		r.supported = TRUE;
+		r.load = load;
+		r.drawMilliseconds = windowFrames ? (windowDrawNs / 1.0E6 / windowFrames) : 0.0;
+		r.resolveMilliseconds = windowFrames ? (windowResolveNs / 1.0E6 / windowFrames) : 0.0;
+		r.samplesPerFrame = windowFrames ? (static_cast<double>(windowSamples) / windowFrames) : 0.0;
+		nextConfig();
+	}
+}
+// Sweep of all framebuffer object formats combinations at current load and options.
+void RenderTarget::startSweep()
+{
+	memset(results, 0, sizeof(results));
+	sweepState = TARGET_SWEEP_RUNNING;
+	sweepIndex = -1;
+	nextConfig();
+}
+void RenderTarget::stopSweep()
+{
+	sweepState = TARGET_SWEEP_OFF;
+	apply(colorSelected, depthSelected, samplesSelected);
+}
+targetSweepState RenderTarget::getSweepState()
+{
+	return sweepState;
+}
+// Fixed target row shows averages for display update interval, window restarts after read.
+void RenderTarget::writeRow(char* row, int size)
+{
+	char szResults[APPCONST::MAX_TEXT_STRING];
+	if (sweepState == TARGET_SWEEP_RUNNING)
+	{
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "Sweep(W) %d/%d %s %s %dx", sweepIndex + 1, TARGET_CONFIGS,
+			colorFormats[colorNow].name, depthFormats[depthNow].name, samplesCounts[samplesNow]);
+	}
+	else if (sweepState == TARGET_SWEEP_DONE)
+	{
+		int supported = 0;
+		for (int i = 0; i < TARGET_CONFIGS; i++)
+		{
+			if (results[i].supported) supported++;
+		}
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "Sweep(W) done, %d of %d targets supported (W=close)",
+			supported, TARGET_CONFIGS);
+	}
+	else if (!drawFbo)
+	{
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "%s %s %dx not supported",
+			colorFormats[colorNow].name, depthFormats[depthNow].name, samplesCounts[samplesNow]);
+	}
+	else
+	{
+		double drawSeconds = windowDrawNs / 1.0E9;
+		double samplesPerSecond = (drawSeconds > 0.0) ? (windowSamples / drawSeconds) : 0.0;
+		int bytes = colorFormats[colorNow].bytes + depthFormats[depthNow].bytes;
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "%-7s %-5s %dx GPU ms %-6.3f Res %-6.3f Gsmp/s %-6.2f GB/s %-6.1f",
+			colorFormats[colorNow].name, depthFormats[depthNow].name, samplesCounts[samplesNow],
+			windowFrames ? (windowDrawNs / 1.0E6 / windowFrames) : 0.0,
+			windowFrames ? (windowResolveNs / 1.0E6 / windowFrames) : 0.0,
+			samplesPerSecond / 1.0E9, samplesPerSecond * bytes / 1.0E9);
+		windowDrawNs = 0;
+		windowResolveNs = 0;
+		windowSamples = 0;
+		windowFrames = 0;
+	}
+	snprintf(row, size, "%-*s", size - 1, szResults);
+}
+BOOL RenderTarget::saveReport(const char* fileName)
+{
+	if (sweepState != TARGET_SWEEP_DONE) return FALSE;
+	return report.save(fileName);
+}
+const char* RenderTarget::getColorName(targetColor color)
+{
+	return colorFormats[color].name;
+}
+const char* RenderTarget::getDepthName(targetDepth depth)
+{
+	return depthFormats[depth].name;
+}
+int RenderTarget::getSamples(int samplesIndex)
+{
+	return samplesCounts[samplesIndex];
+}
+BOOL RenderTarget::apply(targetColor color, targetDepth depth, int samplesIndex)
+{
+	if ((color == colorNow) && (depth == depthNow) && (samplesIndex == samplesNow))
+	{
+		return (color == TARGET_COLOR_DEFAULT) || drawFbo;
+	}
+	destroy();
+	colorNow = color;
+	depthNow = depth;
+	samplesNow = samplesIndex;
+	resetWindow();
+	if (color == TARGET_COLOR_DEFAULT) return TRUE;
+	return create();
+}
+// Not complete framebuffer means formats and samples combination not supported.
+BOOL RenderTarget::create()
+{
+	int samples = samplesCounts[samplesNow];
+	if (samples > maxSamples) return FALSE;
+	GLsizei storageSamples = (samples > 1) ? samples : 0;
+	const targetFormat& color = colorFormats[colorNow];
+	const targetFormat& depth = depthFormats[depthNow];
+	f->glGenFramebuffers(1, &drawFbo);
+	f->glGenRenderbuffers(1, &colorBuffer);
+	f->glGenRenderbuffers(1, &depthBuffer);
+	f->glBindRenderbuffer(GL_RENDERBUFFER, colorBuffer);
+	f->glRenderbufferStorageMultisample(GL_RENDERBUFFER, storageSamples, color.internalFormat, width, height);
+	f->glBindRenderbuffer(GL_RENDERBUFFER, depthBuffer);
+	f->glRenderbufferStorageMultisample(GL_RENDERBUFFER, storageSamples, depth.internalFormat, width, height);
+	f->glBindFramebuffer(GL_FRAMEBUFFER, drawFbo);
+	f->glFramebufferRenderbuffer(GL_FRAMEBUFFER, color.attachment, GL_RENDERBUFFER, colorBuffer);
+	f->glFramebufferRenderbuffer(GL_FRAMEBUFFER, depth.attachment, GL_RENDERBUFFER, depthBuffer);
+	BOOL status = (f->glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+	if (status && (samples > 1))
+	{
+		f->glGenFramebuffers(1, &resolveFbo);
+		f->glGenRenderbuffers(1, &resolveBuffer);
+		f->glBindRenderbuffer(GL_RENDERBUFFER, resolveBuffer);
+		f->glRenderbufferStorageMultisample(GL_RENDERBUFFER, 0, color.internalFormat, width, height);
+		f->glBindFramebuffer(GL_FRAMEBUFFER, resolveFbo);
+		f->glFramebufferRenderbuffer(GL_FRAMEBUFFER, color.attachment, GL_RENDERBUFFER, resolveBuffer);
+		status = (f->glCheckFramebufferStatus(GL_FRAMEBUFFER) == GL_FRAMEBUFFER_COMPLETE);
+	}
+	f->glBindFramebuffer(GL_FRAMEBUFFER, 0);
+	f->glBindRenderbuffer(GL_RENDERBUFFER, 0);
+	if (glGetError()) status = FALSE;
+	if (!status) destroy();
+	return status;
+}
+void RenderTarget::destroy()
+{
+	if (drawFbo)       f->glDeleteFramebuffers(1, &drawFbo);
+	if (resolveFbo)    f->glDeleteFramebuffers(1, &resolveFbo);
+	if (colorBuffer)   f->glDeleteRenderbuffers(1, &colorBuffer);
+	if (depthBuffer)   f->glDeleteRenderbuffers(1, &depthBuffer);
+	if (resolveBuffer) f->glDeleteRenderbuffers(1, &resolveBuffer);
+	drawFbo = 0;
+	resolveFbo = 0;
+	colorBuffer = 0;
+	depthBuffer = 0;
+	resolveBuffer = 0;
+}
+// Queries of frame slot read before slot reuse, results not ready yet are skipped.
+void RenderTarget::readQueries(int slot)
+{
+	if (!queriesIssued[slot]) return;
+	queriesIssued[slot] = FALSE;
+	GLuint available = 0;
+	f->glGetQueryObjectuiv(queries[slot][2], GL_QUERY_RESULT_AVAILABLE, &available);
+	if (!available) return;
+	DWORD64 value = 0;
+	f->glGetQueryObjectui64v(queries[slot][0], GL_QUERY_RESULT, &value);
+	windowDrawNs += value;
+	f->glGetQueryObjectui64v(queries[slot][1], GL_QUERY_RESULT, &value);
+	windowSamples += value;
+	f->glGetQueryObjectui64v(queries[slot][2], GL_QUERY_RESULT, &value);
+	windowResolveNs += value;
+	windowFrames++;
+}
+// Queries issued for previous target or warmup frames are discarded.
+void RenderTarget::resetWindow()
+{
+	memset(queriesIssued, 0, sizeof(queriesIssued));
+	windowDrawNs = 0;
+	windowResolveNs = 0;
+	windowSamples = 0;
+	windowFrames = 0;
+}
+// Sweep order: color, depth, samples, not supported combinations skipped,
+// user selected target restored and report built after last combination.
+void RenderTarget::nextConfig()
+{
+	while (++sweepIndex < TARGET_CONFIGS)
+	{
+		targetColor color = static_cast<targetColor>(sweepIndex / (TARGET_DEPTHS_COUNT * TARGET_SAMPLES_COUNT) + 1);
+		targetDepth depth = static_cast<targetDepth>(sweepIndex / TARGET_SAMPLES_COUNT % TARGET_DEPTHS_COUNT);
+		if (apply(color, depth, sweepIndex % TARGET_SAMPLES_COUNT) && drawFbo)
+		{
+			sweepFrame = 0;
+			return;
+		}
+		results[sweepIndex].supported = FALSE;
+	}
+	sweepState = TARGET_SWEEP_DONE;
+	apply(colorSelected, depthSelected, samplesSelected);
+
+	report.clear();
+	report.add("Render targets sweep %dx%d, GB/s is samples/s multiplied by color and depth bytes per sample\r\n", width, height);
+	report.add("color,depth,samples,bytes per sample,instances,scene GPU ms,resolve GPU ms,Msamples/frame,Gsamples/s,GB/s\r\n");
+	for (int i = 0; i < TARGET_CONFIGS; i++)
+	{
+		const targetFormat& color = colorFormats[i / (TARGET_DEPTHS_COUNT * TARGET_SAMPLES_COUNT) + 1];
+		const targetFormat& depth = depthFormats[i / TARGET_SAMPLES_COUNT % TARGET_DEPTHS_COUNT];
+		int samples = samplesCounts[i % TARGET_SAMPLES_COUNT];
+		const targetResult& r = results[i];
+		if (!r.supported)
+		{
+			report.add("%s,%s,%d,%d,,,,,,not supported\r\n", color.name, depth.name, samples, color.bytes + depth.bytes);
+			continue;
+		}
+		double samplesPerSecond = (r.drawMilliseconds > 0.0) ? (r.samplesPerFrame / (r.drawMilliseconds / 1000.0)) : 0.0;
+		report.add("%s,%s,%d,%d,%u,%.3f,%.3f,%.3f,%.3f,%.1f\r\n", color.name, depth.name, samples, color.bytes + depth.bytes,
+			r.load, r.drawMilliseconds, r.resolveMilliseconds, r.samplesPerFrame / 1.0E6, samplesPerSecond / 1.0E9,
+			samplesPerSecond * (color.bytes + depth.bytes) / 1.0E9);
+	}
+}
+
+const targetFormat RenderTarget::colorFormats[]
+{
+	{ 0,              0,                    4,  "Window"  },
+	{ GL_RGBA8,       GL_COLOR_ATTACHMENT0, 4,  "RGBA8"   },
+	{ GL_RGB10_A2,    GL_COLOR_ATTACHMENT0, 4,  "RGB10A2" },
+	{ GL_RGBA16F,     GL_COLOR_ATTACHMENT0, 8,  "RGBA16F" },
+	{ GL_RGBA32F,     GL_COLOR_ATTACHMENT0, 16, "RGBA32F" }
+};
+
+const targetFormat RenderTarget::depthFormats[]
+{
+	{ GL_DEPTH_COMPONENT16,  GL_DEPTH_ATTACHMENT,         2, "D16"   },
+	{ GL_DEPTH24_STENCIL8,   GL_DEPTH_STENCIL_ATTACHMENT, 4, "D24S8" },
+	{ GL_DEPTH_COMPONENT32F, GL_DEPTH_ATTACHMENT,         4, "D32F"  }
+};
+
+const int RenderTarget::samplesCounts[] { 1, 2, 4, 8 };
@@ -0,0 +1,124 @@
+/*
+OpenGL GPUstress.
+Render target class header.
+Scene rendered to framebuffer object of selected color and depth formats
+and samples count, multisampled target resolved, then copied to window.
+Format sweep measures all formats combinations.
+*/
+
+#pragma once
+#ifndef RENDERTARGET_H
+#define RENDERTARGET_H
+
+#include <windows.h>
+#include <iostream>
+#include "Global.h"
+#include "OpenGLImport.h"
+#include "Report.h"
+
+enum targetColor
+{
+    TARGET_COLOR_DEFAULT = 0,   // Window framebuffer, no framebuffer object.
+    TARGET_RGBA8,
+    TARGET_RGB10A2,
+    TARGET_RGBA16F,
+    TARGET_RGBA32F,
+    TARGET_COLORS_COUNT
+};
+
+enum targetDepth
+{
+    TARGET_D16 = 0,
+    TARGET_D24S8,
+    TARGET_D32F,
+    TARGET_DEPTHS_COUNT
+};
+
+enum targetSweepState
+{
+    TARGET_SWEEP_OFF = 0,
+    TARGET_SWEEP_RUNNING,
+    TARGET_SWEEP_DONE
+};
+
+constexpr int TARGET_SAMPLES_COUNT = 4;     // 1, 2, 4, 8 samples.
+constexpr int TARGET_CONFIGS = (TARGET_COLORS_COUNT - 1) * TARGET_DEPTHS_COUNT * TARGET_SAMPLES_COUNT;
+
+struct targetFormat
+{
+    GLenum internalFormat;
+    GLenum attachment;
+    int bytes;
+    const char* name;
+};
+
+// Measured target: GPU time of scene and resolve, samples passed depth test per frame.
+struct targetResult
+{
+    BOOL supported;
+    unsigned int load;
+    double drawMilliseconds;
+    double resolveMilliseconds;
+    double samplesPerFrame;
+};
+
+class RenderTarget
+{
+public:
+    RenderTarget();
+    ~RenderTarget();
+    int init(const oglFunctionsList* pFunctions, GLsizei viewWidth, GLsizei viewHeight);
+    void release();
+    void resize(GLsizei viewWidth, GLsizei viewHeight);
+    BOOL select(targetColor color, targetDepth depth, int samplesIndex);
+    BOOL getActive();
+    void beginFrame();
+    void endFrame(unsigned int load);
+    void startSweep();
+    void stopSweep();
+    targetSweepState getSweepState();
+    void writeRow(char* row, int size);
+    BOOL saveReport(const char* fileName);
+    static const char* getColorName(targetColor color);
+    static const char* getDepthName(targetDepth depth);
+    static int getSamples(int samplesIndex);
+private:
+    BOOL apply(targetColor color, targetDepth depth, int samplesIndex);
+    BOOL create();
+    void destroy();
+    void readQueries(int slot);
+    void resetWindow();
+    void nextConfig();
+    const oglFunctionsList* f;
+    GLsizei width;
+    GLsizei height;
+    GLint maxSamples;
+    GLuint drawFbo;
+    GLuint resolveFbo;
+    GLuint colorBuffer;
+    GLuint depthBuffer;
+    GLuint resolveBuffer;
+    targetColor colorNow;
+    targetDepth depthNow;
+    int samplesNow;
+    targetColor colorSelected;
+    targetDepth depthSelected;
+    int samplesSelected;
+    GLuint queries[APPCONST::TARGET_QUERY_FRAMES][3];     // Scene time, samples passed, resolve time.
+    BOOL queriesIssued[APPCONST::TARGET_QUERY_FRAMES];
+    int queryNext;
+    DWORD64 windowDrawNs;
+    DWORD64 windowResolveNs;
+    DWORD64 windowSamples;
+    DWORD64 windowFrames;
+    targetSweepState sweepState;
+    int sweepIndex;
+    int sweepFrame;
+    targetResult results[TARGET_CONFIGS];
+    Report report;
+    static const targetFormat colorFormats[];
+    static const targetFormat depthFormats[];
+    static const int samplesCounts[];
+};
+
+#endif // RENDERTARGET_H
@@ -0,0 +1,215 @@
+/*
+OpenGL GPUstress.
+Record and replay class.
+Log is raw draw options records, record size in header checked at load,
+logs are valid for same application build. Replay frame CPU time is interval
+between frames starts without pacing wait, GPU time is filled by OpenGL class
+from timestamps. Per-frame report of two runs can be compared line by line.
+*/
+
+#include "Replay.h"
+
+Replay::Replay() : state(REPLAY_OFF), hFile(INVALID_HANDLE_VALUE), records(nullptr), bufferUsed(0), framesCount(0),
+	               frameIndex(0), paced(FALSE), tscPeriod(0.0), startTsc(0), lastTsc(0),
+	               cpuMilliseconds(nullptr), gpuMilliseconds(nullptr)
+{
+
+}
+Replay::~Replay()
+{
+	stopRecord();
+	release();
+}
+BOOL Replay::startRecord(const char* fileName)
+{
+	if (state == REPLAY_PLAYING) return FALSE;
+	stopRecord();
+	release();
+	records = new drawOptions[APPCONST::REPLAY_BUFFER_RECORDS];
+	hFile = CreateFile(fileName, GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE)
+	{
+		release();
+		return FALSE;
+	}
+	replayFileHeader header = { APPCONST::REPLAY_SIGNATURE, sizeof(drawOptions), 0, 0 };
+	DWORD written = 0;
+	if ((!WriteFile(hFile, &header, sizeof(header), &written, nullptr)) || (written != sizeof(header)))
+	{
+		CloseHandle(hFile);
+		hFile = INVALID_HANDLE_VALUE;
+		release();
+		return FALSE;
+	}
+	bufferUsed = 0;
+	framesCount = 0;
+	state = REPLAY_RECORDING;
+	return TRUE;
+}
+// Frames count written to header at stop, log without it not loaded.
+void Replay::stopRecord()
+{
+	if (state != REPLAY_RECORDING) return;
+	flushBuffer();
+	replayFileHeader header = { APPCONST::REPLAY_SIGNATURE, sizeof(drawOptions), framesCount, 0 };
+	DWORD written = 0;
+	SetFilePointer(hFile, 0, nullptr, FILE_BEGIN);
+	WriteFile(hFile, &header, sizeof(header), &written, nullptr);
+	CloseHandle(hFile);
+	hFile = INVALID_HANDLE_VALUE;
+	release();
+	state = REPLAY_OFF;
+}
+// Called with final options of frame, before draw.
+void Replay::record(const drawOptions& options)
+{
+	if (state != REPLAY_RECORDING) return;
+	if (framesCount >= APPCONST::REPLAY_MAX_FRAMES)
+	{
+		stopRecord();
+		return;
+	}
+	records[bufferUsed++] = options;
+	framesCount++;
+	if (bufferUsed == APPCONST::REPLAY_BUFFER_RECORDS)
+	{
+		flushBuffer();
+	}
+}
+BOOL Replay::startReplay(const char* fileName, BOOL pacedReplay, double period)
+{
+	stopRecord();
+	release();
+	HANDLE hLog = CreateFile(fileName, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hLog == INVALID_HANDLE_VALUE) return FALSE;
+	replayFileHeader header = { 0 };
+	DWORD read = 0;
+	BOOL status = ReadFile(hLog, &header, sizeof(header), &read, nullptr) && (read == sizeof(header)) &&
+		(header.signature == APPCONST::REPLAY_SIGNATURE) && (header.recordSize == sizeof(drawOptions)) &&
+		header.framesCount && (header.framesCount <= APPCONST::REPLAY_MAX_FRAMES);
+	if (status)
+	{
+		records = new drawOptions[header.framesCount];
+		cpuMilliseconds = new double[header.framesCount];
+		gpuMilliseconds = new double[header.framesCount];
+		memset(cpuMilliseconds, 0, header.framesCount * sizeof(double));
+		memset(gpuMilliseconds, 0, header.framesCount * sizeof(double));
+		DWORD bytes = header.framesCount * sizeof(drawOptions);
+		status = ReadFile(hLog, records, bytes, &read, nullptr) && (read == bytes);
+	}
+	CloseHandle(hLog);
+	if (!status)
+	{
+		release();
+		return FALSE;
+	}
+	framesCount = header.framesCount;
+	frameIndex = 0;
+	paced = pacedReplay;
+	tscPeriod = period;
+	startTsc = 0;
+	lastTsc = 0;
+	state = REPLAY_PLAYING;
+	return TRUE;
+}
+// Called before draw, sets options of next logged frame, returns FALSE after last frame.
+// Paced replay: frame N starts not before N timesteps from first frame start.
+BOOL Replay::frame(drawOptions& options)
+{
+	if (state != REPLAY_PLAYING) return FALSE;
+	DWORD64 now = __rdtsc();
+	if (frameIndex)
+	{
+		cpuMilliseconds[frameIndex - 1] = (now - lastTsc) * tscPeriod * 1000.0;
+	}
+	else
+	{
+		startTsc = now;
+	}
+	if (frameIndex >= framesCount)
+	{
+		state = REPLAY_DONE;
+		return FALSE;
+	}
+	if (paced && frameIndex)
+	{
+		DWORD64 deadline = startTsc + static_cast<DWORD64>(frameIndex * APPCONST::REPLAY_TIMESTEP / tscPeriod);
+		while ((now = __rdtsc()) < deadline)
+		{
+			if (((deadline - now) * tscPeriod) > 0.002)
+			{
+				Sleep(1);
+			}
+			else
+			{
+				YieldProcessor();
+			}
+		}
+	}
+	lastTsc = now;
+	options = records[frameIndex++];
+	return TRUE;
+}
+replayState Replay::getState()
+{
+	return state;
+}
+// Per-frame GPU times buffer, filled by OpenGL class frame timing.
+double* Replay::getGpuMilliseconds()
+{
+	return gpuMilliseconds;
+}
+DWORD32 Replay::getFramesCount()
+{
+	return framesCount;
+}
+BOOL Replay::saveReport(const char* fileName)
+{
+	if ((state != REPLAY_DONE) || (!records)) return FALSE;
+	HANDLE hReport = CreateFile(fileName, GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hReport == INVALID_HANDLE_VALUE) return FALSE;
+	char* text = new char[APPCONST::REPORT_BUFFER_SIZE];
+	int used = snprintf(text, APPCONST::REPORT_BUFFER_SIZE, "Replay %u frames, %s\r\n"
+		"frame,seconds,instances,mode,depth test,CPU frame ms,GPU frame ms\r\n",
+		framesCount, paced ? "paced" : "as fast as possible");
+	BOOL status = TRUE;
+	for (DWORD32 i = 0; (i < framesCount) && status; i++)
+	{
+		const drawOptions& r = records[i];
+		used += snprintf(text + used, APPCONST::REPLAY_TEXT_RECORD, "%u,%.6f,%u,%d,%d,%.3f,%.3f\r\n",
+			i, r.seconds, r.load, r.mode, r.depthTest, cpuMilliseconds[i], gpuMilliseconds[i]);
+		if ((used > (APPCONST::REPORT_BUFFER_SIZE - APPCONST::REPLAY_TEXT_RECORD)) || (i == (framesCount - 1)))
+		{
+			DWORD written = 0;
+			status = WriteFile(hReport, text, used, &written, nullptr) && (written == static_cast<DWORD>(used));
+			used = 0;
+		}
+	}
+	delete[] text;
+	CloseHandle(hReport);
+	return status;
+}
+BOOL Replay::getStatusText(char* text, int size)
+{
+	if ((state != REPLAY_PLAYING) || ((frameIndex & 0x3F) != 1)) return FALSE;
+	snprintf(text, size, "Replay frame %u/%u, %s", frameIndex, framesCount, paced ? "paced" : "as fast as possible");
+	return TRUE;
+}
+BOOL Replay::flushBuffer()
+{
+	if (!bufferUsed) return TRUE;
+	DWORD written = 0;
+	DWORD bytes = bufferUsed * sizeof(drawOptions);
+	BOOL status = WriteFile(hFile, records, bytes, &written, nullptr) && (written == bytes);
+	bufferUsed = 0;
+	return status;
+}
+void Replay::release()
+{
+	if (records)         delete[] records;
+	if (cpuMilliseconds) delete[] cpuMilliseconds;
+	if (gpuMilliseconds) delete[] gpuMilliseconds;
+	records = nullptr;
+	cpuMilliseconds = nullptr;
+	gpuMilliseconds = nullptr;
+}
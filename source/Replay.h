@@ -0,0 +1,68 @@
+/*
+OpenGL GPUstress.
+Record and replay class header.
+Recording logs per-frame animation time and draw options, replay feeds
+logged frames back to draw, as fast as possible or paced at fixed timestep,
+and writes per-frame CPU and GPU times for frame by frame compare of runs.
+*/
+
+#pragma once
+#ifndef REPLAY_H
+#define REPLAY_H
+
+#include <windows.h>
+#include <iostream>
+#include <intrin.h>
+#include "Global.h"
+#include "OpenGL.h"
+
+enum replayState
+{
+    REPLAY_OFF = 0,
+    REPLAY_RECORDING,
+    REPLAY_PLAYING,
+    REPLAY_DONE
+};
+
+// Replay log file header, followed by frame records, record is draw options with animation time.
+struct replayFileHeader
+{
+    DWORD32 signature;
+    DWORD32 recordSize;
+    DWORD32 framesCount;
+    DWORD32 reserved;
+};
+
+class Replay
+{
+public:
+    Replay();
+    ~Replay();
+    BOOL startRecord(const char* fileName);
+    void stopRecord();
+    void record(const drawOptions& options);
+    BOOL startReplay(const char* fileName, BOOL pacedReplay, double period);
+    BOOL frame(drawOptions& options);
+    replayState getState();
+    double* getGpuMilliseconds();
+    DWORD32 getFramesCount();
+    BOOL saveReport(const char* fileName);
+    BOOL getStatusText(char* text, int size);
+private:
+    BOOL flushBuffer();
+    void release();
+    replayState state;
+    HANDLE hFile;
+    drawOptions* records;
+    DWORD32 bufferUsed;
+    DWORD32 framesCount;
+    DWORD32 frameIndex;
+    BOOL paced;
+    double tscPeriod;
+    DWORD64 startTsc;
+    DWORD64 lastTsc;
+    double* cpuMilliseconds;
+    double* gpuMilliseconds;
+};
+
+#endif // REPLAY_H
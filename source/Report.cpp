@@ -0,0 +1,48 @@
+/*
+OpenGL GPUstress.
+Text report class.
+*/
+
+#include "Report.h"
+
+Report::Report() : used(0)
+{
+	buffer = new char[APPCONST::REPORT_BUFFER_SIZE];
+	memset(buffer, 0, APPCONST::REPORT_BUFFER_SIZE);
+}
+Report::~Report()
+{
+	if (buffer) delete[] buffer;
+}
+void Report::clear()
+{
+	used = 0;
+	if (buffer) buffer[0] = 0;
+}
+void Report::add(const char* format, ...)
+{
+	if ((!buffer) || (used >= (APPCONST::REPORT_BUFFER_SIZE - 1))) return;
+	va_list args;
+	va_start(args, format);
+	int k = vsnprintf(buffer + used, APPCONST::REPORT_BUFFER_SIZE - used, format, args);
+	va_end(args);
+	if (k > 0)
+	{
+		used += k;
+		if (used >= APPCONST::REPORT_BUFFER_SIZE) used = APPCONST::REPORT_BUFFER_SIZE - 1;
+	}
+}
+BOOL Report::save(const char* fileName)
+{
+	if (!buffer) return FALSE;
+	HANDLE hFile = CreateFile(fileName, GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) return FALSE;
+	DWORD written = 0;
+	BOOL status = WriteFile(hFile, buffer, static_cast<DWORD>(used), &written, nullptr);
+	CloseHandle(hFile);
+	return status && (written == used);
+}
+const char* Report::getText()
+{
+	return buffer;
+}
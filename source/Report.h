@@ -0,0 +1,30 @@
+/*
+OpenGL GPUstress.
+Text report class header.
+Benchmark results tables formatted to memory buffer and saved as text file.
+*/
+
+#pragma once
+#ifndef REPORT_H
+#define REPORT_H
+
+#include <windows.h>
+#include <iostream>
+#include <stdarg.h>
+#include "Global.h"
+
+class Report
+{
+public:
+    Report();
+    ~Report();
+    void clear();
+    void add(const char* format, ...);
+    BOOL save(const char* fileName);
+    const char* getText();
+private:
+    char* buffer;
+    size_t used;
+};
+
+#endif // REPORT_H
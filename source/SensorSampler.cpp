@@ -0,0 +1,408 @@
+/*
+OpenGL GPUstress.
+Sensor telemetry sampler class.
+Sysfs nodes discovered at start, node file reopened for each read, sysfs
+attribute value is generated at open. Energy counters converted to watts
+by delta between samples, counter wrap handled by node range.
+Trace is CSV line per sample, channels columns in discovery order.
+*/
+
+#include "SensorSampler.h"
+
+SensorSampler::SensorSampler() : channels(nullptr), channelsCount(0), cpuPaths(nullptr), cpusCount(0), hFile(INVALID_HANDLE_VALUE),
+	                             hThread(NULL), hStopEvent(NULL), snapshot{ 0 }, period(APPCONST::SENSOR_DEFAULT_PERIOD_MS),
+	                             tscFrequency(0.0), lastTsc(0), framesCount(0), instancesCount(0), lastFrames(0), lastInstances(0)
+{
+	InitializeCriticalSection(&snapshotLock);
+	channels = new sensorChannel[APPCONST::SENSOR_MAX_CHANNELS];
+	cpuPaths = new char[APPCONST::SENSOR_MAX_CPUS * MAX_PATH];
+	line = new char[APPCONST::SENSOR_TEXT_RECORD];
+}
+SensorSampler::~SensorSampler()
+{
+	stop();
+	delete[] channels;
+	delete[] cpuPaths;
+	delete[] line;
+	DeleteCriticalSection(&snapshotLock);
+}
+// Root is sysfs mount point as Windows path, for example Z:\sys under Wine.
+BOOL SensorSampler::start(const char* root, DWORD periodMs, double tscHz, const char* fileName)
+{
+	stop();
+	if (periodMs < APPCONST::SENSOR_MIN_PERIOD_MS) periodMs = APPCONST::SENSOR_MIN_PERIOD_MS;
+	if (periodMs > APPCONST::SENSOR_MAX_PERIOD_MS) periodMs = APPCONST::SENSOR_MAX_PERIOD_MS;
+	period = periodMs;
+	tscFrequency = tscHz;
+	channelsCount = 0;
+	cpusCount = 0;
+	discoverHwmon(root);
+	discoverPowercap(root);
+	discoverCpufreq(root);
+	hFile = CreateFile(fileName, GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) return FALSE;
+	int k = snprintf(line, APPCONST::SENSOR_TEXT_RECORD, "# TSC frequency Hz = %.0f, sysfs root %s, %d channels, %d cpufreq nodes, period ms %u\r\ntsc",
+		tscFrequency, root, channelsCount, cpusCount, period);
+	BOOL status = writeText(line, k);
+	for (int i = 0; (i < channelsCount) && status; i++)
+	{
+		k = snprintf(line, APPCONST::SENSOR_TEXT_RECORD, ",%s_%s", channels[i].name, szKindUnits[channels[i].kind]);
+		status = writeText(line, k);
+	}
+	k = snprintf(line, APPCONST::SENSOR_TEXT_RECORD, ",cpu_MHz_avg,cpu_MHz_max,rapl_W,hwmon_W,total_W,FPS,Minst/s,FPS_per_W,Minst_per_J\r\n");
+	if ((!status) || (!writeText(line, k)))
+	{
+		CloseHandle(hFile);
+		hFile = INVALID_HANDLE_VALUE;
+		return FALSE;
+	}
+	memset(&snapshot, 0, sizeof(snapshot));
+	lastTsc = 0;
+	lastFrames = framesCount;
+	lastInstances = instancesCount;
+	hStopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+	hThread = hStopEvent ? CreateThread(nullptr, 0, samplerThread, this, 0, nullptr) : NULL;
+	if (!hThread)
+	{
+		stop();
+		return FALSE;
+	}
+	return TRUE;
+}
+void SensorSampler::stop()
+{
+	if (hThread)
+	{
+		SetEvent(hStopEvent);
+		WaitForSingleObject(hThread, INFINITE);
+		CloseHandle(hThread);
+		hThread = NULL;
+	}
+	if (hStopEvent)
+	{
+		CloseHandle(hStopEvent);
+		hStopEvent = NULL;
+	}
+	if (hFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(hFile);
+		hFile = INVALID_HANDLE_VALUE;
+	}
+}
+BOOL SensorSampler::getActive()
+{
+	return (hThread != NULL);
+}
+// Render thread counts frames and instances, sampler thread reads deltas.
+void SensorSampler::frame(DWORD32 instances)
+{
+	InterlockedExchangeAdd64(&framesCount, 1);
+	InterlockedExchangeAdd64(&instancesCount, instances);
+}
+void SensorSampler::writeRow(char* row, int size)
+{
+	char szResults[APPCONST::MAX_TEXT_STRING];
+	EnterCriticalSection(&snapshotLock);
+	sensorSnapshot s = snapshot;
+	LeaveCriticalSection(&snapshotLock);
+	if (!s.valid)
+	{
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "Sensors(1) %d channels, %d cpufreq nodes, waiting", channelsCount, cpusCount);
+	}
+	else
+	{
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "Sensors(1) %.0fC %.0fMHz RAPL %.1fW hwmon %.1fW total %.1fW FPS/W %.3f",
+			s.maxTemperature, s.cpuMegahertz, s.raplWatts, s.hwmonWatts, s.totalWatts, s.fpsPerWatt);
+	}
+	snprintf(row, size, "%-*s", size - 1, szResults);
+}
+DWORD WINAPI SensorSampler::samplerThread(LPVOID parm)
+{
+	SensorSampler* p = static_cast<SensorSampler*>(parm);
+	do
+	{
+		p->sample();
+	} while (WaitForSingleObject(p->hStopEvent, p->period) == WAIT_TIMEOUT);
+	return 0;
+}
+// Hwmon attributes: tempN_input millidegrees, powerN_average or powerN_input microwatts,
+// freqN_input hertz, fanN_input RPM. Channel name is device name and attribute base.
+// Only GPU drivers power counted to total, CPU hwmon power is same energy as RAPL zones.
+void SensorSampler::discoverHwmon(const char* root)
+{
+	char path[MAX_PATH];
+	snprintf(path, MAX_PATH, "%s\\class\\hwmon\\hwmon*", root);
+	WIN32_FIND_DATA dirData;
+	HANDLE hDirs = FindFirstFile(path, &dirData);
+	if (hDirs == INVALID_HANDLE_VALUE) return;
+	do
+	{
+		char dir[MAX_PATH];
+		char device[APPCONST::SENSOR_NAME_SIZE];
+		snprintf(dir, MAX_PATH, "%s\\class\\hwmon\\%s", root, dirData.cFileName);
+		snprintf(path, MAX_PATH, "%s\\name", dir);
+		if (!readText(path, device, APPCONST::SENSOR_NAME_SIZE))
+		{
+			snprintf(device, APPCONST::SENSOR_NAME_SIZE, "%s", dirData.cFileName);
+		}
+		BOOL gpu = getGpuDevice(device);
+		snprintf(path, MAX_PATH, "%s\\*", dir);
+		WIN32_FIND_DATA fileData;
+		HANDLE hFiles = FindFirstFile(path, &fileData);
+		if (hFiles == INVALID_HANDLE_VALUE) continue;
+		do
+		{
+			const char* n = fileData.cFileName;
+			size_t length = strlen(n);
+			BOOL input = (length > 6) && (!strcmp(n + length - 6, "_input"));
+			BOOL average = (length > 8) && (!strcmp(n + length - 8, "_average"));
+			if ((!input) && (!average)) continue;
+			char base[APPCONST::SENSOR_NAME_SIZE];
+			snprintf(base, APPCONST::SENSOR_NAME_SIZE, "%.*s", static_cast<int>(length - (input ? 6 : 8)), n);
+			char name[APPCONST::SENSOR_NAME_SIZE];
+			snprintf(name, APPCONST::SENSOR_NAME_SIZE, "%s_%s", device, base);
+			snprintf(path, MAX_PATH, "%s\\%s", dir, n);
+			if (!strncmp(n, "power", 5))
+			{
+				// Averaged power preferred if device reports both.
+				char averagePath[MAX_PATH];
+				snprintf(averagePath, MAX_PATH, "%s\\%s_average", dir, base);
+				if (input && (GetFileAttributes(averagePath) != INVALID_FILE_ATTRIBUTES)) continue;
+				addChannel(SENSOR_POWER, path, name, 1.0E-6, gpu, 0);
+			}
+			else if (average)
+			{
+				continue;
+			}
+			else if (!strncmp(n, "temp", 4))
+			{
+				addChannel(SENSOR_TEMPERATURE, path, name, 1.0E-3, FALSE, 0);
+			}
+			else if (!strncmp(n, "freq", 4))
+			{
+				addChannel(SENSOR_FREQUENCY, path, name, 1.0E-6, FALSE, 0);
+			}
+			else if (!strncmp(n, "fan", 3))
+			{
+				addChannel(SENSOR_FAN, path, name, 1.0, FALSE, 0);
+			}
+		} while (FindNextFile(hFiles, &fileData));
+		FindClose(hFiles);
+	} while (FindNextFile(hDirs, &dirData));
+	FindClose(hDirs);
+}
+BOOL SensorSampler::getGpuDevice(const char* device)
+{
+	for (int i = 0; szGpuDevices[i]; i++)
+	{
+		if (!strcmp(device, szGpuDevices[i])) return TRUE;
+	}
+	return FALSE;
+}
+// Powercap zones: intel-rapl:N is package, intel-rapl:N:M is subzone of package, only
+// packages counted to total power. Energy counters are microjoules. Zone separator may be
+// mapped to other char by Wine or fake tree, zone level counted by separators after "rapl".
+void SensorSampler::discoverPowercap(const char* root)
+{
+	char path[MAX_PATH];
+	snprintf(path, MAX_PATH, "%s\\class\\powercap\\*rapl*", root);
+	WIN32_FIND_DATA dirData;
+	HANDLE hDirs = FindFirstFile(path, &dirData);
+	if (hDirs == INVALID_HANDLE_VALUE) return;
+	do
+	{
+		const char* id = strstr(dirData.cFileName, "rapl");
+		if (!id) continue;
+		char name[APPCONST::SENSOR_NAME_SIZE];
+		int length = snprintf(name, APPCONST::SENSOR_NAME_SIZE, "rapl");
+		int separators = 0;
+		for (const char* p = id + 4; *p && (length < (APPCONST::SENSOR_NAME_SIZE - 1)); p++)
+		{
+			BOOL digit = (*p >= '0') && (*p <= '9');
+			if (!digit) separators++;
+			name[length++] = digit ? *p : '_';
+		}
+		name[length] = 0;
+		if (!separators) continue;      // Control type directory, no energy counter.
+		char dir[MAX_PATH];
+		char zone[APPCONST::SENSOR_NAME_SIZE];
+		snprintf(dir, MAX_PATH, "%s\\class\\powercap\\%s", root, dirData.cFileName);
+		snprintf(path, MAX_PATH, "%s\\name", dir);
+		if (readText(path, zone, APPCONST::SENSOR_NAME_SIZE))
+		{
+			snprintf(name + length, APPCONST::SENSOR_NAME_SIZE - length, "_%s", zone);
+		}
+		DWORD64 range = 0;
+		snprintf(path, MAX_PATH, "%s\\max_energy_range_uj", dir);
+		readValue(path, &range);
+		snprintf(path, MAX_PATH, "%s\\energy_uj", dir);
+		addChannel(SENSOR_ENERGY, path, name, 1.0E-6, (separators == 1), range);
+	} while (FindNextFile(hDirs, &dirData));
+	FindClose(hDirs);
+}
+// Current clock of each CPU, kilohertz.
+void SensorSampler::discoverCpufreq(const char* root)
+{
+	char path[MAX_PATH];
+	snprintf(path, MAX_PATH, "%s\\devices\\system\\cpu\\cpu*", root);
+	WIN32_FIND_DATA dirData;
+	HANDLE hDirs = FindFirstFile(path, &dirData);
+	if (hDirs == INVALID_HANDLE_VALUE) return;
+	do
+	{
+		char* cpuPath = cpuPaths + cpusCount * MAX_PATH;
+		snprintf(cpuPath, MAX_PATH, "%s\\devices\\system\\cpu\\%s\\cpufreq\\scaling_cur_freq", root, dirData.cFileName);
+		if (GetFileAttributes(cpuPath) != INVALID_FILE_ATTRIBUTES)
+		{
+			cpusCount++;
+		}
+	} while ((cpusCount < APPCONST::SENSOR_MAX_CPUS) && FindNextFile(hDirs, &dirData));
+	FindClose(hDirs);
+}
+// Nodes which can't be read at discovery not added.
+void SensorSampler::addChannel(sensorKind kind, const char* path, const char* name, double scale, BOOL total, DWORD64 range)
+{
+	DWORD64 value = 0;
+	if ((channelsCount >= APPCONST::SENSOR_MAX_CHANNELS) || (!readValue(path, &value))) return;
+	sensorChannel& c = channels[channelsCount++];
+	memset(&c, 0, sizeof(sensorChannel));
+	c.kind = kind;
+	c.total = total;
+	c.scale = scale;
+	c.range = range;
+	snprintf(c.name, APPCONST::SENSOR_NAME_SIZE, "%s", name);
+	snprintf(c.path, MAX_PATH, "%s", path);
+}
+// Negative readings are disabled or faulty sensors, read fails.
+BOOL SensorSampler::readValue(const char* path, DWORD64* value)
+{
+	char text[APPCONST::SENSOR_NAME_SIZE];
+	if ((!readText(path, text, APPCONST::SENSOR_NAME_SIZE)) || (text[0] == '-')) return FALSE;
+	char* end = nullptr;
+	*value = _strtoui64(text, &end, 10);
+	return (end != text);
+}
+// Node text without trailing line feed.
+BOOL SensorSampler::readText(const char* path, char* text, int size)
+{
+	HANDLE h = CreateFile(path, GENERIC_READ, FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (h == INVALID_HANDLE_VALUE) return FALSE;
+	DWORD bytes = 0;
+	BOOL status = ReadFile(h, text, size - 1, &bytes, nullptr);
+	CloseHandle(h);
+	if ((!status) || (!bytes)) return FALSE;
+	while (bytes && ((text[bytes - 1] == '\n') || (text[bytes - 1] == '\r') || (text[bytes - 1] == ' ')))
+	{
+		bytes--;
+	}
+	text[bytes] = 0;
+	return (bytes != 0);
+}
+// Channels keep previous value if node read failed. First sample has no interval, rates are zero.
+void SensorSampler::sample()
+{
+	DWORD64 tsc = __rdtsc();
+	double seconds = (lastTsc && (tscFrequency > 0.0)) ? ((tsc - lastTsc) / tscFrequency) : 0.0;
+	sensorSnapshot s = { 0 };
+	int k = snprintf(line, APPCONST::SENSOR_TEXT_RECORD, "%I64u", tsc);
+	for (int i = 0; i < channelsCount; i++)
+	{
+		sensorChannel& c = channels[i];
+		DWORD64 raw = 0;
+		if (readValue(c.path, &raw))
+		{
+			if (c.kind == SENSOR_ENERGY)
+			{
+				// Wrap without known range can't be measured, sample dropped, previous value kept.
+				BOOL wrap = (raw < c.lastRaw);
+				if ((!wrap) || c.range)
+				{
+					DWORD64 delta = wrap ? (raw + c.range - c.lastRaw) : (raw - c.lastRaw);
+					c.value = (c.lastValid && (seconds > 0.0)) ? (delta * c.scale / seconds) : 0.0;
+				}
+				c.lastRaw = raw;
+				c.lastValid = TRUE;
+			}
+			else
+			{
+				c.value = raw * c.scale;
+			}
+		}
+		if ((c.kind == SENSOR_TEMPERATURE) && (c.value > s.maxTemperature)) s.maxTemperature = c.value;
+		if (c.total && (c.kind == SENSOR_ENERGY)) s.raplWatts += c.value;
+		if (c.total && (c.kind == SENSOR_POWER)) s.hwmonWatts += c.value;
+		k += snprintf(line + k, APPCONST::SENSOR_TEXT_RECORD - k, ",%.3f", c.value);
+	}
+	readFrequency(&s.cpuMegahertz, &s.cpuMegahertzMax);
+	s.totalWatts = s.raplWatts + s.hwmonWatts;
+	LONG64 frames = framesCount;
+	LONG64 instances = instancesCount;
+	double instancesPerSecond = 0.0;
+	if (seconds > 0.0)
+	{
+		s.fps = (frames - lastFrames) / seconds;
+		instancesPerSecond = (instances - lastInstances) / seconds;
+		s.valid = TRUE;
+	}
+	if (s.totalWatts > 0.0)
+	{
+		s.fpsPerWatt = s.fps / s.totalWatts;
+		s.instancesPerJoule = instancesPerSecond / s.totalWatts;
+	}
+	lastFrames = frames;
+	lastInstances = instances;
+	lastTsc = tsc;
+	k += snprintf(line + k, APPCONST::SENSOR_TEXT_RECORD - k, ",%.0f,%.0f,%.2f,%.2f,%.2f,%.2f,%.3f,%.4f,%.4f\r\n",
+		s.cpuMegahertz, s.cpuMegahertzMax, s.raplWatts, s.hwmonWatts, s.totalWatts, s.fps, instancesPerSecond / 1.0E6, s.fpsPerWatt, s.instancesPerJoule / 1.0E6);
+	writeText(line, k);
+	EnterCriticalSection(&snapshotLock);
+	snapshot = s;
+	LeaveCriticalSection(&snapshotLock);
+}
+// Cpufreq nodes if found, Windows power information otherwise.
+void SensorSampler::readFrequency(double* average, double* maximum)
+{
+	*average = 0.0;
+	*maximum = 0.0;
+	double sum = 0.0;
+	int count = 0;
+	if (cpusCount)
+	{
+		for (int i = 0; i < cpusCount; i++)
+		{
+			DWORD64 kilohertz = 0;
+			if (!readValue(cpuPaths + i * MAX_PATH, &kilohertz)) continue;
+			double megahertz = kilohertz / 1000.0;
+			if (megahertz > *maximum) *maximum = megahertz;
+			sum += megahertz;
+			count++;
+		}
+	}
+	else
+	{
+		processorPowerInfo info[APPCONST::SENSOR_MAX_CPUS];
+		SYSTEM_INFO system;
+		GetSystemInfo(&system);
+		ULONG cpus = system.dwNumberOfProcessors;
+		if (cpus > APPCONST::SENSOR_MAX_CPUS) cpus = APPCONST::SENSOR_MAX_CPUS;
+		if (CallNtPowerInformation(ProcessorInformation, nullptr, 0, info, cpus * sizeof(processorPowerInfo))) return;
+		for (ULONG i = 0; i < cpus; i++)
+		{
+			double megahertz = info[i].currentMhz;
+			if (megahertz > *maximum) *maximum = megahertz;
+			sum += megahertz;
+			count++;
+		}
+	}
+	if (count) *average = sum / count;
+}
+BOOL SensorSampler::writeText(const char* text, int size)
+{
+	if ((hFile == INVALID_HANDLE_VALUE) || (size <= 0)) return FALSE;
+	DWORD written = 0;
+	return WriteFile(hFile, text, static_cast<DWORD>(size), &written, nullptr) && (written == static_cast<DWORD>(size));
+}
+
+const char* SensorSampler::szKindUnits[] = { "C", "W", "W", "MHz", "RPM" };
+// Hwmon device names of GPU drivers, power of these devices counted to total.
+const char* SensorSampler::szGpuDevices[] = { "amdgpu", "radeon", "nouveau", "i915", "xe", nullptr };
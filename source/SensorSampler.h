@@ -0,0 +1,114 @@
+/*
+OpenGL GPUstress.
+Sensor telemetry sampler class header.
+Background thread reads temperature, power, energy, clock and fan nodes of
+Linux sysfs tree (hwmon, powercap RAPL, cpufreq) at fixed period, samples
+stamped by TSC, same timebase as frame trace records. Sysfs tree is
+visible to application under Wine, root is configurable, fake tree can be
+used for tests. CPU clocks read by Windows power information if no cpufreq nodes.
+*/
+
+#pragma once
+#ifndef SENSORSAMPLER_H
+#define SENSORSAMPLER_H
+
+#include <windows.h>
+#include <iostream>
+#include <intrin.h>
+#include <powrprof.h>
+#include "Global.h"
+
+enum sensorKind
+{
+    SENSOR_TEMPERATURE = 0,     // Celsius.
+    SENSOR_POWER,               // Watts, instant or averaged by device.
+    SENSOR_ENERGY,              // Energy counter, reported as watts between samples.
+    SENSOR_FREQUENCY,           // MHz.
+    SENSOR_FAN,                 // RPM.
+    SENSOR_KINDS_COUNT
+};
+
+// Sysfs node, value is latest sample in channel units.
+struct sensorChannel
+{
+    sensorKind kind;
+    BOOL total;                 // Counted to total power: RAPL top level zones and GPU hwmon power.
+    double scale;               // Raw value to channel units.
+    DWORD64 range;              // Energy counter wrap range, raw units.
+    DWORD64 lastRaw;
+    BOOL lastValid;
+    double value;
+    char name[APPCONST::SENSOR_NAME_SIZE];
+    char path[MAX_PATH];
+};
+
+// Windows processor power information record, not declared by SDK headers.
+struct processorPowerInfo
+{
+    ULONG number;
+    ULONG maxMhz;
+    ULONG currentMhz;
+    ULONG mhzLimit;
+    ULONG maxIdleState;
+    ULONG currentIdleState;
+};
+
+// Latest sample summary for overlay, perf per watt of interval between samples.
+struct sensorSnapshot
+{
+    BOOL valid;
+    double maxTemperature;
+    double cpuMegahertz;
+    double cpuMegahertzMax;
+    double raplWatts;
+    double hwmonWatts;
+    double totalWatts;
+    double fps;
+    double fpsPerWatt;
+    double instancesPerJoule;
+};
+
+class SensorSampler
+{
+public:
+    SensorSampler();
+    ~SensorSampler();
+    BOOL start(const char* root, DWORD periodMs, double tscHz, const char* fileName);
+    void stop();
+    BOOL getActive();
+    void frame(DWORD32 instances);
+    void writeRow(char* row, int size);
+private:
+    static DWORD WINAPI samplerThread(LPVOID parm);
+    void discoverHwmon(const char* root);
+    static BOOL getGpuDevice(const char* device);
+    void discoverPowercap(const char* root);
+    void discoverCpufreq(const char* root);
+    void addChannel(sensorKind kind, const char* path, const char* name, double scale, BOOL total, DWORD64 range);
+    static BOOL readValue(const char* path, DWORD64* value);
+    static BOOL readText(const char* path, char* text, int size);
+    void sample();
+    void readFrequency(double* average, double* maximum);
+    BOOL writeText(const char* text, int size);
+    sensorChannel* channels;
+    int channelsCount;
+    char* cpuPaths;             // Cpufreq current clock nodes, MAX_PATH chars each.
+    int cpusCount;
+    HANDLE hFile;
+    HANDLE hThread;
+    HANDLE hStopEvent;
+    CRITICAL_SECTION snapshotLock;
+    sensorSnapshot snapshot;
+    DWORD period;
+    double tscFrequency;
+    DWORD64 lastTsc;
+    volatile LONG64 framesCount;
+    volatile LONG64 instancesCount;
+    LONG64 lastFrames;
+    LONG64 lastInstances;
+    char* line;
+    static const char* szKindUnits[];
+    static const char* szGpuDevices[];
+};
+
+#endif // SENSORSAMPLER_H
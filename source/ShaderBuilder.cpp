@@ -0,0 +1,330 @@
+/*
+OpenGL GPUstress.
+Shader programs builder class.
+Program binary cache requires glGetProgramBinary, glProgramBinary
+(OpenGL 4.1 or ARB_get_program_binary), without it programs always
+compiled from sources. Cached binary rejected by driver (driver update)
+means fall back to compile and rewrite cache file.
+*/
+
+#include "ShaderBuilder.h"
+
+ShaderBuilder::ShaderBuilder() : f(nullptr), fo(nullptr), keyPrefix(0), tscPeriod(0.0),
+	                             startupTicks(0), cacheHits(0), cacheMisses(0), variantsCount(0), variants{ 0 }
+{
+	errorLog = new GLchar[APPCONST::TEMP_BUFFER_SIZE];
+	memset(errorLog, 0, APPCONST::TEMP_BUFFER_SIZE);
+	binaryBuffer = new BYTE[APPCONST::SHADER_BINARY_MAX];
+	memset(binaryBuffer, 0, APPCONST::SHADER_BINARY_MAX);
+}
+ShaderBuilder::~ShaderBuilder()
+{
+	if (errorLog)     delete[] errorLog;
+	if (binaryBuffer) delete[] binaryBuffer;
+}
+void ShaderBuilder::init(const oglFunctionsList* pFunctions, const oglOptionalFunctionsList* pOptional, double period)
+{
+	f = pFunctions;
+	fo = pOptional;
+	tscPeriod = period;
+	// Key prefix: FNV-1a hash of renderer and version strings.
+	keyPrefix = 0xCBF29CE484222325ULL;
+	const GLenum names[] = { GL_VENDOR, GL_RENDERER, GL_VERSION };
+	for (GLenum name : names)
+	{
+		const GLubyte* p = glGetString(name);
+		while (p && *p)
+		{
+			keyPrefix = (keyPrefix ^ *(p++)) * 0x100000001B3ULL;
+		}
+	}
+	if (getCacheSupported())
+	{
+		CreateDirectory(APPCONST::SHADER_CACHE_DIR, nullptr);
+	}
+}
+BOOL ShaderBuilder::getCacheSupported()
+{
+	return fo && fo->glGetProgramBinary && fo->glProgramBinary && fo->glProgramParameteri && binaryBuffer;
+}
+int ShaderBuilder::build(const char* version, const char* defines, const char* vertexSource, const char* fragmentSource, GLuint& programId)
+{
+	DWORD64 t1 = __rdtsc();
+	shaderVariant variant = { version, defines, vertexSource, fragmentSource };
+	registerVariant(variant);
+	DWORD64 key = hashKey(variant);
+	programId = 0;
+	if (getCacheSupported() && loadCached(key, programId))
+	{
+		cacheHits++;
+		startupTicks += __rdtsc() - t1;
+		return 0;
+	}
+	cacheMisses++;
+
+	const GLchar* vertexStrings[] = { version, defines, vertexSource };
+	const GLchar* fragmentStrings[] = { version, defines, fragmentSource };
+	GLuint vertexShaderId = 0;
+	int status = compile(GL_VERTEX_SHADER, vertexStrings, 3, vertexShaderId);
+	if (status) return status;
+	GLuint fragmentShaderId = 0;
+	status = compile(GL_FRAGMENT_SHADER, fragmentStrings, 3, fragmentShaderId);
+	if (status)
+	{
+		f->glDeleteShader(vertexShaderId);
+		return status;
+	}
+	status = link(vertexShaderId, fragmentShaderId, programId);
+	f->glDeleteShader(vertexShaderId);
+	f->glDeleteShader(fragmentShaderId);
+	if ((!status) && getCacheSupported())
+	{
+		saveCached(key, programId);
+	}
+	startupTicks += __rdtsc() - t1;
+	return status;
+}
+int ShaderBuilder::compile(GLenum shaderType, const GLchar** strings, GLsizei count, GLuint& shaderId)
+{
+	BOOL vertex = (shaderType == GL_VERTEX_SHADER);
+	shaderId = f->glCreateShader(shaderType);
+	if (!shaderId) return vertex ? 0x106 : 0x109;
+	f->glShaderSource(shaderId, count, strings, nullptr);
+	f->glCompileShader(shaderId);
+	GLint params = 0;
+	f->glGetShaderiv(shaderId, GL_COMPILE_STATUS, &params);
+	if (params == GL_FALSE)
+	{
+		if (!errorLog) return vertex ? 0x107 : 0x10A;
+		char* p = errorLog;
+		GLsizei n = APPCONST::TEMP_BUFFER_SIZE;
+		GLsizei k = snprintf(p, n, vertex ? "Vertex shader compiling error:\r\n" : "Fragment shader compiling error:\r\n");
+		p += k;
+		n -= k;
+		f->glGetShaderInfoLog(shaderId, n, nullptr, p);
+		MessageBox(NULL, errorLog, nullptr, MB_ICONERROR);
+		f->glDeleteShader(shaderId);
+		shaderId = 0;
+		return vertex ? 0x108 : 0x10B;
+	}
+	return 0;
+}
+int ShaderBuilder::link(GLuint vertexShaderId, GLuint fragmentShaderId, GLuint& programId)
+{
+	programId = f->glCreateProgram();
+	if (!programId) return 0x10C;
+	if (getCacheSupported())
+	{
+		fo->glProgramParameteri(programId, GL_PROGRAM_BINARY_RETRIEVABLE_HINT, GL_TRUE);
+	}
+	f->glAttachShader(programId, vertexShaderId);
+	f->glAttachShader(programId, fragmentShaderId);
+	f->glLinkProgram(programId);
+	GLint params = 0;
+	f->glGetProgramiv(programId, GL_LINK_STATUS, &params);
+	if (params == GL_FALSE)
+	{
+		if (!errorLog) return 0x10D;
+		char* p = errorLog;
+		GLsizei n = APPCONST::TEMP_BUFFER_SIZE;
+		GLsizei k = snprintf(p, n, "Shader program linking error:\r\n");
+		p += k;
+		n -= k;
+		f->glGetProgramInfoLog(programId, n, nullptr, p);
+		MessageBox(NULL, errorLog, nullptr, MB_ICONERROR);
+		f->glDeleteProgram(programId);
+		programId = 0;
+		return 0x10E;
+	}
+	return 0;
+}
+DWORD64 ShaderBuilder::hashKey(const shaderVariant& variant)
+{
+	DWORD64 hash = keyPrefix;
+	const char* strings[] = { variant.version, variant.defines, variant.vertexSource, variant.fragmentSource };
+	for (const char* p : strings)
+	{
+		while (p && *p)
+		{
+			hash = (hash ^ static_cast<BYTE>(*(p++))) * 0x100000001B3ULL;
+		}
+		hash = (hash ^ 0xFF) * 0x100000001B3ULL;    // Strings separator.
+	}
+	return hash;
+}
+void ShaderBuilder::cacheFileName(DWORD64 key, char* name, size_t size)
+{
+	snprintf(name, size, "%s\\%016I64X.bin", APPCONST::SHADER_CACHE_DIR, key);
+}
+BOOL ShaderBuilder::loadCached(DWORD64 key, GLuint& programId)
+{
+	char name[MAX_PATH];
+	cacheFileName(key, name, MAX_PATH);
+	HANDLE hFile = CreateFile(name, GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) return FALSE;
+	shaderCacheHeader header;
+	DWORD read = 0;
+	BOOL status = ReadFile(hFile, &header, sizeof(header), &read, nullptr) && (read == sizeof(header)) &&
+		(header.signature == APPCONST::SHADER_CACHE_SIGNATURE) && (header.key == key) &&
+		(header.binaryLength <= APPCONST::SHADER_BINARY_MAX);
+	if (status)
+	{
+		status = ReadFile(hFile, binaryBuffer, header.binaryLength, &read, nullptr) && (read == header.binaryLength);
+	}
+	CloseHandle(hFile);
+	if (status)
+	{
+		status = loadBinary(header.binaryFormat, binaryBuffer, header.binaryLength, programId);
+	}
+	return status;
+}
+BOOL ShaderBuilder::saveCached(DWORD64 key, GLuint programId)
+{
+	GLint length = 0;
+	f->glGetProgramiv(programId, GL_PROGRAM_BINARY_LENGTH, &length);
+	if ((length <= 0) || (length > APPCONST::SHADER_BINARY_MAX)) return FALSE;
+	shaderCacheHeader header;
+	header.signature = APPCONST::SHADER_CACHE_SIGNATURE;
+	header.binaryFormat = 0;
+	header.binaryLength = 0;
+	header.reserved = 0;
+	header.key = key;
+	GLenum format = 0;
+	GLsizei written = 0;
+	fo->glGetProgramBinary(programId, length, &written, &format, binaryBuffer);
+	if (glGetError() || (written <= 0)) return FALSE;
+	header.binaryFormat = format;
+	header.binaryLength = written;
+
+	char name[MAX_PATH];
+	cacheFileName(key, name, MAX_PATH);
+	HANDLE hFile = CreateFile(name, GENERIC_WRITE, 0, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) return FALSE;
+	DWORD count = 0;
+	BOOL status = WriteFile(hFile, &header, sizeof(header), &count, nullptr) &&
+		WriteFile(hFile, binaryBuffer, header.binaryLength, &count, nullptr);
+	CloseHandle(hFile);
+	if (!status)
+	{
+		DeleteFile(name);
+	}
+	return status;
+}
+BOOL ShaderBuilder::loadBinary(GLenum format, const void* data, GLsizei length, GLuint& programId)
+{
+	programId = f->glCreateProgram();
+	if (!programId) return FALSE;
+	fo->glProgramBinary(programId, format, data, length);
+	GLint params = 0;
+	f->glGetProgramiv(programId, GL_LINK_STATUS, &params);
+	if ((params == GL_FALSE) || glGetError())
+	{
+		f->glDeleteProgram(programId);
+		programId = 0;
+		return FALSE;
+	}
+	return TRUE;
+}
+void ShaderBuilder::registerVariant(const shaderVariant& variant)
+{
+	for (int i = 0; i < variantsCount; i++)
+	{
+		if ((variants[i].version == variant.version) && (variants[i].defines == variant.defines) &&
+			(variants[i].vertexSource == variant.vertexSource) && (variants[i].fragmentSource == variant.fragmentSource))
+		{
+			return;
+		}
+	}
+	if (variantsCount < APPCONST::SHADER_VARIANTS_MAX)
+	{
+		variants[variantsCount++] = variant;
+	}
+}
+// Compile, link and binary load times for all registered variants.
+// Unique define per repetition prevents driver own shader cache hits.
+BOOL ShaderBuilder::benchmark(const char* fileName)
+{
+	report.clear();
+	report.add("Shader build times, ms, average of %d repetitions\r\n", APPCONST::SHADER_BENCH_REPEATS);
+	report.add("Startup builds: %d cached, %d compiled, %.3f ms total\r\n",
+		cacheHits, cacheMisses, startupTicks * tscPeriod * 1000.0);
+	report.add("variant,defines,compile vertex,compile fragment,link,binary bytes,binary load\r\n");
+	for (int i = 0; i < variantsCount; i++)
+	{
+		const shaderVariant& v = variants[i];
+		DWORD64 ticksVertex = 0;
+		DWORD64 ticksFragment = 0;
+		DWORD64 ticksLink = 0;
+		DWORD64 ticksLoad = 0;
+		GLint binaryBytes = 0;
+		int loadCount = 0;
+		for (int r = 0; r < APPCONST::SHADER_BENCH_REPEATS; r++)
+		{
+			char szNonce[APPCONST::MAX_TEXT_STRING];
+			snprintf(szNonce, APPCONST::MAX_TEXT_STRING, "#define SHADER_NONCE_%I64X\r\n", __rdtsc());
+			const GLchar* vertexStrings[] = { v.version, v.defines, szNonce, v.vertexSource };
+			const GLchar* fragmentStrings[] = { v.version, v.defines, szNonce, v.fragmentSource };
+			GLuint vertexShaderId = 0;
+			GLuint fragmentShaderId = 0;
+			GLuint programId = 0;
+			DWORD64 t1 = __rdtsc();
+			if (compile(GL_VERTEX_SHADER, vertexStrings, 4, vertexShaderId)) return FALSE;
+			DWORD64 t2 = __rdtsc();
+			if (compile(GL_FRAGMENT_SHADER, fragmentStrings, 4, fragmentShaderId))
+			{
+				f->glDeleteShader(vertexShaderId);
+				return FALSE;
+			}
+			DWORD64 t3 = __rdtsc();
+			int status = link(vertexShaderId, fragmentShaderId, programId);
+			DWORD64 t4 = __rdtsc();
+			f->glDeleteShader(vertexShaderId);
+			f->glDeleteShader(fragmentShaderId);
+			if (status) return FALSE;
+			ticksVertex += t2 - t1;
+			ticksFragment += t3 - t2;
+			ticksLink += t4 - t3;
+
+			if (getCacheSupported())
+			{
+				GLenum format = 0;
+				GLsizei length = 0;
+				f->glGetProgramiv(programId, GL_PROGRAM_BINARY_LENGTH, &binaryBytes);
+				if ((binaryBytes > 0) && (binaryBytes <= APPCONST::SHADER_BINARY_MAX))
+				{
+					fo->glGetProgramBinary(programId, binaryBytes, &length, &format, binaryBuffer);
+					GLuint loadedId = 0;
+					DWORD64 t5 = __rdtsc();
+					BOOL loaded = loadBinary(format, binaryBuffer, length, loadedId);
+					DWORD64 t6 = __rdtsc();
+					if (loaded)
+					{
+						ticksLoad += t6 - t5;
+						loadCount++;
+						f->glDeleteProgram(loadedId);
+					}
+				}
+			}
+			f->glDeleteProgram(programId);
+		}
+		double k = tscPeriod * 1000.0 / APPCONST::SHADER_BENCH_REPEATS;
+		char szDefines[APPCONST::MAX_TEXT_STRING];
+		int n = 0;
+		for (const char* p = v.defines; p && *p && (n < APPCONST::MAX_TEXT_STRING - 1); p++)
+		{
+			szDefines[n++] = ((*p == '\r') || (*p == '\n') || (*p == ',')) ? ' ' : *p;
+		}
+		szDefines[n] = 0;
+		report.add("%d,%s,%.3f,%.3f,%.3f,%d,", i, n ? szDefines : "none",
+			ticksVertex * k, ticksFragment * k, ticksLink * k, binaryBytes);
+		if (loadCount)
+		{
+			report.add("%.3f\r\n", ticksLoad * tscPeriod * 1000.0 / loadCount);
+		}
+		else
+		{
+			report.add("n/a\r\n");
+		}
+	}
+	return report.save(fileName);
+}
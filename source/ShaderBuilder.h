@@ -0,0 +1,72 @@
+/*
+OpenGL GPUstress.
+Shader programs builder class header.
+Builds program from common sources with version and defines strings,
+used for main program and generated shader variants.
+Linked programs binaries cached on disk, key is hash of renderer and
+version strings and shader sources.
+*/
+
+#pragma once
+#ifndef SHADERBUILDER_H
+#define SHADERBUILDER_H
+
+#include <windows.h>
+#include <iostream>
+#include <intrin.h>
+#include "Global.h"
+#include "OpenGLImport.h"
+#include "Report.h"
+
+// Shader variant sources, registered at build for compile time benchmark.
+struct shaderVariant
+{
+    const char* version;
+    const char* defines;
+    const char* vertexSource;
+    const char* fragmentSource;
+};
+
+// Binary cache file header, followed by program binary.
+struct shaderCacheHeader
+{
+    DWORD32 signature;
+    DWORD32 binaryFormat;
+    DWORD32 binaryLength;
+    DWORD32 reserved;
+    DWORD64 key;
+};
+
+class ShaderBuilder
+{
+public:
+    ShaderBuilder();
+    ~ShaderBuilder();
+    void init(const oglFunctionsList* pFunctions, const oglOptionalFunctionsList* pOptional, double period);
+    int build(const char* version, const char* defines, const char* vertexSource, const char* fragmentSource, GLuint& programId);
+    BOOL benchmark(const char* fileName);
+    BOOL getCacheSupported();
+private:
+    int compile(GLenum shaderType, const GLchar** strings, GLsizei count, GLuint& shaderId);
+    int link(GLuint vertexShaderId, GLuint fragmentShaderId, GLuint& programId);
+    DWORD64 hashKey(const shaderVariant& variant);
+    void cacheFileName(DWORD64 key, char* name, size_t size);
+    BOOL loadCached(DWORD64 key, GLuint& programId);
+    BOOL saveCached(DWORD64 key, GLuint programId);
+    BOOL loadBinary(GLenum format, const void* data, GLsizei length, GLuint& programId);
+    void registerVariant(const shaderVariant& variant);
+    const oglFunctionsList* f;
+    const oglOptionalFunctionsList* fo;
+    GLchar* errorLog;
+    BYTE* binaryBuffer;
+    DWORD64 keyPrefix;
+    double tscPeriod;
+    DWORD64 startupTicks;
+    int cacheHits;
+    int cacheMisses;
+    int variantsCount;
+    shaderVariant variants[APPCONST::SHADER_VARIANTS_MAX];
+    Report report;
+};
+
+#endif // SHADERBUILDER_H
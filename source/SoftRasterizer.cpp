@@ -0,0 +1,546 @@
+/*
+OpenGL GPUstress.
+Software rasterizer class.
+Frame rendered by batches of instances. Setup phase: each thread transforms
+own part of batch, builds triangles planes and bins triangles to screen tiles.
+Raster phase: threads take tiles, tile processes bins of all threads in
+threads order, it is instances order, so result not depends on threads count.
+Pixel center rule as OpenGL: centers at half-integer coordinates, top-left
+rule for centers exactly at edge, window Y axis up. Depth function LESS,
+repeat wrap, linear filter.
+*/
+
+#include "SoftRasterizer.h"
+
+SoftRasterizer::SoftRasterizer() : texels(nullptr), colorBuffer(nullptr), depthBuffer(nullptr), workers(nullptr), workersCount(0),
+	                               tilesX(APPCONST::SOFT_WIDTH / APPCONST::SOFT_TILE_SIZE), tilesCount(0), avx2(FALSE), depthEnabled(TRUE),
+	                               instanceScales(nullptr), instanceLoad(0), vertices(nullptr), transformed{ 0 },
+	                               tileNext(0), barrierCount(0), barrierSense(FALSE)
+{
+	int tilesY = (APPCONST::SOFT_HEIGHT + APPCONST::SOFT_TILE_SIZE - 1) / APPCONST::SOFT_TILE_SIZE;
+	tilesCount = tilesX * tilesY;
+	colorBuffer = new DWORD32[APPCONST::SOFT_WIDTH * APPCONST::SOFT_HEIGHT];
+	depthBuffer = new float[APPCONST::SOFT_WIDTH * APPCONST::SOFT_HEIGHT];
+	// AVX2 requires CPU support and YMM registers state save by OS.
+	int regs[4] = { 0 };
+	__cpuid(regs, 0);
+	if (regs[0] >= 7)
+	{
+		__cpuid(regs, 1);
+		BOOL osYmm = (regs[2] & (1 << 27)) && (regs[2] & (1 << 28)) && ((_xgetbv(0) & 6) == 6);
+		__cpuidex(regs, 7, 0);
+		avx2 = osYmm && (regs[1] & (1 << 5));
+	}
+}
+SoftRasterizer::~SoftRasterizer()
+{
+	if (colorBuffer) delete[] colorBuffer;
+	if (depthBuffer) delete[] depthBuffer;
+}
+// Texture is BGRA TEXTURE_WIDTH x TEXTURE_HEIGHT, cube is vertices array of CUBE_VERTICES x (x, y, z, u, v).
+BOOL SoftRasterizer::init(const void* texture, const float* cube)
+{
+	texels = static_cast<const DWORD32*>(texture);
+	vertices = cube;
+	return texels && vertices && colorBuffer && depthBuffer;
+}
+BOOL SoftRasterizer::getAvx2()
+{
+	return avx2;
+}
+// Same frame rendered with 1, 2, 4 ... threads up to logical processors count, long operation.
+BOOL SoftRasterizer::benchmark(const float* model, const float* scales, unsigned int load, BOOL depthTest, double period)
+{
+	if ((!texels) || (!vertices) || (!colorBuffer) || (!depthBuffer) || (!scales)) return FALSE;
+	instanceScales = scales;
+	instanceLoad = load;
+	depthEnabled = depthTest;
+	// Rotation is same for all instances, per-instance part is scale and grid position.
+	for (int i = 0; i < APPCONST::CUBE_VERTICES; i++)
+	{
+		const float* a = vertices + i * 5;
+		float* t = transformed + i * 6;
+		for (int r = 0; r < 4; r++)
+		{
+			t[r] = model[r] * a[0] + model[4 + r] * a[1] + model[8 + r] * a[2] + model[12 + r];
+		}
+		t[4] = a[3];
+		t[5] = a[4];
+	}
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	int cores = static_cast<int>(info.dwNumberOfProcessors);
+	if (cores < 1) cores = 1;
+	if (cores > APPCONST::SOFT_MAX_THREADS) cores = APPCONST::SOFT_MAX_THREADS;
+	unsigned int cubes = (load > APPCONST::TEXT_CHARS) ? (load - APPCONST::TEXT_CHARS) : 0;
+	report.clear();
+	report.add("Software rasterizer %s, %ux%u, %u cubes, %u triangles per frame, depth test %s\r\n",
+		avx2 ? "AVX2" : "scalar", APPCONST::SOFT_WIDTH, APPCONST::SOFT_HEIGHT, cubes,
+		cubes * (APPCONST::CUBE_VERTICES / 3), depthEnabled ? "on" : "off");
+	report.add("threads,frames,ms per frame,Mtri/s,Mpix/s,speedup,efficiency %%\r\n");
+	double singleSeconds = 0.0;
+	int threads = 1;
+	while (TRUE)
+	{
+		DWORD64 t1 = __rdtsc();
+		run(threads);
+		double seconds = (__rdtsc() - t1) * period;
+		if (threads == 1) singleSeconds = seconds;
+		DWORD64 triangles = 0;
+		DWORD64 pixels = 0;
+		for (int i = 0; i < workersCount; i++)
+		{
+			triangles += workers[i].trianglesDone;
+			pixels += workers[i].pixelsDone;
+		}
+		double speedup = (seconds > 0.0) ? (singleSeconds / seconds) : 0.0;
+		report.add("%d,%d,%.2f,%.3f,%.3f,%.2f,%.1f\r\n", workersCount, APPCONST::SOFT_FRAMES,
+			seconds * 1000.0 / APPCONST::SOFT_FRAMES, triangles / seconds / 1.0E6, pixels / seconds / 1.0E6,
+			speedup, speedup * 100.0 / workersCount);
+		for (int i = 0; i < workersCount; i++)
+		{
+			delete[] workers[i].triangles;
+			delete[] workers[i].bins;
+		}
+		delete[] workers;
+		workers = nullptr;
+		if (threads >= cores) break;
+		threads = ((threads * 2) < cores) ? (threads * 2) : cores;
+	}
+	BOOL status = saveBitmap(APPCONST::SOFT_IMAGE_NAME);
+	return report.save(APPCONST::SOFT_REPORT_NAME) && status;
+}
+// Workers state valid after return, released by caller.
+void SoftRasterizer::run(int threads)
+{
+	workers = new softWorker[threads];
+	for (int i = 0; i < threads; i++)
+	{
+		softWorker& w = workers[i];
+		w.owner = this;
+		w.index = i;
+		w.sense = FALSE;
+		w.triangles = nullptr;
+		w.trianglesCount = 0;
+		w.bins = nullptr;
+		w.trianglesDone = 0;
+		w.pixelsDone = 0;
+	}
+	// Threads created suspended, run continues with created threads if creation failed.
+	HANDLE handles[APPCONST::SOFT_MAX_THREADS];
+	int created = 0;
+	for (int i = 1; i < threads; i++)
+	{
+		handles[created] = CreateThread(nullptr, 0, workerThread, &workers[i], CREATE_SUSPENDED, nullptr);
+		if (!handles[created]) break;
+		created++;
+	}
+	// Batch split by actual workers count, triangles buffers sized for it.
+	workersCount = created + 1;
+	unsigned int perWorker = (APPCONST::SOFT_BATCH_INSTANCES + workersCount - 1) / workersCount;
+	for (int i = 0; i < workersCount; i++)
+	{
+		workers[i].triangles = new softTriangle[perWorker * (APPCONST::CUBE_VERTICES / 3)];
+		workers[i].bins = new std::vector<unsigned int>[tilesCount];
+	}
+	barrierCount.store(0);
+	barrierSense.store(FALSE);
+	tileNext.store(0);
+	for (int i = 0; i < created; i++)
+	{
+		ResumeThread(handles[i]);
+	}
+	workerLoop(workers[0]);
+	for (int i = 0; i < created; i++)
+	{
+		WaitForSingleObject(handles[i], INFINITE);
+		CloseHandle(handles[i]);
+	}
+}
+DWORD WINAPI SoftRasterizer::workerThread(LPVOID parm)
+{
+	softWorker* p = reinterpret_cast<softWorker*>(parm);
+	p->owner->workerLoop(*p);
+	return 0;
+}
+// Executed by all workers with same control flow, phases separated by barriers.
+void SoftRasterizer::workerLoop(softWorker& w)
+{
+	constexpr unsigned int BATCH = APPCONST::SOFT_BATCH_INSTANCES;
+	unsigned int cubes = (instanceLoad > APPCONST::TEXT_CHARS) ? (instanceLoad - APPCONST::TEXT_CHARS) : 0;
+	unsigned int batches = cubes ? ((cubes + BATCH - 1) / BATCH) : 1;
+	for (int frame = 0; frame < APPCONST::SOFT_FRAMES; frame++)
+	{
+		for (unsigned int b = 0; b < batches; b++)
+		{
+			unsigned int batchCount = cubes ? (((cubes - b * BATCH) < BATCH) ? (cubes - b * BATCH) : BATCH) : 0;
+			unsigned int per = (batchCount + workersCount - 1) / workersCount;
+			unsigned int offset = w.index * per;
+			unsigned int count = (offset < batchCount) ? (((batchCount - offset) < per) ? (batchCount - offset) : per) : 0;
+			if (!w.index) tileNext.store(0);
+			setupBatch(w, APPCONST::TEXT_CHARS + b * BATCH + offset, count);
+			barrier(w);
+			int tile = 0;
+			while ((tile = tileNext.fetch_add(1)) < tilesCount)
+			{
+				rasterTile(w, tile, (b == 0));
+			}
+			barrier(w);
+		}
+	}
+}
+// Vertex shader of cubes, instance ID is index of scale.
+void SoftRasterizer::setupBatch(softWorker& w, unsigned int first, unsigned int count)
+{
+	w.trianglesCount = 0;
+	for (int i = 0; i < tilesCount; i++)
+	{
+		w.bins[i].clear();
+	}
+	float clip[APPCONST::CUBE_VERTICES * 6];
+	for (unsigned int id = first; id < (first + count); id++)
+	{
+		int nx = id % 9;
+		int ny = id / 9 % 3;
+		float dx = -0.85f + nx / 4.75f;
+		float dy = -0.56f + ny / 1.80f;
+		// As shader: x and y dividers both from z expression, z divider not scaled.
+		float sz = 5.50f + 7.5f - 8.5f * fabsf(instanceScales[id]);
+		float sxy = 3.2f + sz / 3.0f;
+		for (int i = 0; i < APPCONST::CUBE_VERTICES; i++)
+		{
+			const float* t = transformed + i * 6;
+			float* c = clip + i * 6;
+			c[0] = t[0] / sxy + dx;
+			c[1] = t[1] / sxy + dy;
+			c[2] = t[2] / sz;
+			c[3] = t[3];
+			c[4] = (94.0f + 344.0f * t[4] + nx * 303.0f) / APPCONST::TEXTURE_WIDTH;
+			c[5] = (1527.0f - 344.0f * t[5] - 482.0f * (2 - ny)) / APPCONST::TEXTURE_HEIGHT;
+		}
+		for (int i = 0; i < APPCONST::CUBE_VERTICES; i += 3)
+		{
+			setupTriangle(w, clip + i * 6, clip + (i + 1) * 6, clip + (i + 2) * 6);
+		}
+	}
+}
+// Planes computed at double precision, values at pixel centers evaluated at float.
+void SoftRasterizer::setupTriangle(softWorker& w, const float* v0, const float* v1, const float* v2)
+{
+	if ((v0[3] <= 0.0f) || (v1[3] <= 0.0f) || (v2[3] <= 0.0f)) return;     // Behind viewer, not clipped.
+	const float* p[3] = { v0, v1, v2 };
+	double X[3], Y[3], Z[3], W[3], U[3], V[3];
+	for (int i = 0; i < 3; i++)
+	{
+		double iw = 1.0 / p[i][3];
+		X[i] = (p[i][0] * iw * 0.5 + 0.5) * APPCONST::SOFT_WIDTH;
+		Y[i] = (p[i][1] * iw * 0.5 + 0.5) * APPCONST::SOFT_HEIGHT;
+		Z[i] = p[i][2] * iw * 0.5 + 0.5;
+		W[i] = iw;
+		U[i] = p[i][4] * iw;
+		V[i] = p[i][5] * iw;
+	}
+	double area = (X[1] - X[0]) * (Y[2] - Y[0]) - (X[2] - X[0]) * (Y[1] - Y[0]);
+	if (fabs(area) < 1.0E-9) return;
+	// Pixels with centers inside bounding box.
+	double minXf = fmin(X[0], fmin(X[1], X[2]));
+	double maxXf = fmax(X[0], fmax(X[1], X[2]));
+	double minYf = fmin(Y[0], fmin(Y[1], Y[2]));
+	double maxYf = fmax(Y[0], fmax(Y[1], Y[2]));
+	if ((maxXf < 0.0) || (maxYf < 0.0) || (minXf > APPCONST::SOFT_WIDTH) || (minYf > APPCONST::SOFT_HEIGHT)) return;
+	int minX = static_cast<int>(ceil(fmax(minXf - 0.5, 0.0)));
+	int maxX = static_cast<int>(floor(fmin(maxXf - 0.5, APPCONST::SOFT_WIDTH - 1.0)));
+	int minY = static_cast<int>(ceil(fmax(minYf - 0.5, 0.0)));
+	int maxY = static_cast<int>(floor(fmin(maxYf - 0.5, APPCONST::SOFT_HEIGHT - 1.0)));
+	if ((minX > maxX) || (minY > maxY)) return;
+
+	softTriangle& t = w.triangles[w.trianglesCount];
+	double k = 1.0 / area;
+	double e[3][3];
+	for (int i = 0; i < 3; i++)
+	{
+		int a = (i + 1) % 3;
+		int b = (i + 2) % 3;
+		e[i][0] = (Y[a] - Y[b]) * k;
+		e[i][1] = (X[b] - X[a]) * k;
+		e[i][2] = (X[a] * Y[b] - X[b] * Y[a]) * k;
+	}
+	// Planes gradient points inside. Window Y is up: top edge is horizontal with inside below it,
+	// left edge has inside at right.
+	t.topLeft = 0;
+	for (int i = 0; i < 3; i++)
+	{
+		if ((e[i][0] > 0.0) || ((e[i][0] == 0.0) && (e[i][1] < 0.0))) t.topLeft |= 1 << i;
+	}
+	for (int j = 0; j < 3; j++)
+	{
+		for (int i = 0; i < 3; i++) t.edges[i][j] = static_cast<float>(e[i][j]);
+		t.zPlane[j] = static_cast<float>(Z[0] * e[0][j] + Z[1] * e[1][j] + Z[2] * e[2][j]);
+		t.wPlane[j] = static_cast<float>(W[0] * e[0][j] + W[1] * e[1][j] + W[2] * e[2][j]);
+		t.uPlane[j] = static_cast<float>(U[0] * e[0][j] + U[1] * e[1][j] + U[2] * e[2][j]);
+		t.vPlane[j] = static_cast<float>(V[0] * e[0][j] + V[1] * e[1][j] + V[2] * e[2][j]);
+	}
+	t.minX = minX;
+	t.minY = minY;
+	t.maxX = maxX;
+	t.maxY = maxY;
+	for (int ty = minY / APPCONST::SOFT_TILE_SIZE; ty <= maxY / APPCONST::SOFT_TILE_SIZE; ty++)
+	{
+		for (int tx = minX / APPCONST::SOFT_TILE_SIZE; tx <= maxX / APPCONST::SOFT_TILE_SIZE; tx++)
+		{
+			w.bins[ty * tilesX + tx].push_back(w.trianglesCount);
+		}
+	}
+	w.trianglesCount++;
+	w.trianglesDone++;
+}
+void SoftRasterizer::rasterTile(softWorker& w, int tile, BOOL clear)
+{
+	int tx0 = (tile % tilesX) * APPCONST::SOFT_TILE_SIZE;
+	int ty0 = (tile / tilesX) * APPCONST::SOFT_TILE_SIZE;
+	int tx1 = tx0 + APPCONST::SOFT_TILE_SIZE - 1;
+	int ty1 = ty0 + APPCONST::SOFT_TILE_SIZE - 1;
+	if (ty1 >= APPCONST::SOFT_HEIGHT) ty1 = APPCONST::SOFT_HEIGHT - 1;
+	if (clear)
+	{
+		const DWORD32 background = 0xFF000000 |
+			(static_cast<DWORD32>(APPCONST::BACKGROUND_R * 255.0f + 0.5f) << 16) |
+			(static_cast<DWORD32>(APPCONST::BACKGROUND_G * 255.0f + 0.5f) << 8) |
+			static_cast<DWORD32>(APPCONST::BACKGROUND_B * 255.0f + 0.5f);
+		for (int y = ty0; y <= ty1; y++)
+		{
+			for (int x = tx0; x <= tx1; x++)
+			{
+				colorBuffer[y * APPCONST::SOFT_WIDTH + x] = background;
+				depthBuffer[y * APPCONST::SOFT_WIDTH + x] = 1.0f;
+			}
+		}
+	}
+	DWORD64 pixels = 0;
+	for (int i = 0; i < workersCount; i++)
+	{
+		const softWorker& src = workers[i];
+		const std::vector<unsigned int>& bin = src.bins[tile];
+		for (size_t j = 0; j < bin.size(); j++)
+		{
+			const softTriangle& t = src.triangles[bin[j]];
+			int x0 = (t.minX > tx0) ? t.minX : tx0;
+			int y0 = (t.minY > ty0) ? t.minY : ty0;
+			int x1 = (t.maxX < tx1) ? t.maxX : tx1;
+			int y1 = (t.maxY < ty1) ? t.maxY : ty1;
+			if (avx2)
+			{
+				rasterAvx2(t, x0, y0, x1, y1, pixels);
+			}
+			else
+			{
+				rasterScalar(t, x0, y0, x1, y1, pixels);
+			}
+		}
+	}
+	w.pixelsDone += pixels;
+}
+// 8 pixels per step, x0 aligned down to 8, tile bounds are multiple of 8.
+void SoftRasterizer::rasterAvx2(const softTriangle& t, int x0, int y0, int x1, int y1, DWORD64& pixels)
+{
+	const __m256 lanes = _mm256_setr_ps(0.0f, 1.0f, 2.0f, 3.0f, 4.0f, 5.0f, 6.0f, 7.0f);
+	const __m256 half = _mm256_set1_ps(0.5f);
+	const __m256 zero = _mm256_setzero_ps();
+	const __m256 one = _mm256_set1_ps(1.0f);
+	const __m256 left = _mm256_set1_ps(static_cast<float>(x0));
+	const __m256 right = _mm256_set1_ps(static_cast<float>(x1));
+	const __m256 texW = _mm256_set1_ps(static_cast<float>(APPCONST::TEXTURE_WIDTH));
+	const __m256 texH = _mm256_set1_ps(static_cast<float>(APPCONST::TEXTURE_HEIGHT));
+	const __m256 invW = _mm256_set1_ps(1.0f / APPCONST::TEXTURE_WIDTH);
+	const __m256 invH = _mm256_set1_ps(1.0f / APPCONST::TEXTURE_HEIGHT);
+	const __m256i texWi = _mm256_set1_epi32(APPCONST::TEXTURE_WIDTH);
+	const __m256i texHi = _mm256_set1_epi32(APPCONST::TEXTURE_HEIGHT);
+	const __m256i oneI = _mm256_set1_epi32(1);
+	const __m256i byteMask = _mm256_set1_epi32(0xFF);
+	const __m256i alpha = _mm256_set1_epi32(static_cast<int>(0xFF000000));
+	const int* texBase = reinterpret_cast<const int*>(texels);
+	for (int y = y0; y <= y1; y++)
+	{
+		const __m256 py = _mm256_set1_ps(y + 0.5f);
+		DWORD32* colorRow = colorBuffer + y * APPCONST::SOFT_WIDTH;
+		float* depthRow = depthBuffer + y * APPCONST::SOFT_WIDTH;
+		for (int x = x0 & (~7); x <= x1; x += 8)
+		{
+			__m256 index = _mm256_add_ps(_mm256_set1_ps(static_cast<float>(x)), lanes);
+			__m256 px = _mm256_add_ps(index, half);
+			__m256 mask = _mm256_and_ps(_mm256_cmp_ps(index, left, _CMP_GE_OQ), _mm256_cmp_ps(index, right, _CMP_LE_OQ));
+			for (int i = 0; i < 3; i++)
+			{
+				__m256 l = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(t.edges[i][0]), px),
+					_mm256_mul_ps(_mm256_set1_ps(t.edges[i][1]), py)), _mm256_set1_ps(t.edges[i][2]));
+				__m256 edge = (t.topLeft & (1 << i)) ? _mm256_cmp_ps(l, zero, _CMP_GE_OQ) : _mm256_cmp_ps(l, zero, _CMP_GT_OQ);
+				mask = _mm256_and_ps(mask, edge);
+			}
+			if (!_mm256_movemask_ps(mask)) continue;
+			__m256 z = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(t.zPlane[0]), px),
+				_mm256_mul_ps(_mm256_set1_ps(t.zPlane[1]), py)), _mm256_set1_ps(t.zPlane[2]));
+			mask = _mm256_and_ps(mask, _mm256_and_ps(_mm256_cmp_ps(z, zero, _CMP_GE_OQ), _mm256_cmp_ps(z, one, _CMP_LE_OQ)));
+			if (depthEnabled)
+			{
+				mask = _mm256_and_ps(mask, _mm256_cmp_ps(z, _mm256_loadu_ps(depthRow + x), _CMP_LT_OQ));
+			}
+			int bits = _mm256_movemask_ps(mask);
+			if (!bits) continue;
+
+			// Perspective-correct texture coordinates.
+			__m256 w = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(t.wPlane[0]), px),
+				_mm256_mul_ps(_mm256_set1_ps(t.wPlane[1]), py)), _mm256_set1_ps(t.wPlane[2]));
+			__m256 u = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(t.uPlane[0]), px),
+				_mm256_mul_ps(_mm256_set1_ps(t.uPlane[1]), py)), _mm256_set1_ps(t.uPlane[2]));
+			__m256 v = _mm256_add_ps(_mm256_add_ps(_mm256_mul_ps(_mm256_set1_ps(t.vPlane[0]), px),
+				_mm256_mul_ps(_mm256_set1_ps(t.vPlane[1]), py)), _mm256_set1_ps(t.vPlane[2]));
+			__m256 rw = _mm256_div_ps(one, w);
+			__m256 fx = _mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(u, rw), texW), half);
+			__m256 fy = _mm256_sub_ps(_mm256_mul_ps(_mm256_mul_ps(v, rw), texH), half);
+
+			// Bilinear: texel centers at half-integer coordinates, repeat wrap of left-bottom texel.
+			__m256 fx0 = _mm256_floor_ps(fx);
+			__m256 fy0 = _mm256_floor_ps(fy);
+			__m256 ax = _mm256_sub_ps(fx, fx0);
+			__m256 ay = _mm256_sub_ps(fy, fy0);
+			fx0 = _mm256_sub_ps(fx0, _mm256_mul_ps(texW, _mm256_floor_ps(_mm256_mul_ps(fx0, invW))));
+			fy0 = _mm256_sub_ps(fy0, _mm256_mul_ps(texH, _mm256_floor_ps(_mm256_mul_ps(fy0, invH))));
+			__m256i ix0 = _mm256_cvttps_epi32(fx0);
+			__m256i iy0 = _mm256_cvttps_epi32(fy0);
+			__m256i ix1 = _mm256_add_epi32(ix0, oneI);
+			__m256i iy1 = _mm256_add_epi32(iy0, oneI);
+			ix1 = _mm256_sub_epi32(ix1, _mm256_and_si256(_mm256_cmpeq_epi32(ix1, texWi), texWi));
+			iy1 = _mm256_sub_epi32(iy1, _mm256_and_si256(_mm256_cmpeq_epi32(iy1, texHi), texHi));
+			__m256i row0 = _mm256_mullo_epi32(iy0, texWi);
+			__m256i row1 = _mm256_mullo_epi32(iy1, texWi);
+			__m256i gatherMask = _mm256_castps_si256(mask);
+			__m256i none = _mm256_setzero_si256();
+			__m256i t00 = _mm256_mask_i32gather_epi32(none, texBase, _mm256_add_epi32(row0, ix0), gatherMask, 4);
+			__m256i t10 = _mm256_mask_i32gather_epi32(none, texBase, _mm256_add_epi32(row0, ix1), gatherMask, 4);
+			__m256i t01 = _mm256_mask_i32gather_epi32(none, texBase, _mm256_add_epi32(row1, ix0), gatherMask, 4);
+			__m256i t11 = _mm256_mask_i32gather_epi32(none, texBase, _mm256_add_epi32(row1, ix1), gatherMask, 4);
+			__m256i color = alpha;
+			for (int shift = 0; shift < 24; shift += 8)
+			{
+				__m128i count = _mm_cvtsi32_si128(shift);
+				__m256 c00 = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srl_epi32(t00, count), byteMask));
+				__m256 c10 = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srl_epi32(t10, count), byteMask));
+				__m256 c01 = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srl_epi32(t01, count), byteMask));
+				__m256 c11 = _mm256_cvtepi32_ps(_mm256_and_si256(_mm256_srl_epi32(t11, count), byteMask));
+				__m256 bottom = _mm256_add_ps(c00, _mm256_mul_ps(_mm256_sub_ps(c10, c00), ax));
+				__m256 top = _mm256_add_ps(c01, _mm256_mul_ps(_mm256_sub_ps(c11, c01), ax));
+				__m256 c = _mm256_add_ps(bottom, _mm256_mul_ps(_mm256_sub_ps(top, bottom), ay));
+				// Add half and truncate as scalar path, not round to nearest even.
+				color = _mm256_or_si256(color, _mm256_sll_epi32(_mm256_cvttps_epi32(_mm256_add_ps(c, half)), count));
+			}
+			_mm256_maskstore_epi32(reinterpret_cast<int*>(colorRow + x), gatherMask, color);
+			if (depthEnabled)
+			{
+				_mm256_maskstore_ps(depthRow + x, gatherMask, z);
+			}
+			pixels += __popcnt(bits);
+		}
+	}
+}
+// Reference path for CPU without AVX2, same arithmetic per pixel.
+void SoftRasterizer::rasterScalar(const softTriangle& t, int x0, int y0, int x1, int y1, DWORD64& pixels)
+{
+	for (int y = y0; y <= y1; y++)
+	{
+		float py = y + 0.5f;
+		for (int x = x0; x <= x1; x++)
+		{
+			float px = x + 0.5f;
+			BOOL inside = TRUE;
+			for (int i = 0; i < 3; i++)
+			{
+				float l = t.edges[i][0] * px + t.edges[i][1] * py + t.edges[i][2];
+				if ((l < 0.0f) || ((l == 0.0f) && (!(t.topLeft & (1 << i))))) inside = FALSE;
+			}
+			if (!inside) continue;
+			float z = t.zPlane[0] * px + t.zPlane[1] * py + t.zPlane[2];
+			float* pDepth = depthBuffer + y * APPCONST::SOFT_WIDTH + x;
+			if ((z < 0.0f) || (z > 1.0f)) continue;
+			if (depthEnabled && (!(z < *pDepth))) continue;
+			float w = t.wPlane[0] * px + t.wPlane[1] * py + t.wPlane[2];
+			float u = (t.uPlane[0] * px + t.uPlane[1] * py + t.uPlane[2]) / w;
+			float v = (t.vPlane[0] * px + t.vPlane[1] * py + t.vPlane[2]) / w;
+			colorBuffer[y * APPCONST::SOFT_WIDTH + x] = sampleScalar(u, v);
+			if (depthEnabled) *pDepth = z;
+			pixels++;
+		}
+	}
+}
+DWORD32 SoftRasterizer::sampleScalar(float u, float v)
+{
+	constexpr int TW = APPCONST::TEXTURE_WIDTH;
+	constexpr int TH = APPCONST::TEXTURE_HEIGHT;
+	float fx = u * TW - 0.5f;
+	float fy = v * TH - 0.5f;
+	float fx0 = floorf(fx);
+	float fy0 = floorf(fy);
+	float ax = fx - fx0;
+	float ay = fy - fy0;
+	int ix0 = static_cast<int>(fx0 - TW * floorf(fx0 / TW));
+	int iy0 = static_cast<int>(fy0 - TH * floorf(fy0 / TH));
+	int ix1 = (ix0 + 1 == TW) ? 0 : (ix0 + 1);
+	int iy1 = (iy0 + 1 == TH) ? 0 : (iy0 + 1);
+	DWORD32 t00 = texels[iy0 * TW + ix0];
+	DWORD32 t10 = texels[iy0 * TW + ix1];
+	DWORD32 t01 = texels[iy1 * TW + ix0];
+	DWORD32 t11 = texels[iy1 * TW + ix1];
+	DWORD32 color = 0xFF000000;
+	for (int shift = 0; shift < 24; shift += 8)
+	{
+		float c00 = static_cast<float>((t00 >> shift) & 0xFF);
+		float c10 = static_cast<float>((t10 >> shift) & 0xFF);
+		float c01 = static_cast<float>((t01 >> shift) & 0xFF);
+		float c11 = static_cast<float>((t11 >> shift) & 0xFF);
+		float bottom = c00 + (c10 - c00) * ax;
+		float top = c01 + (c11 - c01) * ax;
+		color |= static_cast<DWORD32>(bottom + (top - bottom) * ay + 0.5f) << shift;
+	}
+	return color;
+}
+// Sense-reversing spin barrier, workers count threads.
+void SoftRasterizer::barrier(softWorker& w)
+{
+	w.sense = !w.sense;
+	if (barrierCount.fetch_add(1) == (workersCount - 1))
+	{
+		barrierCount.store(0);
+		barrierSense.store(w.sense);
+	}
+	else
+	{
+		while (barrierSense.load() != w.sense)
+		{
+			_mm_pause();
+		}
+	}
+}
+// Frame buffer rows are bottom-up as BMP rows.
+BOOL SoftRasterizer::saveBitmap(const char* fileName)
+{
+	constexpr DWORD IMAGE_BYTES = APPCONST::SOFT_WIDTH * APPCONST::SOFT_HEIGHT * sizeof(DWORD32);
+	BITMAPFILEHEADER fileHeader = { 0 };
+	BITMAPINFOHEADER infoHeader = { 0 };
+	fileHeader.bfType = 0x4D42;    // "BM"
+	fileHeader.bfOffBits = sizeof(BITMAPFILEHEADER) + sizeof(BITMAPINFOHEADER);
+	fileHeader.bfSize = fileHeader.bfOffBits + IMAGE_BYTES;
+	infoHeader.biSize = sizeof(BITMAPINFOHEADER);
+	infoHeader.biWidth = APPCONST::SOFT_WIDTH;
+	infoHeader.biHeight = APPCONST::SOFT_HEIGHT;
+	infoHeader.biPlanes = 1;
+	infoHeader.biBitCount = 32;
+	infoHeader.biCompression = BI_RGB;
+	infoHeader.biSizeImage = IMAGE_BYTES;
+	HANDLE hFile = CreateFile(fileName, GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) return FALSE;
+	DWORD written = 0;
+	BOOL status = WriteFile(hFile, &fileHeader, sizeof(fileHeader), &written, nullptr) &&
+		WriteFile(hFile, &infoHeader, sizeof(infoHeader), &written, nullptr) &&
+		WriteFile(hFile, colorBuffer, IMAGE_BYTES, &written, nullptr) && (written == IMAGE_BYTES);
+	CloseHandle(hFile);
+	return status;
+}
@@ -0,0 +1,93 @@
+/*
+OpenGL GPUstress.
+Software rasterizer class header.
+CPU reference renderer of cubes scene: same vertex transform as vertex shader,
+tiled multithreaded rasterization, AVX2 for 8 pixels per step,
+perspective-correct bilinear texture sampling and depth test.
+*/
+
+#pragma once
+#ifndef SOFTRASTERIZER_H
+#define SOFTRASTERIZER_H
+
+#include <windows.h>
+#include <iostream>
+#include <intrin.h>
+#include <immintrin.h>
+#include <math.h>
+#include <atomic>
+#include <vector>
+#include "Global.h"
+#include "Report.h"
+
+// Screen space triangle after setup, planes: value = A * x + B * y + C at pixel center.
+struct softTriangle
+{
+    float edges[3][3];      // Barycentric coordinates planes, pixel inside if all not negative.
+    DWORD32 topLeft;        // Bit per edge, pixel center exactly at edge inside only for top or left edge.
+    float zPlane[3];        // Window depth.
+    float wPlane[3];        // 1/w.
+    float uPlane[3];        // u/w.
+    float vPlane[3];        // v/w.
+    int minX;
+    int minY;
+    int maxX;
+    int maxY;
+};
+
+class SoftRasterizer;
+
+// Worker thread state: own setup output and bins, counters written by owner thread only.
+struct softWorker
+{
+    SoftRasterizer* owner;
+    int index;
+    BOOL sense;
+    softTriangle* triangles;
+    unsigned int trianglesCount;
+    std::vector<unsigned int>* bins;
+    DWORD64 trianglesDone;
+    DWORD64 pixelsDone;
+    BYTE pad[APPCONST::CACHE_LINE_SIZE];
+};
+
+class SoftRasterizer
+{
+public:
+    SoftRasterizer();
+    ~SoftRasterizer();
+    BOOL init(const void* texture, const float* cube);
+    BOOL benchmark(const float* model, const float* scales, unsigned int load, BOOL depthTest, double period);
+    BOOL getAvx2();
+private:
+    void run(int threads);
+    static DWORD WINAPI workerThread(LPVOID parm);
+    void workerLoop(softWorker& w);
+    void setupBatch(softWorker& w, unsigned int first, unsigned int count);
+    void setupTriangle(softWorker& w, const float* v0, const float* v1, const float* v2);
+    void rasterTile(softWorker& w, int tile, BOOL clear);
+    void rasterAvx2(const softTriangle& t, int x0, int y0, int x1, int y1, DWORD64& pixels);
+    void rasterScalar(const softTriangle& t, int x0, int y0, int x1, int y1, DWORD64& pixels);
+    DWORD32 sampleScalar(float u, float v);
+    void barrier(softWorker& w);
+    BOOL saveBitmap(const char* fileName);
+    const DWORD32* texels;
+    DWORD32* colorBuffer;
+    float* depthBuffer;
+    softWorker* workers;
+    int workersCount;
+    int tilesX;
+    int tilesCount;
+    BOOL avx2;
+    BOOL depthEnabled;
+    const float* instanceScales;
+    unsigned int instanceLoad;
+    const float* vertices;
+    float transformed[APPCONST::CUBE_VERTICES * 6];    // Rotated cube vertices: x, y, z, w, u, v.
+    std::atomic<int> tileNext;
+    std::atomic<int> barrierCount;
+    std::atomic<BOOL> barrierSense;
+    Report report;
+};
+
+#endif // SOFTRASTERIZER_H
@@ -0,0 +1,134 @@
+/*
+OpenGL GPUstress.
+Staging memory arena class.
+Pages allocation at NUMA node of current processor, render thread is
+not pinned and can migrate, node is preferred node at arena create.
+Windows have no transparent huge pages, large pages are explicit
+MEM_LARGE_PAGES allocation, committed and locked at allocation time.
+*/
+
+#include "StagingArena.h"
+
+StagingArena::StagingArena() : base(nullptr), size(0), used(0), kind(ARENA_HEAP), node(0), pageSize(0)
+{
+
+}
+StagingArena::~StagingArena()
+{
+	release();
+}
+BOOL StagingArena::create(arenaKind arenaType, size_t bytes)
+{
+	release();
+	PROCESSOR_NUMBER processor;
+	USHORT nodeNumber = 0;
+	GetCurrentProcessorNumberEx(&processor);
+	if (!GetNumaProcessorNodeEx(&processor, &nodeNumber)) nodeNumber = 0;
+	node = nodeNumber;
+
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	DWORD allocationType = MEM_RESERVE | MEM_COMMIT;
+	pageSize = info.dwPageSize;
+	if (arenaType == ARENA_LARGE_PAGES)
+	{
+		pageSize = GetLargePageMinimum();
+		if ((!pageSize) || (!enableLockMemory())) return FALSE;
+		allocationType |= MEM_LARGE_PAGES;
+	}
+	size = (bytes + pageSize - 1) / pageSize * pageSize;
+
+	if (arenaType == ARENA_HEAP)
+	{
+		base = static_cast<BYTE*>(_aligned_malloc(size, APPCONST::CACHE_LINE_SIZE));
+		if (!base) return FALSE;
+		memset(base, 0, size);
+	}
+	else
+	{
+		base = static_cast<BYTE*>(VirtualAllocExNuma(GetCurrentProcess(), nullptr, size, allocationType, PAGE_READWRITE, node));
+		if (!base) return FALSE;
+		// Touch pages: physical pages mapped now, not at first fill.
+		for (size_t i = 0; i < size; i += pageSize)
+		{
+			base[i] = 0;
+		}
+	}
+	kind = arenaType;
+	used = 0;
+	return TRUE;
+}
+void StagingArena::release()
+{
+	if (base)
+	{
+		if (kind == ARENA_HEAP)
+		{
+			_aligned_free(base);
+		}
+		else
+		{
+			VirtualFree(base, 0, MEM_RELEASE);
+		}
+	}
+	base = nullptr;
+	size = 0;
+	used = 0;
+}
+// Cache line aligned sub-allocation, released with arena.
+void* StagingArena::allocate(size_t bytes)
+{
+	constexpr size_t ALIGN = APPCONST::CACHE_LINE_SIZE;
+	size_t aligned = (bytes + ALIGN - 1) / ALIGN * ALIGN;
+	if ((!base) || ((size - used) < aligned)) return nullptr;
+	void* p = base + used;
+	used += aligned;
+	return p;
+}
+// Decommit and commit used part of arena, next access of each page is demand zero page fault.
+// If node commit fails, pages committed without node preference and refault stops,
+// arena kind becomes plain pages. Returns FALSE if arena pages not committed.
+BOOL StagingArena::refault()
+{
+	if ((kind != ARENA_PAGES_REFAULT) || (!base)) return TRUE;
+	VirtualFree(base, size, MEM_DECOMMIT);
+	if (VirtualAllocExNuma(GetCurrentProcess(), base, size, MEM_COMMIT, PAGE_READWRITE, node)) return TRUE;
+	kind = ARENA_PAGES;
+	return (VirtualAlloc(base, size, MEM_COMMIT, PAGE_READWRITE) != nullptr);
+}
+arenaKind StagingArena::getKind()
+{
+	return kind;
+}
+DWORD StagingArena::getNode()
+{
+	return node;
+}
+size_t StagingArena::getPageSize()
+{
+	return pageSize;
+}
+DWORD StagingArena::getPageFaults()
+{
+	PROCESS_MEMORY_COUNTERS counters;
+	counters.cb = sizeof(counters);
+	if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) return 0;
+	return counters.PageFaultCount;
+}
+// Large pages requires SeLockMemoryPrivilege enabled in process token.
+BOOL StagingArena::enableLockMemory()
+{
+	HANDLE hToken = NULL;
+	if (!OpenProcessToken(GetCurrentProcess(), TOKEN_ADJUST_PRIVILEGES | TOKEN_QUERY, &hToken)) return FALSE;
+	TOKEN_PRIVILEGES privileges;
+	privileges.PrivilegeCount = 1;
+	privileges.Privileges[0].Attributes = SE_PRIVILEGE_ENABLED;
+	BOOL status = LookupPrivilegeValue(nullptr, SE_LOCK_MEMORY_NAME, &privileges.Privileges[0].Luid);
+	if (status)
+	{
+		status = AdjustTokenPrivileges(hToken, FALSE, &privileges, 0, nullptr, nullptr) &&
+			(GetLastError() == ERROR_SUCCESS);
+	}
+	CloseHandle(hToken);
+	return status;
+}
@@ -0,0 +1,49 @@
+/*
+OpenGL GPUstress.
+Staging memory arena class header.
+Upload source buffers allocated from one cache line aligned region,
+region is heap block, 4KB pages or 2MB large pages at NUMA node of render thread.
+*/
+
+#pragma once
+#ifndef STAGINGARENA_H
+#define STAGINGARENA_H
+
+#include <windows.h>
+#include <psapi.h>
+#include <malloc.h>
+#include "Global.h"
+
+enum arenaKind
+{
+    ARENA_HEAP = 0,         // Cache line aligned heap block.
+    ARENA_PAGES,            // Committed and touched 4KB pages at render thread NUMA node.
+    ARENA_PAGES_REFAULT,    // Same pages decommitted and committed each frame, page faults at fill.
+    ARENA_LARGE_PAGES,      // 2MB pages, requires "Lock pages in memory" user right.
+    ARENA_KINDS_COUNT
+};
+
+class StagingArena
+{
+public:
+    StagingArena();
+    ~StagingArena();
+    BOOL create(arenaKind arenaType, size_t bytes);
+    void release();
+    void* allocate(size_t bytes);
+    BOOL refault();
+    arenaKind getKind();
+    DWORD getNode();
+    size_t getPageSize();
+    static DWORD getPageFaults();
+private:
+    static BOOL enableLockMemory();
+    BYTE* base;
+    size_t size;
+    size_t used;
+    arenaKind kind;
+    DWORD node;
+    size_t pageSize;
+};
+
+#endif // STAGINGARENA_H
@@ -0,0 +1,231 @@
+/*
+OpenGL GPUstress.
+State change cost benchmark class.
+Matrix cell 0 is reference without state changes, other cells are
+change type x switch frequency. Cost of one change is cell time minus
+reference time, divided by switches count, CPU submit time measured.
+Programs A and B are different variants of same cube shader,
+textures, VAOs and uniform buffers of pair have same contents.
+*/
+
+#include "StateBenchmark.h"
+
+StateBenchmark::StateBenchmark() : f(nullptr), programs{ 0 }, textures{ 0 }, vaos{ 0 }, ubos{ 0 },
+	                               modelLocations{ -1, -1 }, ownTexture(FALSE), ownVao(FALSE), tscPeriod(0.0), cellIndex(0),
+	                               cellTicks{ 0 }, cellSwitches{ 0 }, cellFrames{ 0 }
+{
+
+}
+StateBenchmark::~StateBenchmark()
+{
+
+}
+int StateBenchmark::init(const oglFunctionsList* pFunctions, ShaderBuilder* pBuilder,
+	const char* version, const char* vertexSource, const char* fragmentSource,
+	GLuint mainTexture, GLuint mainVao, GLuint cubeVbo, GLuint instanceVbo,
+	const void* rawData, double period)
+{
+	f = pFunctions;
+	tscPeriod = period;
+	resetStatistics();
+
+	int status = pBuilder->build(version, definesA, vertexSource, fragmentSource, programs[0]);
+	if (status) return status;
+	status = pBuilder->build(version, definesB, vertexSource, fragmentSource, programs[1]);
+	if (status) return status;
+
+	f->glGenBuffers(2, ubos);
+	if (glGetError() || (!ubos[0]) || (!ubos[1])) return 0x140;
+	const GLfloat stateOffset[4] = { 0.0f, 0.0f, 0.0f, 0.0f };
+	for (int i = 0; i < 2; i++)
+	{
+		f->glBindBuffer(GL_UNIFORM_BUFFER, ubos[i]);
+		f->glBufferData(GL_UNIFORM_BUFFER, sizeof(stateOffset), stateOffset, GL_STATIC_DRAW);
+		if (glGetError()) return 0x141;
+	}
+	f->glBindBuffer(GL_UNIFORM_BUFFER, 0);
+
+	for (int i = 0; i < 2; i++)
+	{
+		f->glUseProgram(programs[i]);
+		f->glUniform1i(f->glGetUniformLocation(programs[i], "texture1"), 0);
+		f->glUniform1i(f->glGetUniformLocation(programs[i], "instanceBase"), APPCONST::TEXT_CHARS);
+		GLuint blockIndex = f->glGetUniformBlockIndex(programs[i], "stateBlock");
+		if (blockIndex == GL_INVALID_INDEX) return 0x142;
+		f->glUniformBlockBinding(programs[i], blockIndex, 0);
+		modelLocations[i] = f->glGetUniformLocation(programs[i], "model_R");
+		if (glGetError()) return 0x143;
+	}
+
+	textures[0] = mainTexture;
+	glGenTextures(1, &textures[1]);
+	if (glGetError() || (!textures[1])) return 0x144;
+	ownTexture = TRUE;
+	glBindTexture(GL_TEXTURE_2D, textures[1]);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB,
+		APPCONST::TEXTURE_WIDTH, APPCONST::TEXTURE_HEIGHT,
+		0, GL_BGRA, GL_UNSIGNED_BYTE, rawData);
+	f->glGenerateMipmap(GL_TEXTURE_2D);
+	if (glGetError()) return 0x145;
+	glBindTexture(GL_TEXTURE_2D, mainTexture);
+
+	vaos[0] = mainVao;
+	f->glGenVertexArrays(1, &vaos[1]);
+	if (!vaos[1]) return 0x146;
+	ownVao = TRUE;
+	f->glBindVertexArray(vaos[1]);
+	f->glBindBuffer(GL_ARRAY_BUFFER, cubeVbo);
+	f->glVertexAttribPointer(0, 3, GL_FLOAT, 0, APPCONST::CUBE_STRIDE, 0);
+	f->glEnableVertexAttribArray(0);
+	f->glVertexAttribPointer(1, 2, GL_FLOAT, 0, APPCONST::CUBE_STRIDE, (void*)APPCONST::CUBE_TEXTURE_OFFSET);
+	f->glEnableVertexAttribArray(1);
+	f->glBindBuffer(GL_ARRAY_BUFFER, instanceVbo);
+	f->glVertexAttribPointer(2, 1, GL_FLOAT, 0, 4, 0);
+	f->glVertexAttribDivisor(2, 1);
+	f->glEnableVertexAttribArray(2);
+	if (glGetError()) return 0x147;
+	f->glBindVertexArray(mainVao);
+	return 0;
+}
+void StateBenchmark::release()
+{
+	if (!f) return;
+	for (int i = 0; i < 2; i++)
+	{
+		if (programs[i]) f->glDeleteProgram(programs[i]);
+		programs[i] = 0;
+	}
+	if (ubos[0]) f->glDeleteBuffers(2, ubos);
+	if (ownTexture) glDeleteTextures(1, &textures[1]);
+	if (ownVao) f->glDeleteVertexArrays(1, &vaos[1]);
+	ubos[0] = ubos[1] = 0;
+	ownTexture = FALSE;
+	ownVao = FALSE;
+}
+void StateBenchmark::resetStatistics()
+{
+	memset(cellTicks, 0, sizeof(cellTicks));
+	memset(cellSwitches, 0, sizeof(cellSwitches));
+	memset(cellFrames, 0, sizeof(cellFrames));
+	cellIndex = 0;
+}
+// One matrix cell per frame. Caller restores own program, texture and VAO bindings.
+void StateBenchmark::draw(const GLfloat* modelMatrix)
+{
+	int type = STATE_NONE;
+	int frequencyIndex = 0;
+	if (cellIndex)
+	{
+		type = (cellIndex - 1) / APPCONST::STATE_FREQUENCIES_COUNT + 1;
+		frequencyIndex = (cellIndex - 1) % APPCONST::STATE_FREQUENCIES_COUNT;
+	}
+	const int frequency = APPCONST::STATE_FREQUENCIES[frequencyIndex];
+
+	for (int i = 0; i < 2; i++)
+	{
+		f->glUseProgram(programs[i]);
+		f->glUniformMatrix4fv(modelLocations[i], 1, 0, modelMatrix);
+	}
+	for (int i = 0; i < STATE_TYPES_COUNT; i++)
+	{
+		switchState(i, 0);
+	}
+
+	constexpr GLint ARRAY_COUNT = APPCONST::CUBE_VERTICES;
+	int select = 0;
+	DWORD64 switches = 0;
+	DWORD64 t1 = __rdtsc();
+	for (int i = 0; i < APPCONST::STATE_DRAWS_PER_FRAME; i++)
+	{
+		if ((type != STATE_NONE) && (i % frequency == 0))
+		{
+			select ^= 1;
+			switchState(type, select);
+			switches++;
+		}
+		glDrawArrays(GL_TRIANGLES, 0, ARRAY_COUNT);
+	}
+	cellTicks[type][frequencyIndex] += __rdtsc() - t1;
+	cellSwitches[type][frequencyIndex] += switches;
+	cellFrames[type][frequencyIndex]++;
+	cellIndex = (cellIndex + 1) % (1 + (STATE_TYPES_COUNT - 1) * APPCONST::STATE_FREQUENCIES_COUNT);
+}
+void StateBenchmark::switchState(int type, int select)
+{
+	switch (type)
+	{
+	case STATE_PROGRAM:
+		f->glUseProgram(programs[select]);
+		break;
+	case STATE_TEXTURE:
+		glBindTexture(GL_TEXTURE_2D, textures[select]);
+		break;
+	case STATE_VAO:
+		f->glBindVertexArray(vaos[select]);
+		break;
+	case STATE_UBO:
+		f->glBindBufferBase(GL_UNIFORM_BUFFER, 0, ubos[select]);
+		break;
+	default:
+		break;
+	}
+}
+double StateBenchmark::nsPerDraw()
+{
+	if (!cellFrames[STATE_NONE][0]) return 0.0;
+	double ticks = static_cast<double>(cellTicks[STATE_NONE][0]) / cellFrames[STATE_NONE][0];
+	return ticks * tscPeriod * 1.0E9 / APPCONST::STATE_DRAWS_PER_FRAME;
+}
+double StateBenchmark::nsPerChange(int type, int frequencyIndex)
+{
+	DWORD64 frames = cellFrames[type][frequencyIndex];
+	if ((!frames) || (!cellFrames[STATE_NONE][0]) || (!cellSwitches[type][frequencyIndex])) return 0.0;
+	double ticks = static_cast<double>(cellTicks[type][frequencyIndex]) / frames;
+	double reference = static_cast<double>(cellTicks[STATE_NONE][0]) / cellFrames[STATE_NONE][0];
+	double switches = static_cast<double>(cellSwitches[type][frequencyIndex]) / frames;
+	return (ticks - reference) * tscPeriod * 1.0E9 / switches;
+}
+void StateBenchmark::writeRow(char* row, int size)
+{
+	char szResults[APPCONST::MAX_TEXT_STRING];
+	snprintf(szResults, APPCONST::MAX_TEXT_STRING, "ns/change: Prog %-6.1f Tex %-6.1f VAO %-6.1f UBO %-6.1f ns/draw %-5.1f R=save",
+		nsPerChange(STATE_PROGRAM, 0), nsPerChange(STATE_TEXTURE, 0),
+		nsPerChange(STATE_VAO, 0), nsPerChange(STATE_UBO, 0), nsPerDraw());
+	snprintf(row, size, "%-*s", size - 1, szResults);
+}
+BOOL StateBenchmark::saveReport(const char* fileName)
+{
+	if (!cellFrames[STATE_NONE][0]) return FALSE;
+	report.clear();
+	report.add("State change cost, CPU ns per change, %d draws per frame, reference ns/draw = %.2f\r\n",
+		APPCONST::STATE_DRAWS_PER_FRAME, nsPerDraw());
+	report.add("change type");
+	for (int j = 0; j < APPCONST::STATE_FREQUENCIES_COUNT; j++)
+	{
+		report.add(",every %d draws", APPCONST::STATE_FREQUENCIES[j]);
+	}
+	report.add("\r\n");
+	for (int i = STATE_PROGRAM; i < STATE_TYPES_COUNT; i++)
+	{
+		report.add("%s", typeNames[i]);
+		for (int j = 0; j < APPCONST::STATE_FREQUENCIES_COUNT; j++)
+		{
+			report.add(",%.2f", nsPerChange(i, j));
+		}
+		report.add("\r\n");
+	}
+	return report.save(fileName);
+}
+
+// Variants A and B differs by one instruction, both reads uniform block.
+const char* StateBenchmark::definesA =
+"#define STATE_BLOCK\r\n";
+const char* StateBenchmark::definesB =
+"#define STATE_BLOCK\r\n"
+"#define STATE_VARIANT_B\r\n";
+
+const char* StateBenchmark::typeNames[] { "none", "program", "texture", "VAO", "uniform block" };
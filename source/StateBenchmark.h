@@ -0,0 +1,66 @@
+/*
+OpenGL GPUstress.
+State change cost benchmark class header.
+Draws interleaved with controlled switches of shader program, texture,
+vertex array object or uniform block buffer, one matrix cell per frame.
+*/
+
+#pragma once
+#ifndef STATEBENCHMARK_H
+#define STATEBENCHMARK_H
+
+#include <windows.h>
+#include <intrin.h>
+#include "Global.h"
+#include "OpenGLImport.h"
+#include "ShaderBuilder.h"
+#include "Report.h"
+
+enum stateChangeType
+{
+    STATE_NONE = 0,     // Reference: draws without state changes.
+    STATE_PROGRAM,
+    STATE_TEXTURE,
+    STATE_VAO,
+    STATE_UBO,
+    STATE_TYPES_COUNT
+};
+
+class StateBenchmark
+{
+public:
+    StateBenchmark();
+    ~StateBenchmark();
+    int init(const oglFunctionsList* pFunctions, ShaderBuilder* pBuilder,
+        const char* version, const char* vertexSource, const char* fragmentSource,
+        GLuint mainTexture, GLuint mainVao, GLuint cubeVbo, GLuint instanceVbo,
+        const void* rawData, double tscPeriod);
+    void release();
+    void resetStatistics();
+    void draw(const GLfloat* modelMatrix);
+    void writeRow(char* row, int size);
+    BOOL saveReport(const char* fileName);
+private:
+    double nsPerChange(int type, int frequencyIndex);
+    double nsPerDraw();
+    void switchState(int type, int select);
+    const oglFunctionsList* f;
+    GLuint programs[2];
+    GLuint textures[2];
+    GLuint vaos[2];
+    GLuint ubos[2];
+    GLint modelLocations[2];
+    BOOL ownTexture;
+    BOOL ownVao;
+    double tscPeriod;
+    int cellIndex;
+    DWORD64 cellTicks[STATE_TYPES_COUNT][APPCONST::STATE_FREQUENCIES_COUNT];
+    DWORD64 cellSwitches[STATE_TYPES_COUNT][APPCONST::STATE_FREQUENCIES_COUNT];
+    DWORD64 cellFrames[STATE_TYPES_COUNT][APPCONST::STATE_FREQUENCIES_COUNT];
+    Report report;
+    static const char* definesA;
+    static const char* definesB;
+    static const char* typeNames[];
+};
+
+#endif // STATEBENCHMARK_H
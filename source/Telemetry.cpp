@@ -0,0 +1,222 @@
+/*
+OpenGL GPUstress.
+Per-frame telemetry class.
+Render thread only stores record to ring and publishes head index,
+no system calls and no locks at producer side. Writer thread polls ring,
+formats records and writes trace file.
+*/
+
+#include "Telemetry.h"
+
+Telemetry::Telemetry() : writeBufferUsed(0), hFile(INVALID_HANDLE_VALUE), hThread(NULL), hStopEvent(NULL),
+	                     format(TRACE_OFF), tscFrequency(0.0), frameCounter(0), droppedCount(0),
+	                     padHead{ 0 }, head(0), padTail{ 0 }, tail(0), padEnd{ 0 }, writtenCount(0)
+{
+	ring = new frameRecord[APPCONST::TELEMETRY_RING_RECORDS];
+	memset(ring, 0, APPCONST::TELEMETRY_RING_RECORDS * sizeof(frameRecord));
+	writeBuffer = new char[APPCONST::TELEMETRY_WRITE_BUFFER];
+	memset(writeBuffer, 0, APPCONST::TELEMETRY_WRITE_BUFFER);
+}
+Telemetry::~Telemetry()
+{
+	stop();
+	if (ring)        delete[] ring;
+	if (writeBuffer) delete[] writeBuffer;
+}
+BOOL Telemetry::start(const char* fileName, traceFormat traceMode, double tscHz)
+{
+	stop();
+	if ((!ring) || (!writeBuffer) || (traceMode == TRACE_OFF)) return FALSE;
+	hFile = CreateFile(fileName, GENERIC_WRITE, FILE_SHARE_READ, nullptr, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (hFile == INVALID_HANDLE_VALUE) return FALSE;
+
+	format = traceMode;
+	tscFrequency = tscHz;
+	frameCounter = 0;
+	droppedCount = 0;
+	writeBufferUsed = 0;
+	head.store(0, std::memory_order_relaxed);
+	tail.store(0, std::memory_order_relaxed);
+	writtenCount.store(0, std::memory_order_relaxed);
+
+	if (format == TRACE_BINARY)
+	{
+		traceFileHeader header;
+		header.signature = APPCONST::TRACE_SIGNATURE;
+		header.recordSize = sizeof(frameRecord);
+		header.stagesCount = STAGE_COUNT;
+		header.droppedCount = 0;
+		header.tscFrequency = tscFrequency;
+		memcpy(writeBuffer, &header, sizeof(header));
+		writeBufferUsed = sizeof(header);
+	}
+	else
+	{
+		writeBufferUsed = snprintf(writeBuffer, APPCONST::TELEMETRY_TEXT_RECORD,
+			"# TSC frequency Hz = %.0f\r\n"
+			"frame,instances,depth,bytes,tsc_begin,tsc_setup,tsc_matrix,tsc_fill,tsc_upload,tsc_draw,tsc_swap,tsc_text,"
+			"us_setup,us_matrix,us_fill,us_upload,us_draw,us_swap,us_text,us_total,us_capture\r\n",
+			tscFrequency);
+	}
+
+	hStopEvent = CreateEvent(nullptr, TRUE, FALSE, nullptr);
+	if (hStopEvent)
+	{
+		hThread = CreateThread(nullptr, 0, writerThread, this, 0, nullptr);
+	}
+	if (!hThread)
+	{
+		if (hStopEvent)
+		{
+			CloseHandle(hStopEvent);
+			hStopEvent = NULL;
+		}
+		CloseHandle(hFile);
+		hFile = INVALID_HANDLE_VALUE;
+		format = TRACE_OFF;
+		return FALSE;
+	}
+	return TRUE;
+}
+void Telemetry::stop()
+{
+	if (hThread)
+	{
+		SetEvent(hStopEvent);
+		WaitForSingleObject(hThread, INFINITE);
+		CloseHandle(hThread);
+		hThread = NULL;
+		writeFooter();
+	}
+	if (hStopEvent)
+	{
+		CloseHandle(hStopEvent);
+		hStopEvent = NULL;
+	}
+	if (hFile != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(hFile);
+		hFile = INVALID_HANDLE_VALUE;
+	}
+	format = TRACE_OFF;
+}
+// Producer side, called by render thread.
+BOOL Telemetry::push(const frameRecord& record)
+{
+	if (format == TRACE_OFF) return FALSE;
+	DWORD64 h = head.load(std::memory_order_relaxed);
+	DWORD64 t = tail.load(std::memory_order_acquire);
+	if ((h - t) >= APPCONST::TELEMETRY_RING_RECORDS)
+	{
+		droppedCount++;
+		return FALSE;
+	}
+	frameRecord* p = &ring[h & (APPCONST::TELEMETRY_RING_RECORDS - 1)];
+	*p = record;
+	p->frameIndex = frameCounter++;
+	head.store(h + 1, std::memory_order_release);
+	return TRUE;
+}
+traceFormat Telemetry::getFormat()
+{
+	return format;
+}
+DWORD64 Telemetry::getWrittenCount()
+{
+	return writtenCount.load(std::memory_order_relaxed);
+}
+DWORD64 Telemetry::getDroppedCount()
+{
+	return droppedCount;
+}
+// Dropped records count after writer thread finished: CSV footer line,
+// binary header field rewritten, records stream stays raw.
+void Telemetry::writeFooter()
+{
+	if (hFile == INVALID_HANDLE_VALUE) return;
+	DWORD written = 0;
+	if (format == TRACE_BINARY)
+	{
+		DWORD32 dropped = (droppedCount > MAXDWORD32) ? MAXDWORD32 : static_cast<DWORD32>(droppedCount);
+		if (SetFilePointer(hFile, offsetof(traceFileHeader, droppedCount), nullptr, FILE_BEGIN) != INVALID_SET_FILE_POINTER)
+		{
+			WriteFile(hFile, &dropped, sizeof(dropped), &written, nullptr);
+		}
+	}
+	else
+	{
+		char footer[64];
+		int k = snprintf(footer, sizeof(footer), "# dropped records = %I64u\r\n", droppedCount);
+		if (k > 0) WriteFile(hFile, footer, k, &written, nullptr);
+	}
+}
+// Consumer side, background thread.
+DWORD WINAPI Telemetry::writerThread(LPVOID parm)
+{
+	Telemetry* p = reinterpret_cast<Telemetry*>(parm);
+	SetThreadPriority(GetCurrentThread(), THREAD_PRIORITY_BELOW_NORMAL);
+	while (WaitForSingleObject(p->hStopEvent, APPCONST::TELEMETRY_POLL_MS) == WAIT_TIMEOUT)
+	{
+		p->drain();
+	}
+	p->drain();
+	p->flushBuffer();
+	return 0;
+}
+void Telemetry::drain()
+{
+	DWORD64 t = tail.load(std::memory_order_relaxed);
+	DWORD64 h = head.load(std::memory_order_acquire);
+	while (t < h)
+	{
+		writeRecord(ring[t & (APPCONST::TELEMETRY_RING_RECORDS - 1)]);
+		t++;
+		tail.store(t, std::memory_order_release);
+	}
+}
+BOOL Telemetry::flushBuffer()
+{
+	BOOL status = TRUE;
+	if (writeBufferUsed)
+	{
+		DWORD written = 0;
+		status = WriteFile(hFile, writeBuffer, static_cast<DWORD>(writeBufferUsed), &written, nullptr);
+		writeBufferUsed = 0;
+	}
+	return status;
+}
+BOOL Telemetry::writeRecord(const frameRecord& r)
+{
+	if ((APPCONST::TELEMETRY_WRITE_BUFFER - writeBufferUsed) < APPCONST::TELEMETRY_TEXT_RECORD)
+	{
+		if (!flushBuffer()) return FALSE;
+	}
+	char* p = writeBuffer + writeBufferUsed;
+	if (format == TRACE_BINARY)
+	{
+		memcpy(p, &r, sizeof(frameRecord));
+		writeBufferUsed += sizeof(frameRecord);
+	}
+	else
+	{
+		int k = snprintf(p, APPCONST::TELEMETRY_TEXT_RECORD,
+			"%I64u,%u,%u,%I64u,%I64u,%I64u,%I64u,%I64u,%I64u,%I64u,%I64u,%I64u",
+			r.frameIndex, r.instanceCount, r.depthMode, r.bytesUploaded,
+			r.tsc[STAGE_BEGIN], r.tsc[STAGE_SETUP], r.tsc[STAGE_MATRIX], r.tsc[STAGE_FILL],
+			r.tsc[STAGE_UPLOAD], r.tsc[STAGE_DRAW], r.tsc[STAGE_SWAP], r.tsc[STAGE_TEXT]);
+		if (k > 0) writeBufferUsed += k;
+		// Stage durations in microseconds, time inside zone of stage.
+		double usPerTick = (tscFrequency > 0.0) ? (1000000.0 / tscFrequency) : 0.0;
+		for (int i = STAGE_SETUP; i < STAGE_COUNT; i++)
+		{
+			k = snprintf(writeBuffer + writeBufferUsed, APPCONST::TELEMETRY_TEXT_RECORD, ",%.2f",
+				r.ticks[i] * usPerTick);
+			if (k > 0) writeBufferUsed += k;
+		}
+		k = snprintf(writeBuffer + writeBufferUsed, APPCONST::TELEMETRY_TEXT_RECORD, ",%.2f,%.2f\r\n",
+			(r.tsc[STAGE_TEXT] - r.tsc[STAGE_BEGIN]) * usPerTick, r.captureTicks * usPerTick);
+		if (k > 0) writeBufferUsed += k;
+	}
+	writtenCount.fetch_add(1, std::memory_order_relaxed);
+	return TRUE;
+}
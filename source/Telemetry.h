@@ -0,0 +1,97 @@
+/*
+OpenGL GPUstress.
+Per-frame telemetry class header.
+Single-producer / single-consumer lock-free ring of fixed-size frame records,
+render thread is producer, background writer thread is consumer.
+*/
+
+#pragma once
+#ifndef TELEMETRY_H
+#define TELEMETRY_H
+
+#include <windows.h>
+#include <atomic>
+#include "Global.h"
+
+// Frame stages boundaries, indexes in the timestamps array of frame record.
+enum frameStage
+{
+    STAGE_BEGIN = 0,    // Frame start.
+    STAGE_SETUP,        // Clear, depth mode, texture, program bind done.
+    STAGE_MATRIX,       // Rotation matrices build done.
+    STAGE_FILL,         // Instance data SIMD fill done.
+    STAGE_UPLOAD,       // Instance data upload by glBufferData done.
+    STAGE_DRAW,         // Draw call issue done.
+    STAGE_SWAP,         // SwapBuffers done.
+    STAGE_TEXT,         // Text formatting and text uniforms update done, frame end.
+    STAGE_COUNT
+};
+
+enum traceFormat
+{
+    TRACE_OFF = 0,
+    TRACE_CSV,
+    TRACE_BINARY,
+    TRACE_FORMATS_COUNT
+};
+
+// Fixed size per-frame record, CPU TSC clocks.
+// Zones not contiguous, stage time is ticks inside zone, not interval between stage ends.
+struct frameRecord
+{
+    DWORD64 tsc[STAGE_COUNT];
+    DWORD64 ticks[STAGE_COUNT];     // Ticks inside zone of stage, index 0 is total of zones.
+    DWORD64 frameIndex;
+    DWORD64 bytesUploaded;
+    DWORD64 captureTicks;       // Frame capture, own interval between draw and swap zones.
+    DWORD32 instanceCount;
+    DWORD32 depthMode;          // Bit 0 depth test, bits 1+ depth order.
+};
+
+// Binary trace file header, followed by raw frame records.
+struct traceFileHeader
+{
+    DWORD32 signature;
+    DWORD32 recordSize;
+    DWORD32 stagesCount;
+    DWORD32 droppedCount;       // Records dropped by full ring, written at trace stop.
+    double tscFrequency;
+};
+
+class Telemetry
+{
+public:
+    Telemetry();
+    ~Telemetry();
+    BOOL start(const char* fileName, traceFormat traceMode, double tscHz);
+    void stop();
+    BOOL push(const frameRecord& record);
+    traceFormat getFormat();
+    DWORD64 getWrittenCount();
+    DWORD64 getDroppedCount();
+private:
+    static DWORD WINAPI writerThread(LPVOID parm);
+    void drain();
+    BOOL flushBuffer();
+    void writeFooter();
+    BOOL writeRecord(const frameRecord& record);
+    frameRecord* ring;
+    char* writeBuffer;
+    size_t writeBufferUsed;
+    HANDLE hFile;
+    HANDLE hThread;
+    HANDLE hStopEvent;
+    traceFormat format;
+    double tscFrequency;
+    DWORD64 frameCounter;
+    DWORD64 droppedCount;
+    // Producer and consumer indexes at separate cache lines, prevent false sharing.
+    BYTE padHead[APPCONST::CACHE_LINE_SIZE];
+    std::atomic<DWORD64> head;         // Written by producer only.
+    BYTE padTail[APPCONST::CACHE_LINE_SIZE];
+    std::atomic<DWORD64> tail;         // Written by consumer only.
+    BYTE padEnd[APPCONST::CACHE_LINE_SIZE];
+    std::atomic<DWORD64> writtenCount;
+};
+
+#endif // TELEMETRY_H
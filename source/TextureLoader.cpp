@@ -18,7 +18,18 @@ TextureLoader::TextureLoader(HINSTANCE hModule)
 	gdiplusStartupInput.DebugEventCallback = nullptr;
 	gdiplusStartupInput.SuppressBackgroundThread = FALSE;
 	gdiplusStartupInput.SuppressExternalCodecs = FALSE;
-	if (GdiplusStartup(&gdiplusToken, &gdiplusStartupInput, nullptr) == Gdiplus::GpStatus::Ok)
+	if (GdiplusStartup(&gdiplusToken, &gdiplusStartupInput, nullptr) != Gdiplus::GpStatus::Ok)
+	{
+		gdiplusToken = NULL;
+	}
+	hInstance = hModule;
+}
+// JPEG resource decoded on request, not required if baked atlas blob used.
+// GDI+ started by constructor is also used by frame capture.
+void* TextureLoader::decode()
+{
+	HINSTANCE hModule = hInstance;
+	if ((!rawPointer) && gdiplusToken)
 	{
 		HRSRC hResInfo = FindResource(hModule, MAKEINTRESOURCE(IDR_JPEG_TEXTURE), RT_RCDATA);
 		if(hResInfo)
@@ -69,6 +80,7 @@ TextureLoader::TextureLoader(HINSTANCE hModule)
 			}
 		}
 	}
+	return rawPointer;
 }
 TextureLoader::~TextureLoader()
 {
@@ -103,3 +115,4 @@ HGLOBAL TextureLoader::hGlobal = nullptr;
 HBITMAP TextureLoader::hBitmap = nullptr;
 void* TextureLoader::rawPointer = nullptr;
 BITMAP TextureLoader::bitmap;
+HINSTANCE TextureLoader::hInstance = NULL;
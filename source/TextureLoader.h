@@ -19,6 +19,7 @@ class TextureLoader
 public:
     TextureLoader(HINSTANCE hModule);
     ~TextureLoader();
+    void* decode();
     void* getRawPointer();
     BITMAP* getStrucPointer();
 private:
@@ -28,6 +29,7 @@ private:
     static HBITMAP hBitmap;
     static void* rawPointer;
     static BITMAP bitmap;
+    static HINSTANCE hInstance;
 };
 
 #endif // TEXTURELOADER_H
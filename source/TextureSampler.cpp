@@ -0,0 +1,519 @@
+/*
+OpenGL GPUstress.
+Texture sampling stress class.
+Samples use explicit gradients of same anisotropic footprint for all filters,
+1 texel by SAMPLING_FOOTPRINT texels, so filters compared at same texture
+coordinates: bilinear reads base level, trilinear reads small mip levels,
+anisotropic filter takes more probes at detailed levels.
+Texels rate is nominal: samples rate multiplied by texels per sample of filter.
+Generated working sets are RGBA8 texture arrays with mip levels, sizes are
+base level bytes, layers and layer size passed to shader as uniforms.
+Layers drawn with low alpha blend, scene stays visible.
+*/
+
+#include "TextureSampler.h"
+
+TextureSampler::TextureSampler() : f(nullptr), programs{ 0 }, patternLocations{ -1, -1 }, layersLocation(-1), layerSizeLocation(-1),
+	                               frameLocation(-1), gradXLocation(-1), gradYLocation(-1), sampler(0), emptyVao(0), texture(0),
+	                               arrayTexture(0), width(0), height(0), maxAnisotropy(1.0f), maxLayers(0),
+	                               filterNow(SAMPLING_OFF), patternNow(PATTERN_COHERENT), setNow(0), setAllocated(0), setSupported(TRUE),
+	                               filterSelected(SAMPLING_OFF), patternSelected(PATTERN_COHERENT), setSelected(0), frameIndex(0),
+	                               queries{ 0 }, queriesIssued{ 0 }, queryNext(0), windowNs(0), windowFrames(0),
+	                               cellNs{ { { 0 } } }, cellFrames{ { { 0 } } }, cellSamples{ { { 0 } } }, sweepState(SAMPLING_SWEEP_OFF), sweepFrame(0),
+	                               sweepFilter(SAMPLING_BILINEAR), sweepPattern(PATTERN_COHERENT), sweepResults{ 0 }
+{
+
+}
+TextureSampler::~TextureSampler()
+{
+
+}
+int TextureSampler::init(const oglFunctionsList* pFunctions, ShaderBuilder* pBuilder, const char* version,
+	GLuint mainTexture, GLsizei viewWidth, GLsizei viewHeight)
+{
+	f = pFunctions;
+	texture = mainTexture;
+	width = viewWidth;
+	height = viewHeight;
+
+	char defines[APPCONST::MAX_TEXT_STRING];
+	int k = snprintf(defines, APPCONST::MAX_TEXT_STRING, "#define SAMPLING_TAPS %d\r\n#define SAMPLING_STRIDE %d\r\n"
+		"#define SAMPLING_LAYERS %d\r\n", APPCONST::SAMPLING_TAPS, APPCONST::SAMPLING_STRIDE, APPCONST::SAMPLING_LAYERS);
+	int status = pBuilder->build(version, defines, vertexSource, fragmentSource, programs[0]);
+	if (status) return status;
+	snprintf(defines + k, APPCONST::MAX_TEXT_STRING - k, "%s", arrayDefines);
+	status = pBuilder->build(version, defines, vertexSource, fragmentSource, programs[1]);
+	if (status) return status;
+	for (int i = 0; i < 2; i++)
+	{
+		f->glUseProgram(programs[i]);
+		f->glUniform1i(f->glGetUniformLocation(programs[i], "texture1"), 0);
+		patternLocations[i] = f->glGetUniformLocation(programs[i], "pattern");
+		if (glGetError() || (patternLocations[i] < 0)) return 0x170;
+	}
+	f->glUseProgram(programs[0]);
+	f->glUniform2f(f->glGetUniformLocation(programs[0], "texelSize"),
+		1.0f / APPCONST::TEXTURE_WIDTH, 1.0f / APPCONST::TEXTURE_HEIGHT);
+	f->glUniform2f(f->glGetUniformLocation(programs[0], "gradX"), 1.0f / APPCONST::TEXTURE_WIDTH, 0.0f);
+	f->glUniform2f(f->glGetUniformLocation(programs[0], "gradY"), 0.0f, APPCONST::SAMPLING_FOOTPRINT / APPCONST::TEXTURE_HEIGHT);
+	layersLocation = f->glGetUniformLocation(programs[1], "layers");
+	layerSizeLocation = f->glGetUniformLocation(programs[1], "layerSize");
+	frameLocation = f->glGetUniformLocation(programs[1], "frameIndex");
+	gradXLocation = f->glGetUniformLocation(programs[1], "gradX");
+	gradYLocation = f->glGetUniformLocation(programs[1], "gradY");
+	if (glGetError() || (layersLocation < 0) || (layerSizeLocation < 0) || (frameLocation < 0)) return 0x175;
+
+	f->glGenVertexArrays(1, &emptyVao);
+	if (glGetError() || (!emptyVao)) return 0x171;
+	f->glGenSamplers(1, &sampler);
+	if (glGetError() || (!sampler)) return 0x172;
+	f->glSamplerParameteri(sampler, GL_TEXTURE_WRAP_S, GL_REPEAT);
+	f->glSamplerParameteri(sampler, GL_TEXTURE_WRAP_T, GL_REPEAT);
+	f->glSamplerParameteri(sampler, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+	if (glGetError()) return 0x173;
+	f->glGenQueries(APPCONST::SAMPLING_QUERY_FRAMES, queries);
+	if (glGetError() || (!queries[0])) return 0x174;
+	glGetIntegerv(GL_MAX_ARRAY_TEXTURE_LAYERS, &maxLayers);
+	if (glGetError()) return 0x176;
+
+	// Anisotropic filter is extension before OpenGL 4.6, error means not supported.
+	glGetFloatv(GL_MAX_TEXTURE_MAX_ANISOTROPY, &maxAnisotropy);
+	if (glGetError())
+	{
+		maxAnisotropy = 1.0f;
+	}
+	return 0;
+}
+void TextureSampler::release()
+{
+	if (!f) return;
+	destroySet();
+	if (queries[0])  f->glDeleteQueries(APPCONST::SAMPLING_QUERY_FRAMES, queries);
+	if (sampler)     f->glDeleteSamplers(1, &sampler);
+	if (emptyVao)    f->glDeleteVertexArrays(1, &emptyVao);
+	for (int i = 0; i < 2; i++)
+	{
+		if (programs[i]) f->glDeleteProgram(programs[i]);
+		programs[i] = 0;
+	}
+	queries[0] = 0;
+	sampler = 0;
+	emptyVao = 0;
+}
+// User selected mode, applied if working sets sweep not running.
+void TextureSampler::select(samplingFilter filter, samplingPattern pattern, int set)
+{
+	filterSelected = filter;
+	patternSelected = pattern;
+	setSelected = set;
+	if (sweepState == SAMPLING_SWEEP_RUNNING) return;
+	apply(filter, pattern, set);
+}
+BOOL TextureSampler::getActive()
+{
+	return (filterNow != SAMPLING_OFF);
+}
+// Caller restores program and vertex array, depth test and blending left disabled.
+void TextureSampler::draw()
+{
+	if ((filterNow == SAMPLING_OFF) || (!getSupported())) return;
+	int slot = queryNext;
+	readQueries(slot);
+	int programIndex = setNow ? 1 : 0;
+	glDisable(GL_DEPTH_TEST);
+	glEnable(GL_BLEND);
+	glBlendFunc(GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA);
+	f->glUseProgram(programs[programIndex]);
+	f->glBindVertexArray(emptyVao);
+	if (programIndex)
+	{
+		glBindTexture(GL_TEXTURE_2D_ARRAY, arrayTexture);
+		f->glUniform1i(frameLocation, frameIndex++);
+	}
+	else
+	{
+		glBindTexture(GL_TEXTURE_2D, texture);
+	}
+	f->glBindSampler(0, sampler);
+	f->glBeginQuery(GL_TIME_ELAPSED, queries[slot]);
+	f->glDrawArraysInstanced(GL_TRIANGLES, 0, 3, APPCONST::SAMPLING_LAYERS);
+	f->glEndQuery(GL_TIME_ELAPSED);
+	f->glBindSampler(0, 0);
+	if (programIndex)
+	{
+		glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	}
+	glDisable(GL_BLEND);
+	queriesIssued[slot] = TRUE;
+	queryNext = (slot + 1) % APPCONST::SAMPLING_QUERY_FRAMES;
+
+	if (sweepState != SAMPLING_SWEEP_RUNNING) return;
+	sweepFrame++;
+	if (sweepFrame == APPCONST::SAMPLING_WARMUP_FRAMES)
+	{
+		memset(queriesIssued, 0, sizeof(queriesIssued));
+		windowNs = 0;
+		windowFrames = 0;
+	}
+	else if (sweepFrame >= (APPCONST::SAMPLING_WARMUP_FRAMES + APPCONST::SAMPLING_MEASURE_FRAMES))
+	{
+		samplingSetResult& r = sweepResults[setNow];
+		r.supported = TRUE;
+		r.milliseconds = windowFrames ? (windowNs / 1.0E6 / windowFrames) : 0.0;
+		r.samplesPerSecond = windowNs ? (samplesPerFrame() * windowFrames / (windowNs / 1.0E9)) : 0.0;
+		nextSet();
+	}
+}
+// Sweep of generated working sets at selected filter and pattern, bilinear if sampling off.
+void TextureSampler::startSweep()
+{
+	memset(sweepResults, 0, sizeof(sweepResults));
+	sweepState = SAMPLING_SWEEP_RUNNING;
+	sweepFilter = (filterSelected == SAMPLING_OFF) ? SAMPLING_BILINEAR : filterSelected;
+	sweepPattern = patternSelected;
+	apply(sweepFilter, sweepPattern, 0);
+	nextSet();
+}
+void TextureSampler::stopSweep()
+{
+	sweepState = SAMPLING_SWEEP_OFF;
+	apply(filterSelected, patternSelected, setSelected);
+}
+samplingSweepState TextureSampler::getSweepState()
+{
+	return sweepState;
+}
+// Row shows averages for display update interval, window restarts after read.
+void TextureSampler::writeRow(char* row, int size)
+{
+	char szResults[APPCONST::MAX_TEXT_STRING];
+	const samplingFilterInfo& info = filters[filterNow];
+	if (sweepState == SAMPLING_SWEEP_RUNNING)
+	{
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "Tex sweep(J) %d/%d %s %s %s", setNow, APPCONST::SAMPLING_SETS_COUNT - 1,
+			setNames[setNow], info.name, patternNames[patternNow]);
+	}
+	else if (sweepState == SAMPLING_SWEEP_DONE)
+	{
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "Tex sweep(J) done, %s %s saved (J=close)",
+			filters[sweepFilter].name, patternNames[sweepPattern]);
+	}
+	else if (!getSupported())
+	{
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "Tex(L,P,G) %s %s %s not supported, max aniso %.0f",
+			info.name, patternNames[patternNow], setNames[setNow], maxAnisotropy);
+	}
+	else
+	{
+		double seconds = windowNs / 1.0E9;
+		double samplesPerSecond = (seconds > 0.0) ? (samplesPerFrame() * windowFrames / seconds) : 0.0;
+		snprintf(szResults, APPCONST::MAX_TEXT_STRING, "Tex(L,P,G) %-6s %-8s %-5s ms %-6.3f Gsmp/s %-6.2f Gtex/s %-6.1f",
+			info.name, patternNames[patternNow], setNames[setNow], windowFrames ? (windowNs / 1.0E6 / windowFrames) : 0.0,
+			samplesPerSecond / 1.0E9, samplesPerSecond * info.texelsPerSample / 1.0E9);
+		windowNs = 0;
+		windowFrames = 0;
+	}
+	snprintf(row, size, "%-*s", size - 1, szResults);
+}
+BOOL TextureSampler::saveReport(const char* fileName)
+{
+	report.clear();
+	report.add("Texture sampling %dx%d, %d layers, %d samples per fragment, footprint 1x%.0f texels\r\n",
+		width, height, APPCONST::SAMPLING_LAYERS, APPCONST::SAMPLING_TAPS, APPCONST::SAMPLING_FOOTPRINT);
+	report.add("Gtexels/s is nominal: samples/s multiplied by fixed texels per sample of filter, not measured\r\n");
+	report.add("working set,filter,pattern,texels per sample,frames,GPU ms,Gsamples/s,Gtexels/s\r\n");
+	BOOL measured = FALSE;
+	for (int s = 0; s < APPCONST::SAMPLING_SETS_COUNT; s++)
+	{
+		for (int i = SAMPLING_BILINEAR; i < SAMPLING_FILTERS_COUNT; i++)
+		{
+			for (int j = 0; j < PATTERNS_COUNT; j++)
+			{
+				DWORD64 frames = cellFrames[s][i][j];
+				if ((!frames) || (!cellNs[s][i][j])) continue;
+				double seconds = cellNs[s][i][j] / 1.0E9;
+				double samples = cellSamples[s][i][j];
+				report.add("%s,%s,%s,%d,%I64u,%.3f,%.3f,%.2f\r\n", setNames[s], filters[i].name, patternNames[j],
+					filters[i].texelsPerSample, frames, cellNs[s][i][j] / 1.0E6 / frames, samples / seconds / 1.0E9,
+					samples * filters[i].texelsPerSample / seconds / 1.0E9);
+				measured = TRUE;
+			}
+		}
+	}
+	if (!measured) return FALSE;
+	return report.save(fileName);
+}
+BOOL TextureSampler::saveSweepReport(const char* fileName)
+{
+	if (sweepState != SAMPLING_SWEEP_DONE) return FALSE;
+	report.clear();
+	report.add("Texture working sets sweep %dx%d, filter %s, pattern %s, sizes are base level bytes\r\n",
+		width, height, filters[sweepFilter].name, patternNames[sweepPattern]);
+	report.add("Gtexels/s is nominal: samples/s multiplied by fixed texels per sample of filter, not measured\r\n");
+	report.add("working set MB,GPU ms,Gsamples/s,Gtexels/s\r\n");
+	for (int s = 1; s < APPCONST::SAMPLING_SETS_COUNT; s++)
+	{
+		const samplingSetResult& r = sweepResults[s];
+		if (!r.supported)
+		{
+			report.add("%d,,,not supported\r\n", APPCONST::SAMPLING_SET_MEGABYTES[s]);
+			continue;
+		}
+		report.add("%d,%.3f,%.3f,%.2f\r\n", APPCONST::SAMPLING_SET_MEGABYTES[s], r.milliseconds, r.samplesPerSecond / 1.0E9,
+			r.samplesPerSecond * filters[sweepFilter].texelsPerSample / 1.0E9);
+	}
+	return report.save(fileName);
+}
+// Window resized, samples per frame changed, queries issued for old size discarded.
+void TextureSampler::resize(GLsizei viewWidth, GLsizei viewHeight)
+{
+	width = viewWidth;
+	height = viewHeight;
+	memset(queriesIssued, 0, sizeof(queriesIssued));
+	windowNs = 0;
+	windowFrames = 0;
+}
+// Sampler state, program uniforms and working set updated at change only, queries of previous mode discarded.
+// Generated working set allocated while sampling active only, gigabytes textures not kept.
+void TextureSampler::apply(samplingFilter filter, samplingPattern pattern, int set)
+{
+	if ((filter == filterNow) && (pattern == patternNow) && (set == setNow)) return;
+	filterNow = filter;
+	patternNow = pattern;
+	setNow = set;
+	memset(queriesIssued, 0, sizeof(queriesIssued));
+	windowNs = 0;
+	windowFrames = 0;
+	int allocate = (filter != SAMPLING_OFF) ? set : 0;
+	if (allocate != setAllocated)
+	{
+		setSupported = createSet(allocate);
+	}
+	if ((filter == SAMPLING_OFF) || (!getSupported())) return;
+	f->glSamplerParameteri(sampler, GL_TEXTURE_MIN_FILTER, filters[filter].minFilter);
+	if (maxAnisotropy > 1.0f)
+	{
+		f->glSamplerParameterf(sampler, GL_TEXTURE_MAX_ANISOTROPY, filters[filter].anisotropy);
+	}
+	int programIndex = set ? 1 : 0;
+	f->glUseProgram(programs[programIndex]);
+	f->glUniform1i(patternLocations[programIndex], pattern);
+}
+// Texture array of square power of two layers, one noise layer uploaded to all layers.
+// Allocation error means working set above memory available for textures.
+BOOL TextureSampler::createSet(int set)
+{
+	destroySet();
+	setAllocated = set;
+	if (!set) return TRUE;
+	// Sizes in DWORD64, gigabytes working set wraps size_t at 32-bit build.
+	DWORD64 bytes = static_cast<DWORD64>(APPCONST::SAMPLING_SET_MEGABYTES[set]) * 1048576;
+	if (bytes > static_cast<DWORD64>(SIZE_MAX)) return FALSE;
+	DWORD64 texels = bytes / 4;
+	GLsizei size = APPCONST::SAMPLING_LAYER_SIZE;
+	while (size && ((static_cast<DWORD64>(size) * size) > texels)) size >>= 1;
+	DWORD64 layerTexels = static_cast<DWORD64>(size) * size;
+	if (!layerTexels) return FALSE;
+	DWORD64 layersCount = texels / layerTexels;
+	if (layersCount > static_cast<DWORD64>(maxLayers)) return FALSE;
+	GLsizei layers = static_cast<GLsizei>(layersCount);
+
+	glGenTextures(1, &arrayTexture);
+	if (glGetError() || (!arrayTexture)) return FALSE;
+	glBindTexture(GL_TEXTURE_2D_ARRAY, arrayTexture);
+	GLint level = 0;
+	for (GLsizei levelSize = size; levelSize; levelSize >>= 1)
+	{
+		f->glTexImage3D(GL_TEXTURE_2D_ARRAY, level++, GL_RGBA8, levelSize, levelSize, layers, 0, GL_BGRA, GL_UNSIGNED_BYTE, nullptr);
+	}
+	BOOL status = (glGetError() == GL_NO_ERROR);
+	if (status)
+	{
+		DWORD32* noise = new DWORD32[static_cast<size_t>(layerTexels)];
+		DWORD32 x = 0x9E3779B9;
+		for (DWORD64 i = 0; i < layerTexels; i++)
+		{
+			x ^= x << 13;
+			x ^= x >> 17;
+			x ^= x << 5;
+			noise[i] = x;
+		}
+		for (GLsizei layer = 0; (layer < layers) && status; layer++)
+		{
+			f->glTexSubImage3D(GL_TEXTURE_2D_ARRAY, 0, 0, 0, layer, size, size, 1, GL_BGRA, GL_UNSIGNED_BYTE, noise);
+			status = (glGetError() == GL_NO_ERROR);
+		}
+		delete[] noise;
+	}
+	if (status)
+	{
+		f->glGenerateMipmap(GL_TEXTURE_2D_ARRAY);
+		status = (glGetError() == GL_NO_ERROR);
+	}
+	glBindTexture(GL_TEXTURE_2D_ARRAY, 0);
+	if (!status)
+	{
+		destroySet();
+		setAllocated = set;
+		return FALSE;
+	}
+	f->glUseProgram(programs[1]);
+	f->glUniform1i(layersLocation, layers);
+	f->glUniform1i(layerSizeLocation, size);
+	f->glUniform2f(gradXLocation, 1.0f / size, 0.0f);
+	f->glUniform2f(gradYLocation, 0.0f, APPCONST::SAMPLING_FOOTPRINT / size);
+	return TRUE;
+}
+void TextureSampler::destroySet()
+{
+	if (arrayTexture) glDeleteTextures(1, &arrayTexture);
+	arrayTexture = 0;
+	setAllocated = 0;
+}
+BOOL TextureSampler::getSupported()
+{
+	return setSupported && (filters[filterNow].anisotropy <= maxAnisotropy);
+}
+// Query of frame slot read before slot reuse, result not ready yet is skipped.
+void TextureSampler::readQueries(int slot)
+{
+	if (!queriesIssued[slot]) return;
+	queriesIssued[slot] = FALSE;
+	GLuint available = 0;
+	f->glGetQueryObjectuiv(queries[slot], GL_QUERY_RESULT_AVAILABLE, &available);
+	if (!available) return;
+	DWORD64 value = 0;
+	f->glGetQueryObjectui64v(queries[slot], GL_QUERY_RESULT, &value);
+	windowNs += value;
+	windowFrames++;
+	cellNs[setNow][filterNow][patternNow] += value;
+	cellFrames[setNow][filterNow][patternNow]++;
+	cellSamples[setNow][filterNow][patternNow] += samplesPerFrame();
+}
+// Not supported working sets skipped, user selected mode restored after last working set.
+void TextureSampler::nextSet()
+{
+	int set = setNow;
+	while (++set < APPCONST::SAMPLING_SETS_COUNT)
+	{
+		apply(sweepFilter, sweepPattern, set);
+		if (getSupported())
+		{
+			sweepFrame = 0;
+			return;
+		}
+		sweepResults[set].supported = FALSE;
+	}
+	sweepState = SAMPLING_SWEEP_DONE;
+	apply(filterSelected, patternSelected, setSelected);
+}
+double TextureSampler::samplesPerFrame()
+{
+	return static_cast<double>(width) * height * APPCONST::SAMPLING_LAYERS * APPCONST::SAMPLING_TAPS;
+}
+
+const samplingFilterInfo TextureSampler::filters[]
+{
+	{ GL_LINEAR,               1.0f,  0,   "Off"    },
+	{ GL_LINEAR,               1.0f,  4,   "Bilin"  },
+	{ GL_LINEAR_MIPMAP_LINEAR, 1.0f,  8,   "Trilin" },
+	{ GL_LINEAR_MIPMAP_LINEAR, 2.0f,  16,  "Af2"    },
+	{ GL_LINEAR_MIPMAP_LINEAR, 4.0f,  32,  "Af4"    },
+	{ GL_LINEAR_MIPMAP_LINEAR, 8.0f,  64,  "Af8"    },
+	{ GL_LINEAR_MIPMAP_LINEAR, 16.0f, 128, "Af16"   }
+};
+
+const char* TextureSampler::patternNames[] = { "Coherent", "Strided", "Random" };
+
+const char* TextureSampler::setNames[] = { "Atlas", "4M", "16M", "64M", "256M", "1G", "4G" };
+
+// Variant for generated texture array working set.
+const char* TextureSampler::arrayDefines =
+"#define SAMPLING_ARRAY\r\n";
+
+// Full screen triangle from vertex ID, no vertex buffer, layer is instance ID.
+const char* TextureSampler::vertexSource =
+"flat out int layerId;\r\n"
+"void main()\r\n"
+"{\r\n"
+"   vec2 v = vec2((gl_VertexID << 1) & 2, gl_VertexID & 2);\r\n"
+"   gl_Position = vec4(v * 2.0f - 1.0f, 0.0f, 1.0f);\r\n"
+"   layerId = gl_InstanceID;\r\n"
+"}\r\n\0";
+
+// Texture coordinates of sample by pattern, explicit gradients select mip levels and anisotropy.
+// Array variant: texel index in working set, texels count is power of two, index wraps at
+// working set end, coherent pattern streams through working set over frames.
+const char* TextureSampler::fragmentSource =
+"out vec4 FragColor;\r\n"
+"flat in int layerId;\r\n"
+"#ifdef SAMPLING_ARRAY\r\n"
+"uniform sampler2DArray texture1;\r\n"
+"uniform int layers;\r\n"
+"uniform int layerSize;\r\n"
+"uniform int frameIndex;\r\n"
+"#else\r\n"
+"uniform sampler2D texture1;\r\n"
+"uniform vec2 texelSize;\r\n"
+"#endif\r\n"
+"uniform int pattern;\r\n"
+"uniform vec2 gradX;\r\n"
+"uniform vec2 gradY;\r\n"
+"uint hash(uint x)\r\n"
+"{\r\n"
+"   x ^= x >> 16u;\r\n"
+"   x *= 0x7FEB352Du;\r\n"
+"   x ^= x >> 15u;\r\n"
+"   x *= 0x846CA68Bu;\r\n"
+"   x ^= x >> 16u;\r\n"
+"   return x;\r\n"
+"}\r\n"
+"void main()\r\n"
+"{\r\n"
+"   vec2 p = floor(gl_FragCoord.xy);\r\n"
+"   vec4 sum = vec4(0.0f);\r\n"
+"   for (int i = 0; i < SAMPLING_TAPS; i++)\r\n"
+"   {\r\n"
+"      int k = layerId * SAMPLING_TAPS + i;\r\n"
+"#ifdef SAMPLING_ARRAY\r\n"
+"      uint size = uint(layerSize);\r\n"
+"      uint layerTexels = size * size;\r\n"
+"      uint pixel = (uint(p.y) << 12u) + uint(p.x);\r\n"
+"      uint offset = uint(frameIndex * SAMPLING_LAYERS * SAMPLING_TAPS + k) << 23u;\r\n"
+"      uint index;\r\n"
+"      if (pattern == 0)\r\n"
+"      {\r\n"
+"         index = pixel + offset;\r\n"
+"      }\r\n"
+"      else if (pattern == 1)\r\n"
+"      {\r\n"
+"         index = (pixel + offset) * uint(SAMPLING_STRIDE);\r\n"
+"      }\r\n"
+"      else\r\n"
+"      {\r\n"
+"         index = hash(pixel + offset);\r\n"
+"      }\r\n"
+"      index &= layerTexels * uint(layers) - 1u;\r\n"
+"      uint t = index % layerTexels;\r\n"
+"      vec2 uv = (vec2(t % size, t / size) + 0.5f) / float(layerSize);\r\n"
+"      sum += textureGrad(texture1, vec3(uv, float(index / layerTexels)), gradX, gradY);\r\n"
+"#else\r\n"
+"      vec2 uv;\r\n"
+"      if (pattern == 0)\r\n"
+"      {\r\n"
+"         uv = (p + vec2(k & 3, k >> 2)) * texelSize;\r\n"
+"      }\r\n"
+"      else if (pattern == 1)\r\n"
+"      {\r\n"
+"         uv = (p * float(SAMPLING_STRIDE) + vec2(k * 7, k * 13)) * texelSize;\r\n"
+"      }\r\n"
+"      else\r\n"
+"      {\r\n"
+"         uint h = hash(uint(p.x) + (uint(p.y) << 12u) + (uint(k) << 24u));\r\n"
+"         uv = vec2(h & 0xFFFFu, h >> 16u) / 65536.0f;\r\n"
+"      }\r\n"
+"      sum += textureGrad(texture1, uv, gradX, gradY);\r\n"
+"#endif\r\n"
+"   }\r\n"
+"   FragColor = vec4(sum.rgb / float(SAMPLING_TAPS), 0.05f);\r\n"
+"}\r\n\0";
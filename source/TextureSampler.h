@@ -0,0 +1,137 @@
+/*
+OpenGL GPUstress.
+Texture sampling stress class header.
+Full screen layers over scene, each fragment takes samples of main texture
+or of generated texture array working set, with selected filter and
+texture coordinates pattern, GPU time measured by queries.
+Working sets sweep measures sampling rate from few megabytes to gigabytes.
+*/
+
+#pragma once
+#ifndef TEXTURESAMPLER_H
+#define TEXTURESAMPLER_H
+
+#include <windows.h>
+#include <iostream>
+#include "Global.h"
+#include "OpenGLImport.h"
+#include "ShaderBuilder.h"
+#include "Report.h"
+
+enum samplingFilter
+{
+    SAMPLING_OFF = 0,
+    SAMPLING_BILINEAR,      // Base level only, 4 texels per sample.
+    SAMPLING_TRILINEAR,     // Two mip levels, 8 texels per sample.
+    SAMPLING_ANISO_2,       // Anisotropic, up to N trilinear probes per sample.
+    SAMPLING_ANISO_4,
+    SAMPLING_ANISO_8,
+    SAMPLING_ANISO_16,
+    SAMPLING_FILTERS_COUNT
+};
+
+enum samplingPattern
+{
+    PATTERN_COHERENT = 0,   // Neighbour fragments sample neighbour texels.
+    PATTERN_STRIDED,        // Neighbour fragments step over texel rows and cache lines.
+    PATTERN_RANDOM,         // Hash of fragment position and sample index.
+    PATTERNS_COUNT
+};
+
+enum samplingSweepState
+{
+    SAMPLING_SWEEP_OFF = 0,
+    SAMPLING_SWEEP_RUNNING,
+    SAMPLING_SWEEP_DONE
+};
+
+struct samplingFilterInfo
+{
+    GLint minFilter;
+    GLfloat anisotropy;
+    int texelsPerSample;
+    const char* name;
+};
+
+// Working set sweep step result.
+struct samplingSetResult
+{
+    BOOL supported;
+    double milliseconds;
+    double samplesPerSecond;
+};
+
+class TextureSampler
+{
+public:
+    TextureSampler();
+    ~TextureSampler();
+    int init(const oglFunctionsList* pFunctions, ShaderBuilder* pBuilder, const char* version,
+        GLuint mainTexture, GLsizei viewWidth, GLsizei viewHeight);
+    void release();
+    void resize(GLsizei viewWidth, GLsizei viewHeight);
+    void select(samplingFilter filter, samplingPattern pattern, int set);
+    BOOL getActive();
+    void draw();
+    void startSweep();
+    void stopSweep();
+    samplingSweepState getSweepState();
+    void writeRow(char* row, int size);
+    BOOL saveReport(const char* fileName);
+    BOOL saveSweepReport(const char* fileName);
+private:
+    void apply(samplingFilter filter, samplingPattern pattern, int set);
+    BOOL createSet(int set);
+    void destroySet();
+    BOOL getSupported();
+    void readQueries(int slot);
+    void nextSet();
+    double samplesPerFrame();
+    const oglFunctionsList* f;
+    GLuint programs[2];             // Main texture, texture array.
+    GLint patternLocations[2];
+    GLint layersLocation;
+    GLint layerSizeLocation;
+    GLint frameLocation;
+    GLint gradXLocation;
+    GLint gradYLocation;
+    GLuint sampler;
+    GLuint emptyVao;
+    GLuint texture;
+    GLuint arrayTexture;
+    GLsizei width;
+    GLsizei height;
+    GLfloat maxAnisotropy;
+    GLint maxLayers;
+    samplingFilter filterNow;
+    samplingPattern patternNow;
+    int setNow;
+    int setAllocated;
+    BOOL setSupported;
+    samplingFilter filterSelected;
+    samplingPattern patternSelected;
+    int setSelected;
+    int frameIndex;
+    GLuint queries[APPCONST::SAMPLING_QUERY_FRAMES];
+    BOOL queriesIssued[APPCONST::SAMPLING_QUERY_FRAMES];
+    int queryNext;
+    DWORD64 windowNs;
+    DWORD64 windowFrames;
+    DWORD64 cellNs[APPCONST::SAMPLING_SETS_COUNT][SAMPLING_FILTERS_COUNT][PATTERNS_COUNT];
+    DWORD64 cellFrames[APPCONST::SAMPLING_SETS_COUNT][SAMPLING_FILTERS_COUNT][PATTERNS_COUNT];
+    double cellSamples[APPCONST::SAMPLING_SETS_COUNT][SAMPLING_FILTERS_COUNT][PATTERNS_COUNT];   // Frames may differ by window size.
+    samplingSweepState sweepState;
+    int sweepFrame;
+    samplingFilter sweepFilter;
+    samplingPattern sweepPattern;
+    samplingSetResult sweepResults[APPCONST::SAMPLING_SETS_COUNT];
+    Report report;
+    static const samplingFilterInfo filters[];
+    static const char* patternNames[];
+    static const char* setNames[];
+    static const char* arrayDefines;
+    static const char* vertexSource;
+    static const char* fragmentSource;
+};
+
+#endif // TEXTURESAMPLER_H
@@ -0,0 +1,1077 @@
+/*
+OpenGL GPUstress.
+Vulkan backend class.
+Same scene as OpenGL path: instanced textured cubes with per-instance scale
+stream and text overlay quads, rendered to offscreen color and depth target.
+Each frame: wait fences of frame slot, SSE fill of instance stream into mapped
+memory of slot, record render pass between timestamps, submit.
+Coherent ring: slot of host visible coherent ring bound as instance vertex
+buffer, vertex fetch reads host memory.
+Staging transfer: slot of staging buffer copied to slot of device local buffer
+by dedicated transfer queue (DMA engine) if device has it, graphics submit
+waits copy by semaphore. Copy has own timestamps pair.
+Timestamps pools reset by graphics queue before load measure, because
+transfer-only queue can't reset queries. Queue without timestamps support
+records no timestamps, GPU time column of it is n/a.
+Shaders are SPIR-V binaries at end of file, GLSL equivalent in comments.
+*/
+
+#include "VulkanBackend.h"
+
+VulkanBackend::VulkanBackend() : hLibrary(NULL), vkGetInstanceProcAddr(nullptr), v{ 0 }, instance(nullptr), physicalDevice(nullptr),
+	                             device(nullptr), properties{ 0 }, memoryProperties{ 0 }, graphics{ 0 }, transfer{ 0 }, slotBytes(0),
+	                             ringBuffer(0), ringMemory(0), ringMapped(nullptr), stagingBuffer(0), stagingMemory(0), stagingMapped(nullptr),
+	                             deviceBuffer(0), deviceMemory(0), copyDone{ 0 }, cubeBuffer(0), cubeMemory(0), textSlotBytes(0),
+	                             textBuffer(0), textMemory(0), textMapped(nullptr), texture(0), textureMemory(0), textureView(0), sampler(0),
+	                             colorImage(0), colorMemory(0), colorView(0), depthImage(0), depthMemory(0), depthView(0),
+	                             renderPass(0), framebuffer(0), setLayout(0), descriptorPool(0), descriptorSet(0), pipelineLayout(0),
+	                             cubesPipeline(0), textPipeline(0), constants{ 0 }, textChars{ 0 }, tscPeriod(0.0)
+{
+
+}
+VulkanBackend::~VulkanBackend()
+{
+	release();
+}
+int VulkanBackend::init(double period, const void* rawData, const float* cubeVertices)
+{
+	tscPeriod = period;
+	hLibrary = LoadLibrary(APPCONST::VULKAN_LIBRARY_NAME);
+	if (!hLibrary) return 0x200;
+	vkGetInstanceProcAddr = reinterpret_cast<PFN_vkVoidFunction(__stdcall*)(VkInstance, const char*)>
+		(GetProcAddress(hLibrary, "vkGetInstanceProcAddr"));
+	if (!vkGetInstanceProcAddr) return 0x201;
+	VkResult(__stdcall *vkCreateInstance)(const VkInstanceCreateInfo*, const void*, VkInstance*) =
+		reinterpret_cast<VkResult(__stdcall*)(const VkInstanceCreateInfo*, const void*, VkInstance*)>
+		(vkGetInstanceProcAddr(nullptr, "vkCreateInstance"));
+	if (!vkCreateInstance) return 0x201;
+
+	VkApplicationInfo app = { VK_STRUCTURE_TYPE_APPLICATION_INFO, nullptr, APPCONST::APP_NAME, 1, APPCONST::APP_NAME, 1, VK_API_VERSION_1_0 };
+	VkInstanceCreateInfo ici = { VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO, nullptr, 0, &app, 0, nullptr, 0, nullptr };
+	if ((vkCreateInstance(&ici, nullptr, &instance) != VK_SUCCESS) || (!instance)) return 0x202;
+
+	const char** pName = vkNamesList;
+	size_t* pFunc = reinterpret_cast<size_t*>(&v);
+	while (*pName)
+	{
+		PFN_vkVoidFunction pFn = vkGetInstanceProcAddr(instance, *(pName++));
+		if (!pFn) return 0x203;
+		*(pFunc++) = reinterpret_cast<size_t>(pFn);
+	}
+
+	// Discrete GPU preferred, first device otherwise.
+	VkPhysicalDevice devices[16];
+	DWORD32 count = 16;
+	VkResult result = v.vkEnumeratePhysicalDevices(instance, &count, devices);
+	if (((result != VK_SUCCESS) && (result != 5)) || (!count)) return 0x204;   // 5 = VK_INCOMPLETE.
+	physicalDevice = devices[0];
+	for (DWORD32 i = 0; i < count; i++)
+	{
+		v.vkGetPhysicalDeviceProperties(devices[i], &properties);
+		if (properties.deviceType == VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU)
+		{
+			physicalDevice = devices[i];
+			break;
+		}
+	}
+	v.vkGetPhysicalDeviceProperties(physicalDevice, &properties);
+	v.vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+
+	// Transfer-only family is DMA engine, graphics family used for transfer if not found.
+	VkQueueFamilyProperties families[16];
+	count = 16;
+	v.vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &count, families);
+	graphics.family = 0xFFFFFFFF;
+	transfer.family = 0xFFFFFFFF;
+	for (DWORD32 i = 0; i < count; i++)
+	{
+		VkFlags flags = families[i].queueFlags;
+		if ((flags & VK_QUEUE_GRAPHICS_BIT) && (graphics.family == 0xFFFFFFFF))
+		{
+			graphics.family = i;
+			graphics.timestampBits = families[i].timestampValidBits;
+		}
+		if ((flags & VK_QUEUE_TRANSFER_BIT) && (!(flags & (VK_QUEUE_GRAPHICS_BIT | VK_QUEUE_COMPUTE_BIT))) &&
+			(transfer.family == 0xFFFFFFFF))
+		{
+			transfer.family = i;
+			transfer.timestampBits = families[i].timestampValidBits;
+		}
+	}
+	if (graphics.family == 0xFFFFFFFF) return 0x205;
+	if (transfer.family == 0xFFFFFFFF)
+	{
+		transfer.family = graphics.family;
+		transfer.timestampBits = graphics.timestampBits;
+	}
+
+	const float priority = 1.0f;
+	VkDeviceQueueCreateInfo qci[2] =
+	{
+		{ VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO, nullptr, 0, graphics.family, 1, &priority },
+		{ VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO, nullptr, 0, transfer.family, 1, &priority }
+	};
+	DWORD32 qciCount = (transfer.family != graphics.family) ? 2 : 1;
+	VkDeviceCreateInfo dci = { VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO, nullptr, 0, qciCount, qci, 0, nullptr, 0, nullptr, nullptr };
+	if ((v.vkCreateDevice(physicalDevice, &dci, nullptr, &device) != VK_SUCCESS) || (!device)) return 0x206;
+	v.vkGetDeviceQueue(device, graphics.family, 0, &graphics.queue);
+	v.vkGetDeviceQueue(device, transfer.family, 0, &transfer.queue);
+	int status = createQueue(graphics);
+	if (status) return status;
+	status = createQueue(transfer);
+	if (status) return status;
+
+	// Slot per frame in flight at ring, staging and device local buffers, sized for maximum load.
+	// Device local buffer written by transfer queue and read by graphics queue, shared by both families.
+	slotBytes = (static_cast<VkDeviceSize>(APPCONST::MAXIMUM_INSTANCING_COUNT) * sizeof(float) + 255) & (~255ULL);
+	constexpr VkFlags HOST = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+	status = createBuffer(slotBytes * APPCONST::VULKAN_FRAMES_IN_FLIGHT, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+		HOST, FALSE, ringBuffer, ringMemory, reinterpret_cast<void**>(&ringMapped));
+	if (status) return status;
+	status = createBuffer(slotBytes * APPCONST::VULKAN_FRAMES_IN_FLIGHT, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+		HOST, FALSE, stagingBuffer, stagingMemory, reinterpret_cast<void**>(&stagingMapped));
+	if (status) return status;
+	status = createBuffer(slotBytes * APPCONST::VULKAN_FRAMES_IN_FLIGHT, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+		VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, transfer.family != graphics.family, deviceBuffer, deviceMemory, nullptr);
+	if (status) return status;
+	VkSemaphoreCreateInfo sci = { VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO, nullptr, 0 };
+	for (int i = 0; i < APPCONST::VULKAN_FRAMES_IN_FLIGHT; i++)
+	{
+		if (v.vkCreateSemaphore(device, &sci, nullptr, &copyDone[i]) != VK_SUCCESS) return 0x210;
+	}
+
+	// Cube model vertices, text quads use first face positions.
+	BYTE* pCube = nullptr;
+	status = createBuffer(APPCONST::CUBE_VERTICES * APPCONST::CUBE_STRIDE, VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+		HOST, FALSE, cubeBuffer, cubeMemory, reinterpret_cast<void**>(&pCube));
+	if (status) return status;
+	memcpy(pCube, cubeVertices, APPCONST::CUBE_VERTICES * APPCONST::CUBE_STRIDE);
+	v.vkUnmapMemory(device, cubeMemory);
+
+	// Text chars slot per frame in flight, selected by dynamic offset.
+	VkDeviceSize alignment = properties.limits.minUniformBufferOffsetAlignment;
+	if (alignment < 16) alignment = 16;
+	textSlotBytes = (APPCONST::TEXT_CHARS + alignment - 1) / alignment * alignment;
+	status = createBuffer(textSlotBytes * APPCONST::VULKAN_FRAMES_IN_FLIGHT, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
+		HOST, FALSE, textBuffer, textMemory, reinterpret_cast<void**>(&textMapped));
+	if (status) return status;
+
+	status = uploadTexture(rawData);
+	if (status) return status;
+	status = createRenderTarget();
+	if (status) return status;
+	status = createDescriptors();
+	if (status) return status;
+	return createPipelines();
+}
+// All loads for all upload modes, results saved as text report.
+int VulkanBackend::run(const char* fileName)
+{
+	report.clear();
+	report.add("Vulkan device: %s, API %u.%u.%u, timestamp period %.3f ns, target %dx%d\r\n", properties.deviceName,
+		properties.apiVersion >> 22, (properties.apiVersion >> 12) & 0x3FF, properties.apiVersion & 0xFFF,
+		properties.limits.timestampPeriod, APPCONST::VULKAN_TARGET_WIDTH, APPCONST::VULKAN_TARGET_HEIGHT);
+	report.add("upload,queue family,instances,frames,fill us/frame,fill GB/s,submit us/frame,"
+		"fence wait us/frame,GPU copy us/frame,GPU draw us/frame,frame us,FPS,upload MB/s\r\n");
+	for (int mode = 0; mode < UPLOADS_COUNT; mode++)
+	{
+		for (int i = 0; loads[i]; i++)
+		{
+			int status = measure(static_cast<vulkanUpload>(mode), loads[i]);
+			if (status) return status;
+		}
+	}
+	return report.save(fileName) ? 0 : 0x20F;
+}
+// Load includes text chars as OpenGL path load, instance stream holds cubes only.
+int VulkanBackend::measure(vulkanUpload mode, unsigned int load)
+{
+	BOOL staging = (mode == UPLOAD_STAGING_TRANSFER);
+	BYTE* pMapped = staging ? stagingMapped : ringMapped;
+	int status = resetQueries(graphics);
+	if (status) return status;
+	if (staging)
+	{
+		status = resetQueries(transfer);
+		if (status) return status;
+	}
+	const unsigned int cubes = load - APPCONST::TEXT_CHARS;
+	const VkDeviceSize bytes = static_cast<VkDeviceSize>(cubes) * sizeof(float);
+	memset(textChars, 0, sizeof(textChars));
+	snprintf(textChars + 128 * 3 + 1, 127, "Vulkan %s, %s, instances %u", properties.deviceName, szUploadNames[mode], load);
+	constants.texelScale[0] = 1.0f / APPCONST::TEXTURE_WIDTH;
+	constants.texelScale[1] = 1.0f / APPCONST::TEXTURE_HEIGHT;
+	constants.instanceBase = APPCONST::TEXT_CHARS;
+
+	VkClearValue clears[2];
+	clears[0].color[0] = APPCONST::BACKGROUND_R;
+	clears[0].color[1] = APPCONST::BACKGROUND_G;
+	clears[0].color[2] = APPCONST::BACKGROUND_B;
+	clears[0].color[3] = 1.0f;
+	clears[1].depthStencil.depth = 1.0f;
+	clears[1].depthStencil.stencil = 0;
+	VkRenderPassBeginInfo rbi = { VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO, nullptr, renderPass, framebuffer,
+		{ { 0, 0 }, { APPCONST::VULKAN_TARGET_WIDTH, APPCONST::VULKAN_TARGET_HEIGHT } }, 2, clears };
+	VkCommandBufferBeginInfo cbi = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, nullptr, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr };
+	const VkFlags waitStage = VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+
+	DWORD64 fillTicks = 0;
+	DWORD64 submitTicks = 0;
+	DWORD64 waitTicks = 0;
+	DWORD64 startTsc = 0;
+	DWORD64 sceneTsc = __rdtsc();
+	for (int frame = 0; frame < APPCONST::VULKAN_TOTAL_FRAMES; frame++)
+	{
+		BOOL measured = (frame >= APPCONST::VULKAN_WARMUP_FRAMES);
+		int slot = frame % APPCONST::VULKAN_FRAMES_IN_FLIGHT;
+		DWORD64 t0 = __rdtsc();
+		if (frame == APPCONST::VULKAN_WARMUP_FRAMES) startTsc = t0;
+		if (v.vkWaitForFences(device, 1, &graphics.fences[slot], 1, APPCONST::VULKAN_FENCE_TIMEOUT_NS) != VK_SUCCESS) return 0x20E;
+		v.vkResetFences(device, 1, &graphics.fences[slot]);
+		if (staging)
+		{
+			if (v.vkWaitForFences(device, 1, &transfer.fences[slot], 1, APPCONST::VULKAN_FENCE_TIMEOUT_NS) != VK_SUCCESS) return 0x20E;
+			v.vkResetFences(device, 1, &transfer.fences[slot]);
+		}
+		DWORD64 t1 = __rdtsc();
+
+		float scale = static_cast<float>(sin(frame * 0.0075) * 0.6);
+		const size_t vCount = (cubes + 3) / 4;
+		__m128* vPtr = reinterpret_cast<__m128*>(pMapped + slot * slotBytes);
+		__m128 vData = _mm_load_ps1(&scale);
+		for (size_t i = 0; i < vCount; i++)
+		{
+			*(vPtr++) = vData;
+		}
+		memcpy(textMapped + slot * textSlotBytes, textChars, APPCONST::TEXT_CHARS);
+		rotation((t0 - sceneTsc) * tscPeriod, constants.model);
+		DWORD64 t2 = __rdtsc();
+
+		VkBuffer instanceBuffer = ringBuffer;
+		VkSubmitInfo si = { VK_STRUCTURE_TYPE_SUBMIT_INFO, nullptr, 0, nullptr, nullptr, 1, nullptr, 0, nullptr };
+		if (staging)
+		{
+			VkCommandBuffer cb = transfer.commands[slot];
+			v.vkBeginCommandBuffer(cb, &cbi);
+			if (transfer.timestampBits)
+			{
+				v.vkCmdWriteTimestamp(cb, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, transfer.queries, frame * 2);
+			}
+			VkBufferCopy region = { slot * slotBytes, slot * slotBytes, bytes };
+			v.vkCmdCopyBuffer(cb, stagingBuffer, deviceBuffer, 1, &region);
+			if (transfer.timestampBits)
+			{
+				v.vkCmdWriteTimestamp(cb, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, transfer.queries, frame * 2 + 1);
+			}
+			v.vkEndCommandBuffer(cb);
+			si.pCommandBuffers = &cb;
+			si.signalSemaphoreCount = 1;
+			si.pSignalSemaphores = &copyDone[slot];
+			if (v.vkQueueSubmit(transfer.queue, 1, &si, transfer.fences[slot]) != VK_SUCCESS) return 0x20D;
+			instanceBuffer = deviceBuffer;
+			si.signalSemaphoreCount = 0;
+			si.pSignalSemaphores = nullptr;
+			si.waitSemaphoreCount = 1;
+			si.pWaitSemaphores = &copyDone[slot];
+			si.pWaitDstStageMask = &waitStage;
+		}
+
+		VkCommandBuffer cb = graphics.commands[slot];
+		v.vkBeginCommandBuffer(cb, &cbi);
+		if (graphics.timestampBits)
+		{
+			v.vkCmdWriteTimestamp(cb, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, graphics.queries, frame * 2);
+		}
+		v.vkCmdBeginRenderPass(cb, &rbi, VK_SUBPASS_CONTENTS_INLINE);
+		const VkBuffer buffers[2] = { cubeBuffer, instanceBuffer };
+		const VkDeviceSize offsets[2] = { 0, slot * slotBytes };
+		const DWORD32 textOffset = static_cast<DWORD32>(slot * textSlotBytes);
+		v.vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, cubesPipeline);
+		v.vkCmdBindDescriptorSets(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, pipelineLayout, 0, 1, &descriptorSet, 1, &textOffset);
+		v.vkCmdPushConstants(cb, pipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(vulkanPushConstants), &constants);
+		v.vkCmdBindVertexBuffers(cb, 0, 2, buffers, offsets);
+		v.vkCmdDraw(cb, APPCONST::CUBE_VERTICES, cubes, 0, 0);
+		// Text pipeline has same layout, descriptor set, push constants and vertex binding 0 stay bound.
+		v.vkCmdBindPipeline(cb, VK_PIPELINE_BIND_POINT_GRAPHICS, textPipeline);
+		v.vkCmdDraw(cb, APPCONST::TEXT_QUAD_VERTICES, APPCONST::TEXT_CHARS, 0, 0);
+		v.vkCmdEndRenderPass(cb);
+		if (graphics.timestampBits)
+		{
+			v.vkCmdWriteTimestamp(cb, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, graphics.queries, frame * 2 + 1);
+		}
+		v.vkEndCommandBuffer(cb);
+		si.pCommandBuffers = &cb;
+		if (v.vkQueueSubmit(graphics.queue, 1, &si, graphics.fences[slot]) != VK_SUCCESS) return 0x20D;
+		DWORD64 t3 = __rdtsc();
+		if (measured)
+		{
+			waitTicks += t1 - t0;
+			fillTicks += t2 - t1;
+			submitTicks += t3 - t2;
+		}
+	}
+	double seconds = (__rdtsc() - startTsc) * tscPeriod;
+	v.vkDeviceWaitIdle(device);
+	char drawCell[16];
+	char copyCell[16];
+	writeGpuCell(drawCell, sizeof(drawCell), getGpuMicroseconds(graphics));
+	writeGpuCell(copyCell, sizeof(copyCell), staging ? getGpuMicroseconds(transfer) : 0.0);
+
+	constexpr double FRAMES = APPCONST::VULKAN_MEASURE_FRAMES;
+	double usPerTick = tscPeriod * 1.0E6 / FRAMES;
+	double fillSeconds = fillTicks * tscPeriod;
+	report.add("%s,%u,%u,%d,%.1f,%.2f,%.1f,%.1f,%s,%s,%.1f,%.1f,%.1f\r\n", szUploadNames[mode],
+		staging ? transfer.family : graphics.family, load, APPCONST::VULKAN_MEASURE_FRAMES, fillTicks * usPerTick,
+		(fillSeconds > 0.0) ? (bytes * FRAMES / fillSeconds / 1.0E9) : 0.0,
+		submitTicks * usPerTick, waitTicks * usPerTick, copyCell, drawCell, seconds * 1.0E6 / FRAMES,
+		(seconds > 0.0) ? (FRAMES / seconds) : 0.0,
+		(seconds > 0.0) ? (bytes * FRAMES / 1048576.0 / seconds) : 0.0);
+	return 0;
+}
+// Average GPU time between timestamps pair of measured frames, negative if queue has no timestamps.
+double VulkanBackend::getGpuMicroseconds(vulkanQueue& q)
+{
+	if (!q.timestampBits) return -1.0;
+	const DWORD64 mask = (q.timestampBits >= 64) ? ~0ULL : ((1ULL << q.timestampBits) - 1);
+	DWORD64 gpuTicks = 0;
+	DWORD64 gpuSamples = 0;
+	DWORD64* stamps = new DWORD64[APPCONST::VULKAN_MEASURE_FRAMES * 2];
+	if (v.vkGetQueryPoolResults(device, q.queries, APPCONST::VULKAN_WARMUP_FRAMES * 2, APPCONST::VULKAN_MEASURE_FRAMES * 2,
+		APPCONST::VULKAN_MEASURE_FRAMES * 2 * sizeof(DWORD64), stamps, sizeof(DWORD64), VK_QUERY_RESULT_64_BIT) == VK_SUCCESS)
+	{
+		for (int i = 0; i < APPCONST::VULKAN_MEASURE_FRAMES; i++)
+		{
+			gpuTicks += (stamps[i * 2 + 1] - stamps[i * 2]) & mask;
+			gpuSamples++;
+		}
+	}
+	delete[] stamps;
+	return gpuSamples ? (gpuTicks * properties.limits.timestampPeriod / 1000.0 / gpuSamples) : 0.0;
+}
+// GPU time cell of report, n/a if queue has no timestamps.
+void VulkanBackend::writeGpuCell(char* cell, int size, double us)
+{
+	if (us < 0.0)
+	{
+		snprintf(cell, size, "n/a");
+	}
+	else
+	{
+		snprintf(cell, size, "%.1f", us);
+	}
+}
+// Same rotations product as OpenGL path model matrix, column-major.
+void VulkanBackend::rotation(double seconds, float* matrix)
+{
+	float x[16] = { 0 };
+	float y[16] = { 0 };
+	float z[16] = { 0 };
+	float xy[16];
+	for (int i = 0; i < 16; i += 5)
+	{
+		x[i] = y[i] = z[i] = 1.0f;
+	}
+	float xSin = static_cast<float>(sin(-seconds * 0.25));
+	float xCos = static_cast<float>(cos(-seconds * 0.25));
+	float ySin = static_cast<float>(sin(seconds * 0.5));
+	float yCos = static_cast<float>(cos(seconds * 0.5));
+	float zSin = static_cast<float>(sin(seconds * 1.5));
+	float zCos = static_cast<float>(cos(seconds * 1.5));
+	x[5] = xCos;  x[6] = -xSin; x[9] = xSin;  x[10] = xCos;
+	y[0] = yCos;  y[2] = ySin;  y[8] = -ySin; y[10] = yCos;
+	z[0] = zCos;  z[1] = -zSin; z[4] = zSin;  z[5] = zCos;
+	for (int c = 0; c < 4; c++)
+	{
+		for (int r = 0; r < 4; r++)
+		{
+			xy[c * 4 + r] = x[r] * y[c * 4] + x[4 + r] * y[c * 4 + 1] + x[8 + r] * y[c * 4 + 2] + x[12 + r] * y[c * 4 + 3];
+		}
+	}
+	for (int c = 0; c < 4; c++)
+	{
+		for (int r = 0; r < 4; r++)
+		{
+			matrix[c * 4 + r] = xy[r] * z[c * 4] + xy[4 + r] * z[c * 4 + 1] + xy[8 + r] * z[c * 4 + 2] + xy[12 + r] * z[c * 4 + 3];
+		}
+	}
+}
+int VulkanBackend::createQueue(vulkanQueue& q)
+{
+	VkCommandPoolCreateInfo pci = { VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO, nullptr,
+		VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT, q.family };
+	if (v.vkCreateCommandPool(device, &pci, nullptr, &q.pool) != VK_SUCCESS) return 0x20A;
+	VkCommandBufferAllocateInfo cai = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO, nullptr, q.pool,
+		VK_COMMAND_BUFFER_LEVEL_PRIMARY, APPCONST::VULKAN_FRAMES_IN_FLIGHT };
+	if (v.vkAllocateCommandBuffers(device, &cai, q.commands) != VK_SUCCESS) return 0x20A;
+	// Fences created signaled, first wait of each slot not blocks.
+	VkFenceCreateInfo fci = { VK_STRUCTURE_TYPE_FENCE_CREATE_INFO, nullptr, VK_FENCE_CREATE_SIGNALED_BIT };
+	for (int i = 0; i < APPCONST::VULKAN_FRAMES_IN_FLIGHT; i++)
+	{
+		if (v.vkCreateFence(device, &fci, nullptr, &q.fences[i]) != VK_SUCCESS) return 0x20B;
+	}
+	VkQueryPoolCreateInfo qpi = { VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO, nullptr, 0, VK_QUERY_TYPE_TIMESTAMP,
+		APPCONST::VULKAN_TOTAL_FRAMES * 2, 0 };
+	if (v.vkCreateQueryPool(device, &qpi, nullptr, &q.queries) != VK_SUCCESS) return 0x20C;
+	return 0;
+}
+// One-time commands of setup at first graphics command buffer, executed and waited by endSetup.
+VkCommandBuffer VulkanBackend::beginSetup()
+{
+	VkCommandBuffer cb = graphics.commands[0];
+	if (v.vkWaitForFences(device, 1, &graphics.fences[0], 1, APPCONST::VULKAN_FENCE_TIMEOUT_NS) != VK_SUCCESS) return nullptr;
+	v.vkResetFences(device, 1, &graphics.fences[0]);
+	VkCommandBufferBeginInfo cbi = { VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO, nullptr, VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT, nullptr };
+	v.vkBeginCommandBuffer(cb, &cbi);
+	return cb;
+}
+int VulkanBackend::endSetup(VkCommandBuffer cb)
+{
+	v.vkEndCommandBuffer(cb);
+	VkSubmitInfo si = { VK_STRUCTURE_TYPE_SUBMIT_INFO, nullptr, 0, nullptr, nullptr, 1, &cb, 0, nullptr };
+	if (v.vkQueueSubmit(graphics.queue, 1, &si, graphics.fences[0]) != VK_SUCCESS) return 0x20D;
+	if (v.vkWaitForFences(device, 1, &graphics.fences[0], 1, APPCONST::VULKAN_FENCE_TIMEOUT_NS) != VK_SUCCESS) return 0x20E;
+	return 0;
+}
+// Timestamps pool of queue reset by graphics queue, device is idle between loads.
+int VulkanBackend::resetQueries(vulkanQueue& q)
+{
+	if (!q.timestampBits) return 0;
+	VkCommandBuffer cb = beginSetup();
+	if (!cb) return 0x20E;
+	v.vkCmdResetQueryPool(cb, q.queries, 0, APPCONST::VULKAN_TOTAL_FRAMES * 2);
+	return endSetup(cb);
+}
+void VulkanBackend::releaseQueue(vulkanQueue& q)
+{
+	if (q.queries) v.vkDestroyQueryPool(device, q.queries, nullptr);
+	for (int i = 0; i < APPCONST::VULKAN_FRAMES_IN_FLIGHT; i++)
+	{
+		if (q.fences[i]) v.vkDestroyFence(device, q.fences[i], nullptr);
+	}
+	if (q.pool) v.vkDestroyCommandPool(device, q.pool, nullptr);
+	memset(&q, 0, sizeof(vulkanQueue));
+}
+// First memory type with required properties from buffer allowed types, optionally mapped.
+// Concurrent buffer accessed by graphics and transfer families without ownership transfer.
+int VulkanBackend::createBuffer(VkDeviceSize size, VkFlags usage, VkFlags flags, BOOL concurrent,
+	VkBuffer& buffer, VkDeviceMemory& memory, void** ppMapped)
+{
+	const DWORD32 families[2] = { graphics.family, transfer.family };
+	VkBufferCreateInfo bci = { VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO, nullptr, 0, size, usage,
+		concurrent ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE, concurrent ? 2U : 0U, concurrent ? families : nullptr };
+	if (v.vkCreateBuffer(device, &bci, nullptr, &buffer) != VK_SUCCESS) return 0x207;
+	VkMemoryRequirements requirements;
+	v.vkGetBufferMemoryRequirements(device, buffer, &requirements);
+	DWORD32 typeIndex = 0xFFFFFFFF;
+	for (DWORD32 i = 0; i < memoryProperties.memoryTypeCount; i++)
+	{
+		if ((requirements.memoryTypeBits & (1U << i)) && ((memoryProperties.memoryTypes[i].propertyFlags & flags) == flags))
+		{
+			typeIndex = i;
+			break;
+		}
+	}
+	if (typeIndex == 0xFFFFFFFF) return 0x208;
+	VkMemoryAllocateInfo mai = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, nullptr, requirements.size, typeIndex };
+	if (v.vkAllocateMemory(device, &mai, nullptr, &memory) != VK_SUCCESS) return 0x209;
+	if (v.vkBindBufferMemory(device, buffer, memory, 0) != VK_SUCCESS) return 0x209;
+	if (ppMapped && (v.vkMapMemory(device, memory, 0, size, 0, ppMapped) != VK_SUCCESS)) return 0x209;
+	return 0;
+}
+// Device local 2D image with one level and its view.
+int VulkanBackend::createImage(DWORD32 width, DWORD32 height, int format, VkFlags usage, VkFlags aspect,
+	VkImage& image, VkDeviceMemory& memory, VkImageView& view)
+{
+	VkImageCreateInfo ici = { VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO, nullptr, 0, VK_IMAGE_TYPE_2D, format, { width, height, 1 }, 1, 1,
+		VK_SAMPLE_COUNT_1_BIT, VK_IMAGE_TILING_OPTIMAL, usage, VK_SHARING_MODE_EXCLUSIVE, 0, nullptr, VK_IMAGE_LAYOUT_UNDEFINED };
+	if (v.vkCreateImage(device, &ici, nullptr, &image) != VK_SUCCESS) return 0x211;
+	VkMemoryRequirements requirements;
+	v.vkGetImageMemoryRequirements(device, image, &requirements);
+	DWORD32 typeIndex = 0xFFFFFFFF;
+	for (DWORD32 i = 0; i < memoryProperties.memoryTypeCount; i++)
+	{
+		if ((requirements.memoryTypeBits & (1U << i)) &&
+			(memoryProperties.memoryTypes[i].propertyFlags & VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT))
+		{
+			typeIndex = i;
+			break;
+		}
+	}
+	if (typeIndex == 0xFFFFFFFF) return 0x208;
+	VkMemoryAllocateInfo mai = { VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO, nullptr, requirements.size, typeIndex };
+	if (v.vkAllocateMemory(device, &mai, nullptr, &memory) != VK_SUCCESS) return 0x209;
+	if (v.vkBindImageMemory(device, image, memory, 0) != VK_SUCCESS) return 0x209;
+	VkImageViewCreateInfo vci = { VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO, nullptr, 0, image, VK_IMAGE_VIEW_TYPE_2D, format,
+		{ 0, 0, 0, 0 }, { aspect, 0, 1, 0, 1 } };
+	if (v.vkCreateImageView(device, &vci, nullptr, &view) != VK_SUCCESS) return 0x212;
+	return 0;
+}
+// Atlas level 0 as OpenGL path with linear filter without mipmaps, BGRA rows copied by temporary staging buffer.
+int VulkanBackend::uploadTexture(const void* rawData)
+{
+	const VkDeviceSize textureBytes = static_cast<VkDeviceSize>(APPCONST::TEXTURE_WIDTH) * APPCONST::TEXTURE_HEIGHT * 4;
+	int status = createImage(APPCONST::TEXTURE_WIDTH, APPCONST::TEXTURE_HEIGHT, VK_FORMAT_B8G8R8A8_UNORM,
+		VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_SAMPLED_BIT, VK_IMAGE_ASPECT_COLOR_BIT, texture, textureMemory, textureView);
+	if (status) return status;
+	VkBuffer uploadBuffer = 0;
+	VkDeviceMemory uploadMemory = 0;
+	BYTE* pUpload = nullptr;
+	status = createBuffer(textureBytes, VK_BUFFER_USAGE_TRANSFER_SRC_BIT, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+		FALSE, uploadBuffer, uploadMemory, reinterpret_cast<void**>(&pUpload));
+	if (!status)
+	{
+		memcpy(pUpload, rawData, static_cast<size_t>(textureBytes));
+		VkCommandBuffer cb = beginSetup();
+		status = 0x20E;
+		if (cb)
+		{
+			VkImageMemoryBarrier barrier = { VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER, nullptr, 0, VK_ACCESS_TRANSFER_WRITE_BIT,
+				VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, VK_QUEUE_FAMILY_IGNORED, VK_QUEUE_FAMILY_IGNORED,
+				texture, { VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1 } };
+			v.vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+			VkBufferImageCopy region = { 0, 0, 0, { VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1 }, { 0, 0, 0 },
+				{ APPCONST::TEXTURE_WIDTH, APPCONST::TEXTURE_HEIGHT, 1 } };
+			v.vkCmdCopyBufferToImage(cb, uploadBuffer, texture, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &region);
+			barrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+			barrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+			barrier.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+			barrier.newLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL;
+			v.vkCmdPipelineBarrier(cb, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, 0, 0, nullptr, 0, nullptr, 1, &barrier);
+			status = endSetup(cb);
+		}
+	}
+	if (uploadBuffer) v.vkDestroyBuffer(device, uploadBuffer, nullptr);
+	if (uploadMemory) v.vkFreeMemory(device, uploadMemory, nullptr);
+	if (status) return status;
+
+	VkSamplerCreateInfo sci = { VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO, nullptr, 0, VK_FILTER_LINEAR, VK_FILTER_LINEAR,
+		VK_SAMPLER_MIPMAP_MODE_NEAREST, VK_SAMPLER_ADDRESS_MODE_REPEAT, VK_SAMPLER_ADDRESS_MODE_REPEAT, VK_SAMPLER_ADDRESS_MODE_REPEAT,
+		0.0f, 0, 1.0f, 0, VK_COMPARE_OP_NEVER, 0.0f, 0.0f, 0, 0 };
+	if (v.vkCreateSampler(device, &sci, nullptr, &sampler) != VK_SUCCESS) return 0x213;
+	return 0;
+}
+// Color and depth attachments, cleared by render pass each frame.
+// External dependency orders attachments writes of consecutive frames in flight.
+int VulkanBackend::createRenderTarget()
+{
+	int status = createImage(APPCONST::VULKAN_TARGET_WIDTH, APPCONST::VULKAN_TARGET_HEIGHT, VK_FORMAT_R8G8B8A8_UNORM,
+		VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT, VK_IMAGE_ASPECT_COLOR_BIT, colorImage, colorMemory, colorView);
+	if (status) return status;
+	status = createImage(APPCONST::VULKAN_TARGET_WIDTH, APPCONST::VULKAN_TARGET_HEIGHT, VK_FORMAT_D16_UNORM,
+		VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT, VK_IMAGE_ASPECT_DEPTH_BIT, depthImage, depthMemory, depthView);
+	if (status) return status;
+
+	VkAttachmentDescription attachments[2] =
+	{
+		{ 0, VK_FORMAT_R8G8B8A8_UNORM, VK_SAMPLE_COUNT_1_BIT, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_STORE,
+		  VK_ATTACHMENT_LOAD_OP_DONT_CARE, VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL },
+		{ 0, VK_FORMAT_D16_UNORM, VK_SAMPLE_COUNT_1_BIT, VK_ATTACHMENT_LOAD_OP_CLEAR, VK_ATTACHMENT_STORE_OP_DONT_CARE,
+		  VK_ATTACHMENT_LOAD_OP_DONT_CARE, VK_ATTACHMENT_STORE_OP_DONT_CARE, VK_IMAGE_LAYOUT_UNDEFINED, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL }
+	};
+	VkAttachmentReference colorRef = { 0, VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL };
+	VkAttachmentReference depthRef = { 1, VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL };
+	VkSubpassDescription subpass = { 0, VK_PIPELINE_BIND_POINT_GRAPHICS, 0, nullptr, 1, &colorRef, nullptr, &depthRef, 0, nullptr };
+	constexpr VkFlags STAGES = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+		VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+	constexpr VkFlags WRITES = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+	VkSubpassDependency dependency = { VK_SUBPASS_EXTERNAL, 0, STAGES, STAGES, WRITES,
+		WRITES | VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT, 0 };
+	VkRenderPassCreateInfo rci = { VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO, nullptr, 0, 2, attachments, 1, &subpass, 1, &dependency };
+	if (v.vkCreateRenderPass(device, &rci, nullptr, &renderPass) != VK_SUCCESS) return 0x214;
+	const VkImageView views[2] = { colorView, depthView };
+	VkFramebufferCreateInfo fci = { VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO, nullptr, 0, renderPass, 2, views,
+		APPCONST::VULKAN_TARGET_WIDTH, APPCONST::VULKAN_TARGET_HEIGHT, 1 };
+	if (v.vkCreateFramebuffer(device, &fci, nullptr, &framebuffer) != VK_SUCCESS) return 0x214;
+	return 0;
+}
+// One set for both pipelines: atlas sampler for fragment shader, text chars block for text vertex shader.
+int VulkanBackend::createDescriptors()
+{
+	VkDescriptorSetLayoutBinding bindings[2] =
+	{
+		{ 0, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1, VK_SHADER_STAGE_FRAGMENT_BIT, nullptr },
+		{ 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1, VK_SHADER_STAGE_VERTEX_BIT, nullptr }
+	};
+	VkDescriptorSetLayoutCreateInfo lci = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO, nullptr, 0, 2, bindings };
+	if (v.vkCreateDescriptorSetLayout(device, &lci, nullptr, &setLayout) != VK_SUCCESS) return 0x215;
+	VkDescriptorPoolSize sizes[2] = { { VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, 1 }, { VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, 1 } };
+	VkDescriptorPoolCreateInfo pci = { VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO, nullptr, 0, 1, 2, sizes };
+	if (v.vkCreateDescriptorPool(device, &pci, nullptr, &descriptorPool) != VK_SUCCESS) return 0x215;
+	VkDescriptorSetAllocateInfo sai = { VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO, nullptr, descriptorPool, 1, &setLayout };
+	if (v.vkAllocateDescriptorSets(device, &sai, &descriptorSet) != VK_SUCCESS) return 0x215;
+	VkDescriptorImageInfo imageInfo = { sampler, textureView, VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL };
+	VkDescriptorBufferInfo bufferInfo = { textBuffer, 0, APPCONST::TEXT_CHARS };
+	VkWriteDescriptorSet writes[2] =
+	{
+		{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, descriptorSet, 0, 0, 1, VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, &imageInfo, nullptr, nullptr },
+		{ VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET, nullptr, descriptorSet, 1, 0, 1, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, nullptr, &bufferInfo, nullptr }
+	};
+	v.vkUpdateDescriptorSets(device, 2, writes, 0, nullptr);
+	VkPushConstantRange range = { VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(vulkanPushConstants) };
+	VkPipelineLayoutCreateInfo plci = { VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO, nullptr, 0, 1, &setLayout, 1, &range };
+	if (v.vkCreatePipelineLayout(device, &plci, nullptr, &pipelineLayout) != VK_SUCCESS) return 0x215;
+	return 0;
+}
+// Cubes pipeline: model vertices and instance scales bindings, depth test as OpenGL path default.
+// Text pipeline: first face positions only, without depth test as OpenGL text draw.
+int VulkanBackend::createPipelines()
+{
+	VkShaderModule modules[3] = { 0, 0, 0 };
+	const DWORD32* codes[3] = { cubesVertexCode, textVertexCode, fragmentCode };
+	const size_t sizes[3] = { cubesVertexBytes, textVertexBytes, fragmentBytes };
+	int status = 0;
+	for (int i = 0; (i < 3) && (!status); i++)
+	{
+		VkShaderModuleCreateInfo mci = { VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO, nullptr, 0, sizes[i], codes[i] };
+		if (v.vkCreateShaderModule(device, &mci, nullptr, &modules[i]) != VK_SUCCESS) status = 0x216;
+	}
+
+	VkVertexInputBindingDescription vertexBindings[2] =
+	{
+		{ 0, APPCONST::CUBE_STRIDE, VK_VERTEX_INPUT_RATE_VERTEX },
+		{ 1, sizeof(float), VK_VERTEX_INPUT_RATE_INSTANCE }
+	};
+	VkVertexInputAttributeDescription attributes[3] =
+	{
+		{ 0, 0, VK_FORMAT_R32G32B32_SFLOAT, 0 },
+		{ 1, 0, VK_FORMAT_R32G32_SFLOAT, APPCONST::CUBE_TEXTURE_OFFSET },
+		{ 2, 1, VK_FORMAT_R32_SFLOAT, 0 }
+	};
+	VkPipelineVertexInputStateCreateInfo cubesInput = { VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO, nullptr, 0,
+		2, vertexBindings, 3, attributes };
+	VkPipelineVertexInputStateCreateInfo textInput = { VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO, nullptr, 0,
+		1, vertexBindings, 1, attributes };
+	VkPipelineInputAssemblyStateCreateInfo assembly = { VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO, nullptr, 0,
+		VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST, 0 };
+	VkViewport viewport = { 0.0f, 0.0f, static_cast<float>(APPCONST::VULKAN_TARGET_WIDTH), static_cast<float>(APPCONST::VULKAN_TARGET_HEIGHT), 0.0f, 1.0f };
+	VkRect2D scissor = { { 0, 0 }, { APPCONST::VULKAN_TARGET_WIDTH, APPCONST::VULKAN_TARGET_HEIGHT } };
+	VkPipelineViewportStateCreateInfo viewportState = { VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO, nullptr, 0, 1, &viewport, 1, &scissor };
+	VkPipelineRasterizationStateCreateInfo raster = { VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO, nullptr, 0, 0, 0,
+		VK_POLYGON_MODE_FILL, VK_CULL_MODE_NONE, VK_FRONT_FACE_COUNTER_CLOCKWISE, 0, 0.0f, 0.0f, 0.0f, 1.0f };
+	VkPipelineMultisampleStateCreateInfo multisample = { VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO, nullptr, 0,
+		VK_SAMPLE_COUNT_1_BIT, 0, 0.0f, nullptr, 0, 0 };
+	VkPipelineDepthStencilStateCreateInfo cubesDepth = { VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO, nullptr, 0,
+		1, 1, VK_COMPARE_OP_LESS, 0, 0, { 0 }, { 0 }, 0.0f, 1.0f };
+	VkPipelineDepthStencilStateCreateInfo textDepth = cubesDepth;
+	textDepth.depthTestEnable = 0;
+	textDepth.depthWriteEnable = 0;
+	VkPipelineColorBlendAttachmentState blendAttachment = { 0, 0, 0, 0, 0, 0, 0, VK_COLOR_COMPONENT_RGBA_BITS };
+	VkPipelineColorBlendStateCreateInfo blend = { VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO, nullptr, 0, 0, 0,
+		1, &blendAttachment, { 0.0f, 0.0f, 0.0f, 0.0f } };
+
+	VkPipelineShaderStageCreateInfo stages[2][2] =
+	{
+		{
+			{ VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, nullptr, 0, VK_SHADER_STAGE_VERTEX_BIT, modules[0], "main", nullptr },
+			{ VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, nullptr, 0, VK_SHADER_STAGE_FRAGMENT_BIT, modules[2], "main", nullptr }
+		},
+		{
+			{ VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, nullptr, 0, VK_SHADER_STAGE_VERTEX_BIT, modules[1], "main", nullptr },
+			{ VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO, nullptr, 0, VK_SHADER_STAGE_FRAGMENT_BIT, modules[2], "main", nullptr }
+		}
+	};
+	VkGraphicsPipelineCreateInfo pipelines[2] =
+	{
+		{ VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO, nullptr, 0, 2, stages[0], &cubesInput, &assembly, nullptr, &viewportState,
+		  &raster, &multisample, &cubesDepth, &blend, nullptr, pipelineLayout, renderPass, 0, 0, -1 },
+		{ VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO, nullptr, 0, 2, stages[1], &textInput, &assembly, nullptr, &viewportState,
+		  &raster, &multisample, &textDepth, &blend, nullptr, pipelineLayout, renderPass, 0, 0, -1 }
+	};
+	VkPipeline created[2] = { 0, 0 };
+	if ((!status) && (v.vkCreateGraphicsPipelines(device, 0, 2, pipelines, nullptr, created) != VK_SUCCESS)) status = 0x217;
+	cubesPipeline = created[0];
+	textPipeline = created[1];
+	for (int i = 0; i < 3; i++)
+	{
+		if (modules[i]) v.vkDestroyShaderModule(device, modules[i], nullptr);
+	}
+	return status;
+}
+void VulkanBackend::release()
+{
+	if (device)
+	{
+		v.vkDeviceWaitIdle(device);
+		releaseQueue(graphics);
+		releaseQueue(transfer);
+		for (int i = 0; i < APPCONST::VULKAN_FRAMES_IN_FLIGHT; i++)
+		{
+			if (copyDone[i]) v.vkDestroySemaphore(device, copyDone[i], nullptr);
+			copyDone[i] = 0;
+		}
+		if (cubesPipeline) v.vkDestroyPipeline(device, cubesPipeline, nullptr);
+		if (textPipeline) v.vkDestroyPipeline(device, textPipeline, nullptr);
+		if (pipelineLayout) v.vkDestroyPipelineLayout(device, pipelineLayout, nullptr);
+		if (descriptorPool) v.vkDestroyDescriptorPool(device, descriptorPool, nullptr);
+		if (setLayout) v.vkDestroyDescriptorSetLayout(device, setLayout, nullptr);
+		if (framebuffer) v.vkDestroyFramebuffer(device, framebuffer, nullptr);
+		if (renderPass) v.vkDestroyRenderPass(device, renderPass, nullptr);
+		if (sampler) v.vkDestroySampler(device, sampler, nullptr);
+		const VkImageView views[3] = { textureView, colorView, depthView };
+		const VkImage images[3] = { texture, colorImage, depthImage };
+		const VkDeviceMemory imageMemories[3] = { textureMemory, colorMemory, depthMemory };
+		for (int i = 0; i < 3; i++)
+		{
+			if (views[i]) v.vkDestroyImageView(device, views[i], nullptr);
+			if (images[i]) v.vkDestroyImage(device, images[i], nullptr);
+			if (imageMemories[i]) v.vkFreeMemory(device, imageMemories[i], nullptr);
+		}
+		if (ringMapped) v.vkUnmapMemory(device, ringMemory);
+		if (stagingMapped) v.vkUnmapMemory(device, stagingMemory);
+		if (textMapped) v.vkUnmapMemory(device, textMemory);
+		if (ringBuffer) v.vkDestroyBuffer(device, ringBuffer, nullptr);
+		if (stagingBuffer) v.vkDestroyBuffer(device, stagingBuffer, nullptr);
+		if (deviceBuffer) v.vkDestroyBuffer(device, deviceBuffer, nullptr);
+		if (cubeBuffer) v.vkDestroyBuffer(device, cubeBuffer, nullptr);
+		if (textBuffer) v.vkDestroyBuffer(device, textBuffer, nullptr);
+		if (ringMemory) v.vkFreeMemory(device, ringMemory, nullptr);
+		if (stagingMemory) v.vkFreeMemory(device, stagingMemory, nullptr);
+		if (deviceMemory) v.vkFreeMemory(device, deviceMemory, nullptr);
+		if (cubeMemory) v.vkFreeMemory(device, cubeMemory, nullptr);
+		if (textMemory) v.vkFreeMemory(device, textMemory, nullptr);
+		v.vkDestroyDevice(device, nullptr);
+		device = nullptr;
+	}
+	ringMapped = nullptr;
+	stagingMapped = nullptr;
+	textMapped = nullptr;
+	ringBuffer = stagingBuffer = deviceBuffer = cubeBuffer = textBuffer = 0;
+	ringMemory = stagingMemory = deviceMemory = cubeMemory = textMemory = 0;
+	texture = colorImage = depthImage = 0;
+	textureMemory = colorMemory = depthMemory = 0;
+	textureView = colorView = depthView = 0;
+	sampler = 0;
+	renderPass = 0;
+	framebuffer = 0;
+	setLayout = 0;
+	descriptorPool = 0;
+	descriptorSet = 0;
+	pipelineLayout = 0;
+	cubesPipeline = textPipeline = 0;
+	if (instance && v.vkDestroyInstance)
+	{
+		v.vkDestroyInstance(instance, nullptr);
+	}
+	instance = nullptr;
+	if (hLibrary)
+	{
+		FreeLibrary(hLibrary);
+		hLibrary = NULL;
+	}
+}
+
+// Names for Vulkan functions import, order must match vkFunctionsList.
+const char* VulkanBackend::vkNamesList[]
+{	"vkDestroyInstance",
+	"vkEnumeratePhysicalDevices",
+	"vkGetPhysicalDeviceProperties",
+	"vkGetPhysicalDeviceQueueFamilyProperties",
+	"vkGetPhysicalDeviceMemoryProperties",
+	"vkCreateDevice",
+	"vkDestroyDevice",
+	"vkGetDeviceQueue",
+	"vkDeviceWaitIdle",
+	"vkCreateBuffer",
+	"vkDestroyBuffer",
+	"vkGetBufferMemoryRequirements",
+	"vkAllocateMemory",
+	"vkFreeMemory",
+	"vkBindBufferMemory",
+	"vkMapMemory",
+	"vkUnmapMemory",
+	"vkCreateCommandPool",
+	"vkDestroyCommandPool",
+	"vkAllocateCommandBuffers",
+	"vkBeginCommandBuffer",
+	"vkEndCommandBuffer",
+	"vkCmdCopyBuffer",
+	"vkCmdResetQueryPool",
+	"vkCmdWriteTimestamp",
+	"vkCreateQueryPool",
+	"vkDestroyQueryPool",
+	"vkGetQueryPoolResults",
+	"vkCreateFence",
+	"vkDestroyFence",
+	"vkWaitForFences",
+	"vkResetFences",
+	"vkQueueSubmit",
+	"vkCreateSemaphore",
+	"vkDestroySemaphore",
+	"vkCreateImage",
+	"vkDestroyImage",
+	"vkGetImageMemoryRequirements",
+	"vkBindImageMemory",
+	"vkCreateImageView",
+	"vkDestroyImageView",
+	"vkCreateSampler",
+	"vkDestroySampler",
+	"vkCreateDescriptorSetLayout",
+	"vkDestroyDescriptorSetLayout",
+	"vkCreateDescriptorPool",
+	"vkDestroyDescriptorPool",
+	"vkAllocateDescriptorSets",
+	"vkUpdateDescriptorSets",
+	"vkCreatePipelineLayout",
+	"vkDestroyPipelineLayout",
+	"vkCreateShaderModule",
+	"vkDestroyShaderModule",
+	"vkCreateGraphicsPipelines",
+	"vkDestroyPipeline",
+	"vkCreateRenderPass",
+	"vkDestroyRenderPass",
+	"vkCreateFramebuffer",
+	"vkDestroyFramebuffer",
+	"vkCmdPipelineBarrier",
+	"vkCmdCopyBufferToImage",
+	"vkCmdBeginRenderPass",
+	"vkCmdEndRenderPass",
+	"vkCmdBindPipeline",
+	"vkCmdBindDescriptorSets",
+	"vkCmdBindVertexBuffers",
+	"vkCmdPushConstants",
+	"vkCmdDraw",
+	nullptr };
+const char* VulkanBackend::szUploadNames[] { "Coherent ring", "Staging transfer" };
+const unsigned int VulkanBackend::loads[]
+{
+	APPCONST::INSTANCING_COUNT_LOAD_0, APPCONST::INSTANCING_COUNT_LOAD_1, APPCONST::INSTANCING_COUNT_LOAD_2,
+	APPCONST::INSTANCING_COUNT_LOAD_3, APPCONST::INSTANCING_COUNT_LOAD_4, APPCONST::INSTANCING_COUNT_LOAD_5,
+	APPCONST::INSTANCING_COUNT_LOAD_6, APPCONST::INSTANCING_COUNT_LOAD_7, 0
+};
+
+// SPIR-V 1.0 binaries of shaders, equivalent GLSL 4.50 sources in comments.
+// Common push constant block of vertex shaders:
+// layout(push_constant) uniform sceneConstants { mat4 model_R; vec2 texelScale; int instanceBase; };
+// Clip space depth is 0...1, OpenGL -1...1 depth of cubes remapped by (z + w) / 2.
+
+// Cubes vertex shader, same as OpenGL vertex shader with instanced attribute.
+// layout(location = 0) in vec3 aPos;
+// layout(location = 1) in vec2 aTexCoord;
+// layout(location = 2) in float sc;
+// layout(location = 0) out vec2 TexCoord;
+// void main()
+// {
+//    int id = gl_InstanceIndex + instanceBase;
+//    int nx = id % 9;
+//    int ny = id / 9 % 3;
+//    float dx = -0.85f + nx / 4.75f;
+//    float dy = -0.56f + ny / 1.80f;
+//    vec4 t = model_R * vec4(aPos, 1.0f);
+//    float sz = 13.0f - 8.5f * abs(sc);
+//    float sx = 3.2f + sz / 3.0f;
+//    gl_Position = vec4(t.x / sx + dx, t.y / sx + dy, (t.z / sz + t.w) * 0.5f, t.w);
+//    float tx = 94.0f + 344.0f * aTexCoord.x + nx * 303.0f;
+//    float ty = 1527.0f - 344.0f * aTexCoord.y - 482.0f * (2 - ny);
+//    TexCoord = vec2(tx * texelScale.x, ty * texelScale.y);
+// }
+const DWORD32 VulkanBackend::cubesVertexCode[]
+{
+	0x07230203, 0x00010000, 0x00000000, 0x0000006B, 0x00000000, 0x00020011, 0x00000001, 0x0006000B,
+	0x00000001, 0x4C534C47, 0x6474732E, 0x3035342E, 0x00000000, 0x0003000E, 0x00000000, 0x00000001,
+	0x000B000F, 0x00000000, 0x0000002E, 0x6E69616D, 0x00000000, 0x00000005, 0x00000008, 0x0000000A,
+	0x0000000D, 0x00000010, 0x00000012, 0x00040047, 0x00000005, 0x0000001E, 0x00000000, 0x00040047,
+	0x00000008, 0x0000001E, 0x00000001, 0x00040047, 0x0000000A, 0x0000001E, 0x00000002, 0x00040047,
+	0x0000000D, 0x0000000B, 0x0000002B, 0x00040047, 0x00000010, 0x0000000B, 0x00000000, 0x00040047,
+	0x00000012, 0x0000001E, 0x00000000, 0x00030047, 0x00000014, 0x00000002, 0x00050048, 0x00000014,
+	0x00000000, 0x00000023, 0x00000000, 0x00040048, 0x00000014, 0x00000000, 0x00000005, 0x00050048,
+	0x00000014, 0x00000000, 0x00000007, 0x00000010, 0x00050048, 0x00000014, 0x00000001, 0x00000023,
+	0x00000040, 0x00050048, 0x00000014, 0x00000002, 0x00000023, 0x00000048, 0x00030016, 0x00000002,
+	0x00000020, 0x00040017, 0x00000003, 0x00000002, 0x00000003, 0x00040020, 0x00000004, 0x00000001,
+	0x00000003, 0x0004003B, 0x00000004, 0x00000005, 0x00000001, 0x00040017, 0x00000006, 0x00000002,
+	0x00000002, 0x00040020, 0x00000007, 0x00000001, 0x00000006, 0x0004003B, 0x00000007, 0x00000008,
+	0x00000001, 0x00040020, 0x00000009, 0x00000001, 0x00000002, 0x0004003B, 0x00000009, 0x0000000A,
+	0x00000001, 0x00040015, 0x0000000B, 0x00000020, 0x00000001, 0x00040020, 0x0000000C, 0x00000001,
+	0x0000000B, 0x0004003B, 0x0000000C, 0x0000000D, 0x00000001, 0x00040017, 0x0000000E, 0x00000002,
+	0x00000004, 0x00040020, 0x0000000F, 0x00000003, 0x0000000E, 0x0004003B, 0x0000000F, 0x00000010,
+	0x00000003, 0x00040020, 0x00000011, 0x00000003, 0x00000006, 0x0004003B, 0x00000011, 0x00000012,
+	0x00000003, 0x00040018, 0x00000013, 0x0000000E, 0x00000004, 0x0005001E, 0x00000014, 0x00000013,
+	0x00000006, 0x0000000B, 0x00040020, 0x00000015, 0x00000009, 0x00000014, 0x0004003B, 0x00000015,
+	0x00000016, 0x00000009, 0x0004002B, 0x00000002, 0x00000017, 0xBF59999A, 0x0004002B, 0x00000002,
+	0x00000018, 0x40980000, 0x0004002B, 0x00000002, 0x00000019, 0xBF0F5C29, 0x0004002B, 0x00000002,
+	0x0000001A, 0x3FE66666, 0x0004002B, 0x00000002, 0x0000001B, 0x3F800000, 0x0004002B, 0x00000002,
+	0x0000001C, 0x41500000, 0x0004002B, 0x00000002, 0x0000001D, 0x41080000, 0x0004002B, 0x00000002,
+	0x0000001E, 0x404CCCCD, 0x0004002B, 0x00000002, 0x0000001F, 0x40400000, 0x0004002B, 0x00000002,
+	0x00000020, 0x3F000000, 0x0004002B, 0x00000002, 0x00000021, 0x42BC0000, 0x0004002B, 0x00000002,
+	0x00000022, 0x43AC0000, 0x0004002B, 0x00000002, 0x00000023, 0x43978000, 0x0004002B, 0x00000002,
+	0x00000024, 0x44BEE000, 0x0004002B, 0x00000002, 0x00000025, 0x43F10000, 0x0004002B, 0x0000000B,
+	0x00000026, 0x00000000, 0x0004002B, 0x0000000B, 0x00000027, 0x00000001, 0x0004002B, 0x0000000B,
+	0x00000028, 0x00000002, 0x0004002B, 0x0000000B, 0x00000029, 0x00000003, 0x0004002B, 0x0000000B,
+	0x0000002A, 0x00000009, 0x00020014, 0x0000002B, 0x00020013, 0x0000002C, 0x00030021, 0x0000002D,
+	0x0000002C, 0x00040020, 0x00000030, 0x00000009, 0x0000000B, 0x00040020, 0x0000003E, 0x00000009,
+	0x00000013, 0x00040020, 0x00000056, 0x00000009, 0x00000006, 0x00050036, 0x0000002C, 0x0000002E,
+	0x00000000, 0x0000002D, 0x000200F8, 0x0000002F, 0x00050041, 0x00000030, 0x00000031, 0x00000016,
+	0x00000028, 0x0004003D, 0x0000000B, 0x00000032, 0x00000031, 0x0004003D, 0x0000000B, 0x00000033,
+	0x0000000D, 0x00050080, 0x0000000B, 0x00000034, 0x00000033, 0x00000032, 0x0005008A, 0x0000000B,
+	0x00000035, 0x00000034, 0x0000002A, 0x00050087, 0x0000000B, 0x00000036, 0x00000034, 0x0000002A,
+	0x0005008A, 0x0000000B, 0x00000037, 0x00000036, 0x00000029, 0x0004006F, 0x00000002, 0x00000038,
+	0x00000035, 0x0004006F, 0x00000002, 0x00000039, 0x00000037, 0x00050088, 0x00000002, 0x0000003A,
+	0x00000038, 0x00000018, 0x00050081, 0x00000002, 0x0000003B, 0x00000017, 0x0000003A, 0x00050088,
+	0x00000002, 0x0000003C, 0x00000039, 0x0000001A, 0x00050081, 0x00000002, 0x0000003D, 0x00000019,
+	0x0000003C, 0x00050041, 0x0000003E, 0x0000003F, 0x00000016, 0x00000026, 0x0004003D, 0x00000013,
+	0x00000040, 0x0000003F, 0x0004003D, 0x00000003, 0x00000041, 0x00000005, 0x00050050, 0x0000000E,
+	0x00000042, 0x00000041, 0x0000001B, 0x00050091, 0x0000000E, 0x00000043, 0x00000040, 0x00000042,
+	0x0004003D, 0x00000002, 0x00000044, 0x0000000A, 0x0006000C, 0x00000002, 0x00000045, 0x00000001,
+	0x00000004, 0x00000044, 0x00050085, 0x00000002, 0x00000046, 0x0000001D, 0x00000045, 0x00050083,
+	0x00000002, 0x00000047, 0x0000001C, 0x00000046, 0x00050088, 0x00000002, 0x00000048, 0x00000047,
+	0x0000001F, 0x00050081, 0x00000002, 0x00000049, 0x0000001E, 0x00000048, 0x00050051, 0x00000002,
+	0x0000004A, 0x00000043, 0x00000000, 0x00050051, 0x00000002, 0x0000004B, 0x00000043, 0x00000001,
+	0x00050051, 0x00000002, 0x0000004C, 0x00000043, 0x00000002, 0x00050051, 0x00000002, 0x0000004D,
+	0x00000043, 0x00000003, 0x00050088, 0x00000002, 0x0000004E, 0x0000004A, 0x00000049, 0x00050081,
+	0x00000002, 0x0000004F, 0x0000004E, 0x0000003B, 0x00050088, 0x00000002, 0x00000050, 0x0000004B,
+	0x00000049, 0x00050081, 0x00000002, 0x00000051, 0x00000050, 0x0000003D, 0x00050088, 0x00000002,
+	0x00000052, 0x0000004C, 0x00000047, 0x00050081, 0x00000002, 0x00000053, 0x00000052, 0x0000004D,
+	0x00050085, 0x00000002, 0x00000054, 0x00000053, 0x00000020, 0x00070050, 0x0000000E, 0x00000055,
+	0x0000004F, 0x00000051, 0x00000054, 0x0000004D, 0x0003003E, 0x00000010, 0x00000055, 0x00050041,
+	0x00000056, 0x00000057, 0x00000016, 0x00000027, 0x0004003D, 0x00000006, 0x00000058, 0x00000057,
+	0x00050051, 0x00000002, 0x00000059, 0x00000058, 0x00000000, 0x00050051, 0x00000002, 0x0000005A,
+	0x00000058, 0x00000001, 0x0004003D, 0x00000006, 0x0000005B, 0x00000008, 0x00050051, 0x00000002,
+	0x0000005C, 0x0000005B, 0x00000000, 0x00050051, 0x00000002, 0x0000005D, 0x0000005B, 0x00000001,
+	0x00050085, 0x00000002, 0x0000005E, 0x00000022, 0x0000005C, 0x00050081, 0x00000002, 0x0000005F,
+	0x00000021, 0x0000005E, 0x00050085, 0x00000002, 0x00000060, 0x00000038, 0x00000023, 0x00050081,
+	0x00000002, 0x00000061, 0x0000005F, 0x00000060, 0x00050082, 0x0000000B, 0x00000062, 0x00000028,
+	0x00000037, 0x0004006F, 0x00000002, 0x00000063, 0x00000062, 0x00050085, 0x00000002, 0x00000064,
+	0x00000022, 0x0000005D, 0x00050083, 0x00000002, 0x00000065, 0x00000024, 0x00000064, 0x00050085,
+	0x00000002, 0x00000066, 0x00000025, 0x00000063, 0x00050083, 0x00000002, 0x00000067, 0x00000065,
+	0x00000066, 0x00050085, 0x00000002, 0x00000068, 0x00000061, 0x00000059, 0x00050085, 0x00000002,
+	0x00000069, 0x00000067, 0x0000005A, 0x00050050, 0x00000006, 0x0000006A, 0x00000068, 0x00000069,
+	0x0003003E, 0x00000012, 0x0000006A, 0x000100FD, 0x00010038
+};
+
+// Text overlay vertex shader, same as OpenGL text vertex shader, chars by uniform block.
+// layout(location = 0) in vec3 aPos;
+// layout(location = 0) out vec2 TexCoord;
+// layout(set = 0, binding = 1) uniform textBlock { ivec4 showText[56]; };
+// void main()
+// {
+//    int id = gl_InstanceIndex;
+//    int nx = id & 0x7F;
+//    int ny = id >> 7;
+//    ny = (ny >= 4) ? (47 - ny) : ny;
+//    float x1 = nx * (2.0f / 128.0f) - 1.0f;
+//    float y1 = ny * (2.0f * 44.0f / 1967.0f) - 1.0f;
+//    float x2 = x1 + 2.0f / 128.0f;
+//    float y2 = y1 + 2.0f * 44.0f / 1967.0f;
+//    gl_Position = vec4((aPos.x < 0) ? x1 : x2, (aPos.y < 0) ? y1 : y2, 0.0f, 1.0f);
+//    bool b = ((ny == 0) && (((nx > 72) && (nx < 82)) || ((nx > 111) && (nx < 121)))) || (ny == 43);
+//    float fs = b ? (16.0f * texelScale.y) : 0.0f;
+//    int index = id >> 2;
+//    int a = (showText[index >> 2][index & 3] >> ((id & 3) << 3)) & 0x7F;
+//    float corx = 0.5f * texelScale.x;
+//    float cory = 0.5f * texelScale.y;
+//    float kx = 8.0f * texelScale.x;
+//    float ky = 16.0f * texelScale.y;
+//    float tx1 = kx * a - corx;
+//    float tx2 = tx1 + kx - corx;
+//    float ty1 = cory + fs;
+//    float ty2 = ky - cory + fs;
+//    TexCoord = vec2((aPos.x < 0) ? tx1 : tx2, (aPos.y < 0) ? ty1 : ty2);
+// }
+const DWORD32 VulkanBackend::textVertexCode[]
+{
+	0x07230203, 0x00010000, 0x00000000, 0x00000072, 0x00000000, 0x00020011, 0x00000001, 0x0003000E,
+	0x00000000, 0x00000001, 0x0009000F, 0x00000000, 0x0000002F, 0x6E69616D, 0x00000000, 0x00000004,
+	0x00000007, 0x0000000A, 0x0000000D, 0x00040047, 0x00000004, 0x0000001E, 0x00000000, 0x00040047,
+	0x00000007, 0x0000000B, 0x0000002B, 0x00040047, 0x0000000A, 0x0000000B, 0x00000000, 0x00040047,
+	0x0000000D, 0x0000001E, 0x00000000, 0x00030047, 0x0000000F, 0x00000002, 0x00050048, 0x0000000F,
+	0x00000000, 0x00000023, 0x00000000, 0x00040048, 0x0000000F, 0x00000000, 0x00000005, 0x00050048,
+	0x0000000F, 0x00000000, 0x00000007, 0x00000010, 0x00050048, 0x0000000F, 0x00000001, 0x00000023,
+	0x00000040, 0x00050048, 0x0000000F, 0x00000002, 0x00000023, 0x00000048, 0x00040047, 0x00000014,
+	0x00000006, 0x00000010, 0x00030047, 0x00000015, 0x00000002, 0x00050048, 0x00000015, 0x00000000,
+	0x00000023, 0x00000000, 0x00040047, 0x00000017, 0x00000022, 0x00000000, 0x00040047, 0x00000017,
+	0x00000021, 0x00000001, 0x00030016, 0x00000001, 0x00000020, 0x00040017, 0x00000002, 0x00000001,
+	0x00000003, 0x00040020, 0x00000003, 0x00000001, 0x00000002, 0x0004003B, 0x00000003, 0x00000004,
+	0x00000001, 0x00040015, 0x00000005, 0x00000020, 0x00000001, 0x00040020, 0x00000006, 0x00000001,
+	0x00000005, 0x0004003B, 0x00000006, 0x00000007, 0x00000001, 0x00040017, 0x00000008, 0x00000001,
+	0x00000004, 0x00040020, 0x00000009, 0x00000003, 0x00000008, 0x0004003B, 0x00000009, 0x0000000A,
+	0x00000003, 0x00040017, 0x0000000B, 0x00000001, 0x00000002, 0x00040020, 0x0000000C, 0x00000003,
+	0x0000000B, 0x0004003B, 0x0000000C, 0x0000000D, 0x00000003, 0x00040018, 0x0000000E, 0x00000008,
+	0x00000004, 0x0005001E, 0x0000000F, 0x0000000E, 0x0000000B, 0x00000005, 0x00040020, 0x00000010,
+	0x00000009, 0x0000000F, 0x0004003B, 0x00000010, 0x00000011, 0x00000009, 0x00040017, 0x00000012,
+	0x00000005, 0x00000004, 0x0004002B, 0x00000005, 0x00000013, 0x00000038, 0x0004001C, 0x00000014,
+	0x00000012, 0x00000013, 0x0003001E, 0x00000015, 0x00000014, 0x00040020, 0x00000016, 0x00000002,
+	0x00000015, 0x0004003B, 0x00000016, 0x00000017, 0x00000002, 0x0004002B, 0x00000001, 0x00000018,
+	0x3C800000, 0x0004002B, 0x00000001, 0x00000019, 0x3D373F62, 0x0004002B, 0x00000001, 0x0000001A,
+	0x3F800000, 0x0004002B, 0x00000001, 0x0000001B, 0x00000000, 0x0004002B, 0x00000001, 0x0000001C,
+	0x41800000, 0x0004002B, 0x00000001, 0x0000001D, 0x3F000000, 0x0004002B, 0x00000001, 0x0000001E,
+	0x41000000, 0x0004002B, 0x00000005, 0x0000001F, 0x00000000, 0x0004002B, 0x00000005, 0x00000020,
+	0x00000001, 0x0004002B, 0x00000005, 0x00000021, 0x00000002, 0x0004002B, 0x00000005, 0x00000022,
+	0x00000003, 0x0004002B, 0x00000005, 0x00000023, 0x00000004, 0x0004002B, 0x00000005, 0x00000024,
+	0x00000007, 0x0004002B, 0x00000005, 0x00000025, 0x0000002B, 0x0004002B, 0x00000005, 0x00000026,
+	0x0000002F, 0x0004002B, 0x00000005, 0x00000027, 0x00000048, 0x0004002B, 0x00000005, 0x00000028,
+	0x00000052, 0x0004002B, 0x00000005, 0x00000029, 0x0000006F, 0x0004002B, 0x00000005, 0x0000002A,
+	0x00000079, 0x0004002B, 0x00000005, 0x0000002B, 0x0000007F, 0x00020014, 0x0000002C, 0x00020013,
+	0x0000002D, 0x00030021, 0x0000002E, 0x0000002D, 0x00040020, 0x00000052, 0x00000009, 0x0000000B,
+	0x00040020, 0x0000005E, 0x00000002, 0x00000005, 0x00050036, 0x0000002D, 0x0000002F, 0x00000000,
+	0x0000002E, 0x000200F8, 0x00000030, 0x0004003D, 0x00000005, 0x00000031, 0x00000007, 0x000500C7,
+	0x00000005, 0x00000032, 0x00000031, 0x0000002B, 0x000500C3, 0x00000005, 0x00000033, 0x00000031,
+	0x00000024, 0x000500AF, 0x0000002C, 0x00000034, 0x00000033, 0x00000023, 0x00050082, 0x00000005,
+	0x00000035, 0x00000026, 0x00000033, 0x000600A9, 0x00000005, 0x00000036, 0x00000034, 0x00000035,
+	0x00000033, 0x0004006F, 0x00000001, 0x00000037, 0x00000032, 0x00050085, 0x00000001, 0x00000038,
+	0x00000037, 0x00000018, 0x00050083, 0x00000001, 0x00000039, 0x00000038, 0x0000001A, 0x0004006F,
+	0x00000001, 0x0000003A, 0x00000036, 0x00050085, 0x00000001, 0x0000003B, 0x0000003A, 0x00000019,
+	0x00050083, 0x00000001, 0x0000003C, 0x0000003B, 0x0000001A, 0x00050081, 0x00000001, 0x0000003D,
+	0x00000039, 0x00000018, 0x00050081, 0x00000001, 0x0000003E, 0x0000003C, 0x00000019, 0x0004003D,
+	0x00000002, 0x0000003F, 0x00000004, 0x00050051, 0x00000001, 0x00000040, 0x0000003F, 0x00000000,
+	0x000500B8, 0x0000002C, 0x00000041, 0x00000040, 0x0000001B, 0x00050051, 0x00000001, 0x00000042,
+	0x0000003F, 0x00000001, 0x000500B8, 0x0000002C, 0x00000043, 0x00000042, 0x0000001B, 0x000600A9,
+	0x00000001, 0x00000044, 0x00000041, 0x00000039, 0x0000003D, 0x000600A9, 0x00000001, 0x00000045,
+	0x00000043, 0x0000003C, 0x0000003E, 0x00070050, 0x00000008, 0x00000046, 0x00000044, 0x00000045,
+	0x0000001B, 0x0000001A, 0x0003003E, 0x0000000A, 0x00000046, 0x000500AA, 0x0000002C, 0x00000047,
+	0x00000036, 0x0000001F, 0x000500AD, 0x0000002C, 0x00000048, 0x00000032, 0x00000027, 0x000500B1,
+	0x0000002C, 0x00000049, 0x00000032, 0x00000028, 0x000500A7, 0x0000002C, 0x0000004A, 0x00000048,
+	0x00000049, 0x000500AD, 0x0000002C, 0x0000004B, 0x00000032, 0x00000029, 0x000500B1, 0x0000002C,
+	0x0000004C, 0x00000032, 0x0000002A, 0x000500A7, 0x0000002C, 0x0000004D, 0x0000004B, 0x0000004C,
+	0x000500AA, 0x0000002C, 0x0000004E, 0x00000036, 0x00000025, 0x000500A6, 0x0000002C, 0x0000004F,
+	0x0000004A, 0x0000004D, 0x000500A7, 0x0000002C, 0x00000050, 0x00000047, 0x0000004F, 0x000500A6,
+	0x0000002C, 0x00000051, 0x00000050, 0x0000004E, 0x00050041, 0x00000052, 0x00000053, 0x00000011,
+	0x00000020, 0x0004003D, 0x0000000B, 0x00000054, 0x00000053, 0x00050051, 0x00000001, 0x00000055,
+	0x00000054, 0x00000000, 0x00050051, 0x00000001, 0x00000056, 0x00000054, 0x00000001, 0x00050085,
+	0x00000001, 0x00000057, 0x0000001C, 0x00000056, 0x000600A9, 0x00000001, 0x00000058, 0x00000051,
+	0x00000057, 0x0000001B, 0x000500C3, 0x00000005, 0x00000059, 0x00000031, 0x00000021, 0x000500C7,
+	0x00000005, 0x0000005A, 0x00000031, 0x00000022, 0x000500C4, 0x00000005, 0x0000005B, 0x0000005A,
+	0x00000022, 0x000500C3, 0x00000005, 0x0000005C, 0x00000059, 0x00000021, 0x000500C7, 0x00000005,
+	0x0000005D, 0x00000059, 0x00000022, 0x00070041, 0x0000005E, 0x0000005F, 0x00000017, 0x0000001F,
+	0x0000005C, 0x0000005D, 0x0004003D, 0x00000005, 0x00000060, 0x0000005F, 0x000500C3, 0x00000005,
+	0x00000061, 0x00000060, 0x0000005B, 0x000500C7, 0x00000005, 0x00000062, 0x00000061, 0x0000002B,
+	0x0004006F, 0x00000001, 0x00000063, 0x00000062, 0x00050085, 0x00000001, 0x00000064, 0x0000001D,
+	0x00000055, 0x00050085, 0x00000001, 0x00000065, 0x0000001D, 0x00000056, 0x00050085, 0x00000001,
+	0x00000066, 0x0000001E, 0x00000055, 0x00050085, 0x00000001, 0x00000067, 0x0000001C, 0x00000056,
+	0x00050085, 0x00000001, 0x00000068, 0x00000066, 0x00000063, 0x00050083, 0x00000001, 0x00000069,
+	0x00000068, 0x00000064, 0x00050081, 0x00000001, 0x0000006A, 0x00000069, 0x00000066, 0x00050083,
+	0x00000001, 0x0000006B, 0x0000006A, 0x00000064, 0x00050081, 0x00000001, 0x0000006C, 0x00000065,
+	0x00000058, 0x00050083, 0x00000001, 0x0000006D, 0x00000067, 0x00000065, 0x00050081, 0x00000001,
+	0x0000006E, 0x0000006D, 0x00000058, 0x000600A9, 0x00000001, 0x0000006F, 0x00000041, 0x00000069,
+	0x0000006B, 0x000600A9, 0x00000001, 0x00000070, 0x00000043, 0x0000006C, 0x0000006E, 0x00050050,
+	0x0000000B, 0x00000071, 0x0000006F, 0x00000070, 0x0003003E, 0x0000000D, 0x00000071, 0x000100FD,
+	0x00010038
+};
+
+// Fragment shader of both pipelines.
+// layout(location = 0) in vec2 TexCoord;
+// layout(location = 0) out vec4 FragColor;
+// layout(set = 0, binding = 0) uniform sampler2D texture1;
+// void main()
+// {
+//    FragColor = texture(texture1, TexCoord);
+// }
+const DWORD32 VulkanBackend::fragmentCode[]
+{
+	0x07230203, 0x00010000, 0x00000000, 0x00000013, 0x00000000, 0x00020011, 0x00000001, 0x0003000E,
+	0x00000000, 0x00000001, 0x0007000F, 0x00000004, 0x0000000E, 0x6E69616D, 0x00000000, 0x00000004,
+	0x00000007, 0x00030010, 0x0000000E, 0x00000007, 0x00040047, 0x00000004, 0x0000001E, 0x00000000,
+	0x00040047, 0x00000007, 0x0000001E, 0x00000000, 0x00040047, 0x0000000B, 0x00000022, 0x00000000,
+	0x00040047, 0x0000000B, 0x00000021, 0x00000000, 0x00030016, 0x00000001, 0x00000020, 0x00040017,
+	0x00000002, 0x00000001, 0x00000002, 0x00040020, 0x00000003, 0x00000001, 0x00000002, 0x0004003B,
+	0x00000003, 0x00000004, 0x00000001, 0x00040017, 0x00000005, 0x00000001, 0x00000004, 0x00040020,
+	0x00000006, 0x00000003, 0x00000005, 0x0004003B, 0x00000006, 0x00000007, 0x00000003, 0x00090019,
+	0x00000008, 0x00000001, 0x00000001, 0x00000000, 0x00000000, 0x00000000, 0x00000001, 0x00000000,
+	0x0003001B, 0x00000009, 0x00000008, 0x00040020, 0x0000000A, 0x00000000, 0x00000009, 0x0004003B,
+	0x0000000A, 0x0000000B, 0x00000000, 0x00020013, 0x0000000C, 0x00030021, 0x0000000D, 0x0000000C,
+	0x00050036, 0x0000000C, 0x0000000E, 0x00000000, 0x0000000D, 0x000200F8, 0x0000000F, 0x0004003D,
+	0x00000009, 0x00000010, 0x0000000B, 0x0004003D, 0x00000002, 0x00000011, 0x00000004, 0x00050057,
+	0x00000005, 0x00000012, 0x00000010, 0x00000011, 0x0003003E, 0x00000007, 0x00000012, 0x000100FD,
+	0x00010038
+};
+const size_t VulkanBackend::cubesVertexBytes = sizeof(cubesVertexCode);
+const size_t VulkanBackend::textVertexBytes = sizeof(textVertexCode);
+const size_t VulkanBackend::fragmentBytes = sizeof(fragmentCode);
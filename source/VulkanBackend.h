@@ -0,0 +1,134 @@
+/*
+OpenGL GPUstress.
+Vulkan backend class header.
+Headless render of same instanced cubes and text overlay scene as OpenGL
+path to offscreen target, with same loads and CPU fill, for compare of APIs
+upload and draw costs. Runs on any Vulkan 1.0 device, include Mesa lavapipe
+CPU device.
+*/
+
+#pragma once
+#ifndef VULKANBACKEND_H
+#define VULKANBACKEND_H
+
+#include <windows.h>
+#include <iostream>
+#include <intrin.h>
+#include <math.h>
+#include "Global.h"
+#include "VulkanImport.h"
+#include "Report.h"
+
+enum vulkanUpload
+{
+    UPLOAD_COHERENT_RING = 0,   // CPU writes persistently mapped coherent ring, bound as instance vertex buffer.
+    UPLOAD_STAGING_TRANSFER,    // CPU writes staging buffer, transfer queue copies to device local buffer, draw waits copy.
+    UPLOADS_COUNT
+};
+
+// Push constants of cubes and text pipelines, layout of shaders push constant block.
+struct vulkanPushConstants
+{
+    float model[16];
+    float texelScale[2];        // 1 / texture size, shaders not query texture size.
+    int instanceBase;
+};
+
+// Per-queue submission context, one command buffer and fence per frame in flight.
+struct vulkanQueue
+{
+    DWORD32 family;
+    DWORD32 timestampBits;
+    VkQueue queue;
+    VkCommandPool pool;
+    VkCommandBuffer commands[APPCONST::VULKAN_FRAMES_IN_FLIGHT];
+    VkFence fences[APPCONST::VULKAN_FRAMES_IN_FLIGHT];
+    VkQueryPool queries;       // Timestamps pair per frame of load measure.
+};
+
+class VulkanBackend
+{
+public:
+    VulkanBackend();
+    ~VulkanBackend();
+    int init(double period, const void* rawData, const float* cubeVertices);
+    int run(const char* fileName);
+private:
+    void release();
+    int createQueue(vulkanQueue& q);
+    void releaseQueue(vulkanQueue& q);
+    VkCommandBuffer beginSetup();
+    int endSetup(VkCommandBuffer cb);
+    int resetQueries(vulkanQueue& q);
+    int createBuffer(VkDeviceSize size, VkFlags usage, VkFlags properties, BOOL concurrent,
+        VkBuffer& buffer, VkDeviceMemory& memory, void** ppMapped);
+    int createImage(DWORD32 width, DWORD32 height, int format, VkFlags usage, VkFlags aspect,
+        VkImage& image, VkDeviceMemory& memory, VkImageView& view);
+    int uploadTexture(const void* rawData);
+    int createRenderTarget();
+    int createDescriptors();
+    int createPipelines();
+    int measure(vulkanUpload mode, unsigned int load);
+    double getGpuMicroseconds(vulkanQueue& q);
+    static void writeGpuCell(char* cell, int size, double us);
+    static void rotation(double seconds, float* matrix);
+    HMODULE hLibrary;
+    PFN_vkVoidFunction(__stdcall *vkGetInstanceProcAddr)(VkInstance instance, const char* pName);
+    vkFunctionsList v;
+    VkInstance instance;
+    VkPhysicalDevice physicalDevice;
+    VkDevice device;
+    VkPhysicalDeviceProperties properties;
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    vulkanQueue graphics;
+    vulkanQueue transfer;
+    VkDeviceSize slotBytes;
+    VkBuffer ringBuffer;
+    VkDeviceMemory ringMemory;
+    BYTE* ringMapped;
+    VkBuffer stagingBuffer;
+    VkDeviceMemory stagingMemory;
+    BYTE* stagingMapped;
+    VkBuffer deviceBuffer;
+    VkDeviceMemory deviceMemory;
+    VkSemaphore copyDone[APPCONST::VULKAN_FRAMES_IN_FLIGHT];
+    VkBuffer cubeBuffer;
+    VkDeviceMemory cubeMemory;
+    VkDeviceSize textSlotBytes;
+    VkBuffer textBuffer;
+    VkDeviceMemory textMemory;
+    BYTE* textMapped;
+    VkImage texture;
+    VkDeviceMemory textureMemory;
+    VkImageView textureView;
+    VkSampler sampler;
+    VkImage colorImage;
+    VkDeviceMemory colorMemory;
+    VkImageView colorView;
+    VkImage depthImage;
+    VkDeviceMemory depthMemory;
+    VkImageView depthView;
+    VkRenderPass renderPass;
+    VkFramebuffer framebuffer;
+    VkDescriptorSetLayout setLayout;
+    VkDescriptorPool descriptorPool;
+    VkDescriptorSet descriptorSet;
+    VkPipelineLayout pipelineLayout;
+    VkPipeline cubesPipeline;
+    VkPipeline textPipeline;
+    vulkanPushConstants constants;
+    char textChars[APPCONST::TEXT_CHARS];
+    double tscPeriod;
+    Report report;
+    static const char* vkNamesList[];
+    static const char* szUploadNames[];
+    static const unsigned int loads[];
+    static const DWORD32 cubesVertexCode[];
+    static const DWORD32 textVertexCode[];
+    static const DWORD32 fragmentCode[];
+    static const size_t cubesVertexBytes;
+    static const size_t textVertexBytes;
+    static const size_t fragmentBytes;
+};
+
+#endif // VULKANBACKEND_H
@@ -0,0 +1,1044 @@
+/*
+OpenGL GPUstress.
+Vulkan definitions and dynamically imported functions list.
+Subset of vulkan_core.h (Vulkan 1.0) used by Vulkan backend,
+vulkan-1.dll loaded at runtime, Vulkan SDK not required for build.
+*/
+
+#pragma once
+#ifndef VULKANIMPORT_H
+#define VULKANIMPORT_H
+
+#include <windows.h>
+
+#define VK_API_VERSION_1_0  (1U << 22)
+#define VK_SUCCESS  0
+#define VK_MAX_PHYSICAL_DEVICE_NAME_SIZE  256
+#define VK_UUID_SIZE  16
+#define VK_MAX_MEMORY_TYPES  32
+#define VK_MAX_MEMORY_HEAPS  16
+
+#define VK_STRUCTURE_TYPE_APPLICATION_INFO  0
+#define VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO  1
+#define VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO  2
+#define VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO  3
+#define VK_STRUCTURE_TYPE_SUBMIT_INFO  4
+#define VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO  5
+#define VK_STRUCTURE_TYPE_FENCE_CREATE_INFO  8
+#define VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO  9
+#define VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO  11
+#define VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO  12
+#define VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO  14
+#define VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO  15
+#define VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO  16
+#define VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO  18
+#define VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO  19
+#define VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO  20
+#define VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO  22
+#define VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO  23
+#define VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO  24
+#define VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO  25
+#define VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO  26
+#define VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO  28
+#define VK_STRUCTURE_TYPE_PIPELINE_LAYOUT_CREATE_INFO  30
+#define VK_STRUCTURE_TYPE_SAMPLER_CREATE_INFO  31
+#define VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO  32
+#define VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO  33
+#define VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO  34
+#define VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET  35
+#define VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO  37
+#define VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO  38
+#define VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO  39
+#define VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO  40
+#define VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO  42
+#define VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO  43
+#define VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER  45
+
+#define VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU  1
+#define VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU  2
+#define VK_PHYSICAL_DEVICE_TYPE_CPU  4
+#define VK_QUEUE_GRAPHICS_BIT  0x00000001
+#define VK_QUEUE_COMPUTE_BIT   0x00000002
+#define VK_QUEUE_TRANSFER_BIT  0x00000004
+#define VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT   0x00000001
+#define VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT   0x00000002
+#define VK_MEMORY_PROPERTY_HOST_COHERENT_BIT  0x00000004
+#define VK_BUFFER_USAGE_TRANSFER_SRC_BIT   0x00000001
+#define VK_BUFFER_USAGE_TRANSFER_DST_BIT   0x00000002
+#define VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT  0x00000010
+#define VK_BUFFER_USAGE_VERTEX_BUFFER_BIT  0x00000080
+#define VK_SHARING_MODE_EXCLUSIVE  0
+#define VK_SHARING_MODE_CONCURRENT  1
+#define VK_QUEUE_FAMILY_IGNORED  0xFFFFFFFFu
+#define VK_SUBPASS_EXTERNAL  0xFFFFFFFFu
+#define VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT  0x00000002
+#define VK_COMMAND_BUFFER_LEVEL_PRIMARY  0
+#define VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT  0x00000001
+#define VK_FENCE_CREATE_SIGNALED_BIT  0x00000001
+#define VK_QUERY_TYPE_TIMESTAMP  2
+#define VK_QUERY_RESULT_64_BIT  0x00000001
+#define VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT     0x00000001
+#define VK_PIPELINE_STAGE_VERTEX_INPUT_BIT    0x00000004
+#define VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT  0x00000080
+#define VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT  0x00000100
+#define VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT   0x00000200
+#define VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT  0x00000400
+#define VK_PIPELINE_STAGE_TRANSFER_BIT        0x00001000
+#define VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT  0x00002000
+#define VK_ACCESS_SHADER_READ_BIT  0x00000020
+#define VK_ACCESS_COLOR_ATTACHMENT_READ_BIT   0x00000080
+#define VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT  0x00000100
+#define VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT   0x00000200
+#define VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT  0x00000400
+#define VK_ACCESS_TRANSFER_WRITE_BIT  0x00001000
+
+#define VK_FORMAT_R8G8B8A8_UNORM  37
+#define VK_FORMAT_B8G8R8A8_UNORM  44
+#define VK_FORMAT_R32_SFLOAT  100
+#define VK_FORMAT_R32G32_SFLOAT  103
+#define VK_FORMAT_R32G32B32_SFLOAT  106
+#define VK_FORMAT_D16_UNORM  124
+#define VK_IMAGE_TYPE_2D  1
+#define VK_IMAGE_VIEW_TYPE_2D  1
+#define VK_IMAGE_TILING_OPTIMAL  0
+#define VK_SAMPLE_COUNT_1_BIT  1
+#define VK_IMAGE_USAGE_TRANSFER_DST_BIT  0x00000002
+#define VK_IMAGE_USAGE_SAMPLED_BIT  0x00000004
+#define VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT  0x00000010
+#define VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT  0x00000020
+#define VK_IMAGE_ASPECT_COLOR_BIT  0x00000001
+#define VK_IMAGE_ASPECT_DEPTH_BIT  0x00000002
+#define VK_IMAGE_LAYOUT_UNDEFINED  0
+#define VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL  2
+#define VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL  3
+#define VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL  5
+#define VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL  7
+#define VK_FILTER_LINEAR  1
+#define VK_SAMPLER_MIPMAP_MODE_NEAREST  0
+#define VK_SAMPLER_ADDRESS_MODE_REPEAT  0
+#define VK_COMPARE_OP_NEVER  0
+#define VK_COMPARE_OP_LESS  1
+#define VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER  1
+#define VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC  8
+#define VK_SHADER_STAGE_VERTEX_BIT  0x00000001
+#define VK_SHADER_STAGE_FRAGMENT_BIT  0x00000010
+#define VK_VERTEX_INPUT_RATE_VERTEX  0
+#define VK_VERTEX_INPUT_RATE_INSTANCE  1
+#define VK_PRIMITIVE_TOPOLOGY_TRIANGLE_LIST  3
+#define VK_POLYGON_MODE_FILL  0
+#define VK_CULL_MODE_NONE  0
+#define VK_FRONT_FACE_COUNTER_CLOCKWISE  0
+#define VK_COLOR_COMPONENT_RGBA_BITS  0x0000000F
+#define VK_ATTACHMENT_LOAD_OP_CLEAR  1
+#define VK_ATTACHMENT_LOAD_OP_DONT_CARE  2
+#define VK_ATTACHMENT_STORE_OP_STORE  0
+#define VK_ATTACHMENT_STORE_OP_DONT_CARE  1
+#define VK_PIPELINE_BIND_POINT_GRAPHICS  0
+#define VK_SUBPASS_CONTENTS_INLINE  0
+
+typedef int VkResult;
+typedef DWORD32 VkFlags;
+typedef DWORD32 VkBool32;
+typedef DWORD64 VkDeviceSize;
+typedef struct VkInstance_T* VkInstance;
+typedef struct VkPhysicalDevice_T* VkPhysicalDevice;
+typedef struct VkDevice_T* VkDevice;
+typedef struct VkQueue_T* VkQueue;
+typedef struct VkCommandBuffer_T* VkCommandBuffer;
+typedef DWORD64 VkBuffer;
+typedef DWORD64 VkDeviceMemory;
+typedef DWORD64 VkCommandPool;
+typedef DWORD64 VkFence;
+typedef DWORD64 VkQueryPool;
+typedef DWORD64 VkSemaphore;
+typedef DWORD64 VkImage;
+typedef DWORD64 VkImageView;
+typedef DWORD64 VkSampler;
+typedef DWORD64 VkDescriptorSetLayout;
+typedef DWORD64 VkDescriptorPool;
+typedef DWORD64 VkDescriptorSet;
+typedef DWORD64 VkPipelineLayout;
+typedef DWORD64 VkPipeline;
+typedef DWORD64 VkPipelineCache;
+typedef DWORD64 VkShaderModule;
+typedef DWORD64 VkRenderPass;
+typedef DWORD64 VkFramebuffer;
+
+struct VkApplicationInfo
+{
+    int sType;
+    const void* pNext;
+    const char* pApplicationName;
+    DWORD32 applicationVersion;
+    const char* pEngineName;
+    DWORD32 engineVersion;
+    DWORD32 apiVersion;
+};
+
+struct VkInstanceCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    const VkApplicationInfo* pApplicationInfo;
+    DWORD32 enabledLayerCount;
+    const char* const* ppEnabledLayerNames;
+    DWORD32 enabledExtensionCount;
+    const char* const* ppEnabledExtensionNames;
+};
+
+struct VkPhysicalDeviceLimits
+{
+    DWORD32 maxImageDimension1D;
+    DWORD32 maxImageDimension2D;
+    DWORD32 maxImageDimension3D;
+    DWORD32 maxImageDimensionCube;
+    DWORD32 maxImageArrayLayers;
+    DWORD32 maxTexelBufferElements;
+    DWORD32 maxUniformBufferRange;
+    DWORD32 maxStorageBufferRange;
+    DWORD32 maxPushConstantsSize;
+    DWORD32 maxMemoryAllocationCount;
+    DWORD32 maxSamplerAllocationCount;
+    VkDeviceSize bufferImageGranularity;
+    VkDeviceSize sparseAddressSpaceSize;
+    DWORD32 maxBoundDescriptorSets;
+    DWORD32 maxPerStageDescriptorSamplers;
+    DWORD32 maxPerStageDescriptorUniformBuffers;
+    DWORD32 maxPerStageDescriptorStorageBuffers;
+    DWORD32 maxPerStageDescriptorSampledImages;
+    DWORD32 maxPerStageDescriptorStorageImages;
+    DWORD32 maxPerStageDescriptorInputAttachments;
+    DWORD32 maxPerStageResources;
+    DWORD32 maxDescriptorSetSamplers;
+    DWORD32 maxDescriptorSetUniformBuffers;
+    DWORD32 maxDescriptorSetUniformBuffersDynamic;
+    DWORD32 maxDescriptorSetStorageBuffers;
+    DWORD32 maxDescriptorSetStorageBuffersDynamic;
+    DWORD32 maxDescriptorSetSampledImages;
+    DWORD32 maxDescriptorSetStorageImages;
+    DWORD32 maxDescriptorSetInputAttachments;
+    DWORD32 maxVertexInputAttributes;
+    DWORD32 maxVertexInputBindings;
+    DWORD32 maxVertexInputAttributeOffset;
+    DWORD32 maxVertexInputBindingStride;
+    DWORD32 maxVertexOutputComponents;
+    DWORD32 maxTessellationGenerationLevel;
+    DWORD32 maxTessellationPatchSize;
+    DWORD32 maxTessellationControlPerVertexInputComponents;
+    DWORD32 maxTessellationControlPerVertexOutputComponents;
+    DWORD32 maxTessellationControlPerPatchOutputComponents;
+    DWORD32 maxTessellationControlTotalOutputComponents;
+    DWORD32 maxTessellationEvaluationInputComponents;
+    DWORD32 maxTessellationEvaluationOutputComponents;
+    DWORD32 maxGeometryShaderInvocations;
+    DWORD32 maxGeometryInputComponents;
+    DWORD32 maxGeometryOutputComponents;
+    DWORD32 maxGeometryOutputVertices;
+    DWORD32 maxGeometryTotalOutputComponents;
+    DWORD32 maxFragmentInputComponents;
+    DWORD32 maxFragmentOutputAttachments;
+    DWORD32 maxFragmentDualSrcAttachments;
+    DWORD32 maxFragmentCombinedOutputResources;
+    DWORD32 maxComputeSharedMemorySize;
+    DWORD32 maxComputeWorkGroupCount[3];
+    DWORD32 maxComputeWorkGroupInvocations;
+    DWORD32 maxComputeWorkGroupSize[3];
+    DWORD32 subPixelPrecisionBits;
+    DWORD32 subTexelPrecisionBits;
+    DWORD32 mipmapPrecisionBits;
+    DWORD32 maxDrawIndexedIndexValue;
+    DWORD32 maxDrawIndirectCount;
+    float maxSamplerLodBias;
+    float maxSamplerAnisotropy;
+    DWORD32 maxViewports;
+    DWORD32 maxViewportDimensions[2];
+    float viewportBoundsRange[2];
+    DWORD32 viewportSubPixelBits;
+    size_t minMemoryMapAlignment;
+    VkDeviceSize minTexelBufferOffsetAlignment;
+    VkDeviceSize minUniformBufferOffsetAlignment;
+    VkDeviceSize minStorageBufferOffsetAlignment;
+    int minTexelOffset;
+    DWORD32 maxTexelOffset;
+    int minTexelGatherOffset;
+    DWORD32 maxTexelGatherOffset;
+    float minInterpolationOffset;
+    float maxInterpolationOffset;
+    DWORD32 subPixelInterpolationOffsetBits;
+    DWORD32 maxFramebufferWidth;
+    DWORD32 maxFramebufferHeight;
+    DWORD32 maxFramebufferLayers;
+    VkFlags framebufferColorSampleCounts;
+    VkFlags framebufferDepthSampleCounts;
+    VkFlags framebufferStencilSampleCounts;
+    VkFlags framebufferNoAttachmentsSampleCounts;
+    DWORD32 maxColorAttachments;
+    VkFlags sampledImageColorSampleCounts;
+    VkFlags sampledImageIntegerSampleCounts;
+    VkFlags sampledImageDepthSampleCounts;
+    VkFlags sampledImageStencilSampleCounts;
+    VkFlags storageImageSampleCounts;
+    DWORD32 maxSampleMaskWords;
+    VkBool32 timestampComputeAndGraphics;
+    float timestampPeriod;
+    DWORD32 maxClipDistances;
+    DWORD32 maxCullDistances;
+    DWORD32 maxCombinedClipAndCullDistances;
+    DWORD32 discreteQueuePriorities;
+    float pointSizeRange[2];
+    float lineWidthRange[2];
+    float pointSizeGranularity;
+    float lineWidthGranularity;
+    VkBool32 strictLines;
+    VkBool32 standardSampleLocations;
+    VkDeviceSize optimalBufferCopyOffsetAlignment;
+    VkDeviceSize optimalBufferCopyRowPitchAlignment;
+    VkDeviceSize nonCoherentAtomSize;
+};
+
+struct VkPhysicalDeviceSparseProperties
+{
+    VkBool32 residencyStandard2DBlockShape;
+    VkBool32 residencyStandard2DMultisampleBlockShape;
+    VkBool32 residencyStandard3DBlockShape;
+    VkBool32 residencyAlignedMipSize;
+    VkBool32 residencyNonResidentStrict;
+};
+
+struct VkPhysicalDeviceProperties
+{
+    DWORD32 apiVersion;
+    DWORD32 driverVersion;
+    DWORD32 vendorID;
+    DWORD32 deviceID;
+    int deviceType;
+    char deviceName[VK_MAX_PHYSICAL_DEVICE_NAME_SIZE];
+    BYTE pipelineCacheUUID[VK_UUID_SIZE];
+    VkPhysicalDeviceLimits limits;
+    VkPhysicalDeviceSparseProperties sparseProperties;
+};
+
+struct VkExtent3D
+{
+    DWORD32 width;
+    DWORD32 height;
+    DWORD32 depth;
+};
+
+struct VkQueueFamilyProperties
+{
+    VkFlags queueFlags;
+    DWORD32 queueCount;
+    DWORD32 timestampValidBits;
+    VkExtent3D minImageTransferGranularity;
+};
+
+struct VkMemoryType
+{
+    VkFlags propertyFlags;
+    DWORD32 heapIndex;
+};
+
+struct VkMemoryHeap
+{
+    VkDeviceSize size;
+    VkFlags flags;
+};
+
+struct VkPhysicalDeviceMemoryProperties
+{
+    DWORD32 memoryTypeCount;
+    VkMemoryType memoryTypes[VK_MAX_MEMORY_TYPES];
+    DWORD32 memoryHeapCount;
+    VkMemoryHeap memoryHeaps[VK_MAX_MEMORY_HEAPS];
+};
+
+struct VkDeviceQueueCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    DWORD32 queueFamilyIndex;
+    DWORD32 queueCount;
+    const float* pQueuePriorities;
+};
+
+struct VkDeviceCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    DWORD32 queueCreateInfoCount;
+    const VkDeviceQueueCreateInfo* pQueueCreateInfos;
+    DWORD32 enabledLayerCount;
+    const char* const* ppEnabledLayerNames;
+    DWORD32 enabledExtensionCount;
+    const char* const* ppEnabledExtensionNames;
+    const void* pEnabledFeatures;
+};
+
+struct VkBufferCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    VkDeviceSize size;
+    VkFlags usage;
+    int sharingMode;
+    DWORD32 queueFamilyIndexCount;
+    const DWORD32* pQueueFamilyIndices;
+};
+
+struct VkMemoryRequirements
+{
+    VkDeviceSize size;
+    VkDeviceSize alignment;
+    DWORD32 memoryTypeBits;
+};
+
+struct VkMemoryAllocateInfo
+{
+    int sType;
+    const void* pNext;
+    VkDeviceSize allocationSize;
+    DWORD32 memoryTypeIndex;
+};
+
+struct VkCommandPoolCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    DWORD32 queueFamilyIndex;
+};
+
+struct VkCommandBufferAllocateInfo
+{
+    int sType;
+    const void* pNext;
+    VkCommandPool commandPool;
+    int level;
+    DWORD32 commandBufferCount;
+};
+
+struct VkCommandBufferBeginInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    const void* pInheritanceInfo;
+};
+
+struct VkBufferCopy
+{
+    VkDeviceSize srcOffset;
+    VkDeviceSize dstOffset;
+    VkDeviceSize size;
+};
+
+struct VkQueryPoolCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    int queryType;
+    DWORD32 queryCount;
+    VkFlags pipelineStatistics;
+};
+
+struct VkFenceCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+};
+
+struct VkSubmitInfo
+{
+    int sType;
+    const void* pNext;
+    DWORD32 waitSemaphoreCount;
+    const VkSemaphore* pWaitSemaphores;
+    const VkFlags* pWaitDstStageMask;
+    DWORD32 commandBufferCount;
+    const VkCommandBuffer* pCommandBuffers;
+    DWORD32 signalSemaphoreCount;
+    const VkSemaphore* pSignalSemaphores;
+};
+
+struct VkSemaphoreCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+};
+
+struct VkOffset2D
+{
+    int x;
+    int y;
+};
+
+struct VkExtent2D
+{
+    DWORD32 width;
+    DWORD32 height;
+};
+
+struct VkRect2D
+{
+    VkOffset2D offset;
+    VkExtent2D extent;
+};
+
+struct VkOffset3D
+{
+    int x;
+    int y;
+    int z;
+};
+
+struct VkImageCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    int imageType;
+    int format;
+    VkExtent3D extent;
+    DWORD32 mipLevels;
+    DWORD32 arrayLayers;
+    VkFlags samples;
+    int tiling;
+    VkFlags usage;
+    int sharingMode;
+    DWORD32 queueFamilyIndexCount;
+    const DWORD32* pQueueFamilyIndices;
+    int initialLayout;
+};
+
+struct VkComponentMapping
+{
+    int r;
+    int g;
+    int b;
+    int a;
+};
+
+struct VkImageSubresourceRange
+{
+    VkFlags aspectMask;
+    DWORD32 baseMipLevel;
+    DWORD32 levelCount;
+    DWORD32 baseArrayLayer;
+    DWORD32 layerCount;
+};
+
+struct VkImageSubresourceLayers
+{
+    VkFlags aspectMask;
+    DWORD32 mipLevel;
+    DWORD32 baseArrayLayer;
+    DWORD32 layerCount;
+};
+
+struct VkImageViewCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    VkImage image;
+    int viewType;
+    int format;
+    VkComponentMapping components;
+    VkImageSubresourceRange subresourceRange;
+};
+
+struct VkImageMemoryBarrier
+{
+    int sType;
+    const void* pNext;
+    VkFlags srcAccessMask;
+    VkFlags dstAccessMask;
+    int oldLayout;
+    int newLayout;
+    DWORD32 srcQueueFamilyIndex;
+    DWORD32 dstQueueFamilyIndex;
+    VkImage image;
+    VkImageSubresourceRange subresourceRange;
+};
+
+struct VkBufferImageCopy
+{
+    VkDeviceSize bufferOffset;
+    DWORD32 bufferRowLength;
+    DWORD32 bufferImageHeight;
+    VkImageSubresourceLayers imageSubresource;
+    VkOffset3D imageOffset;
+    VkExtent3D imageExtent;
+};
+
+struct VkSamplerCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    int magFilter;
+    int minFilter;
+    int mipmapMode;
+    int addressModeU;
+    int addressModeV;
+    int addressModeW;
+    float mipLodBias;
+    VkBool32 anisotropyEnable;
+    float maxAnisotropy;
+    VkBool32 compareEnable;
+    int compareOp;
+    float minLod;
+    float maxLod;
+    int borderColor;
+    VkBool32 unnormalizedCoordinates;
+};
+
+struct VkDescriptorSetLayoutBinding
+{
+    DWORD32 binding;
+    int descriptorType;
+    DWORD32 descriptorCount;
+    VkFlags stageFlags;
+    const VkSampler* pImmutableSamplers;
+};
+
+struct VkDescriptorSetLayoutCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    DWORD32 bindingCount;
+    const VkDescriptorSetLayoutBinding* pBindings;
+};
+
+struct VkDescriptorPoolSize
+{
+    int type;
+    DWORD32 descriptorCount;
+};
+
+struct VkDescriptorPoolCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    DWORD32 maxSets;
+    DWORD32 poolSizeCount;
+    const VkDescriptorPoolSize* pPoolSizes;
+};
+
+struct VkDescriptorSetAllocateInfo
+{
+    int sType;
+    const void* pNext;
+    VkDescriptorPool descriptorPool;
+    DWORD32 descriptorSetCount;
+    const VkDescriptorSetLayout* pSetLayouts;
+};
+
+struct VkDescriptorImageInfo
+{
+    VkSampler sampler;
+    VkImageView imageView;
+    int imageLayout;
+};
+
+struct VkDescriptorBufferInfo
+{
+    VkBuffer buffer;
+    VkDeviceSize offset;
+    VkDeviceSize range;
+};
+
+struct VkWriteDescriptorSet
+{
+    int sType;
+    const void* pNext;
+    VkDescriptorSet dstSet;
+    DWORD32 dstBinding;
+    DWORD32 dstArrayElement;
+    DWORD32 descriptorCount;
+    int descriptorType;
+    const VkDescriptorImageInfo* pImageInfo;
+    const VkDescriptorBufferInfo* pBufferInfo;
+    const void* pTexelBufferView;
+};
+
+struct VkPushConstantRange
+{
+    VkFlags stageFlags;
+    DWORD32 offset;
+    DWORD32 size;
+};
+
+struct VkPipelineLayoutCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    DWORD32 setLayoutCount;
+    const VkDescriptorSetLayout* pSetLayouts;
+    DWORD32 pushConstantRangeCount;
+    const VkPushConstantRange* pPushConstantRanges;
+};
+
+struct VkShaderModuleCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    size_t codeSize;
+    const DWORD32* pCode;
+};
+
+struct VkPipelineShaderStageCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    VkFlags stage;
+    VkShaderModule module;
+    const char* pName;
+    const void* pSpecializationInfo;
+};
+
+struct VkVertexInputBindingDescription
+{
+    DWORD32 binding;
+    DWORD32 stride;
+    int inputRate;
+};
+
+struct VkVertexInputAttributeDescription
+{
+    DWORD32 location;
+    DWORD32 binding;
+    int format;
+    DWORD32 offset;
+};
+
+struct VkPipelineVertexInputStateCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    DWORD32 vertexBindingDescriptionCount;
+    const VkVertexInputBindingDescription* pVertexBindingDescriptions;
+    DWORD32 vertexAttributeDescriptionCount;
+    const VkVertexInputAttributeDescription* pVertexAttributeDescriptions;
+};
+
+struct VkPipelineInputAssemblyStateCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    int topology;
+    VkBool32 primitiveRestartEnable;
+};
+
+struct VkViewport
+{
+    float x;
+    float y;
+    float width;
+    float height;
+    float minDepth;
+    float maxDepth;
+};
+
+struct VkPipelineViewportStateCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    DWORD32 viewportCount;
+    const VkViewport* pViewports;
+    DWORD32 scissorCount;
+    const VkRect2D* pScissors;
+};
+
+struct VkPipelineRasterizationStateCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    VkBool32 depthClampEnable;
+    VkBool32 rasterizerDiscardEnable;
+    int polygonMode;
+    VkFlags cullMode;
+    int frontFace;
+    VkBool32 depthBiasEnable;
+    float depthBiasConstantFactor;
+    float depthBiasClamp;
+    float depthBiasSlopeFactor;
+    float lineWidth;
+};
+
+struct VkPipelineMultisampleStateCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    VkFlags rasterizationSamples;
+    VkBool32 sampleShadingEnable;
+    float minSampleShading;
+    const DWORD32* pSampleMask;
+    VkBool32 alphaToCoverageEnable;
+    VkBool32 alphaToOneEnable;
+};
+
+struct VkStencilOpState
+{
+    int failOp;
+    int passOp;
+    int depthFailOp;
+    int compareOp;
+    DWORD32 compareMask;
+    DWORD32 writeMask;
+    DWORD32 reference;
+};
+
+struct VkPipelineDepthStencilStateCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    VkBool32 depthTestEnable;
+    VkBool32 depthWriteEnable;
+    int depthCompareOp;
+    VkBool32 depthBoundsTestEnable;
+    VkBool32 stencilTestEnable;
+    VkStencilOpState front;
+    VkStencilOpState back;
+    float minDepthBounds;
+    float maxDepthBounds;
+};
+
+struct VkPipelineColorBlendAttachmentState
+{
+    VkBool32 blendEnable;
+    int srcColorBlendFactor;
+    int dstColorBlendFactor;
+    int colorBlendOp;
+    int srcAlphaBlendFactor;
+    int dstAlphaBlendFactor;
+    int alphaBlendOp;
+    VkFlags colorWriteMask;
+};
+
+struct VkPipelineColorBlendStateCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    VkBool32 logicOpEnable;
+    int logicOp;
+    DWORD32 attachmentCount;
+    const VkPipelineColorBlendAttachmentState* pAttachments;
+    float blendConstants[4];
+};
+
+struct VkGraphicsPipelineCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    DWORD32 stageCount;
+    const VkPipelineShaderStageCreateInfo* pStages;
+    const VkPipelineVertexInputStateCreateInfo* pVertexInputState;
+    const VkPipelineInputAssemblyStateCreateInfo* pInputAssemblyState;
+    const void* pTessellationState;
+    const VkPipelineViewportStateCreateInfo* pViewportState;
+    const VkPipelineRasterizationStateCreateInfo* pRasterizationState;
+    const VkPipelineMultisampleStateCreateInfo* pMultisampleState;
+    const VkPipelineDepthStencilStateCreateInfo* pDepthStencilState;
+    const VkPipelineColorBlendStateCreateInfo* pColorBlendState;
+    const void* pDynamicState;
+    VkPipelineLayout layout;
+    VkRenderPass renderPass;
+    DWORD32 subpass;
+    VkPipeline basePipelineHandle;
+    int basePipelineIndex;
+};
+
+struct VkAttachmentDescription
+{
+    VkFlags flags;
+    int format;
+    VkFlags samples;
+    int loadOp;
+    int storeOp;
+    int stencilLoadOp;
+    int stencilStoreOp;
+    int initialLayout;
+    int finalLayout;
+};
+
+struct VkAttachmentReference
+{
+    DWORD32 attachment;
+    int layout;
+};
+
+struct VkSubpassDescription
+{
+    VkFlags flags;
+    int pipelineBindPoint;
+    DWORD32 inputAttachmentCount;
+    const VkAttachmentReference* pInputAttachments;
+    DWORD32 colorAttachmentCount;
+    const VkAttachmentReference* pColorAttachments;
+    const VkAttachmentReference* pResolveAttachments;
+    const VkAttachmentReference* pDepthStencilAttachment;
+    DWORD32 preserveAttachmentCount;
+    const DWORD32* pPreserveAttachments;
+};
+
+struct VkSubpassDependency
+{
+    DWORD32 srcSubpass;
+    DWORD32 dstSubpass;
+    VkFlags srcStageMask;
+    VkFlags dstStageMask;
+    VkFlags srcAccessMask;
+    VkFlags dstAccessMask;
+    VkFlags dependencyFlags;
+};
+
+struct VkRenderPassCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    DWORD32 attachmentCount;
+    const VkAttachmentDescription* pAttachments;
+    DWORD32 subpassCount;
+    const VkSubpassDescription* pSubpasses;
+    DWORD32 dependencyCount;
+    const VkSubpassDependency* pDependencies;
+};
+
+struct VkFramebufferCreateInfo
+{
+    int sType;
+    const void* pNext;
+    VkFlags flags;
+    VkRenderPass renderPass;
+    DWORD32 attachmentCount;
+    const VkImageView* pAttachments;
+    DWORD32 width;
+    DWORD32 height;
+    DWORD32 layers;
+};
+
+// Clear value: color as 4 floats, or depth and stencil.
+union VkClearValue
+{
+    float color[4];
+    struct
+    {
+        float depth;
+        DWORD32 stencil;
+    } depthStencil;
+};
+
+struct VkRenderPassBeginInfo
+{
+    int sType;
+    const void* pNext;
+    VkRenderPass renderPass;
+    VkFramebuffer framebuffer;
+    VkRect2D renderArea;
+    DWORD32 clearValueCount;
+    const VkClearValue* pClearValues;
+};
+
+typedef void(__stdcall *PFN_vkVoidFunction)(void);
+
+// Instance and device functions, imported by vkGetInstanceProcAddr after instance created.
+// Order must match names list of Vulkan backend class.
+struct vkFunctionsList
+{
+    void(__stdcall *vkDestroyInstance)(VkInstance instance, const void* pAllocator);
+    VkResult(__stdcall *vkEnumeratePhysicalDevices)(VkInstance instance, DWORD32* pCount, VkPhysicalDevice* pDevices);
+    void(__stdcall *vkGetPhysicalDeviceProperties)(VkPhysicalDevice device, VkPhysicalDeviceProperties* pProperties);
+    void(__stdcall *vkGetPhysicalDeviceQueueFamilyProperties)(VkPhysicalDevice device, DWORD32* pCount, VkQueueFamilyProperties* pProperties);
+    void(__stdcall *vkGetPhysicalDeviceMemoryProperties)(VkPhysicalDevice device, VkPhysicalDeviceMemoryProperties* pProperties);
+    VkResult(__stdcall *vkCreateDevice)(VkPhysicalDevice physicalDevice, const VkDeviceCreateInfo* pCreateInfo, const void* pAllocator, VkDevice* pDevice);
+    void(__stdcall *vkDestroyDevice)(VkDevice device, const void* pAllocator);
+    void(__stdcall *vkGetDeviceQueue)(VkDevice device, DWORD32 family, DWORD32 index, VkQueue* pQueue);
+    VkResult(__stdcall *vkDeviceWaitIdle)(VkDevice device);
+    VkResult(__stdcall *vkCreateBuffer)(VkDevice device, const VkBufferCreateInfo* pCreateInfo, const void* pAllocator, VkBuffer* pBuffer);
+    void(__stdcall *vkDestroyBuffer)(VkDevice device, VkBuffer buffer, const void* pAllocator);
+    void(__stdcall *vkGetBufferMemoryRequirements)(VkDevice device, VkBuffer buffer, VkMemoryRequirements* pRequirements);
+    VkResult(__stdcall *vkAllocateMemory)(VkDevice device, const VkMemoryAllocateInfo* pInfo, const void* pAllocator, VkDeviceMemory* pMemory);
+    void(__stdcall *vkFreeMemory)(VkDevice device, VkDeviceMemory memory, const void* pAllocator);
+    VkResult(__stdcall *vkBindBufferMemory)(VkDevice device, VkBuffer buffer, VkDeviceMemory memory, VkDeviceSize offset);
+    VkResult(__stdcall *vkMapMemory)(VkDevice device, VkDeviceMemory memory, VkDeviceSize offset, VkDeviceSize size, VkFlags flags, void** ppData);
+    void(__stdcall *vkUnmapMemory)(VkDevice device, VkDeviceMemory memory);
+    VkResult(__stdcall *vkCreateCommandPool)(VkDevice device, const VkCommandPoolCreateInfo* pCreateInfo, const void* pAllocator, VkCommandPool* pPool);
+    void(__stdcall *vkDestroyCommandPool)(VkDevice device, VkCommandPool pool, const void* pAllocator);
+    VkResult(__stdcall *vkAllocateCommandBuffers)(VkDevice device, const VkCommandBufferAllocateInfo* pInfo, VkCommandBuffer* pBuffers);
+    VkResult(__stdcall *vkBeginCommandBuffer)(VkCommandBuffer buffer, const VkCommandBufferBeginInfo* pInfo);
+    VkResult(__stdcall *vkEndCommandBuffer)(VkCommandBuffer buffer);
+    void(__stdcall *vkCmdCopyBuffer)(VkCommandBuffer buffer, VkBuffer src, VkBuffer dst, DWORD32 count, const VkBufferCopy* pRegions);
+    void(__stdcall *vkCmdResetQueryPool)(VkCommandBuffer buffer, VkQueryPool pool, DWORD32 first, DWORD32 count);
+    void(__stdcall *vkCmdWriteTimestamp)(VkCommandBuffer buffer, VkFlags stage, VkQueryPool pool, DWORD32 query);
+    VkResult(__stdcall *vkCreateQueryPool)(VkDevice device, const VkQueryPoolCreateInfo* pCreateInfo, const void* pAllocator, VkQueryPool* pPool);
+    void(__stdcall *vkDestroyQueryPool)(VkDevice device, VkQueryPool pool, const void* pAllocator);
+    VkResult(__stdcall *vkGetQueryPoolResults)(VkDevice device, VkQueryPool pool, DWORD32 first, DWORD32 count, size_t dataSize, void* pData, VkDeviceSize stride, VkFlags flags);
+    VkResult(__stdcall *vkCreateFence)(VkDevice device, const VkFenceCreateInfo* pCreateInfo, const void* pAllocator, VkFence* pFence);
+    void(__stdcall *vkDestroyFence)(VkDevice device, VkFence fence, const void* pAllocator);
+    VkResult(__stdcall *vkWaitForFences)(VkDevice device, DWORD32 count, const VkFence* pFences, VkBool32 waitAll, DWORD64 timeout);
+    VkResult(__stdcall *vkResetFences)(VkDevice device, DWORD32 count, const VkFence* pFences);
+    VkResult(__stdcall *vkQueueSubmit)(VkQueue queue, DWORD32 count, const VkSubmitInfo* pSubmits, VkFence fence);
+    VkResult(__stdcall *vkCreateSemaphore)(VkDevice device, const VkSemaphoreCreateInfo* pCreateInfo, const void* pAllocator, VkSemaphore* pSemaphore);
+    void(__stdcall *vkDestroySemaphore)(VkDevice device, VkSemaphore semaphore, const void* pAllocator);
+    VkResult(__stdcall *vkCreateImage)(VkDevice device, const VkImageCreateInfo* pCreateInfo, const void* pAllocator, VkImage* pImage);
+    void(__stdcall *vkDestroyImage)(VkDevice device, VkImage image, const void* pAllocator);
+    void(__stdcall *vkGetImageMemoryRequirements)(VkDevice device, VkImage image, VkMemoryRequirements* pRequirements);
+    VkResult(__stdcall *vkBindImageMemory)(VkDevice device, VkImage image, VkDeviceMemory memory, VkDeviceSize offset);
+    VkResult(__stdcall *vkCreateImageView)(VkDevice device, const VkImageViewCreateInfo* pCreateInfo, const void* pAllocator, VkImageView* pView);
+    void(__stdcall *vkDestroyImageView)(VkDevice device, VkImageView view, const void* pAllocator);
+    VkResult(__stdcall *vkCreateSampler)(VkDevice device, const VkSamplerCreateInfo* pCreateInfo, const void* pAllocator, VkSampler* pSampler);
+    void(__stdcall *vkDestroySampler)(VkDevice device, VkSampler sampler, const void* pAllocator);
+    VkResult(__stdcall *vkCreateDescriptorSetLayout)(VkDevice device, const VkDescriptorSetLayoutCreateInfo* pCreateInfo, const void* pAllocator, VkDescriptorSetLayout* pLayout);
+    void(__stdcall *vkDestroyDescriptorSetLayout)(VkDevice device, VkDescriptorSetLayout layout, const void* pAllocator);
+    VkResult(__stdcall *vkCreateDescriptorPool)(VkDevice device, const VkDescriptorPoolCreateInfo* pCreateInfo, const void* pAllocator, VkDescriptorPool* pPool);
+    void(__stdcall *vkDestroyDescriptorPool)(VkDevice device, VkDescriptorPool pool, const void* pAllocator);
+    VkResult(__stdcall *vkAllocateDescriptorSets)(VkDevice device, const VkDescriptorSetAllocateInfo* pInfo, VkDescriptorSet* pSets);
+    void(__stdcall *vkUpdateDescriptorSets)(VkDevice device, DWORD32 writeCount, const VkWriteDescriptorSet* pWrites, DWORD32 copyCount, const void* pCopies);
+    VkResult(__stdcall *vkCreatePipelineLayout)(VkDevice device, const VkPipelineLayoutCreateInfo* pCreateInfo, const void* pAllocator, VkPipelineLayout* pLayout);
+    void(__stdcall *vkDestroyPipelineLayout)(VkDevice device, VkPipelineLayout layout, const void* pAllocator);
+    VkResult(__stdcall *vkCreateShaderModule)(VkDevice device, const VkShaderModuleCreateInfo* pCreateInfo, const void* pAllocator, VkShaderModule* pModule);
+    void(__stdcall *vkDestroyShaderModule)(VkDevice device, VkShaderModule module, const void* pAllocator);
+    VkResult(__stdcall *vkCreateGraphicsPipelines)(VkDevice device, VkPipelineCache cache, DWORD32 count, const VkGraphicsPipelineCreateInfo* pCreateInfos, const void* pAllocator, VkPipeline* pPipelines);
+    void(__stdcall *vkDestroyPipeline)(VkDevice device, VkPipeline pipeline, const void* pAllocator);
+    VkResult(__stdcall *vkCreateRenderPass)(VkDevice device, const VkRenderPassCreateInfo* pCreateInfo, const void* pAllocator, VkRenderPass* pRenderPass);
+    void(__stdcall *vkDestroyRenderPass)(VkDevice device, VkRenderPass renderPass, const void* pAllocator);
+    VkResult(__stdcall *vkCreateFramebuffer)(VkDevice device, const VkFramebufferCreateInfo* pCreateInfo, const void* pAllocator, VkFramebuffer* pFramebuffer);
+    void(__stdcall *vkDestroyFramebuffer)(VkDevice device, VkFramebuffer framebuffer, const void* pAllocator);
+    void(__stdcall *vkCmdPipelineBarrier)(VkCommandBuffer buffer, VkFlags srcStageMask, VkFlags dstStageMask, VkFlags dependencyFlags,
+        DWORD32 memoryBarrierCount, const void* pMemoryBarriers, DWORD32 bufferBarrierCount, const void* pBufferBarriers,
+        DWORD32 imageBarrierCount, const VkImageMemoryBarrier* pImageBarriers);
+    void(__stdcall *vkCmdCopyBufferToImage)(VkCommandBuffer buffer, VkBuffer src, VkImage dst, int dstLayout, DWORD32 count, const VkBufferImageCopy* pRegions);
+    void(__stdcall *vkCmdBeginRenderPass)(VkCommandBuffer buffer, const VkRenderPassBeginInfo* pInfo, int contents);
+    void(__stdcall *vkCmdEndRenderPass)(VkCommandBuffer buffer);
+    void(__stdcall *vkCmdBindPipeline)(VkCommandBuffer buffer, int bindPoint, VkPipeline pipeline);
+    void(__stdcall *vkCmdBindDescriptorSets)(VkCommandBuffer buffer, int bindPoint, VkPipelineLayout layout, DWORD32 firstSet,
+        DWORD32 setCount, const VkDescriptorSet* pSets, DWORD32 dynamicOffsetCount, const DWORD32* pDynamicOffsets);
+    void(__stdcall *vkCmdBindVertexBuffers)(VkCommandBuffer buffer, DWORD32 firstBinding, DWORD32 count, const VkBuffer* pBuffers, const VkDeviceSize* pOffsets);
+    void(__stdcall *vkCmdPushConstants)(VkCommandBuffer buffer, VkPipelineLayout layout, VkFlags stageFlags, DWORD32 offset, DWORD32 size, const void* pValues);
+    void(__stdcall *vkCmdDraw)(VkCommandBuffer buffer, DWORD32 vertexCount, DWORD32 instanceCount, DWORD32 firstVertex, DWORD32 firstInstance);
+};
+
+#endif // VULKANIMPORT_H